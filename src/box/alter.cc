@@ -240,6 +240,26 @@ index_opts_decode(struct index_opts *opts, const char *map,
 			 "less than or equal to 1");
 		return -1;
 	}
+	if (opts->compaction_policy == index_compaction_policy_MAX) {
+		diag_set(ClientError, ER_WRONG_INDEX_OPTIONS,
+			 BOX_INDEX_FIELD_OPTS, "compaction_policy must be "
+			 "'hybrid', 'tiered' or 'leveled'");
+		return -1;
+	}
+	if (opts->compression_dict_size != 0 &&
+	    (opts->compression_dict_size < 256 ||
+	     opts->compression_dict_size > 65536)) {
+		diag_set(ClientError, ER_WRONG_INDEX_OPTIONS,
+			 BOX_INDEX_FIELD_OPTS, "compression_dict_size must be "
+			 "0 or between 256 and 65536");
+		return -1;
+	}
+	if (opts->quota_class == index_quota_class_MAX) {
+		diag_set(ClientError, ER_WRONG_INDEX_OPTIONS,
+			 BOX_INDEX_FIELD_OPTS, "quota_class must be "
+			 "'normal' or 'bulk'");
+		return -1;
+	}
 	return 0;
 }
 
@@ -56,9 +56,22 @@
 #include "txn_limbo.h"
 #include "journal.h"
 #include "raft.h"
+#include "assoc.h"
+#include "space.h"
+#include "index.h"
+#include "tuple.h"
 
 STRS(applier_state, applier_STATE);
 
+enum {
+	/**
+	 * Max number of transactions an applier may have read
+	 * from the network and not yet written to WAL. Bounds
+	 * memory used for transactions pending apply.
+	 */
+	APPLIER_TX_WINDOW = 1024,
+};
+
 static inline void
 applier_set_state(struct applier *applier, enum applier_state state)
 {
@@ -619,6 +632,52 @@ struct applier_tx_row {
 	struct xrow_header row;
 };
 
+/**
+ * A transaction applied by a separate fiber concurrently with
+ * other transactions received by the same applier.
+ */
+struct applier_job {
+	/** Applier that received the transaction. */
+	struct applier *applier;
+	/** Memory for the transaction rows. */
+	struct region region;
+	/** Transaction rows, linked by applier_tx_row::next. */
+	struct stailq rows;
+	/** Id of the instance the transaction originates from. */
+	uint32_t replica_id;
+	/** LSN of the last row of the transaction. */
+	int64_t lsn;
+	/** Keys modified by the transaction, see applier_job_key(). */
+	uint64_t *keys;
+	/** Number of entries in the keys array. */
+	int key_count;
+	/** Allocated size of the keys array. */
+	int key_capacity;
+	/**
+	 * Set if the transaction can't be applied concurrently
+	 * with other transactions, e.g. because it changes the
+	 * schema or its footprint is unknown.
+	 */
+	bool is_barrier;
+	/**
+	 * Set if the transaction must wait for its turn to be
+	 * committed before applying rows. This is the case if
+	 * it modifies spaces of an engine that doesn't allow
+	 * transactions to yield.
+	 */
+	bool apply_in_order;
+	/**
+	 * Set if the transaction must be rolled back, because
+	 * a preceding transaction failed to apply or a WAL write
+	 * failed.
+	 */
+	bool is_cancelled;
+	/** Link in replicaset.applier.apply_queue. */
+	struct rlist in_queue;
+	/** Link in applier::tx_queue. */
+	struct stailq_entry in_tx_queue;
+};
+
 static struct applier_tx_row *
 applier_read_tx_row(struct applier *applier)
 {
@@ -640,7 +699,11 @@ applier_read_tx_row(struct applier *applier)
 	 * from the master for quite a while the connection is
 	 * broken - the master might just be idle.
 	 */
-	if (applier->version_id < version_id(1, 7, 7))
+	if (applier->compression)
+		coio_read_xrow_compressed_timeout_xc(coio,
+						     &applier->decompressor,
+						     ibuf, row, timeout);
+	else if (applier->version_id < version_id(1, 7, 7))
 		coio_read_xrow(coio, ibuf, row);
 	else
 		coio_read_xrow_timeout_xc(coio, ibuf, row, timeout);
@@ -743,6 +806,17 @@ applier_rollback_by_wal_io(void)
 	diag_set_error(&replicaset.applier.diag,
 		       diag_last_error(diag_get()));
 
+	/*
+	 * Transactions dispatched to apply fibers and not yet
+	 * submitted to the journal must be rolled back, too.
+	 */
+	for (int i = 0; i < VCLOCK_MAX; i++) {
+		struct applier_job *job;
+		rlist_foreach_entry(job, &replicaset.applier.apply_queue[i],
+				    in_queue)
+			job->is_cancelled = true;
+	}
+
 	/* Broadcast the rollback across all appliers. */
 	trigger_run(&replicaset.applier.on_rollback, NULL);
 
@@ -750,11 +824,65 @@ applier_rollback_by_wal_io(void)
 	vclock_copy(&replicaset.applier.vclock, &replicaset.vclock);
 }
 
+/**
+ * Applier state attached to a replicated transaction submitted
+ * to the journal.
+ */
+struct applier_txn {
+	/**
+	 * Applier that received the transaction. Reset once the
+	 * transaction leaves the applier window, i.e. is written
+	 * to WAL or rolled back, or the applier disconnects.
+	 */
+	struct applier *applier;
+	/** Link in applier::wal_queue. */
+	struct rlist in_wal_queue;
+	/** Time when the transaction was created on the master. */
+	double tm;
+	/** Trigger invoked on the transaction rollback. */
+	struct trigger on_rollback;
+	/** Trigger invoked on the transaction WAL write. */
+	struct trigger on_wal_write;
+};
+
+/**
+ * Account a transaction that was either written to WAL or
+ * rolled back in the applier window.
+ */
+static void
+applier_txn_complete(struct applier_txn *atxn)
+{
+	struct applier *applier = atxn->applier;
+	if (applier == NULL)
+		return;
+	assert(applier->wal_queue_size > 0);
+	applier->wal_queue_size--;
+	rlist_del_entry(atxn, in_wal_queue);
+	fiber_cond_broadcast(&applier->tx_cond);
+	atxn->applier = NULL;
+}
+
+/**
+ * Detach transactions submitted to the journal by an applier
+ * so that their completion doesn't touch the applier.
+ */
+static void
+applier_clear_wal_queue(struct applier *applier)
+{
+	struct applier_txn *atxn, *tmp;
+	rlist_foreach_entry_safe(atxn, &applier->wal_queue, in_wal_queue,
+				 tmp) {
+		rlist_del_entry(atxn, in_wal_queue);
+		atxn->applier = NULL;
+	}
+	applier->wal_queue_size = 0;
+}
+
 static int
 applier_txn_rollback_cb(struct trigger *trigger, void *event)
 {
-	(void) trigger;
 	struct txn *txn = (struct txn *) event;
+	applier_txn_complete((struct applier_txn *)trigger->data);
 	/*
 	 * Synchronous transaction rollback due to receiving a
 	 * ROLLBACK entry is a normal event and requires no
@@ -768,8 +896,11 @@ applier_txn_rollback_cb(struct trigger *trigger, void *event)
 static int
 applier_txn_wal_write_cb(struct trigger *trigger, void *event)
 {
-	(void) trigger;
 	(void) event;
+	struct applier_txn *atxn = (struct applier_txn *)trigger->data;
+	if (atxn->applier != NULL)
+		atxn->applier->apply_lag = ev_now(loop()) - atxn->tm;
+	applier_txn_complete(atxn);
 	/* Broadcast the WAL write across all appliers. */
 	trigger_run(&replicaset.applier.on_wal_write, NULL);
 	return 0;
@@ -895,6 +1026,593 @@ applier_handle_raft(struct applier *applier, struct xrow_header *row)
 	return box_raft_process(&req, applier->instance_id);
 }
 
+/**
+ * Apply all rows of a replicated transaction.
+ *
+ * Return the transaction ready to be committed or NULL in case
+ * of an error, in which case the transaction is rolled back.
+ */
+static struct txn *
+applier_txn_apply(struct stailq *rows)
+{
+	/**
+	 * Explicitly begin the transaction so that we can
+	 * control fiber->gc life cycle and, in case of apply
+	 * conflict safely access failed xrow object and allocate
+	 * IPROTO_NOP on gc.
+	 */
+	struct txn *txn;
+	txn = txn_begin();
+	struct applier_tx_row *item;
+	if (txn == NULL)
+		return NULL;
+	stailq_foreach_entry(item, rows, next) {
+		struct xrow_header *row = &item->row;
+		int res = apply_row(row);
+		if (res != 0) {
+			struct error *e = diag_last_error(diag_get());
+			/*
+			 * In case of ER_TUPLE_FOUND error and enabled
+			 * replication_skip_conflict configuration
+			 * option, skip applying the foreign row and
+			 * replace it with NOP in the local write ahead
+			 * log.
+			 */
+			if (e->type == &type_ClientError &&
+			    box_error_code(e) == ER_TUPLE_FOUND &&
+			    replication_skip_conflict) {
+				diag_clear(diag_get());
+				row->type = IPROTO_NOP;
+				row->bodycnt = 0;
+				res = apply_row(row);
+			}
+		}
+		if (res != 0)
+			goto rollback;
+	}
+	/*
+	 * We are going to commit so it's a high time to check if
+	 * the current transaction has non-local effects.
+	 */
+	if (txn_is_distributed(txn)) {
+		/*
+		 * A transaction mixes remote and local rows.
+		 * Local rows must be replicated back, which
+		 * doesn't make sense since the master likely has
+		 * new changes which local rows may overwrite.
+		 * Raise an error.
+		 */
+		diag_set(ClientError, ER_UNSUPPORTED,
+			 "Replication", "distributed transactions");
+		goto rollback;
+	}
+	return txn;
+rollback:
+	txn_rollback(txn);
+	return NULL;
+}
+
+/**
+ * Submit a replicated transaction returned by applier_txn_apply()
+ * to the journal. @a tm is the time the transaction was created
+ * on the master.
+ *
+ * The transaction stays in the applier window until it's written
+ * to WAL or rolled back, see APPLIER_TX_WINDOW.
+ *
+ * Return 0 for success or -1 in case of an error.
+ */
+static int
+applier_txn_commit(struct applier *applier, struct txn *txn, double tm)
+{
+	size_t size;
+	struct applier_txn *atxn = region_alloc_object(&txn->region,
+						       typeof(*atxn), &size);
+	if (atxn == NULL) {
+		diag_set(OutOfMemory, size, "region_alloc_object",
+			 "applier_txn");
+		txn_rollback(txn);
+		return -1;
+	}
+	atxn->applier = applier;
+	atxn->tm = tm;
+
+	trigger_create(&atxn->on_rollback, applier_txn_rollback_cb,
+		       atxn, NULL);
+	txn_on_rollback(txn, &atxn->on_rollback);
+
+	trigger_create(&atxn->on_wal_write, applier_txn_wal_write_cb,
+		       atxn, NULL);
+	txn_on_wal_write(txn, &atxn->on_wal_write);
+
+	rlist_add_tail_entry(&applier->wal_queue, atxn, in_wal_queue);
+	applier->wal_queue_size++;
+	if (txn_commit_async(txn) < 0)
+		return -1;
+	return 0;
+}
+
+static struct applier_job *
+applier_job_new(struct applier *applier)
+{
+	struct applier_job *job = (struct applier_job *)
+		calloc(1, sizeof(*job));
+	if (job == NULL) {
+		diag_set(OutOfMemory, sizeof(*job), "malloc",
+			 "struct applier_job");
+		return NULL;
+	}
+	job->applier = applier;
+	region_create(&job->region, &cord()->slabc);
+	stailq_create(&job->rows);
+	rlist_create(&job->in_queue);
+	return job;
+}
+
+static void
+applier_job_delete(struct applier_job *job)
+{
+	assert(rlist_empty(&job->in_queue));
+	region_destroy(&job->region);
+	free(job->keys);
+	free(job);
+}
+
+/**
+ * Get a footprint of a key modified by a transaction. Footprints
+ * of equal keys are equal. Footprints of different keys may
+ * collide, which results in a false conflict.
+ *
+ * @param key   Key parts, without MsgPack array header.
+ */
+static inline uint64_t
+applier_job_key(uint32_t space_id, uint32_t index_id, const char *key,
+		struct key_def *key_def)
+{
+	return ((uint64_t)space_id << 32 | index_id << 24) ^
+		key_hash(key, key_def);
+}
+
+static int
+applier_job_add_key(struct applier_job *job, uint64_t key)
+{
+	if (job->key_count == job->key_capacity) {
+		int capacity = MAX(job->key_capacity * 2, 16);
+		uint64_t *keys = (uint64_t *)realloc(job->keys,
+						     capacity * sizeof(*keys));
+		if (keys == NULL) {
+			diag_set(OutOfMemory, capacity * sizeof(*keys),
+				 "realloc", "keys");
+			return -1;
+		}
+		job->keys = keys;
+		job->key_capacity = capacity;
+	}
+	job->keys[job->key_count++] = key;
+	return 0;
+}
+
+/**
+ * Add keys modified by a transaction row to the job footprint.
+ * Only rows modifying user spaces by primary key may be applied
+ * in parallel: for any other row the job is marked as a barrier.
+ * Since an insertion may fail due to a conflict in a unique
+ * secondary index, its secondary keys are added to the footprint,
+ * too, while deletions and updates of spaces with unique secondary
+ * indexes are treated as barriers, because the old secondary keys
+ * aren't known in advance.
+ */
+static int
+applier_job_add_row(struct applier_job *job, struct xrow_header *row)
+{
+	if (iproto_type_is_synchro_request(row->type))
+		goto barrier;
+	struct request request;
+	if (xrow_decode_dml(row, &request,
+			    dml_request_key_map(row->type)) != 0) {
+		/* Let the applier fiber raise the error. */
+		diag_clear(diag_get());
+		goto barrier;
+	}
+	if (request.type == IPROTO_NOP)
+		return 0;
+	if (request.space_id < BOX_SYSTEM_ID_MAX)
+		goto barrier;
+	struct space *space;
+	space = space_by_id(request.space_id);
+	if (space == NULL || space->index_count == 0 ||
+	    !rlist_empty(&space->before_replace) ||
+	    !rlist_empty(&space->on_replace))
+		goto barrier;
+	if (!space_is_vinyl(space))
+		job->apply_in_order = true;
+	bool has_unique_sk;
+	has_unique_sk = false;
+	for (uint32_t i = 1; i < space->index_count; i++) {
+		if (space->index[i]->def->opts.is_unique)
+			has_unique_sk = true;
+	}
+	const char *key;
+	struct key_def *key_def;
+	switch (request.type) {
+	case IPROTO_REPLACE:
+		/*
+		 * A replaced tuple may free a unique secondary key
+		 * taken by a following transaction, which must not
+		 * be checked for uniqueness before this one is done.
+		 */
+		if (has_unique_sk)
+			goto barrier;
+		FALLTHROUGH;
+	case IPROTO_INSERT:
+		for (uint32_t i = 0; i < space->index_count; i++) {
+			struct index_def *index_def = space->index[i]->def;
+			if (!index_def->opts.is_unique)
+				continue;
+			key_def = index_def->key_def;
+			if (key_def->is_multikey || key_def->for_func_index)
+				goto barrier;
+			key = tuple_extract_key_raw(request.tuple,
+						    request.tuple_end, key_def,
+						    MULTIKEY_NONE, NULL);
+			if (key == NULL)
+				return -1;
+			mp_decode_array(&key);
+			if (applier_job_add_key(job, applier_job_key(
+					space->def->id, index_def->iid,
+					key, key_def)) != 0)
+				return -1;
+		}
+		return 0;
+	case IPROTO_UPSERT:
+		if (has_unique_sk)
+			goto barrier;
+		key_def = space->index[0]->def->key_def;
+		key = tuple_extract_key_raw(request.tuple, request.tuple_end,
+					    key_def, MULTIKEY_NONE, NULL);
+		if (key == NULL)
+			return -1;
+		mp_decode_array(&key);
+		break;
+	case IPROTO_DELETE:
+	case IPROTO_UPDATE:
+		if (has_unique_sk || request.index_id != 0)
+			goto barrier;
+		key_def = space->index[0]->def->key_def;
+		key = request.key;
+		if (mp_decode_array(&key) != key_def->part_count)
+			goto barrier;
+		break;
+	default:
+		goto barrier;
+	}
+	return applier_job_add_key(job, applier_job_key(space->def->id, 0,
+							key, key_def));
+barrier:
+	job->is_barrier = true;
+	return 0;
+}
+
+/**
+ * Check if a job modifies any key modified by a transaction that
+ * is being applied by an apply fiber.
+ */
+static bool
+applier_job_has_conflicts(struct applier_job *job)
+{
+	struct mh_i64ptr_t *h = job->applier->apply_keys;
+	for (int i = 0; i < job->key_count; i++) {
+		if (mh_i64ptr_find(h, job->keys[i], NULL) != mh_end(h))
+			return true;
+	}
+	return false;
+}
+
+static int
+applier_job_register_keys(struct applier_job *job)
+{
+	struct mh_i64ptr_t *h = job->applier->apply_keys;
+	for (int i = 0; i < job->key_count; i++) {
+		struct mh_i64ptr_node_t node = {job->keys[i], job};
+		if (mh_i64ptr_put(h, &node, NULL, NULL) == mh_end(h)) {
+			diag_set(OutOfMemory, sizeof(node), "mh_i64ptr_put",
+				 "apply_keys");
+			return -1;
+		}
+	}
+	return 0;
+}
+
+static void
+applier_job_unregister_keys(struct applier_job *job)
+{
+	struct mh_i64ptr_t *h = job->applier->apply_keys;
+	for (int i = 0; i < job->key_count; i++) {
+		mh_int_t k = mh_i64ptr_find(h, job->keys[i], NULL);
+		if (k != mh_end(h) && mh_i64ptr_node(h, k)->val == job)
+			mh_i64ptr_del(h, k, NULL);
+	}
+}
+
+/**
+ * Copy transaction rows to the job memory so that they outlive
+ * the applier fiber gc region and input buffer.
+ */
+static int
+applier_job_copy_rows(struct applier_job *job, struct stailq *rows)
+{
+	struct applier_tx_row *item;
+	stailq_foreach_entry(item, rows, next) {
+		size_t size;
+		struct applier_tx_row *tx_row =
+			region_alloc_object(&job->region, typeof(*tx_row),
+					    &size);
+		if (tx_row == NULL) {
+			diag_set(OutOfMemory, size, "region_alloc_object",
+				 "tx_row");
+			return -1;
+		}
+		tx_row->row = item->row;
+		struct xrow_header *row = &tx_row->row;
+		for (int i = 0; i < row->bodycnt; i++) {
+			size = row->body[i].iov_len;
+			void *body = region_alloc(&job->region, size);
+			if (body == NULL) {
+				diag_set(OutOfMemory, size, "region",
+					 "xrow body");
+				return -1;
+			}
+			memcpy(body, row->body[i].iov_base, size);
+			row->body[i].iov_base = body;
+		}
+		stailq_add_tail_entry(&job->rows, tx_row, next);
+	}
+	return 0;
+}
+
+/**
+ * Return LSN of the last transaction received from the given
+ * instance and either submitted to the journal or dispatched
+ * to an apply fiber by the given applier.
+ *
+ * Transactions dispatched by other appliers may still fail to
+ * apply, so we wait for them to be submitted to the journal
+ * rather than skip them. Hence an apply queue never contains
+ * transactions dispatched by different appliers.
+ */
+static int
+applier_last_lsn(struct applier *applier, uint32_t replica_id,
+		 int64_t *lsn)
+{
+	struct rlist *queue = &replicaset.applier.apply_queue[replica_id];
+	while (!rlist_empty(queue)) {
+		struct applier_job *last = rlist_last_entry(
+				queue, struct applier_job, in_queue);
+		if (last->applier == applier) {
+			*lsn = last->lsn;
+			return 0;
+		}
+		if (fiber_cond_wait(&replicaset.applier.apply_cond) != 0)
+			return -1;
+	}
+	*lsn = vclock_get(&replicaset.applier.vclock, replica_id);
+	return 0;
+}
+
+/**
+ * Wait until a job is the first in its apply queue, i.e. all
+ * preceding transactions from the same instance are submitted
+ * to the journal.
+ */
+static void
+applier_job_wait_turn(struct applier_job *job)
+{
+	struct rlist *queue =
+		&replicaset.applier.apply_queue[job->replica_id];
+	while (rlist_first_entry(queue, struct applier_job,
+				 in_queue) != job)
+		fiber_cond_wait(&replicaset.applier.apply_cond);
+}
+
+/**
+ * Stop reading and applying transactions received by an applier.
+ * The applier fiber will exit with the error set in applier->diag.
+ */
+static void
+applier_cancel(struct applier *applier)
+{
+	fiber_cancel(applier->reader);
+	if (applier->processor != NULL)
+		fiber_cancel(applier->processor);
+}
+
+/**
+ * Called if a job failed to apply its transaction. Cancels it
+ * and all the following transactions from the same instance,
+ * because they can't be committed without it, and stops their
+ * appliers with the job error.
+ */
+static void
+applier_job_fail(struct applier_job *job)
+{
+	struct error *e = diag_last_error(diag_get());
+	struct rlist *queue =
+		&replicaset.applier.apply_queue[job->replica_id];
+	struct applier_job *last = rlist_last_entry(queue, struct applier_job,
+						    in_queue);
+	struct applier_job *next = job;
+	while (next != last) {
+		next = rlist_next_entry(next, in_queue);
+		struct applier *applier = next->applier;
+		next->is_cancelled = true;
+		if (diag_is_empty(&applier->diag))
+			diag_set_error(&applier->diag, e);
+		applier_cancel(applier);
+	}
+	job->is_cancelled = true;
+	if (diag_is_empty(&job->applier->diag))
+		diag_set_error(&job->applier->diag, e);
+	applier_cancel(job->applier);
+}
+
+static int
+applier_job_f(va_list ap)
+{
+	struct applier_job *job = va_arg(ap, struct applier_job *);
+	struct applier *applier = job->applier;
+	int rc = 0;
+	if (job->apply_in_order)
+		applier_job_wait_turn(job);
+	if (!job->is_cancelled) {
+		struct txn *txn = applier_txn_apply(&job->rows);
+		if (txn == NULL) {
+			rc = -1;
+		} else {
+			applier_job_wait_turn(job);
+			struct xrow_header *last_row = &stailq_last_entry(
+				&job->rows, struct applier_tx_row, next)->row;
+			if (job->is_cancelled)
+				txn_rollback(txn);
+			else
+				rc = applier_txn_commit(applier, txn,
+							last_row->tm);
+		}
+	}
+	if (rc == 0 && !job->is_cancelled) {
+		vclock_follow(&replicaset.applier.vclock, job->replica_id,
+			      job->lsn);
+	} else if (rc != 0) {
+		applier_job_fail(job);
+	}
+	rlist_del(&job->in_queue);
+	fiber_cond_broadcast(&replicaset.applier.apply_cond);
+	applier_job_unregister_keys(job);
+	applier_job_delete(job);
+	assert(applier->apply_job_count > 0);
+	applier->apply_job_count--;
+	fiber_cond_broadcast(&applier->apply_cond);
+	fiber_gc();
+	return 0;
+}
+
+/**
+ * Wait until all transactions dispatched by an applier to apply
+ * fibers are submitted to the journal or rolled back.
+ */
+static int
+applier_wait_jobs(struct applier *applier)
+{
+	while (applier->apply_job_count > 0) {
+		if (fiber_cond_wait(&applier->apply_cond) != 0)
+			return -1;
+	}
+	return 0;
+}
+
+/**
+ * Dispatch a transaction to a new apply fiber so that it's
+ * applied concurrently with other transactions received by
+ * the applier.
+ *
+ * A transaction isn't dispatched until all transactions it
+ * conflicts with, i.e. modifying the same keys, are submitted
+ * to the journal. Transactions from the same instance are
+ * submitted to the journal in the LSN order. As apply fibers
+ * that have their transactions applied are woken up one after
+ * another in the same event loop iteration, their journal
+ * entries are submitted in one batch.
+ *
+ * Return 0 if the transaction was dispatched or skipped, 1 if
+ * it must be applied by the applier fiber, -1 on error.
+ */
+static int
+applier_dispatch_tx(struct applier *applier, struct stailq *rows)
+{
+	struct xrow_header *first_row = &stailq_first_entry(rows,
+					struct applier_tx_row, next)->row;
+	struct xrow_header *last_row;
+	last_row = &stailq_last_entry(rows, struct applier_tx_row, next)->row;
+	uint32_t replica_id = last_row->replica_id;
+	if (first_row->replica_id != replica_id)
+		return 1;
+	struct applier_job *job = applier_job_new(applier);
+	if (job == NULL)
+		return -1;
+	job->replica_id = replica_id;
+	job->lsn = last_row->lsn;
+	struct applier_tx_row *item;
+	stailq_foreach_entry(item, rows, next) {
+		if (applier_job_add_row(job, &item->row) != 0)
+			goto fail;
+		if (job->is_barrier)
+			goto barrier;
+	}
+	while (applier_job_has_conflicts(job) ||
+	       applier->apply_job_count >= replication_apply_fibers) {
+		if (fiber_cond_wait(&applier->apply_cond) != 0)
+			goto fail;
+	}
+	struct replica *replica;
+	replica = replica_by_id(replica_id);
+	struct latch *latch;
+	latch = (replica ? &replica->order_latch :
+		 &replicaset.applier.order_latch);
+	latch_lock(latch);
+	int64_t lsn;
+	if (applier_last_lsn(applier, replica_id, &lsn) != 0) {
+		latch_unlock(latch);
+		goto fail;
+	}
+	/*
+	 * Stop dispatching as soon as a dispatched transaction
+	 * fails to apply, see applier_job_fail().
+	 */
+	if (fiber_is_cancelled()) {
+		diag_set(FiberIsCancelled);
+		latch_unlock(latch);
+		goto fail;
+	}
+	if (lsn >= last_row->lsn) {
+		/* The transaction was received by another applier. */
+		latch_unlock(latch);
+		applier_job_delete(job);
+		return 0;
+	}
+	if (lsn >= first_row->lsn) {
+		/* Let the applier fiber skip the applied part. */
+		latch_unlock(latch);
+		goto barrier;
+	}
+	char name[FIBER_NAME_MAX];
+	int pos;
+	pos = snprintf(name, sizeof(name), "applierf/");
+	uri_format(name + pos, sizeof(name) - pos, &applier->uri, false);
+	struct fiber *f;
+	if (applier_job_copy_rows(job, rows) != 0 ||
+	    applier_job_register_keys(job) != 0 ||
+	    (f = fiber_new(name, applier_job_f)) == NULL) {
+		applier_job_unregister_keys(job);
+		latch_unlock(latch);
+		goto fail;
+	}
+	struct session *session;
+	session = current_session();
+	fiber_set_session(f, session);
+	fiber_set_user(f, &session->credentials);
+	rlist_add_tail_entry(&replicaset.applier.apply_queue[replica_id],
+			     job, in_queue);
+	applier->apply_job_count++;
+	latch_unlock(latch);
+	fiber_start(f, job);
+	return 0;
+barrier:
+	applier_job_delete(job);
+	return 1;
+fail:
+	applier_job_delete(job);
+	return -1;
+}
+
 /**
  * Apply all rows in the rows queue as a single transaction.
  *
@@ -916,6 +1634,17 @@ applier_apply_tx(struct applier *applier, struct stailq *rows)
 	 */
 	if (!raft_is_source_allowed(box_raft(), applier->instance_id))
 		return 0;
+	if (replication_apply_fibers > 1) {
+		int rc = applier_dispatch_tx(applier, rows);
+		if (rc <= 0)
+			return rc;
+	}
+	/*
+	 * Transactions dispatched to apply fibers must be
+	 * applied before a transaction applied in place.
+	 */
+	if (applier_wait_jobs(applier) != 0)
+		return -1;
 	struct xrow_header *first_row = &stailq_first_entry(rows,
 					struct applier_tx_row, next)->row;
 	struct xrow_header *last_row;
@@ -930,6 +1659,18 @@ applier_apply_tx(struct applier *applier, struct stailq *rows)
 	struct latch *latch = (replica ? &replica->order_latch :
 			       &replicaset.applier.order_latch);
 	latch_lock(latch);
+	/*
+	 * Wait for transactions from the same instance dispatched
+	 * to apply fibers by other appliers.
+	 */
+	struct rlist *queue;
+	queue = &replicaset.applier.apply_queue[first_row->replica_id];
+	while (!rlist_empty(queue)) {
+		if (fiber_cond_wait(&replicaset.applier.apply_cond) != 0) {
+			latch_unlock(latch);
+			return -1;
+		}
+	}
 	if (vclock_get(&replicaset.applier.vclock,
 		       last_row->replica_id) >= last_row->lsn) {
 		latch_unlock(latch);
@@ -963,84 +1704,14 @@ applier_apply_tx(struct applier *applier, struct stailq *rows)
 		 */
 		assert(first_row == last_row);
 		if (apply_synchro_row(first_row) != 0)
-			diag_raise();
+			goto fail;
 		goto success;
 	}
 
-	/**
-	 * Explicitly begin the transaction so that we can
-	 * control fiber->gc life cycle and, in case of apply
-	 * conflict safely access failed xrow object and allocate
-	 * IPROTO_NOP on gc.
-	 */
 	struct txn *txn;
-	txn = txn_begin();
-	struct applier_tx_row *item;
-	if (txn == NULL) {
-		latch_unlock(latch);
-		return -1;
-	}
-	stailq_foreach_entry(item, rows, next) {
-		struct xrow_header *row = &item->row;
-		int res = apply_row(row);
-		if (res != 0) {
-			struct error *e = diag_last_error(diag_get());
-			/*
-			 * In case of ER_TUPLE_FOUND error and enabled
-			 * replication_skip_conflict configuration
-			 * option, skip applying the foreign row and
-			 * replace it with NOP in the local write ahead
-			 * log.
-			 */
-			if (e->type == &type_ClientError &&
-			    box_error_code(e) == ER_TUPLE_FOUND &&
-			    replication_skip_conflict) {
-				diag_clear(diag_get());
-				row->type = IPROTO_NOP;
-				row->bodycnt = 0;
-				res = apply_row(row);
-			}
-		}
-		if (res != 0)
-			goto rollback;
-	}
-	/*
-	 * We are going to commit so it's a high time to check if
-	 * the current transaction has non-local effects.
-	 */
-	if (txn_is_distributed(txn)) {
-		/*
-		 * A transaction mixes remote and local rows.
-		 * Local rows must be replicated back, which
-		 * doesn't make sense since the master likely has
-		 * new changes which local rows may overwrite.
-		 * Raise an error.
-		 */
-		diag_set(ClientError, ER_UNSUPPORTED,
-			 "Replication", "distributed transactions");
-		goto rollback;
-	}
-
-	/* We are ready to submit txn to wal. */
-	struct trigger *on_rollback, *on_wal_write;
-	size_t size;
-	on_rollback = region_alloc_object(&txn->region, typeof(*on_rollback),
-					  &size);
-	on_wal_write = region_alloc_object(&txn->region, typeof(*on_wal_write),
-					   &size);
-	if (on_rollback == NULL || on_wal_write == NULL) {
-		diag_set(OutOfMemory, size, "region_alloc_object",
-			 "on_rollback/on_wal_write");
-		goto rollback;
-	}
-
-	trigger_create(on_rollback, applier_txn_rollback_cb, NULL, NULL);
-	txn_on_rollback(txn, on_rollback);
-
-	trigger_create(on_wal_write, applier_txn_wal_write_cb, NULL, NULL);
-	txn_on_wal_write(txn, on_wal_write);
-
-	if (txn_commit_async(txn) < 0)
+	txn = applier_txn_apply(rows);
+	if (txn == NULL ||
+	    applier_txn_commit(applier, txn, last_row->tm) != 0)
 		goto fail;
 
 success:
@@ -1055,8 +1726,6 @@ success:
 		      last_row->lsn);
 	latch_unlock(latch);
 	return 0;
-rollback:
-	txn_rollback(txn);
 fail:
 	latch_unlock(latch);
 	fiber_gc();
@@ -1099,11 +1768,157 @@ applier_on_rollback(struct trigger *trigger, void *event)
 		diag_set_error(&applier->diag,
 			       diag_last_error(&replicaset.applier.diag));
 	}
-	/* Stop the applier fiber. */
-	fiber_cancel(applier->reader);
+	/* Stop the applier fibers. */
+	applier_cancel(applier);
 	return 0;
 }
 
+/**
+ * Apply transactions read from the network by the applier fiber
+ * in the order they were received. Runs in a separate fiber so
+ * that the applier fiber can keep reading while the previous
+ * transactions are being applied and written to WAL.
+ */
+static int
+applier_processor_f(va_list ap)
+{
+	struct applier *applier = va_arg(ap, struct applier *);
+	while (!fiber_is_cancelled()) {
+		if (stailq_empty(&applier->tx_queue)) {
+			fiber_cond_wait(&applier->tx_cond);
+			continue;
+		}
+		struct applier_job *job = stailq_first_entry(
+				&applier->tx_queue, struct applier_job,
+				in_tx_queue);
+		struct xrow_header *first_row = &stailq_first_entry(
+				&job->rows, struct applier_tx_row, next)->row;
+		int rc;
+		if (first_row->lsn == 0) {
+			assert(iproto_type_is_raft_request(first_row->type));
+			rc = applier_handle_raft(applier, first_row);
+			applier_signal_ack(applier);
+		} else {
+			rc = applier_apply_tx(applier, &job->rows);
+		}
+		stailq_shift(&applier->tx_queue);
+		applier->tx_queue_size--;
+		applier_job_delete(job);
+		fiber_cond_broadcast(&applier->tx_cond);
+		fiber_gc();
+		if (rc != 0) {
+			/*
+			 * If the fiber was cancelled, the applier
+			 * fiber is already stopping, see
+			 * applier_cancel(). Otherwise let it raise
+			 * the error, see applier_check_processor().
+			 */
+			if (fiber_is_cancelled())
+				break;
+			fiber_cancel(applier->reader);
+			return -1;
+		}
+	}
+	return 0;
+}
+
+/**
+ * Raise the error the processor fiber failed with, if any.
+ */
+static void
+applier_check_processor(struct applier *applier)
+{
+	struct fiber *processor = applier->processor;
+	if (processor == NULL || !fiber_is_dead(processor))
+		return;
+	applier->processor = NULL;
+	if (fiber_join(processor) != 0)
+		diag_raise();
+}
+
+/**
+ * Queue a transaction read from the network for the processor
+ * fiber. Waits if the applier window is full.
+ */
+static void
+applier_queue_tx(struct applier *applier, struct stailq *rows)
+{
+	while (applier->tx_queue_size + applier->wal_queue_size >=
+	       APPLIER_TX_WINDOW) {
+		if (fiber_cond_wait(&applier->tx_cond) != 0)
+			diag_raise();
+	}
+	struct applier_job *job = applier_job_new(applier);
+	if (job == NULL)
+		diag_raise();
+	if (applier_job_copy_rows(job, rows) != 0) {
+		applier_job_delete(job);
+		diag_raise();
+	}
+	stailq_add_tail_entry(&applier->tx_queue, job, in_tx_queue);
+	applier->tx_queue_size++;
+	fiber_cond_broadcast(&applier->tx_cond);
+}
+
+/**
+ * Read a stream of rows from the binary log and queue them for
+ * the processor fiber, see applier_processor_f().
+ */
+static void
+applier_read_stream(struct applier *applier)
+{
+	struct ibuf *ibuf = &applier->ibuf;
+	while (true) {
+		if (applier->state == APPLIER_FINAL_JOIN &&
+		    instance_id != REPLICA_ID_NIL) {
+			say_info("final data received");
+			applier_set_state(applier, APPLIER_JOINED);
+			applier_set_state(applier, APPLIER_READY);
+			applier_set_state(applier, APPLIER_FOLLOW);
+		}
+
+		struct stailq rows;
+		applier_read_tx(applier, &rows);
+
+		applier->last_row_time = ev_monotonic_now(loop());
+		/*
+		 * In case of an heartbeat message wake a writer up
+		 * and check applier state.
+		 */
+		struct xrow_header *first_row =
+			&stailq_first_entry(&rows, struct applier_tx_row,
+					    next)->row;
+		raft_process_heartbeat(box_raft(), applier->instance_id);
+		if (first_row->lsn != 0 ||
+		    unlikely(iproto_type_is_raft_request(first_row->type)))
+			applier_queue_tx(applier, &rows);
+		else
+			applier_signal_ack(applier);
+
+		if (ibuf_used(ibuf) == 0)
+			ibuf_reset(ibuf);
+		fiber_gc();
+	}
+}
+
+/**
+ * Switch to reading a compressed replication stream. Data read
+ * ahead after the SUBSCRIBE response is already compressed.
+ */
+static void
+applier_enable_compression(struct applier *applier)
+{
+	struct xrow_decompressor *d = &applier->decompressor;
+	if (xrow_decompressor_create(d) != 0)
+		diag_raise();
+	applier->compression = true;
+	struct ibuf *ibuf = &applier->ibuf;
+	size_t size = ibuf_used(ibuf);
+	memcpy(ibuf_reserve_xc(&d->buf, size), ibuf->rpos, size);
+	d->buf.wpos += size;
+	ibuf_reset(ibuf);
+}
+
 /**
  * Execute and process SUBSCRIBE request (follow updates from a master).
  */
@@ -1125,7 +1940,8 @@ applier_subscribe(struct applier *applier)
 	 */
 	uint32_t id_filter = box_is_orphan() ? 0 : 1 << instance_id;
 	xrow_encode_subscribe_xc(&row, &REPLICASET_UUID, &INSTANCE_UUID,
-				 &vclock, replication_anon, id_filter);
+				 &vclock, replication_anon, id_filter,
+				 replication_compression);
 	coio_write_xrow(coio, &row);
 
 	/* Read SUBSCRIBE response */
@@ -1146,8 +1962,10 @@ applier_subscribe(struct applier *applier)
 		 * its and master's cluster ids match.
 		 */
 		vclock_create(&applier->remote_vclock_at_subscribe);
+		bool compression;
 		xrow_decode_subscribe_response_xc(&row, &cluster_id,
-					&applier->remote_vclock_at_subscribe);
+					&applier->remote_vclock_at_subscribe,
+					&compression);
 		applier->instance_id = row.replica_id;
 		/*
 		 * If master didn't send us its cluster id
@@ -1160,6 +1978,12 @@ applier_subscribe(struct applier *applier)
 				  tt_uuid_str(&cluster_id),
 				  tt_uuid_str(&REPLICASET_UUID));
 		}
+		/*
+		 * A master that doesn't support compression
+		 * ignores the request and doesn't confirm it.
+		 */
+		if (compression)
+			applier_enable_compression(applier);
 
 		say_info("subscribed");
 		say_info("remote vclock %s local vclock %s",
@@ -1210,6 +2034,17 @@ applier_subscribe(struct applier *applier)
 		fiber_start(applier->writer, applier);
 	}
 
+	assert(applier->processor == NULL);
+	char name[FIBER_NAME_MAX];
+	int pos = snprintf(name, sizeof(name), "applierp/");
+	uri_format(name + pos, sizeof(name) - pos, &applier->uri, false);
+	applier->processor = fiber_new_xc(name, applier_processor_f);
+	struct session *session = current_session();
+	fiber_set_session(applier->processor, session);
+	fiber_set_user(applier->processor, &session->credentials);
+	fiber_set_joinable(applier->processor, true);
+	fiber_start(applier->processor, applier);
+
 	applier->lag = TIMEOUT_INFINITY;
 
 	/*
@@ -1235,48 +2070,40 @@ applier_subscribe(struct applier *applier)
 	/*
 	 * Process a stream of rows from the binary log.
 	 */
-	while (true) {
-		if (applier->state == APPLIER_FINAL_JOIN &&
-		    instance_id != REPLICA_ID_NIL) {
-			say_info("final data received");
-			applier_set_state(applier, APPLIER_JOINED);
-			applier_set_state(applier, APPLIER_READY);
-			applier_set_state(applier, APPLIER_FOLLOW);
-		}
-
-		struct stailq rows;
-		applier_read_tx(applier, &rows);
-
-		applier->last_row_time = ev_monotonic_now(loop());
+	try {
+		applier_read_stream(applier);
+	} catch (FiberIsCancelled *) {
 		/*
-		 * In case of an heartbeat message wake a writer up
-		 * and check applier state.
+		 * The applier fiber is cancelled by the processor
+		 * fiber if the latter fails to apply a transaction.
 		 */
-		struct xrow_header *first_row =
-			&stailq_first_entry(&rows, struct applier_tx_row,
-					    next)->row;
-		raft_process_heartbeat(box_raft(), applier->instance_id);
-		if (first_row->lsn == 0) {
-			if (unlikely(iproto_type_is_raft_request(
-							first_row->type))) {
-				if (applier_handle_raft(applier,
-							first_row) != 0)
-					diag_raise();
-			}
-			applier_signal_ack(applier);
-		} else if (applier_apply_tx(applier, &rows) != 0) {
-			diag_raise();
-		}
-
-		if (ibuf_used(ibuf) == 0)
-			ibuf_reset(ibuf);
-		fiber_gc();
+		applier_check_processor(applier);
+		throw;
 	}
 }
 
 static inline void
 applier_disconnect(struct applier *applier, enum applier_state state)
 {
+	if (applier->processor != NULL) {
+		fiber_cancel(applier->processor);
+		fiber_join(applier->processor);
+		applier->processor = NULL;
+	}
+	/* Drop transactions that weren't applied. */
+	struct applier_job *job, *tmp;
+	stailq_foreach_entry_safe(job, tmp, &applier->tx_queue, in_tx_queue)
+		applier_job_delete(job);
+	stailq_create(&applier->tx_queue);
+	applier->tx_queue_size = 0;
+
+	/* Wait for transactions dispatched to apply fibers. */
+	bool cancellable = fiber_set_cancellable(false);
+	while (applier->apply_job_count > 0)
+		fiber_cond_wait(&applier->apply_cond);
+	fiber_set_cancellable(cancellable);
+	applier_clear_wal_queue(applier);
+
 	applier_set_state(applier, state);
 	if (applier->writer != NULL) {
 		fiber_cancel(applier->writer);
@@ -1287,6 +2114,10 @@ applier_disconnect(struct applier *applier, enum applier_state state)
 	coio_close_io(loop(), &applier->io);
 	/* Clear all unparsed input. */
 	ibuf_reinit(&applier->ibuf);
+	if (applier->compression) {
+		xrow_decompressor_destroy(&applier->decompressor);
+		applier->compression = false;
+	}
 	fiber_gc();
 }
 
@@ -1494,6 +2325,12 @@ applier_new(const char *uri)
 			 "struct applier");
 		return NULL;
 	}
+	applier->apply_keys = mh_i64ptr_new();
+	if (applier->apply_keys == NULL) {
+		diag_set(OutOfMemory, 0, "mh_i64ptr_new", "mh_i64ptr_t");
+		free(applier);
+		return NULL;
+	}
 	coio_create(&applier->io, -1);
 	ibuf_create(&applier->ibuf, &cord()->slabc, 1024);
 
@@ -1508,6 +2345,10 @@ applier_new(const char *uri)
 	rlist_create(&applier->on_state);
 	fiber_cond_create(&applier->resume_cond);
 	fiber_cond_create(&applier->writer_cond);
+	fiber_cond_create(&applier->apply_cond);
+	stailq_create(&applier->tx_queue);
+	rlist_create(&applier->wal_queue);
+	fiber_cond_create(&applier->tx_cond);
 	diag_create(&applier->diag);
 
 	return applier;
@@ -1517,6 +2358,11 @@ void
 applier_delete(struct applier *applier)
 {
 	assert(applier->reader == NULL && applier->writer == NULL);
+	assert(applier->processor == NULL);
+	assert(applier->apply_job_count == 0);
+	assert(stailq_empty(&applier->tx_queue));
+	assert(rlist_empty(&applier->wal_queue));
+	mh_i64ptr_delete(applier->apply_keys);
 	ibuf_destroy(&applier->ibuf);
 	assert(applier->io.fd == -1);
 	trigger_destroy(&applier->on_state);
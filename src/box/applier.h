@@ -38,12 +38,16 @@
 #include <small/ibuf.h>
 
 #include "fiber_cond.h"
+#include "salad/stailq.h"
 #include "trigger.h"
 #include "trivia/util.h"
 #include "uuid/tt_uuid.h"
 #include "uri/uri.h"
 
 #include "xrow.h"
+#include "xrow_io.h"
+
+struct mh_i64ptr_t;
 
 enum { APPLIER_SOURCE_MAXLEN = 1024 }; /* enough to fit URI with passwords */
 
@@ -78,6 +82,8 @@ struct applier {
 	struct fiber *reader;
 	/** Background fiber to reply with vclock */
 	struct fiber *writer;
+	/** Background fiber to apply transactions read by reader */
+	struct fiber *processor;
 	/** Writer cond. */
 	struct fiber_cond writer_cond;
 	/**
@@ -93,6 +99,12 @@ struct applier {
 	ev_tstamp last_row_time;
 	/** Number of seconds this replica is behind the remote master */
 	ev_tstamp lag;
+	/**
+	 * Number of seconds passed between the last transaction
+	 * written to WAL was created on the remote master and
+	 * written to WAL locally.
+	 */
+	ev_tstamp apply_lag;
 	/** The last box_error_code() logged to avoid log flooding */
 	uint32_t last_logged_errcode;
 	/** Remote instance ID. */
@@ -118,6 +130,10 @@ struct applier {
 	struct ev_io io;
 	/** Input buffer */
 	struct ibuf ibuf;
+	/** Set if the replication stream is compressed. */
+	bool compression;
+	/** Decompressor of the replication stream. */
+	struct xrow_decompressor decompressor;
 	/** Triggers invoked on state change */
 	struct rlist on_state;
 	/**
@@ -131,6 +147,36 @@ struct applier {
 	struct diag diag;
 	/* Master's vclock at the time of SUBSCRIBE. */
 	struct vclock remote_vclock_at_subscribe;
+	/**
+	 * Transactions read from the network and waiting to be
+	 * applied by the processor fiber, linked by
+	 * applier_job::in_tx_queue.
+	 */
+	struct stailq tx_queue;
+	/** Number of transactions in tx_queue. */
+	int tx_queue_size;
+	/**
+	 * Transactions submitted to the journal and not yet
+	 * written to WAL, linked by applier_txn::in_wal_queue.
+	 */
+	struct rlist wal_queue;
+	/** Number of transactions in wal_queue. */
+	int wal_queue_size;
+	/**
+	 * Signaled whenever a transaction is added to tx_queue
+	 * or leaves the applier window, see APPLIER_TX_WINDOW.
+	 */
+	struct fiber_cond tx_cond;
+	/** Number of transactions being applied by apply fibers. */
+	int apply_job_count;
+	/** Signaled whenever an apply fiber completes. */
+	struct fiber_cond apply_cond;
+	/**
+	 * Keys modified by transactions being applied by apply
+	 * fibers, mapped to the transactions. Used to detect
+	 * conflicts between incoming transactions.
+	 */
+	struct mh_i64ptr_t *apply_keys;
 };
 
 /**
@@ -680,6 +680,18 @@ box_check_replication_synchro_timeout(void)
 	return timeout;
 }
 
+static double
+box_check_replication_synchro_ack_window(void)
+{
+	double window = cfg_getd("replication_synchro_ack_window");
+	if (window < 0) {
+		diag_set(ClientError, ER_CFG, "replication_synchro_ack_window",
+			 "the value must not be negative");
+		return -1;
+	}
+	return window;
+}
+
 static double
 box_check_replication_sync_timeout(void)
 {
@@ -691,6 +703,17 @@ box_check_replication_sync_timeout(void)
 	return timeout;
 }
 
+static int
+box_check_replication_apply_fibers(void)
+{
+	int count = cfg_geti("replication_apply_fibers");
+	if (count <= 0) {
+		tnt_raise(ClientError, ER_CFG, "replication_apply_fibers",
+			  "the value must be greater than 0");
+	}
+	return count;
+}
+
 static inline void
 box_check_uuid(struct tt_uuid *uuid, const char *name)
 {
@@ -765,6 +788,30 @@ box_check_readahead(int readahead)
 	}
 }
 
+static int
+box_check_memtx_recovery_threads(void)
+{
+	int threads = cfg_geti("memtx_recovery_threads");
+	if (threads < 1) {
+		tnt_raise(ClientError, ER_CFG, "memtx_recovery_threads",
+			  "must be greater than or equal to 1");
+	}
+	return threads;
+}
+
+static int
+box_check_iproto_threads(void)
+{
+	int threads = cfg_geti("iproto_threads");
+	if (threads < 1 || threads > IPROTO_THREADS_MAX) {
+		tnt_raise(ClientError, ER_CFG, "iproto_threads",
+			  tt_sprintf("must be greater than or equal to 1 "
+				     "and less than or equal to %d",
+				     IPROTO_THREADS_MAX));
+	}
+	return threads;
+}
+
 static void
 box_check_checkpoint_count(int checkpoint_count)
 {
@@ -785,6 +832,28 @@ box_check_wal_max_size(int64_t wal_max_size)
 	return wal_max_size;
 }
 
+static double
+box_check_wal_group_commit_timeout(void)
+{
+	double timeout = cfg_getd("wal_group_commit_timeout");
+	if (timeout < 0) {
+		tnt_raise(ClientError, ER_CFG, "wal_group_commit_timeout",
+			  "the value must not be negative");
+	}
+	return timeout;
+}
+
+static int64_t
+box_check_wal_group_commit_size(void)
+{
+	int64_t size = cfg_geti64("wal_group_commit_size");
+	if (size <= 0) {
+		tnt_raise(ClientError, ER_CFG, "wal_group_commit_size",
+			  "the value must be greater than zero");
+	}
+	return size;
+}
+
 static ssize_t
 box_check_memory_quota(const char *quota_name)
 {
@@ -894,14 +963,21 @@ box_check_config(void)
 		diag_raise();
 	if (box_check_replication_synchro_timeout() < 0)
 		diag_raise();
+	if (box_check_replication_synchro_ack_window() < 0)
+		diag_raise();
 	box_check_replication_sync_timeout();
+	box_check_replication_apply_fibers();
 	box_check_readahead(cfg_geti("readahead"));
+	box_check_iproto_threads();
 	box_check_checkpoint_count(cfg_geti("checkpoint_count"));
 	box_check_wal_max_size(cfg_geti64("wal_max_size"));
 	box_check_wal_mode(cfg_gets("wal_mode"));
+	box_check_wal_group_commit_timeout();
+	box_check_wal_group_commit_size();
 	if (box_check_memory_quota("memtx_memory") < 0)
 		diag_raise();
 	box_check_memtx_min_tuple_size(cfg_geti64("memtx_min_tuple_size"));
+	box_check_memtx_recovery_threads();
 	box_check_small_alloc_options();
 	box_check_vinyl_options();
 	if (box_check_sql_cache_size(cfg_geti("sql_cache_size")) != 0)
@@ -1091,6 +1167,16 @@ box_set_replication_synchro_timeout(void)
 	return 0;
 }
 
+int
+box_set_replication_synchro_ack_window(void)
+{
+	double value = box_check_replication_synchro_ack_window();
+	if (value < 0)
+		return -1;
+	replication_synchro_ack_window = value;
+	return 0;
+}
+
 void
 box_set_replication_sync_timeout(void)
 {
@@ -1103,6 +1189,24 @@ box_set_replication_skip_conflict(void)
 	replication_skip_conflict = cfg_geti("replication_skip_conflict");
 }
 
+void
+box_set_replication_apply_fibers(void)
+{
+	replication_apply_fibers = box_check_replication_apply_fibers();
+}
+
+void
+box_set_replication_compression(void)
+{
+	replication_compression = cfg_geti("replication_compression");
+}
+
+void
+box_set_replication_relay_fanout(void)
+{
+	replication_relay_fanout = cfg_geti("replication_relay_fanout");
+}
+
 void
 box_set_replication_anon(void)
 {
@@ -1436,6 +1540,14 @@ box_set_checkpoint_wal_threshold(void)
 	wal_set_checkpoint_threshold(threshold);
 }
 
+void
+box_set_wal_group_commit(void)
+{
+	double timeout = box_check_wal_group_commit_timeout();
+	int64_t size = box_check_wal_group_commit_size();
+	wal_set_group_commit(timeout, size);
+}
+
 void
 box_set_vinyl_memory(void)
 {
@@ -1472,13 +1584,45 @@ box_set_vinyl_timeout(void)
 	vinyl_engine_set_timeout(vinyl,	cfg_getd("vinyl_timeout"));
 }
 
+void
+box_set_vinyl_parallel_lookup(void)
+{
+	struct engine *vinyl = engine_by_name("vinyl");
+	assert(vinyl != NULL);
+	vinyl_engine_set_parallel_lookup(vinyl,
+					 cfg_getb("vinyl_parallel_lookup"));
+}
+
+void
+box_set_vinyl_compaction_parts(void)
+{
+	int parts = cfg_geti("vinyl_compaction_parts");
+	if (parts < 1) {
+		tnt_raise(ClientError, ER_CFG, "vinyl_compaction_parts",
+			  "must be greater than or equal to 1");
+	}
+	struct engine *vinyl = engine_by_name("vinyl");
+	assert(vinyl != NULL);
+	vinyl_engine_set_compaction_parts(vinyl, parts);
+}
+
+void
+box_set_vinyl_page_cache(void)
+{
+	struct engine *vinyl = engine_by_name("vinyl");
+	assert(vinyl != NULL);
+	vinyl_engine_set_page_cache(vinyl, cfg_geti64("vinyl_page_cache"),
+				    cfg_getb("vinyl_page_cache_compressed"));
+}
+
 void
 box_set_net_msg_max(void)
 {
 	int new_iproto_msg_max = cfg_geti("net_msg_max");
 	iproto_set_msg_max(new_iproto_msg_max);
+	/* The message limit is applied to each thread separately. */
 	fiber_pool_set_max_size(&tx_fiber_pool,
-				new_iproto_msg_max *
+				new_iproto_msg_max * iproto_threads_count *
 				IPROTO_FIBER_POOL_SIZE_FACTOR);
 }
 
@@ -1677,6 +1821,16 @@ box_select(uint32_t space_id, uint32_t index_id,
 	   int iterator, uint32_t offset, uint32_t limit,
 	   const char *key, const char *key_end,
 	   struct port *port)
+{
+	return box_select_ex(space_id, index_id, iterator, offset, limit,
+			     key, key_end, false, port);
+}
+
+int
+box_select_ex(uint32_t space_id, uint32_t index_id,
+	      int iterator, uint32_t offset, uint32_t limit,
+	      const char *key, const char *key_end, bool no_cache,
+	      struct port *port)
 {
 	(void)key_end;
 
@@ -1719,6 +1873,7 @@ box_select(uint32_t space_id, uint32_t index_id,
 		txn_rollback_stmt(txn);
 		return -1;
 	}
+	it->no_cache = no_cache;
 
 	int rc = 0;
 	uint32_t found = 0;
@@ -1748,6 +1903,66 @@ box_select(uint32_t space_id, uint32_t index_id,
 	return 0;
 }
 
+int
+box_get_many(uint32_t space_id, uint32_t index_id,
+	     const char *keys, const char *keys_end,
+	     struct port *port)
+{
+	rmean_collect(rmean_box, IPROTO_SELECT, 1);
+
+	struct space *space = space_cache_find(space_id);
+	if (space == NULL)
+		return -1;
+	if (access_check_space(space, PRIV_R) != 0)
+		return -1;
+	struct index *index = index_find(space, index_id);
+	if (index == NULL)
+		return -1;
+	if (!index->def->opts.is_unique) {
+		diag_set(ClientError, ER_MORE_THAN_ONE_TUPLE);
+		return -1;
+	}
+	if (keys == NULL || keys >= keys_end ||
+	    mp_typeof(*keys) != MP_ARRAY) {
+		diag_set(ClientError, ER_ILLEGAL_PARAMS,
+			 "keys must be an array");
+		return -1;
+	}
+	const char *end = keys;
+	if (mp_check(&end, keys_end) != 0 || end != keys_end) {
+		diag_set(ClientError, ER_INVALID_MSGPACK, "keys");
+		return -1;
+	}
+	uint32_t key_count = mp_decode_array(&keys);
+	const char *key = keys;
+	for (uint32_t i = 0; i < key_count; i++) {
+		if (mp_typeof(*key) != MP_ARRAY) {
+			diag_set(ClientError, ER_ILLEGAL_PARAMS,
+				 "key must be an array");
+			return -1;
+		}
+		uint32_t part_count = mp_decode_array(&key);
+		if (exact_key_validate(index->def->key_def, key,
+				       part_count) != 0)
+			return -1;
+		for (uint32_t j = 0; j < part_count; j++)
+			mp_next(&key);
+	}
+
+	struct txn *txn;
+	struct txn_ro_savepoint svp;
+	if (txn_begin_ro_stmt(space, &txn, &svp) != 0)
+		return -1;
+	port_c_create(port);
+	if (index_get_many(index, keys, key_count, port) != 0) {
+		port_destroy(port);
+		txn_rollback_stmt(txn);
+		return -1;
+	}
+	txn_commit_ro_stmt(txn, &svp);
+	return 0;
+}
+
 API_EXPORT int
 box_insert(uint32_t space_id, const char *tuple, const char *tuple_end,
 	   box_tuple_t **result)
@@ -2359,8 +2574,10 @@ box_process_subscribe(struct ev_io *io, struct xrow_header *header)
 	vclock_create(&replica_clock);
 	bool anon;
 	uint32_t id_filter;
+	bool compression;
 	xrow_decode_subscribe_xc(header, NULL, &replica_uuid, &replica_clock,
-				 &replica_version_id, &anon, &id_filter);
+				 &replica_version_id, &anon, &id_filter,
+				 &compression);
 
 	/* Forbid connection to itself */
 	if (tt_uuid_is_equal(&replica_uuid, &INSTANCE_UUID))
@@ -2428,9 +2645,14 @@ box_process_subscribe(struct ev_io *io, struct xrow_header *header)
 	 * id to replica, and replica checks that its cluster id
 	 * matches master's one. Older versions will just ignore
 	 * the additional field.
+	 *
+	 * If the replica asked to compress the replication
+	 * stream, confirm it in the response. Everything sent
+	 * after the response is compressed then.
 	 */
 	struct xrow_header row;
-	xrow_encode_subscribe_response_xc(&row, &REPLICASET_UUID, &vclock);
+	xrow_encode_subscribe_response_xc(&row, &REPLICASET_UUID, &vclock,
+					  compression);
 	/*
 	 * Identify the message with the replica id of this
 	 * instance, this is the only way for a replica to find
@@ -2457,7 +2679,10 @@ box_process_subscribe(struct ev_io *io, struct xrow_header *header)
 		struct raft_request req;
 		box_raft_checkpoint_remote(&req);
 		xrow_encode_raft(&row, &fiber()->gc, &req);
-		coio_write_xrow(io, &row);
+		if (compression)
+			coio_write_xrow_zstd_frame(io, &row);
+		else
+			coio_write_xrow(io, &row);
 	}
 	/*
 	 * Replica clock is used in gc state and recovery
@@ -2488,8 +2713,21 @@ box_process_subscribe(struct ev_io *io, struct xrow_header *header)
 	 * a stall in updates (in this case replica may hang
 	 * indefinitely).
 	 */
-	relay_subscribe(replica, io->fd, header->sync, &replica_clock,
-			replica_version_id, id_filter);
+	try {
+		relay_subscribe(replica, io->fd, header->sync, &replica_clock,
+				replica_version_id, id_filter, compression);
+	} catch (SocketError *e) {
+		throw;
+	} catch (Exception *e) {
+		if (!compression)
+			throw;
+		/*
+		 * The relay failed before it started the stream,
+		 * but the replica expects it compressed.
+		 */
+		xrow_encode_error_xc(&row, e, header->sync);
+		coio_write_xrow_zstd_frame(io, &row);
+	}
 }
 
 void
@@ -2570,6 +2808,8 @@ engine_init()
 				    cfg_getd("slab_alloc_factor"));
 	engine_register((struct engine *)memtx);
 	box_set_memtx_max_tuple_size();
+	memtx_engine_set_recovery_threads(memtx,
+					  box_check_memtx_recovery_threads());
 
 	struct sysview_engine *sysview = sysview_engine_new_xc();
 	engine_register((struct engine *)sysview);
@@ -2590,6 +2830,9 @@ engine_init()
 	box_set_vinyl_max_tuple_size();
 	box_set_vinyl_cache();
 	box_set_vinyl_timeout();
+	box_set_vinyl_parallel_lookup();
+	box_set_vinyl_compaction_parts();
+	box_set_vinyl_page_cache();
 }
 
 /**
@@ -2976,7 +3219,7 @@ box_cfg_xc(void)
 	schema_init();
 	replication_init();
 	port_init();
-	iproto_init();
+	iproto_init(box_check_iproto_threads());
 	sql_init();
 
 	int64_t wal_max_size = box_check_wal_max_size(cfg_geti64("wal_max_size"));
@@ -3006,8 +3249,13 @@ box_cfg_xc(void)
 		diag_raise();
 	if (box_set_replication_synchro_timeout() != 0)
 		diag_raise();
+	if (box_set_replication_synchro_ack_window() != 0)
+		diag_raise();
 	box_set_replication_sync_timeout();
 	box_set_replication_skip_conflict();
+	box_set_replication_apply_fibers();
+	box_set_replication_compression();
+	box_set_replication_relay_fanout();
 	box_set_replication_anon();
 
 	struct gc_checkpoint *checkpoint = gc_last_checkpoint();
@@ -3214,5 +3462,7 @@ box_reset_stat(void)
 	rmean_cleanup(rmean_box);
 	rmean_cleanup(rmean_error);
 	engine_reset_stat();
+	wal_reset_stat();
+	txn_limbo_reset_stat(&txn_limbo);
 	space_foreach(box_reset_space_stat, NULL);
 }
@@ -239,12 +239,16 @@ void box_set_readahead(void);
 void box_set_checkpoint_count(void);
 void box_set_checkpoint_interval(void);
 void box_set_checkpoint_wal_threshold(void);
+void box_set_wal_group_commit(void);
 void box_set_memtx_memory(void);
 void box_set_memtx_max_tuple_size(void);
 void box_set_vinyl_memory(void);
 void box_set_vinyl_max_tuple_size(void);
 void box_set_vinyl_cache(void);
 void box_set_vinyl_timeout(void);
+void box_set_vinyl_parallel_lookup(void);
+void box_set_vinyl_compaction_parts(void);
+void box_set_vinyl_page_cache(void);
 int box_set_election_mode(void);
 int box_set_election_timeout(void);
 void box_set_replication_timeout(void);
@@ -254,8 +258,12 @@ void box_set_replication_sync_lag(void);
 void box_update_replication_synchro_quorum(void);
 int box_set_replication_synchro_quorum(void);
 int box_set_replication_synchro_timeout(void);
+int box_set_replication_synchro_ack_window(void);
 void box_set_replication_sync_timeout(void);
 void box_set_replication_skip_conflict(void);
+void box_set_replication_apply_fibers(void);
+void box_set_replication_compression(void);
+void box_set_replication_relay_fanout(void);
 void box_set_replication_anon(void);
 void box_set_net_msg_max(void);
 int box_set_crash(void);
@@ -278,6 +286,35 @@ box_select(uint32_t space_id, uint32_t index_id,
 	   const char *key, const char *key_end,
 	   struct port *port);
 
+/**
+ * Same as box_select(), but if @no_cache is set, hint the engine
+ * that the selected tuples shouldn't be cached, see
+ * iterator::no_cache.
+ */
+int
+box_select_ex(uint32_t space_id, uint32_t index_id,
+	      int iterator, uint32_t offset, uint32_t limit,
+	      const char *key, const char *key_end, bool no_cache,
+	      struct port *port);
+
+/**
+ * Look up several keys in a unique index at once.
+ *
+ * \param space_id space identifier
+ * \param index_id index identifier
+ * \param keys MsgPack array of full keys ([[part1, ...], ...])
+ * \param keys_end the end of encoded \a keys
+ * \param[out] port tuples found, in the order of the keys; keys
+ *             that aren't found are skipped
+ * \retval -1 on error (check box_error_last())
+ * \retval 0 on success
+ * \sa \code box.space[space_id].index[index_id]:get_many(keys) \endcode
+ */
+int
+box_get_many(uint32_t space_id, uint32_t index_id,
+	     const char *keys, const char *keys_end,
+	     struct port *port);
+
 /** \cond public */
 
 /*
@@ -38,6 +38,7 @@
 #include "txn.h"
 #include "rmean.h"
 #include "info/info.h"
+#include "port.h"
 
 /* {{{ Utilities. **********************************************/
 
@@ -449,6 +450,7 @@ iterator_create(struct iterator *it, struct index *index)
 	it->space_id = index->def->space_id;
 	it->index_id = index->def->iid;
 	it->index = index;
+	it->no_cache = false;
 }
 
 int
@@ -514,6 +516,15 @@ index_delete(struct index *index)
 
 int
 index_build(struct index *index, struct index *pk)
+{
+	if (index_build_keys(index, pk) != 0)
+		return -1;
+	index_end_build(index);
+	return 0;
+}
+
+int
+index_build_keys(struct index *index, struct index *pk)
 {
 	ssize_t n_tuples = index_size(pk);
 	if (n_tuples < 0)
@@ -547,11 +558,7 @@ index_build(struct index *index, struct index *pk)
 			break;
 	}
 	iterator_delete(it);
-	if (rc != 0)
-		return -1;
-
-	index_end_build(index);
-	return 0;
+	return rc;
 }
 
 struct tuple *
@@ -690,6 +697,23 @@ generic_index_get(struct index *index, const char *key,
 	return -1;
 }
 
+int
+generic_index_get_many(struct index *index, const char *keys,
+		       uint32_t key_count, struct port *port)
+{
+	for (uint32_t i = 0; i < key_count; i++) {
+		const char *key = keys;
+		uint32_t part_count = mp_decode_array(&key);
+		mp_next(&keys);
+		struct tuple *tuple;
+		if (index_get(index, key, part_count, &tuple) != 0)
+			return -1;
+		if (tuple != NULL && port_c_add_tuple(port, tuple) != 0)
+			return -1;
+	}
+	return 0;
+}
+
 int
 generic_index_replace(struct index *index, struct tuple *old_tuple,
 		      struct tuple *new_tuple, enum dup_replace_mode mode,
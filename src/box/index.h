@@ -45,6 +45,7 @@ struct index;
 struct index_def;
 struct key_def;
 struct info_handler;
+struct port;
 
 typedef struct tuple box_tuple_t;
 typedef struct key_def box_key_def_t;
@@ -257,6 +258,12 @@ struct iterator {
 	 * state has not changed since the last lookup.
 	 */
 	struct index *index;
+	/**
+	 * Hint to the engine that tuples returned by the iterator
+	 * are unlikely to be accessed again, e.g. because they are
+	 * read by a big scan, so they shouldn't be cached.
+	 */
+	bool no_cache;
 };
 
 /**
@@ -413,6 +420,14 @@ struct index_vtab {
 			 const char *key, uint32_t part_count);
 	int (*get)(struct index *index, const char *key,
 		   uint32_t part_count, struct tuple **result);
+	/**
+	 * Look up @a key_count full keys stored one after another
+	 * in @a keys (each key is a MsgPack array) and append found
+	 * tuples to @a port in the order of the keys. Keys that are
+	 * not found are skipped.
+	 */
+	int (*get_many)(struct index *index, const char *keys,
+			uint32_t key_count, struct port *port);
 	int (*replace)(struct index *index, struct tuple *old_tuple,
 		       struct tuple *new_tuple, enum dup_replace_mode mode,
 		       struct tuple **result);
@@ -534,6 +549,14 @@ index_unref(struct index *index)
 int
 index_build(struct index *index, struct index *pk);
 
+/**
+ * Begin building this index and feed it all tuples stored in
+ * another index. The build must be completed with
+ * index_end_build().
+ */
+int
+index_build_keys(struct index *index, struct index *pk);
+
 static inline void
 index_commit_create(struct index *index, int64_t signature)
 {
@@ -623,6 +646,13 @@ index_get(struct index *index, const char *key,
 	return index->vtab->get(index, key, part_count, result);
 }
 
+static inline int
+index_get_many(struct index *index, const char *keys,
+	       uint32_t key_count, struct port *port)
+{
+	return index->vtab->get_many(index, keys, key_count, port);
+}
+
 /**
  * Get tuple to be inserted in index, based on index-specific constraints
  * (current constraint: if exclude_null = true, return NULL)
@@ -729,6 +759,8 @@ int generic_index_random(struct index *, uint32_t, struct tuple **);
 ssize_t generic_index_count(struct index *, enum iterator_type,
 			    const char *, uint32_t);
 int generic_index_get(struct index *, const char *, uint32_t, struct tuple **);
+int generic_index_get_many(struct index *, const char *, uint32_t,
+			   struct port *);
 int generic_index_replace(struct index *, struct tuple *, struct tuple *,
 			  enum dup_replace_mode, struct tuple **);
 struct snapshot_iterator *generic_index_create_snapshot_iterator(struct index *);
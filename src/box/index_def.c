@@ -39,6 +39,12 @@ const char *index_type_strs[] = { "HASH", "TREE", "BITSET", "RTREE" };
 
 const char *rtree_index_distance_type_strs[] = { "EUCLID", "MANHATTAN" };
 
+const char *index_compaction_policy_strs[] = {
+	"hybrid", "tiered", "leveled"
+};
+
+const char *index_quota_class_strs[] = { "normal", "bulk" };
+
 const struct index_opts index_opts_default = {
 	/* .unique              = */ true,
 	/* .dimension           = */ 2,
@@ -48,6 +54,11 @@ const struct index_opts index_opts_default = {
 	/* .run_count_per_level = */ 2,
 	/* .run_size_ratio      = */ 3.5,
 	/* .bloom_fpr           = */ 0.05,
+	/* .compaction_policy   = */ INDEX_COMPACTION_POLICY_HYBRID,
+	/* .page_filter         = */ false,
+	/* .page_key_index      = */ false,
+	/* .compression_dict_size = */ 0,
+	/* .quota_class         = */ INDEX_QUOTA_CLASS_NORMAL,
 	/* .lsn                 = */ 0,
 	/* .stat                = */ NULL,
 	/* .func                = */ 0,
@@ -64,6 +75,14 @@ const struct opt_def index_opts_reg[] = {
 	OPT_DEF("run_count_per_level", OPT_INT64, struct index_opts, run_count_per_level),
 	OPT_DEF("run_size_ratio", OPT_FLOAT, struct index_opts, run_size_ratio),
 	OPT_DEF("bloom_fpr", OPT_FLOAT, struct index_opts, bloom_fpr),
+	OPT_DEF_ENUM("compaction_policy", index_compaction_policy,
+		     struct index_opts, compaction_policy, NULL),
+	OPT_DEF("page_filter", OPT_BOOL, struct index_opts, page_filter),
+	OPT_DEF("page_key_index", OPT_BOOL, struct index_opts, page_key_index),
+	OPT_DEF("compression_dict_size", OPT_INT64, struct index_opts,
+		compression_dict_size),
+	OPT_DEF_ENUM("quota_class", index_quota_class, struct index_opts,
+		     quota_class, NULL),
 	OPT_DEF("lsn", OPT_INT64, struct index_opts, lsn),
 	OPT_DEF("func", OPT_UINT32, struct index_opts, func_id),
 	OPT_DEF_LEGACY("sql"),
@@ -58,6 +58,46 @@ enum rtree_index_distance_type {
 };
 extern const char *rtree_index_distance_type_strs[];
 
+/** Policy used by Vinyl to decide when to compact a range. */
+enum index_compaction_policy {
+	/**
+	 * Tiered compaction at all levels but the last one,
+	 * which is always merged into a single run.
+	 */
+	INDEX_COMPACTION_POLICY_HYBRID,
+	/**
+	 * Tiered compaction at all levels: up to
+	 * run_count_per_level runs are allowed per level,
+	 * including the last one. Minimizes write amplification.
+	 */
+	INDEX_COMPACTION_POLICY_TIERED,
+	/**
+	 * Leveled compaction: at most one run is allowed per
+	 * level except the newest one. Minimizes read and space
+	 * amplification.
+	 */
+	INDEX_COMPACTION_POLICY_LEVELED,
+	index_compaction_policy_MAX
+};
+extern const char *index_compaction_policy_strs[];
+
+/**
+ * Class a space belongs to with respect to Vinyl memory quota.
+ * Consumers of lower priority classes are throttled first when
+ * memory is short.
+ */
+enum index_quota_class {
+	/** Latency sensitive writes. */
+	INDEX_QUOTA_CLASS_NORMAL,
+	/**
+	 * Bulk writes that may be delayed in favor of normal
+	 * ones, e.g. data loading.
+	 */
+	INDEX_QUOTA_CLASS_BULK,
+	index_quota_class_MAX
+};
+extern const char *index_quota_class_strs[];
+
 /** Simple alias to represent logarithm metrics. */
 typedef int16_t log_est_t;
 
@@ -153,6 +193,31 @@ struct index_opts {
 	double run_size_ratio;
 	/* Bloom filter false positive rate. */
 	double bloom_fpr;
+	/** Vinyl compaction policy. */
+	enum index_compaction_policy compaction_policy;
+	/**
+	 * Build a xor filter over the keys of each page so that
+	 * a point lookup can skip reading a page that doesn't
+	 * store the key (vinyl only).
+	 */
+	bool page_filter;
+	/**
+	 * Store front-coded keys of each page with restart points
+	 * so that a key search within a page doesn't need to decode
+	 * statements (vinyl only).
+	 */
+	bool page_key_index;
+	/**
+	 * Max size of a zstd dictionary trained for each run to
+	 * compress its pages with or 0 if pages are compressed
+	 * without a dictionary (vinyl only).
+	 */
+	int64_t compression_dict_size;
+	/**
+	 * Quota class of the space, set on the primary index
+	 * (vinyl only).
+	 */
+	enum index_quota_class quota_class;
 	/**
 	 * LSN from the time of index creation.
 	 */
@@ -213,6 +278,17 @@ index_opts_cmp(const struct index_opts *o1, const struct index_opts *o2)
 		return o1->run_size_ratio < o2->run_size_ratio ? -1 : 1;
 	if (o1->bloom_fpr != o2->bloom_fpr)
 		return o1->bloom_fpr < o2->bloom_fpr ? -1 : 1;
+	if (o1->compaction_policy != o2->compaction_policy)
+		return o1->compaction_policy < o2->compaction_policy ? -1 : 1;
+	if (o1->page_filter != o2->page_filter)
+		return o1->page_filter < o2->page_filter ? -1 : 1;
+	if (o1->page_key_index != o2->page_key_index)
+		return o1->page_key_index < o2->page_key_index ? -1 : 1;
+	if (o1->compression_dict_size != o2->compression_dict_size)
+		return o1->compression_dict_size <
+		       o2->compression_dict_size ? -1 : 1;
+	if (o1->quota_class != o2->quota_class)
+		return o1->quota_class < o2->quota_class ? -1 : 1;
 	if (o1->func_id != o2->func_id)
 		return o1->func_id - o2->func_id;
 	if (o1->hint != o2->hint)
@@ -53,6 +53,7 @@
 #include "port.h"
 #include "box.h"
 #include "call.h"
+#include "tuple.h"
 #include "tuple_convert.h"
 #include "session.h"
 #include "xrow.h"
@@ -109,6 +110,47 @@ struct iproto_kharon {
 	struct iproto_wpos wpos;
 };
 
+enum {
+	/**
+	 * A SELECT reply is sent by reference only if its tuples
+	 * are at least this big on average. Smaller tuples are
+	 * cheaper to copy than to pin and unpin.
+	 */
+	IPROTO_TUPLE_REPLY_AVG_BSIZE_MIN = 512,
+	/** Total size of tuples to send a reply by reference. */
+	IPROTO_TUPLE_REPLY_BSIZE_MIN = 16 * 1024,
+};
+
+/**
+ * Tuples of a SELECT reply, which are written to the socket
+ * right from the tuple storage rather than copied to the
+ * connection output buffer. The tx thread encodes the reply
+ * header to the output buffer as usual, references the tuples
+ * and creates an iovec for each of them. The iproto thread
+ * writes the iovecs to the socket as soon as it has flushed
+ * the output buffer up to the position of the reply, and then
+ * returns the reply to tx to release the tuples.
+ */
+struct iproto_tuple_reply {
+	/** Message to return the reply to tx. */
+	struct cmsg base;
+	/** Link in iproto_connection::tuple_replies. */
+	struct rlist in_connection;
+	/** Position in the output buffer the tuples follow. */
+	struct iproto_wpos wpos;
+	/** Referenced tuples. */
+	struct tuple **tuples;
+	/** Number of tuples and iovecs. */
+	int count;
+	/** Index of the first iovec not written yet. */
+	int iov_pos;
+	/**
+	 * Tuple data. Partially written iovecs are adjusted
+	 * in place.
+	 */
+	struct iovec iov[0];
+};
+
 /**
  * Network readahead. A signed integer to avoid
  * automatic type coercion to an unsigned type.
@@ -126,7 +168,10 @@ struct iproto_kharon {
  */
 unsigned iproto_readahead = 16320;
 
-/* The maximal number of iproto messages in fly. */
+/**
+ * The maximal number of iproto messages in fly, stored in TX.
+ * Every network thread keeps its own copy in iproto_thread.
+ */
 static int iproto_msg_max = IPROTO_MSG_MAX_MIN;
 
 /**
@@ -232,57 +277,20 @@ struct iproto_msg
 	 * and the connection must be closed.
 	 */
 	bool close_connection;
+	/**
+	 * Tuples of a SELECT reply sent by reference, if any.
+	 * They follow the output up to wpos.
+	 */
+	struct iproto_tuple_reply *tuple_reply;
 };
 
-static struct mempool iproto_msg_pool;
-
 static struct iproto_msg *
 iproto_msg_new(struct iproto_connection *con);
 
-/**
- * Resume stopped connections, if any.
- */
-static void
-iproto_resume(void);
-
 static void
 iproto_msg_decode(struct iproto_msg *msg, const char **pos, const char *reqend,
 		  bool *stop_input);
 
-static inline void
-iproto_msg_delete(struct iproto_msg *msg)
-{
-	mempool_free(&iproto_msg_pool, msg);
-	iproto_resume();
-}
-
-/**
- * A single global queue for all requests in all connections. All
- * requests from all connections are processed concurrently.
- * Is also used as a queue for just established connections and to
- * execute disconnect triggers. A few notes about these triggers:
- * - they need to be run in a fiber
- * - unlike an ordinary request failure, on_connect trigger
- *   failure must lead to connection close.
- * - on_connect trigger must be processed before any other
- *   request on this connection.
- */
-static struct cpipe tx_pipe;
-static struct cpipe net_pipe;
-
-/**
- * Network thread.
- */
-static struct cord net_cord;
-
-/**
- * Slab cache used for allocating memory for output network buffers
- * in the tx thread.
- */
-static struct slab_cache net_slabc;
-
-struct rmean *rmean_net;
-
 enum rmean_net_name {
 	IPROTO_SENT,
 	IPROTO_RECEIVED,
@@ -298,17 +306,86 @@ const char *rmean_net_strings[IPROTO_LAST] = {
 	"REQUESTS",
 };
 
+/**
+ * Context of a single network thread. Client connections are
+ * spread across several network threads, each of which owns its
+ * own listener, connections, messages and a pair of pipes to the
+ * tx thread, so the threads never touch each other's state.
+ * Since a cbus route refers to the pipe the message travels by,
+ * every thread has its own copy of each route.
+ */
+struct iproto_thread {
+	/** Thread index, 0 is the thread that binds the listener. */
+	int id;
+	/** Network thread. */
+	struct cord net_cord;
+	/**
+	 * A single queue for all requests in all connections of
+	 * this thread. All requests from all connections are
+	 * processed concurrently. Is also used as a queue for
+	 * just established connections and to execute disconnect
+	 * triggers. A few notes about these triggers:
+	 * - they need to be run in a fiber
+	 * - unlike an ordinary request failure, on_connect trigger
+	 *   failure must lead to connection close.
+	 * - on_connect trigger must be processed before any other
+	 *   request on this connection.
+	 */
+	struct cpipe tx_pipe;
+	/** Pipe to the network thread, used by tx. */
+	struct cpipe net_pipe;
+	/**
+	 * Slab cache used for allocating memory for output
+	 * network buffers in the tx thread.
+	 */
+	struct slab_cache net_slabc;
+	/** Pool of iproto_msg objects, used in the net thread. */
+	struct mempool iproto_msg_pool;
+	/** Pool of iproto_connection objects. */
+	struct mempool iproto_connection_pool;
+	/** Connections with input stopped by net_msg_max limit. */
+	struct rlist stopped_connections;
+	/** The maximal number of iproto messages in fly. */
+	int msg_max;
+	/** Binary protocol listener. */
+	struct evio_service binary;
+	/** Network statistics of this thread. */
+	struct rmean *rmean;
+	/* {{{ Routes bound to this thread's pipes. */
+	struct cmsg_hop destroy_route[2];
+	struct cmsg_hop disconnect_route[2];
+	struct cmsg_hop push_route[2];
+	struct cmsg_hop misc_route[2];
+	struct cmsg_hop call_route[2];
+	struct cmsg_hop select_route[2];
+	struct cmsg_hop process1_route[2];
+	struct cmsg_hop sql_route[2];
+	const struct cmsg_hop *dml_route[IPROTO_TYPE_STAT_MAX];
+	struct cmsg_hop join_route[2];
+	struct cmsg_hop subscribe_route[2];
+	struct cmsg_hop error_route[2];
+	struct cmsg_hop connect_route[2];
+	/* }}} */
+};
+
+/** Network threads, allocated in iproto_init(). */
+static struct iproto_thread *iproto_threads;
+
+/** Number of network threads. */
+int iproto_threads_count;
+
+/**
+ * Resume stopped connections, if any.
+ */
+static void
+iproto_resume(struct iproto_thread *iproto_thread);
+
 static void
 tx_process_destroy(struct cmsg *m);
 
 static void
 net_finish_destroy(struct cmsg *m);
 
-static const struct cmsg_hop destroy_route[] = {
-	{ tx_process_destroy, &net_pipe },
-	{ net_finish_destroy, NULL },
-};
-
 /** Fire on_disconnect triggers in the tx thread. */
 static void
 tx_process_disconnect(struct cmsg *m);
@@ -317,11 +394,6 @@ tx_process_disconnect(struct cmsg *m);
 static void
 net_finish_disconnect(struct cmsg *m);
 
-static const struct cmsg_hop disconnect_route[] = {
-	{ tx_process_disconnect, &net_pipe },
-	{ net_finish_disconnect, NULL }
-};
-
 /**
  * Kharon is in the dead world (iproto). Schedule an event to
  * flush new obuf as reflected in the fresh wpos.
@@ -339,12 +411,6 @@ iproto_process_push(struct cmsg *m);
 static void
 tx_end_push(struct cmsg *m);
 
-static const struct cmsg_hop push_route[] = {
-	{ iproto_process_push, &tx_pipe },
-	{ tx_end_push, NULL }
-};
-
-
 /* }}} */
 
 /* {{{ iproto_connection - declaration and definition */
@@ -534,29 +600,42 @@ struct iproto_connection
 	} tx;
 	/** Authentication salt. */
 	char salt[IPROTO_SALT_SIZE];
+	/** Network thread serving the connection. */
+	struct iproto_thread *iproto_thread;
+	/**
+	 * Tuple replies waiting to be written to the socket,
+	 * in the order of their positions in the output.
+	 */
+	struct rlist tuple_replies;
 };
 
-static struct mempool iproto_connection_pool;
-static RLIST_HEAD(stopped_connections);
-
 /**
  * Return true if we have not enough spare messages
  * in the message pool.
  */
 static inline bool
-iproto_check_msg_max(void)
+iproto_check_msg_max(struct iproto_thread *iproto_thread)
+{
+	size_t request_count = mempool_count(&iproto_thread->iproto_msg_pool);
+	return request_count > (size_t) iproto_thread->msg_max;
+}
+
+static inline void
+iproto_msg_delete(struct iproto_msg *msg)
 {
-	size_t request_count = mempool_count(&iproto_msg_pool);
-	return request_count > (size_t) iproto_msg_max;
+	struct iproto_thread *iproto_thread = msg->connection->iproto_thread;
+	mempool_free(&iproto_thread->iproto_msg_pool, msg);
+	iproto_resume(iproto_thread);
 }
 
 static struct iproto_msg *
 iproto_msg_new(struct iproto_connection *con)
 {
-	struct iproto_msg *msg =
-		(struct iproto_msg *) mempool_alloc(&iproto_msg_pool);
+	struct iproto_thread *iproto_thread = con->iproto_thread;
+	struct iproto_msg *msg = (struct iproto_msg *)
+		mempool_alloc(&iproto_thread->iproto_msg_pool);
 	ERROR_INJECT(ERRINJ_TESTING, {
-		mempool_free(&iproto_msg_pool, msg);
+		mempool_free(&iproto_thread->iproto_msg_pool, msg);
 		msg = NULL;
 	});
 	if (msg == NULL) {
@@ -566,8 +645,9 @@ iproto_msg_new(struct iproto_connection *con)
 		return NULL;
 	}
 	msg->close_connection = false;
+	msg->tuple_reply = NULL;
 	msg->connection = con;
-	rmean_collect(rmean_net, IPROTO_REQUESTS, 1);
+	rmean_collect(iproto_thread->rmean, IPROTO_REQUESTS, 1);
 	return msg;
 }
 
@@ -622,7 +702,8 @@ iproto_connection_stop_msg_max_limit(struct iproto_connection *con)
 	 * Important to add to tail and fetch from head to ensure
 	 * strict lifo order (fairness) for stopped connections.
 	 */
-	rlist_add_tail(&stopped_connections, &con->in_stop_list);
+	rlist_add_tail(&con->iproto_thread->stopped_connections,
+		       &con->in_stop_list);
 }
 
 /**
@@ -651,7 +732,32 @@ iproto_connection_try_to_start_destroy(struct iproto_connection *con)
 	 * other parts of the connection.
 	 */
 	con->state = IPROTO_CONNECTION_DESTROYED;
-	cpipe_push(&tx_pipe, &con->destroy_msg);
+	cpipe_push(&con->iproto_thread->tx_pipe, &con->destroy_msg);
+}
+
+/** Release tuples of a tuple reply in the tx thread. */
+static void
+tx_end_tuple_reply(struct cmsg *m)
+{
+	struct iproto_tuple_reply *reply = (struct iproto_tuple_reply *) m;
+	for (int i = 0; i < reply->count; i++)
+		tuple_unref(reply->tuples[i]);
+	free(reply);
+}
+
+/**
+ * Return a tuple reply, either written or discarded, to the tx
+ * thread to unreference the tuples.
+ */
+static void
+iproto_tuple_reply_complete(struct iproto_connection *con,
+			    struct iproto_tuple_reply *reply)
+{
+	static const struct cmsg_hop tuple_reply_route[] = {
+		{ tx_end_tuple_reply, NULL },
+	};
+	cmsg_init(&reply->base, tuple_reply_route);
+	cpipe_push(&con->iproto_thread->tx_pipe, &reply->base);
 }
 
 /**
@@ -671,6 +777,13 @@ iproto_connection_close(struct iproto_connection *con)
 		/* Make evio_has_fd() happy */
 		con->input.fd = con->output.fd = -1;
 		close(fd);
+		/* Tuples which are not sent yet will never be. */
+		struct iproto_tuple_reply *reply, *tmp;
+		rlist_foreach_entry_safe(reply, &con->tuple_replies,
+					 in_connection, tmp) {
+			rlist_del_entry(reply, in_connection);
+			iproto_tuple_reply_complete(con, reply);
+		}
 		/*
 		 * Discard unparsed data, to recycle the
 		 * connection in net_send_msg() as soon as all
@@ -678,7 +791,7 @@ iproto_connection_close(struct iproto_connection *con)
 		 * is done only once.
 		 */
 		con->p_ibuf->wpos -= con->parse_size;
-		cpipe_push(&tx_pipe, &con->disconnect_msg);
+		cpipe_push(&con->iproto_thread->tx_pipe, &con->disconnect_msg);
 		assert(con->state == IPROTO_CONNECTION_ALIVE);
 		con->state = IPROTO_CONNECTION_CLOSED;
 	} else if (con->state == IPROTO_CONNECTION_PENDING_DESTROY) {
@@ -808,13 +921,14 @@ static inline int
 iproto_enqueue_batch(struct iproto_connection *con, struct ibuf *in)
 {
 	assert(rlist_empty(&con->in_stop_list));
+	struct iproto_thread *iproto_thread = con->iproto_thread;
 	int n_requests = 0;
 	bool stop_input = false;
 	const char *errmsg;
 	while (con->parse_size != 0 && !stop_input) {
-		if (iproto_check_msg_max()) {
+		if (iproto_check_msg_max(iproto_thread)) {
 			iproto_connection_stop_msg_max_limit(con);
-			cpipe_flush_input(&tx_pipe);
+			cpipe_flush_input(&iproto_thread->tx_pipe);
 			return 0;
 		}
 		const char *reqstart = in->wpos - con->parse_size;
@@ -823,7 +937,7 @@ iproto_enqueue_batch(struct iproto_connection *con, struct ibuf *in)
 		if (mp_typeof(*pos) != MP_UINT) {
 			errmsg = "packet length";
 err_msgpack:
-			cpipe_flush_input(&tx_pipe);
+			cpipe_flush_input(&iproto_thread->tx_pipe);
 			diag_set(ClientError, ER_INVALID_MSGPACK,
 				 errmsg);
 			return -1;
@@ -859,7 +973,7 @@ err_msgpack:
 		 * This can't throw, but should not be
 		 * done in case of exception.
 		 */
-		cpipe_push_input(&tx_pipe, &msg->base);
+		cpipe_push_input(&iproto_thread->tx_pipe, &msg->base);
 		n_requests++;
 		/* Request is parsed */
 		assert(reqend > reqstart);
@@ -897,7 +1011,7 @@ err_msgpack:
 		 */
 		ev_feed_event(con->loop, &con->input, EV_READ);
 	}
-	cpipe_flush_input(&tx_pipe);
+	cpipe_flush_input(&iproto_thread->tx_pipe);
 	return 0;
 }
 
@@ -909,7 +1023,7 @@ err_msgpack:
 static void
 iproto_connection_resume(struct iproto_connection *con)
 {
-	assert(! iproto_check_msg_max());
+	assert(! iproto_check_msg_max(con->iproto_thread));
 	rlist_del(&con->in_stop_list);
 	/*
 	 * Enqueue_batch() stops the connection again, if the
@@ -933,15 +1047,16 @@ iproto_connection_resume(struct iproto_connection *con)
  * necessary to use up the limit.
  */
 static void
-iproto_resume(void)
+iproto_resume(struct iproto_thread *iproto_thread)
 {
-	while (!iproto_check_msg_max() && !rlist_empty(&stopped_connections)) {
+	while (!iproto_check_msg_max(iproto_thread) &&
+	       !rlist_empty(&iproto_thread->stopped_connections)) {
 		/*
 		 * Shift from list head to ensure strict FIFO
 		 * (fairness) for resumed connections.
 		 */
 		struct iproto_connection *con =
-			rlist_first_entry(&stopped_connections,
+			rlist_first_entry(&iproto_thread->stopped_connections,
 					  struct iproto_connection,
 					  in_stop_list);
 		iproto_connection_resume(con);
@@ -963,7 +1078,7 @@ iproto_connection_on_input(ev_loop *loop, struct ev_io *watcher,
 	 * otherwise we might deplete the fiber pool in tx
 	 * thread and deadlock.
 	 */
-	if (iproto_check_msg_max()) {
+	if (iproto_check_msg_max(con->iproto_thread)) {
 		iproto_connection_stop_msg_max_limit(con);
 		return;
 	}
@@ -988,7 +1103,7 @@ iproto_connection_on_input(ev_loop *loop, struct ev_io *watcher,
 			return;
 		}
 		/* Count statistics */
-		rmean_collect(rmean_net, IPROTO_RECEIVED, nrd);
+		rmean_collect(con->iproto_thread->rmean, IPROTO_RECEIVED, nrd);
 
 		/* Update the read position and connection state. */
 		in->wpos += nrd;
@@ -1004,6 +1119,44 @@ iproto_connection_on_input(ev_loop *loop, struct ev_io *watcher,
 	}
 }
 
+/**
+ * writev() tuples of a tuple reply to the socket and handle
+ * the result. Return values are the same as of iproto_flush().
+ */
+static int
+iproto_flush_tuple_reply(struct iproto_connection *con,
+			 struct iproto_tuple_reply *reply)
+{
+	struct iovec *iov = &reply->iov[reply->iov_pos];
+	ssize_t nwr = sio_writev(con->output.fd, iov,
+				 reply->count - reply->iov_pos);
+	if (nwr > 0) {
+		/* Count statistics */
+		rmean_collect(con->iproto_thread->rmean, IPROTO_SENT, nwr);
+		size_t offset = 0;
+		int advance = sio_move_iov(iov, nwr, &offset);
+		reply->iov_pos += advance;
+		if (reply->iov_pos == reply->count) {
+			rlist_del_entry(reply, in_connection);
+			iproto_tuple_reply_complete(con, reply);
+			return 0;
+		}
+		/* Adjust the partially written iovec. */
+		iov += advance;
+		iov->iov_base = (char *) iov->iov_base + offset;
+		iov->iov_len -= offset;
+		/*
+		 * sio_writev() is limited by IOV_MAX, so the
+		 * socket may still be writable.
+		 */
+		if (advance > 0 && offset == 0)
+			return 0;
+	} else if (nwr < 0 && ! sio_wouldblock(errno)) {
+		diag_raise();
+	}
+	return -1;
+}
+
 /** writev() to the socket and handle the result. */
 
 static int
@@ -1014,6 +1167,19 @@ iproto_flush(struct iproto_connection *con)
 	struct obuf_svp obuf_end = obuf_create_svp(obuf);
 	struct obuf_svp *begin = &con->wpos.svp;
 	struct obuf_svp *end = &con->wend.svp;
+	struct iproto_tuple_reply *reply = NULL;
+	if (!rlist_empty(&con->tuple_replies)) {
+		reply = rlist_first_entry(&con->tuple_replies,
+					  struct iproto_tuple_reply,
+					  in_connection);
+		/*
+		 * The output preceding the tuples has been
+		 * flushed, it's their turn.
+		 */
+		if (reply->wpos.obuf == obuf &&
+		    reply->wpos.svp.used == begin->used)
+			return iproto_flush_tuple_reply(con, reply);
+	}
 	if (con->wend.obuf != obuf) {
 		/*
 		 * Flush the current buffer before
@@ -1026,6 +1192,10 @@ iproto_flush(struct iproto_connection *con)
 			end = &obuf_end;
 		}
 	}
+	/* Don't flush past the tuples of a tuple reply. */
+	if (reply != NULL && reply->wpos.obuf == obuf &&
+	    reply->wpos.svp.used < end->used)
+		end = &reply->wpos.svp;
 	if (begin->used == end->used) {
 		/* Nothing to do. */
 		return 1;
@@ -1047,7 +1217,7 @@ iproto_flush(struct iproto_connection *con)
 
 	if (nwr > 0) {
 		/* Count statistics */
-		rmean_collect(rmean_net, IPROTO_SENT, nwr);
+		rmean_collect(con->iproto_thread->rmean, IPROTO_SENT, nwr);
 		if (begin->used + nwr == end->used) {
 			*begin = *end;
 			return 0;
@@ -1092,22 +1262,25 @@ iproto_connection_on_output(ev_loop *loop, struct ev_io *watcher,
 }
 
 static struct iproto_connection *
-iproto_connection_new(int fd)
+iproto_connection_new(struct iproto_thread *iproto_thread, int fd)
 {
 	struct iproto_connection *con = (struct iproto_connection *)
-		mempool_alloc(&iproto_connection_pool);
+		mempool_alloc(&iproto_thread->iproto_connection_pool);
 	if (con == NULL) {
 		diag_set(OutOfMemory, sizeof(*con), "mempool_alloc", "con");
 		return NULL;
 	}
+	con->iproto_thread = iproto_thread;
 	con->input.data = con->output.data = con;
 	con->loop = loop();
 	ev_io_init(&con->input, iproto_connection_on_input, fd, EV_READ);
 	ev_io_init(&con->output, iproto_connection_on_output, fd, EV_WRITE);
 	ibuf_create(&con->ibuf[0], cord_slab_cache(), iproto_readahead);
 	ibuf_create(&con->ibuf[1], cord_slab_cache(), iproto_readahead);
-	obuf_create(&con->obuf[0], &net_slabc, iproto_readahead);
-	obuf_create(&con->obuf[1], &net_slabc, iproto_readahead);
+	obuf_create(&con->obuf[0], &iproto_thread->net_slabc,
+		    iproto_readahead);
+	obuf_create(&con->obuf[1], &iproto_thread->net_slabc,
+		    iproto_readahead);
 	con->p_ibuf = &con->ibuf[0];
 	con->tx.p_obuf = &con->obuf[0];
 	iproto_wpos_create(&con->wpos, con->tx.p_obuf);
@@ -1116,13 +1289,14 @@ iproto_connection_new(int fd)
 	con->long_poll_count = 0;
 	con->session = NULL;
 	rlist_create(&con->in_stop_list);
+	rlist_create(&con->tuple_replies);
 	/* It may be very awkward to allocate at close. */
-	cmsg_init(&con->destroy_msg, destroy_route);
-	cmsg_init(&con->disconnect_msg, disconnect_route);
+	cmsg_init(&con->destroy_msg, iproto_thread->destroy_route);
+	cmsg_init(&con->disconnect_msg, iproto_thread->disconnect_route);
 	con->state = IPROTO_CONNECTION_ALIVE;
 	con->tx.is_push_pending = false;
 	con->tx.is_push_sent = false;
-	rmean_collect(rmean_net, IPROTO_CONNECTIONS, 1);
+	rmean_collect(iproto_thread->rmean, IPROTO_CONNECTIONS, 1);
 	return con;
 }
 
@@ -1135,6 +1309,7 @@ iproto_connection_delete(struct iproto_connection *con)
 	assert(!evio_has_fd(&con->input));
 	assert(con->session == NULL);
 	assert(con->state == IPROTO_CONNECTION_DESTROYED);
+	assert(rlist_empty(&con->tuple_replies));
 	/*
 	 * The output buffers must have been deleted
 	 * in tx thread.
@@ -1145,7 +1320,7 @@ iproto_connection_delete(struct iproto_connection *con)
 	       con->obuf[0].iov[0].iov_base == NULL);
 	assert(con->obuf[1].pos == 0 &&
 	       con->obuf[1].iov[0].iov_base == NULL);
-	mempool_free(&iproto_connection_pool, con);
+	mempool_free(&con->iproto_thread->iproto_connection_pool, con);
 }
 
 /* }}} iproto_connection */
@@ -1188,68 +1363,12 @@ net_end_join(struct cmsg *msg);
 static void
 net_end_subscribe(struct cmsg *msg);
 
-static const struct cmsg_hop misc_route[] = {
-	{ tx_process_misc, &net_pipe },
-	{ net_send_msg, NULL },
-};
-
-static const struct cmsg_hop call_route[] = {
-	{ tx_process_call, &net_pipe },
-	{ net_send_msg, NULL },
-};
-
-static const struct cmsg_hop select_route[] = {
-	{ tx_process_select, &net_pipe },
-	{ net_send_msg, NULL },
-};
-
-static const struct cmsg_hop process1_route[] = {
-	{ tx_process1, &net_pipe },
-	{ net_send_msg, NULL },
-};
-
-static const struct cmsg_hop sql_route[] = {
-	{ tx_process_sql, &net_pipe },
-	{ net_send_msg, NULL },
-};
-
-static const struct cmsg_hop *dml_route[IPROTO_TYPE_STAT_MAX] = {
-	NULL,                                   /* IPROTO_OK */
-	select_route,                           /* IPROTO_SELECT */
-	process1_route,                         /* IPROTO_INSERT */
-	process1_route,                         /* IPROTO_REPLACE */
-	process1_route,                         /* IPROTO_UPDATE */
-	process1_route,                         /* IPROTO_DELETE */
-	call_route,                             /* IPROTO_CALL_16 */
-	misc_route,                             /* IPROTO_AUTH */
-	call_route,                             /* IPROTO_EVAL */
-	process1_route,                         /* IPROTO_UPSERT */
-	call_route,                             /* IPROTO_CALL */
-	sql_route,                              /* IPROTO_EXECUTE */
-	NULL,                                   /* IPROTO_NOP */
-	sql_route,                              /* IPROTO_PREPARE */
-};
-
-static const struct cmsg_hop join_route[] = {
-	{ tx_process_replication, &net_pipe },
-	{ net_end_join, NULL },
-};
-
-static const struct cmsg_hop subscribe_route[] = {
-	{ tx_process_replication, &net_pipe },
-	{ net_end_subscribe, NULL },
-};
-
-static const struct cmsg_hop error_route[] = {
-	{ tx_reply_iproto_error, &net_pipe },
-	{ net_send_error, NULL },
-};
-
 static void
 iproto_msg_decode(struct iproto_msg *msg, const char **pos, const char *reqend,
 		  bool *stop_input)
 {
 	uint8_t type;
+	struct iproto_thread *iproto_thread = msg->connection->iproto_thread;
 
 	if (xrow_header_decode(&msg->header, pos, reqend, true))
 		goto error;
@@ -1269,46 +1388,48 @@ iproto_msg_decode(struct iproto_msg *msg, const char **pos, const char *reqend,
 	case IPROTO_UPDATE:
 	case IPROTO_DELETE:
 	case IPROTO_UPSERT:
+	case IPROTO_GET_MANY:
 		if (xrow_decode_dml(&msg->header, &msg->dml,
 				    dml_request_key_map(type)))
 			goto error;
-		assert(type < sizeof(dml_route)/sizeof(*dml_route));
-		cmsg_init(&msg->base, dml_route[type]);
+		assert(type < sizeof(iproto_thread->dml_route) /
+			      sizeof(*iproto_thread->dml_route));
+		cmsg_init(&msg->base, iproto_thread->dml_route[type]);
 		break;
 	case IPROTO_CALL_16:
 	case IPROTO_CALL:
 	case IPROTO_EVAL:
 		if (xrow_decode_call(&msg->header, &msg->call))
 			goto error;
-		cmsg_init(&msg->base, call_route);
+		cmsg_init(&msg->base, iproto_thread->call_route);
 		break;
 	case IPROTO_EXECUTE:
 	case IPROTO_PREPARE:
 		if (xrow_decode_sql(&msg->header, &msg->sql) != 0)
 			goto error;
-		cmsg_init(&msg->base, sql_route);
+		cmsg_init(&msg->base, iproto_thread->sql_route);
 		break;
 	case IPROTO_PING:
-		cmsg_init(&msg->base, misc_route);
+		cmsg_init(&msg->base, iproto_thread->misc_route);
 		break;
 	case IPROTO_JOIN:
 	case IPROTO_FETCH_SNAPSHOT:
 	case IPROTO_REGISTER:
-		cmsg_init(&msg->base, join_route);
+		cmsg_init(&msg->base, iproto_thread->join_route);
 		*stop_input = true;
 		break;
 	case IPROTO_SUBSCRIBE:
-		cmsg_init(&msg->base, subscribe_route);
+		cmsg_init(&msg->base, iproto_thread->subscribe_route);
 		*stop_input = true;
 		break;
 	case IPROTO_VOTE_DEPRECATED:
 	case IPROTO_VOTE:
-		cmsg_init(&msg->base, misc_route);
+		cmsg_init(&msg->base, iproto_thread->misc_route);
 		break;
 	case IPROTO_AUTH:
 		if (xrow_decode_auth(&msg->header, &msg->auth))
 			goto error;
-		cmsg_init(&msg->base, misc_route);
+		cmsg_init(&msg->base, iproto_thread->misc_route);
 		break;
 	default:
 		diag_set(ClientError, ER_UNKNOWN_REQUEST_TYPE,
@@ -1321,7 +1442,7 @@ error:
 	diag_log();
 	diag_create(&msg->diag);
 	diag_move(&fiber()->diag, &msg->diag);
-	cmsg_init(&msg->base, error_route);
+	cmsg_init(&msg->base, iproto_thread->error_route);
 }
 
 static void
@@ -1438,7 +1559,8 @@ tx_discard_input(struct iproto_msg *msg)
 		{ net_discard_input, NULL },
 	};
 	cmsg_init(&msg->discard_input, discard_input_route);
-	cpipe_push(&net_pipe, &msg->discard_input);
+	cpipe_push(&msg->connection->iproto_thread->net_pipe,
+		   &msg->discard_input);
 }
 
 /**
@@ -1552,6 +1674,66 @@ error:
 	tx_reply_error(msg);
 }
 
+/**
+ * Check if it's worth sending tuples of a SELECT reply by
+ * reference, see struct iproto_tuple_reply. Returns the total
+ * size of the tuples if it is, 0 otherwise.
+ */
+static size_t
+tx_tuple_reply_bsize(struct port *port)
+{
+	struct port_c *port_c = (struct port_c *) port;
+	size_t bsize = 0;
+	for (struct port_c_entry *pe = port_c->first; pe != NULL;
+	     pe = pe->next) {
+		/* Only tuples can be referenced. */
+		if (pe->mp_size != 0)
+			return 0;
+		bsize += pe->tuple->bsize;
+	}
+	if (bsize < IPROTO_TUPLE_REPLY_BSIZE_MIN ||
+	    bsize < (size_t) port_c->size * IPROTO_TUPLE_REPLY_AVG_BSIZE_MIN)
+		return 0;
+	return bsize;
+}
+
+/**
+ * Reference tuples of a SELECT reply to send them right from
+ * the tuple storage. Must be called when the reply header is
+ * the last thing written to the output buffer.
+ */
+static int
+tx_create_tuple_reply(struct iproto_msg *msg, struct port *port,
+		      struct obuf *out)
+{
+	struct port_c *port_c = (struct port_c *) port;
+	size_t size = sizeof(struct iproto_tuple_reply) +
+		      port_c->size * (sizeof(struct iovec) +
+				      sizeof(struct tuple *));
+	struct iproto_tuple_reply *reply =
+		(struct iproto_tuple_reply *) malloc(size);
+	if (reply == NULL) {
+		diag_set(OutOfMemory, size, "malloc", "reply");
+		return -1;
+	}
+	reply->tuples = (struct tuple **) &reply->iov[port_c->size];
+	reply->count = 0;
+	reply->iov_pos = 0;
+	for (struct port_c_entry *pe = port_c->first; pe != NULL;
+	     pe = pe->next) {
+		struct tuple *tuple = pe->tuple;
+		tuple_ref(tuple);
+		reply->tuples[reply->count] = tuple;
+		reply->iov[reply->count].iov_base = (void *) tuple_data(tuple);
+		reply->iov[reply->count].iov_len = tuple->bsize;
+		reply->count++;
+	}
+	assert(reply->count == port_c->size);
+	iproto_wpos_create(&reply->wpos, out);
+	msg->tuple_reply = reply;
+	return 0;
+}
+
 static void
 tx_process_select(struct cmsg *m)
 {
@@ -1561,14 +1743,20 @@ tx_process_select(struct cmsg *m)
 	struct port port;
 	int count;
 	int rc;
+	size_t bsize;
 	struct request *req = &msg->dml;
 	if (tx_check_schema(msg->header.schema_version))
 		goto error;
 
 	tx_inject_delay();
-	rc = box_select(req->space_id, req->index_id,
-			req->iterator, req->offset, req->limit,
-			req->key, req->key_end, &port);
+	if (msg->header.type == IPROTO_GET_MANY) {
+		rc = box_get_many(req->space_id, req->index_id,
+				  req->key, req->key_end, &port);
+	} else {
+		rc = box_select(req->space_id, req->index_id,
+				req->iterator, req->offset, req->limit,
+				req->key, req->key_end, &port);
+	}
 	if (rc < 0)
 		goto error;
 
@@ -1577,6 +1765,25 @@ tx_process_select(struct cmsg *m)
 		port_destroy(&port);
 		goto error;
 	}
+	bsize = tx_tuple_reply_bsize(&port);
+	if (bsize > 0) {
+		/*
+		 * Big tuples are not copied to the output buffer,
+		 * iproto writes them to the socket right from the
+		 * tuple storage.
+		 */
+		rc = tx_create_tuple_reply(msg, &port, out);
+		count = ((struct port_c *) &port)->size;
+		port_destroy(&port);
+		if (rc != 0) {
+			obuf_rollback_to_svp(out, &svp);
+			goto error;
+		}
+		iproto_reply_select_ext(out, &svp, msg->header.sync,
+					::schema_version, count, bsize);
+		iproto_wpos_create(&msg->wpos, out);
+		return;
+	}
 	/*
 	 * SELECT output format has not changed since Tarantool 1.6
 	 */
@@ -1882,6 +2089,14 @@ net_send_msg(struct cmsg *m)
 		con->long_poll_count--;
 	}
 	con->wend = msg->wpos;
+	if (msg->tuple_reply != NULL) {
+		if (evio_has_fd(&con->output)) {
+			rlist_add_tail_entry(&con->tuple_replies,
+					     msg->tuple_reply, in_connection);
+		} else {
+			iproto_tuple_reply_complete(con, msg->tuple_reply);
+		}
+	}
 
 	if (evio_has_fd(&con->output)) {
 		if (! ev_is_active(&con->output))
@@ -1988,7 +2203,8 @@ net_send_greeting(struct cmsg *m)
 
 		if (nwr > 0) {
 			/* Count statistics. */
-			rmean_collect(rmean_net, IPROTO_SENT, nwr);
+			rmean_collect(con->iproto_thread->rmean, IPROTO_SENT,
+				      nwr);
 		} else if (nwr < 0 && ! sio_wouldblock(errno)) {
 			diag_log();
 		}
@@ -2009,24 +2225,22 @@ net_send_greeting(struct cmsg *m)
 	iproto_msg_delete(msg);
 }
 
-static const struct cmsg_hop connect_route[] = {
-	{ tx_process_connect, &net_pipe },
-	{ net_send_greeting, NULL },
-};
-
 /** }}} */
 
 /**
  * Create a connection and start input.
  */
 static int
-iproto_on_accept(struct evio_service * /* service */, int fd,
+iproto_on_accept(struct evio_service *service, int fd,
 		 struct sockaddr *addr, socklen_t addrlen)
 {
 	(void) addr;
 	(void) addrlen;
 	struct iproto_msg *msg;
-	struct iproto_connection *con = iproto_connection_new(fd);
+	struct iproto_thread *iproto_thread =
+		(struct iproto_thread *) service->on_accept_param;
+	struct iproto_connection *con =
+		iproto_connection_new(iproto_thread, fd);
 	if (con == NULL)
 		return -1;
 	/*
@@ -2036,61 +2250,64 @@ iproto_on_accept(struct evio_service * /* service */, int fd,
 	 */
 	msg = iproto_msg_new(con);
 	if (msg == NULL) {
-		mempool_free(&iproto_connection_pool, con);
+		mempool_free(&iproto_thread->iproto_connection_pool, con);
 		return -1;
 	}
-	cmsg_init(&msg->base, connect_route);
+	cmsg_init(&msg->base, iproto_thread->connect_route);
 	msg->p_ibuf = con->p_ibuf;
 	msg->wpos = con->wpos;
-	cpipe_push(&tx_pipe, &msg->base);
+	cpipe_push(&iproto_thread->tx_pipe, &msg->base);
 	return 0;
 }
 
-static struct evio_service binary; /* iproto binary listener */
-
 /**
  * The network io thread main function:
  * begin serving the message bus.
  */
 static int
-net_cord_f(va_list /* ap */)
+net_cord_f(va_list ap)
 {
-	mempool_create(&iproto_msg_pool, &cord()->slabc,
+	struct iproto_thread *iproto_thread =
+		va_arg(ap, struct iproto_thread *);
+
+	mempool_create(&iproto_thread->iproto_msg_pool, &cord()->slabc,
 		       sizeof(struct iproto_msg));
-	mempool_create(&iproto_connection_pool, &cord()->slabc,
-		       sizeof(struct iproto_connection));
+	mempool_create(&iproto_thread->iproto_connection_pool,
+		       &cord()->slabc, sizeof(struct iproto_connection));
 
-	evio_service_init(loop(), &binary, "binary",
-			  iproto_on_accept, NULL);
+	evio_service_init(loop(), &iproto_thread->binary, "binary",
+			  iproto_on_accept, iproto_thread);
 
 
 	/* Init statistics counter */
-	rmean_net = rmean_new(rmean_net_strings, IPROTO_LAST);
+	iproto_thread->rmean = rmean_new(rmean_net_strings, IPROTO_LAST);
 
-	if (rmean_net == NULL) {
+	if (iproto_thread->rmean == NULL) {
 		tnt_raise(OutOfMemory, sizeof(struct rmean),
 			  "rmean", "struct rmean");
 	}
 
 	struct cbus_endpoint endpoint;
 	/* Create "net" endpoint. */
-	cbus_endpoint_create(&endpoint, "net", fiber_schedule_cb, fiber());
+	cbus_endpoint_create(&endpoint, tt_sprintf("net%d", iproto_thread->id),
+			     fiber_schedule_cb, fiber());
 	/* Create a pipe to "tx" thread. */
-	cpipe_create(&tx_pipe, "tx");
-	cpipe_set_max_input(&tx_pipe, iproto_msg_max / 2);
+	cpipe_create(&iproto_thread->tx_pipe, "tx");
+	cpipe_set_max_input(&iproto_thread->tx_pipe,
+			    iproto_thread->msg_max / 2);
 	/* Process incomming messages. */
 	cbus_loop(&endpoint);
 
-	cpipe_destroy(&tx_pipe);
+	cpipe_destroy(&iproto_thread->tx_pipe);
 	/*
 	 * Nothing to do in the fiber so far, the service
 	 * will take care of creating events for incoming
 	 * connections.
 	 */
-	if (evio_service_is_active(&binary))
-		evio_service_stop(&binary);
+	if (evio_service_is_active(&iproto_thread->binary))
+		evio_service_stop(&iproto_thread->binary);
 
-	rmean_delete(rmean_net);
+	rmean_delete(iproto_thread->rmean);
 	return 0;
 }
 
@@ -2132,11 +2349,11 @@ static void
 tx_begin_push(struct iproto_connection *con)
 {
 	assert(! con->tx.is_push_sent);
-	cmsg_init(&con->kharon.base, push_route);
+	cmsg_init(&con->kharon.base, con->iproto_thread->push_route);
 	iproto_wpos_create(&con->kharon.wpos, con->tx.p_obuf);
 	con->tx.is_push_pending = false;
 	con->tx.is_push_sent = true;
-	cpipe_push(&net_pipe, (struct cmsg *) &con->kharon);
+	cpipe_push(&con->iproto_thread->net_pipe, (struct cmsg *) &con->kharon);
 }
 
 static void
@@ -2184,18 +2401,92 @@ iproto_session_push(struct session *session, struct port *port)
 
 /** }}} */
 
-/** Initialize the iproto subsystem and start network io thread */
-void
-iproto_init(void)
+/** Set up the routes of a network thread. */
+static void
+iproto_thread_init_routes(struct iproto_thread *iproto_thread)
+{
+	struct cpipe *net_pipe = &iproto_thread->net_pipe;
+	struct cpipe *tx_pipe = &iproto_thread->tx_pipe;
+
+	iproto_thread->destroy_route[0] = { tx_process_destroy, net_pipe };
+	iproto_thread->destroy_route[1] = { net_finish_destroy, NULL };
+	iproto_thread->disconnect_route[0] =
+		{ tx_process_disconnect, net_pipe };
+	iproto_thread->disconnect_route[1] = { net_finish_disconnect, NULL };
+	iproto_thread->push_route[0] = { iproto_process_push, tx_pipe };
+	iproto_thread->push_route[1] = { tx_end_push, NULL };
+	iproto_thread->misc_route[0] = { tx_process_misc, net_pipe };
+	iproto_thread->misc_route[1] = { net_send_msg, NULL };
+	iproto_thread->call_route[0] = { tx_process_call, net_pipe };
+	iproto_thread->call_route[1] = { net_send_msg, NULL };
+	iproto_thread->select_route[0] = { tx_process_select, net_pipe };
+	iproto_thread->select_route[1] = { net_send_msg, NULL };
+	iproto_thread->process1_route[0] = { tx_process1, net_pipe };
+	iproto_thread->process1_route[1] = { net_send_msg, NULL };
+	iproto_thread->sql_route[0] = { tx_process_sql, net_pipe };
+	iproto_thread->sql_route[1] = { net_send_msg, NULL };
+	iproto_thread->join_route[0] = { tx_process_replication, net_pipe };
+	iproto_thread->join_route[1] = { net_end_join, NULL };
+	iproto_thread->subscribe_route[0] =
+		{ tx_process_replication, net_pipe };
+	iproto_thread->subscribe_route[1] = { net_end_subscribe, NULL };
+	iproto_thread->error_route[0] = { tx_reply_iproto_error, net_pipe };
+	iproto_thread->error_route[1] = { net_send_error, NULL };
+	iproto_thread->connect_route[0] = { tx_process_connect, net_pipe };
+	iproto_thread->connect_route[1] = { net_send_greeting, NULL };
+
+	const struct cmsg_hop **dml_route = iproto_thread->dml_route;
+	dml_route[IPROTO_OK] = NULL;
+	dml_route[IPROTO_SELECT] = iproto_thread->select_route;
+	dml_route[IPROTO_INSERT] = iproto_thread->process1_route;
+	dml_route[IPROTO_REPLACE] = iproto_thread->process1_route;
+	dml_route[IPROTO_UPDATE] = iproto_thread->process1_route;
+	dml_route[IPROTO_DELETE] = iproto_thread->process1_route;
+	dml_route[IPROTO_CALL_16] = iproto_thread->call_route;
+	dml_route[IPROTO_AUTH] = iproto_thread->misc_route;
+	dml_route[IPROTO_EVAL] = iproto_thread->call_route;
+	dml_route[IPROTO_UPSERT] = iproto_thread->process1_route;
+	dml_route[IPROTO_CALL] = iproto_thread->call_route;
+	dml_route[IPROTO_EXECUTE] = iproto_thread->sql_route;
+	dml_route[IPROTO_NOP] = NULL;
+	dml_route[IPROTO_PREPARE] = iproto_thread->sql_route;
+	dml_route[IPROTO_GET_MANY] = iproto_thread->select_route;
+}
+
+/** Initialize a network thread and start its cord. */
+static void
+iproto_thread_init(struct iproto_thread *iproto_thread, int id)
 {
-	slab_cache_create(&net_slabc, &runtime);
+	iproto_thread->id = id;
+	rlist_create(&iproto_thread->stopped_connections);
+	iproto_thread->msg_max = iproto_msg_max;
+	iproto_thread_init_routes(iproto_thread);
+	slab_cache_create(&iproto_thread->net_slabc, &runtime);
 
-	if (cord_costart(&net_cord, "iproto", net_cord_f, NULL))
+	if (cord_costart(&iproto_thread->net_cord, "iproto", net_cord_f,
+			 iproto_thread))
 		panic("failed to initialize iproto thread");
 
 	/* Create a pipe to "net" thread. */
-	cpipe_create(&net_pipe, "net");
-	cpipe_set_max_input(&net_pipe, iproto_msg_max / 2);
+	cpipe_create(&iproto_thread->net_pipe, tt_sprintf("net%d", id));
+	cpipe_set_max_input(&iproto_thread->net_pipe, iproto_msg_max / 2);
+}
+
+/** Initialize the iproto subsystem and start network io threads */
+void
+iproto_init(int threads_count)
+{
+	assert(threads_count > 0 && threads_count <= IPROTO_THREADS_MAX);
+	iproto_threads = (struct iproto_thread *)
+		calloc(threads_count, sizeof(*iproto_threads));
+	if (iproto_threads == NULL) {
+		panic("failed to allocate %d iproto threads",
+		      threads_count);
+	}
+	iproto_threads_count = threads_count;
+	for (int i = 0; i < threads_count; i++)
+		iproto_thread_init(&iproto_threads[i], i);
+
 	struct session_vtab iproto_session_vtab = {
 		/* .push = */ iproto_session_push,
 		/* .fd = */ iproto_session_fd,
@@ -2220,6 +2511,8 @@ struct iproto_cfg_msg: public cbus_call_msg
 {
 	/** Operation to execute in iproto thread. */
 	enum iproto_cfg_op op;
+	/** Thread to execute the operation in. */
+	struct iproto_thread *iproto_thread;
 	union {
 		struct {
 			/** New URI to bind to. */
@@ -2246,26 +2539,42 @@ static int
 iproto_do_cfg_f(struct cbus_call_msg *m)
 {
 	struct iproto_cfg_msg *cfg_msg = (struct iproto_cfg_msg *) m;
+	struct iproto_thread *iproto_thread = cfg_msg->iproto_thread;
+	struct evio_service *binary = &iproto_thread->binary;
 	int old;
 	try {
 		switch (cfg_msg->op) {
 		case IPROTO_CFG_MSG_MAX:
-			cpipe_set_max_input(&tx_pipe,
+			cpipe_set_max_input(&iproto_thread->tx_pipe,
 					    cfg_msg->iproto_msg_max / 2);
-			old = iproto_msg_max;
-			iproto_msg_max = cfg_msg->iproto_msg_max;
-			if (old < iproto_msg_max)
-				iproto_resume();
+			old = iproto_thread->msg_max;
+			iproto_thread->msg_max = cfg_msg->iproto_msg_max;
+			if (old < iproto_thread->msg_max)
+				iproto_resume(iproto_thread);
 			break;
 		case IPROTO_CFG_LISTEN:
-			if (evio_service_is_active(&binary))
-				evio_service_stop(&binary);
-			if (cfg_msg->uri != NULL &&
-			    (evio_service_bind(&binary, cfg_msg->uri) != 0 ||
-			     evio_service_listen(&binary) != 0))
-				diag_raise();
-			cfg_msg->addrlen = binary.addr_len;
-			cfg_msg->addr = binary.addrstorage;
+			if (evio_service_is_active(binary))
+				evio_service_stop(binary);
+			if (cfg_msg->uri == NULL) {
+				/* Only stop listening. */
+			} else if (iproto_thread->id == 0) {
+				if (evio_service_bind(binary,
+						      cfg_msg->uri) != 0 ||
+				    evio_service_listen(binary) != 0)
+					diag_raise();
+			} else {
+				/*
+				 * The first thread has already bound
+				 * the socket. Accept from the same
+				 * socket, so that the kernel spreads
+				 * new connections among the threads.
+				 */
+				if (evio_service_attach(binary,
+						&iproto_threads[0].binary) != 0)
+					diag_raise();
+			}
+			cfg_msg->addrlen = binary->addr_len;
+			cfg_msg->addr = binary->addrstorage;
 			break;
 		default:
 			unreachable();
@@ -2277,10 +2586,11 @@ iproto_do_cfg_f(struct cbus_call_msg *m)
 }
 
 static inline void
-iproto_do_cfg(struct iproto_cfg_msg *msg)
+iproto_do_cfg(struct iproto_thread *iproto_thread, struct iproto_cfg_msg *msg)
 {
-	if (cbus_call(&net_pipe, &tx_pipe, msg, iproto_do_cfg_f,
-		      NULL, TIMEOUT_INFINITY) != 0)
+	msg->iproto_thread = iproto_thread;
+	if (cbus_call(&iproto_thread->net_pipe, &iproto_thread->tx_pipe, msg,
+		      iproto_do_cfg_f, NULL, TIMEOUT_INFINITY) != 0)
 		diag_raise();
 }
 
@@ -2288,35 +2598,81 @@ void
 iproto_listen(const char *uri)
 {
 	struct iproto_cfg_msg cfg_msg;
-	iproto_cfg_msg_create(&cfg_msg, IPROTO_CFG_LISTEN);
-	cfg_msg.uri = uri;
-	iproto_do_cfg(&cfg_msg);
-	iproto_bound_address_storage = cfg_msg.addr;
-	iproto_bound_address_len = cfg_msg.addrlen;
+	/*
+	 * Stop all listeners first. The first thread goes last,
+	 * because the others accept from its socket.
+	 */
+	for (int i = iproto_threads_count - 1; i >= 0; i--) {
+		iproto_cfg_msg_create(&cfg_msg, IPROTO_CFG_LISTEN);
+		iproto_do_cfg(&iproto_threads[i], &cfg_msg);
+	}
+	iproto_bound_address_len = 0;
+	if (uri == NULL)
+		return;
+	for (int i = 0; i < iproto_threads_count; i++) {
+		iproto_cfg_msg_create(&cfg_msg, IPROTO_CFG_LISTEN);
+		cfg_msg.uri = uri;
+		iproto_do_cfg(&iproto_threads[i], &cfg_msg);
+		if (i == 0) {
+			iproto_bound_address_storage = cfg_msg.addr;
+			iproto_bound_address_len = cfg_msg.addrlen;
+		}
+	}
 }
 
 size_t
 iproto_mem_used(void)
 {
-	return slab_cache_used(&net_cord.slabc) + slab_cache_used(&net_slabc);
+	size_t mem = 0;
+	for (int i = 0; i < iproto_threads_count; i++) {
+		struct iproto_thread *iproto_thread = &iproto_threads[i];
+		mem += slab_cache_used(&iproto_thread->net_cord.slabc) +
+		       slab_cache_used(&iproto_thread->net_slabc);
+	}
+	return mem;
 }
 
 size_t
 iproto_connection_count(void)
 {
-	return mempool_count(&iproto_connection_pool);
+	size_t count = 0;
+	for (int i = 0; i < iproto_threads_count; i++)
+		count += mempool_count(&iproto_threads[i].iproto_connection_pool);
+	return count;
 }
 
 size_t
 iproto_request_count(void)
 {
-	return mempool_count(&iproto_msg_pool);
+	size_t count = 0;
+	for (int i = 0; i < iproto_threads_count; i++)
+		count += mempool_count(&iproto_threads[i].iproto_msg_pool);
+	return count;
+}
+
+int
+iproto_rmean_foreach(rmean_cb cb, void *cb_ctx)
+{
+	for (size_t name = 0; name < IPROTO_LAST; name++) {
+		int64_t mean = 0;
+		int64_t total = 0;
+		for (int i = 0; i < iproto_threads_count; i++) {
+			struct rmean *rmean = iproto_threads[i].rmean;
+			mean += rmean_mean(rmean, name);
+			total += rmean_total(rmean, name);
+		}
+		int rc = cb(rmean_net_strings[name], mean, total, cb_ctx);
+		if (rc != 0)
+			return rc;
+	}
+	return 0;
 }
 
 void
 iproto_reset_stat(void)
 {
-	rmean_cleanup(rmean_net);
+	for (int i = 0; i < iproto_threads_count; i++)
+		rmean_cleanup(iproto_threads[i].rmean);
 }
 
 void
@@ -2328,22 +2684,30 @@ iproto_set_msg_max(int new_iproto_msg_max)
 				     IPROTO_MSG_MAX_MIN));
 	}
 	struct iproto_cfg_msg cfg_msg;
-	iproto_cfg_msg_create(&cfg_msg, IPROTO_CFG_MSG_MAX);
-	cfg_msg.iproto_msg_max = new_iproto_msg_max;
-	iproto_do_cfg(&cfg_msg);
-	cpipe_set_max_input(&net_pipe, new_iproto_msg_max / 2);
+	for (int i = 0; i < iproto_threads_count; i++) {
+		struct iproto_thread *iproto_thread = &iproto_threads[i];
+		iproto_cfg_msg_create(&cfg_msg, IPROTO_CFG_MSG_MAX);
+		cfg_msg.iproto_msg_max = new_iproto_msg_max;
+		iproto_do_cfg(iproto_thread, &cfg_msg);
+		cpipe_set_max_input(&iproto_thread->net_pipe,
+				    new_iproto_msg_max / 2);
+	}
+	iproto_msg_max = new_iproto_msg_max;
 }
 
 void
 iproto_free(void)
 {
-	tt_pthread_cancel(net_cord.id);
-	tt_pthread_join(net_cord.id, NULL);
-	/*
-	* Close socket descriptor to prevent hot standby instance
-	* failing to bind in case it tries to bind before socket
-	* is closed by OS.
-	*/
-	if (evio_service_is_active(&binary))
-		close(binary.ev.fd);
+	for (int i = 0; i < iproto_threads_count; i++) {
+		struct iproto_thread *iproto_thread = &iproto_threads[i];
+		tt_pthread_cancel(iproto_thread->net_cord.id);
+		tt_pthread_join(iproto_thread->net_cord.id, NULL);
+		/*
+		 * Close socket descriptor to prevent hot standby
+		 * instance failing to bind in case it tries to
+		 * bind before socket is closed by OS.
+		 */
+		if (evio_service_is_active(&iproto_thread->binary))
+			close(iproto_thread->binary.ev.fd);
+	}
 }
@@ -33,6 +33,8 @@
 
 #include <stddef.h>
 
+#include "rmean.h"
+
 #if defined(__cplusplus)
 extern "C" {
 #endif /* defined(__cplusplus) */
@@ -52,10 +54,15 @@ enum {
 	 * processing stops until some new fibers are freed up.
 	 */
 	IPROTO_FIBER_POOL_SIZE_FACTOR = 5,
+	/** Maximal number of iproto network threads. */
+	IPROTO_THREADS_MAX = 1000,
 };
 
 extern unsigned iproto_readahead;
 
+/** Number of iproto network threads. */
+extern int iproto_threads_count;
+
 /**
  * Return size of memory used for storing network buffers.
  */
@@ -74,6 +81,13 @@ iproto_connection_count(void);
 size_t
 iproto_request_count(void);
 
+/**
+ * Invoke @a cb for each network statistics counter, summed up
+ * over all iproto threads. See rmean_foreach().
+ */
+int
+iproto_rmean_foreach(rmean_cb cb, void *cb_ctx);
+
 /**
  * Reset network statistics.
  */
@@ -90,8 +104,12 @@ iproto_bound_address(void);
 #if defined(__cplusplus)
 } /* extern "C" */
 
+/**
+ * Initialize the iproto subsystem and start @a threads_count
+ * network threads.
+ */
 void
-iproto_init(void);
+iproto_init(int threads_count);
 
 void
 iproto_listen(const char *uri);
@@ -108,6 +108,7 @@ const char *iproto_type_strs[] =
 	"EXECUTE",
 	NULL, /* NOP */
 	"PREPARE",
+	NULL, /* GET_MANY */
 };
 
 #define bit(c) (1ULL<<IPROTO_##c)
@@ -126,6 +127,7 @@ const uint64_t iproto_body_key_map[IPROTO_TYPE_STAT_MAX] = {
 	0,                                                     /* EXECUTE */
 	0,                                                     /* NOP */
 	0,                                                     /* PREPARE */
+	bit(SPACE_ID) | bit(KEY),                              /* GET_MANY */
 };
 #undef bit
 
@@ -207,7 +209,9 @@ const char *vy_page_info_key_strs[VY_PAGE_INFO_KEY_MAX] = {
 	"unpacked size",
 	"row count",
 	"min key",
-	"row index offset"
+	"row index offset",
+	"filter",
+	"key index offset",
 };
 
 const char *vy_run_info_key_strs[VY_RUN_INFO_KEY_MAX] = {
@@ -220,9 +224,20 @@ const char *vy_run_info_key_strs[VY_RUN_INFO_KEY_MAX] = {
 	"bloom filter legacy",
 	"bloom filter",
 	"stmt stat",
+	"blocked bloom filter",
+	"dictionary",
+	"split id",
 };
 
 const char *vy_row_index_key_strs[VY_ROW_INDEX_KEY_MAX] = {
 	NULL,
 	"row index",
 };
+
+const char *vy_key_index_key_strs[VY_KEY_INDEX_KEY_MAX] = {
+	NULL,
+	"restart interval",
+	"max key size",
+	"restarts",
+	"data",
+};
@@ -127,6 +127,12 @@ enum iproto_key {
 	IPROTO_REPLICA_ANON = 0x50,
 	IPROTO_ID_FILTER = 0x51,
 	IPROTO_ERROR = 0x52,
+	/**
+	 * Set in SUBSCRIBE request if the replica wants the
+	 * replication stream to be compressed and in SUBSCRIBE
+	 * response if the master compresses it.
+	 */
+	IPROTO_REPLICA_COMPRESSION = 0x53,
 	IPROTO_KEY_MAX
 };
 
@@ -217,6 +223,8 @@ enum iproto_type {
 	IPROTO_NOP = 12,
 	/** Prepare SQL statement. */
 	IPROTO_PREPARE = 13,
+	/** Look up several keys in a unique index at once. */
+	IPROTO_GET_MANY = 14,
 	/** The maximum typecode used for box.stat() */
 	IPROTO_TYPE_STAT_MAX,
 
@@ -248,6 +256,8 @@ enum iproto_type {
 	VY_INDEX_PAGE_INFO = 101,
 	/** Vinyl row index stored in .run file */
 	VY_RUN_ROW_INDEX = 102,
+	/** Vinyl key index stored in .run file */
+	VY_RUN_KEY_INDEX = 103,
 
 	/** Non-final response type. */
 	IPROTO_CHUNK = 128,
@@ -277,10 +287,13 @@ iproto_type_name(uint32_t type)
 {
 	/*
 	 * Sic: iptoto_type_strs[IPROTO_NOP] is NULL
-	 * to suppress box.stat() output.
+	 * to suppress box.stat() output. GET_MANY is
+	 * accounted as SELECT.
 	 */
 	if (type == IPROTO_NOP)
 		return "NOP";
+	if (type == IPROTO_GET_MANY)
+		return "GET_MANY";
 
 	if (type < IPROTO_TYPE_STAT_MAX)
 		return iproto_type_strs[type];
@@ -296,6 +309,8 @@ iproto_type_name(uint32_t type)
 		return "PAGEINFO";
 	case VY_RUN_ROW_INDEX:
 		return "ROWINDEX";
+	case VY_RUN_KEY_INDEX:
+		return "KEYINDEX";
 	default:
 		return NULL;
 	}
@@ -319,7 +334,8 @@ static inline bool
 iproto_type_is_dml(uint32_t type)
 {
 	return (type >= IPROTO_SELECT && type <= IPROTO_DELETE) ||
-		type == IPROTO_UPSERT || type == IPROTO_NOP;
+		type == IPROTO_UPSERT || type == IPROTO_NOP ||
+		type == IPROTO_GET_MANY;
 }
 
 /**
@@ -396,6 +412,12 @@ enum vy_run_info_key {
 	VY_RUN_INFO_BLOOM = 7,
 	/** Number of statements of each type (map). */
 	VY_RUN_INFO_STMT_STAT = 8,
+	/** Blocked bloom filter for keys. */
+	VY_RUN_INFO_BLOOM_BLOCKED = 9,
+	/** Zstd dictionary used to compress the run pages. */
+	VY_RUN_INFO_DICT = 10,
+	/** ID shared by runs written by a split compaction. */
+	VY_RUN_INFO_SPLIT_ID = 11,
 	/** The last key in this enum + 1 */
 	VY_RUN_INFO_KEY_MAX
 };
@@ -430,6 +452,10 @@ enum vy_page_info_key {
 	VY_PAGE_INFO_MIN_KEY = 5,
 	/** Offset of the row index in the page. */
 	VY_PAGE_INFO_ROW_INDEX_OFFSET = 6,
+	/** Xor filter over the page keys: [seed, fingerprints]. */
+	VY_PAGE_INFO_FILTER = 7,
+	/** Offset of the key index in the page. */
+	VY_PAGE_INFO_KEY_INDEX_OFFSET = 8,
 	/** The last key in this enum + 1 */
 	VY_PAGE_INFO_KEY_MAX
 };
@@ -471,6 +497,36 @@ vy_row_index_key_name(enum vy_row_index_key key)
 	return vy_row_index_key_strs[key];
 }
 
+/**
+ * Xrow keys for Vinyl key index.
+ * @sa struct vy_page_key_index.
+ */
+enum vy_key_index_key {
+	/** Number of keys between two restart points. */
+	VY_KEY_INDEX_RESTART_INTERVAL = 1,
+	/** Max size of a key stored in the index. */
+	VY_KEY_INDEX_MAX_KEY_SIZE = 2,
+	/** Array of restart point offsets. */
+	VY_KEY_INDEX_RESTARTS = 3,
+	/** Front-coded keys. */
+	VY_KEY_INDEX_DATA = 4,
+	/** The last key in this enum + 1 */
+	VY_KEY_INDEX_KEY_MAX
+};
+
+/**
+ * Return vy_key_index key name by @a key code.
+ * @param key key
+ */
+static inline const char *
+vy_key_index_key_name(enum vy_key_index_key key)
+{
+	if (key <= 0 || key >= VY_KEY_INDEX_KEY_MAX)
+		return NULL;
+	extern const char *vy_key_index_key_strs[];
+	return vy_key_index_key_strs[key];
+}
+
 #if defined(__cplusplus)
 } /* extern "C" */
 #endif
@@ -38,6 +38,7 @@
 
 #include "box/applier.h"
 #include "box/relay.h"
+#include "box/xrow_io.h"
 #include "box/iproto.h"
 #include "box/wal.h"
 #include "box/replication.h"
@@ -107,6 +108,20 @@ lbox_pushapplier(lua_State *L, struct applier *applier)
 			       applier->last_row_time);
 		lua_settable(L, -3);
 
+		lua_pushstring(L, "apply_lag");
+		lua_pushnumber(L, applier->apply_lag);
+		lua_settable(L, -3);
+
+		/*
+		 * Transactions received from the master, but
+		 * not written to WAL yet.
+		 */
+		lua_pushstring(L, "queue");
+		lua_pushinteger(L, applier->tx_queue_size +
+				applier->apply_job_count +
+				applier->wal_queue_size);
+		lua_settable(L, -3);
+
 		char name[APPLIER_SOURCE_MAXLEN];
 		int total = uri_format(name, sizeof(name), &applier->uri, false);
 		/*
@@ -142,6 +157,19 @@ lbox_pushrelay(lua_State *L, struct relay *relay)
 		lua_pushnumber(L, ev_monotonic_now(loop()) -
 			       relay_last_row_time(relay));
 		lua_settable(L, -3);
+		const struct xrow_compressor *c = relay_compressor(relay);
+		if (c != NULL) {
+			lua_pushstring(L, "compression");
+			lua_newtable(L);
+			lua_pushstring(L, "ratio");
+			lua_pushnumber(L, c->size > 0 ?
+				       (double)c->raw_size / c->size : 1);
+			lua_settable(L, -3);
+			lua_pushstring(L, "time");
+			lua_pushnumber(L, c->time);
+			lua_settable(L, -3);
+			lua_settable(L, -3);
+		}
 		break;
 	case RELAY_STOPPED:
 	{
@@ -42,6 +42,7 @@ local default_cfg = {
     strip_core          = true,
     memtx_min_tuple_size = 16,
     memtx_max_tuple_size = 1024 * 1024,
+    memtx_recovery_threads = 1,
     granularity         = 8,
     slab_alloc_factor   = 1.05,
     work_dir            = nil,
@@ -55,6 +56,10 @@ local default_cfg = {
     vinyl_read_threads  = 1,
     vinyl_write_threads = 4,
     vinyl_timeout       = 60,
+    vinyl_parallel_lookup = false,
+    vinyl_compaction_parts = 1,
+    vinyl_page_cache    = 0,
+    vinyl_page_cache_compressed = false,
     vinyl_run_count_per_level = 2,
     vinyl_run_size_ratio      = 3.5,
     vinyl_range_size          = nil, -- set automatically
@@ -72,6 +77,8 @@ local default_cfg = {
     wal_mode            = "write",
     wal_max_size        = 256 * 1024 * 1024,
     wal_dir_rescan_delay= 2,
+    wal_group_commit_timeout = 0,
+    wal_group_commit_size = 1024 * 1024,
     force_recovery      = false,
     replication         = nil,
     instance_uuid       = nil,
@@ -95,15 +102,20 @@ local default_cfg = {
     replication_sync_timeout = 300,
     replication_synchro_quorum = 1,
     replication_synchro_timeout = 5,
+    replication_synchro_ack_window = 0,
     replication_connect_timeout = 30,
     replication_connect_quorum = nil, -- connect all
     replication_skip_conflict = false,
+    replication_apply_fibers = 1,
+    replication_compression = false,
+    replication_relay_fanout = false,
     replication_anon      = false,
     feedback_enabled      = true,
     feedback_crashinfo    = true,
     feedback_host         = "https://feedback.tarantool.io",
     feedback_interval     = 3600,
     net_msg_max           = 768,
+    iproto_threads        = 1,
     sql_cache_size        = 5 * 1024 * 1024,
 }
 
@@ -124,6 +136,7 @@ local template_cfg = {
     strip_core          = 'boolean',
     memtx_min_tuple_size  = 'number',
     memtx_max_tuple_size  = 'number',
+    memtx_recovery_threads = 'number',
     granularity         = 'number',
     slab_alloc_factor   = 'number',
     work_dir            = 'string',
@@ -136,6 +149,10 @@ local template_cfg = {
     vinyl_read_threads        = 'number',
     vinyl_write_threads       = 'number',
     vinyl_timeout             = 'number',
+    vinyl_parallel_lookup     = 'boolean',
+    vinyl_compaction_parts    = 'number',
+    vinyl_page_cache          = 'number',
+    vinyl_page_cache_compressed = 'boolean',
     vinyl_run_count_per_level = 'number',
     vinyl_run_size_ratio      = 'number',
     vinyl_range_size          = 'number',
@@ -154,6 +171,8 @@ local template_cfg = {
     wal_mode            = 'string',
     wal_max_size        = 'number',
     wal_dir_rescan_delay= 'number',
+    wal_group_commit_timeout = 'number',
+    wal_group_commit_size = 'number',
     force_recovery      = 'boolean',
     replication         = 'string, number, table',
     instance_uuid       = 'string',
@@ -177,15 +196,20 @@ local template_cfg = {
     replication_sync_timeout = 'number',
     replication_synchro_quorum = 'string, number',
     replication_synchro_timeout = 'number',
+    replication_synchro_ack_window = 'number',
     replication_connect_timeout = 'number',
     replication_connect_quorum = 'number',
     replication_skip_conflict = 'boolean',
+    replication_apply_fibers = 'number',
+    replication_compression = 'boolean',
+    replication_relay_fanout = 'boolean',
     replication_anon      = 'boolean',
     feedback_enabled      = ifdef_feedback('boolean'),
     feedback_crashinfo    = ifdef_feedback('boolean'),
     feedback_host         = ifdef_feedback('string'),
     feedback_interval     = ifdef_feedback('number'),
     net_msg_max           = 'number',
+    iproto_threads        = 'number',
     sql_cache_size        = 'number',
 }
 
@@ -276,9 +300,15 @@ local dynamic_cfg = {
     vinyl_max_tuple_size    = private.cfg_set_vinyl_max_tuple_size,
     vinyl_cache             = private.cfg_set_vinyl_cache,
     vinyl_timeout           = private.cfg_set_vinyl_timeout,
+    vinyl_parallel_lookup   = private.cfg_set_vinyl_parallel_lookup,
+    vinyl_compaction_parts  = private.cfg_set_vinyl_compaction_parts,
+    vinyl_page_cache        = private.cfg_set_vinyl_page_cache,
+    vinyl_page_cache_compressed = private.cfg_set_vinyl_page_cache,
     checkpoint_count        = private.cfg_set_checkpoint_count,
     checkpoint_interval     = private.cfg_set_checkpoint_interval,
     checkpoint_wal_threshold = private.cfg_set_checkpoint_wal_threshold,
+    wal_group_commit_timeout = private.cfg_set_wal_group_commit,
+    wal_group_commit_size   = private.cfg_set_wal_group_commit,
     worker_pool_threads     = private.cfg_set_worker_pool_threads,
     feedback_enabled        = ifdef_feedback_set_params,
     feedback_crashinfo      = ifdef_feedback_set_params,
@@ -299,7 +329,11 @@ local dynamic_cfg = {
     replication_sync_timeout = private.cfg_set_replication_sync_timeout,
     replication_synchro_quorum = private.cfg_set_replication_synchro_quorum,
     replication_synchro_timeout = private.cfg_set_replication_synchro_timeout,
+    replication_synchro_ack_window = private.cfg_set_replication_synchro_ack_window,
     replication_skip_conflict = private.cfg_set_replication_skip_conflict,
+    replication_apply_fibers = private.cfg_set_replication_apply_fibers,
+    replication_compression = private.cfg_set_replication_compression,
+    replication_relay_fanout = private.cfg_set_replication_relay_fanout,
     replication_anon        = private.cfg_set_replication_anon,
     instance_uuid           = check_instance_uuid,
     replicaset_uuid         = check_replicaset_uuid,
@@ -334,6 +368,7 @@ local dynamic_cfg_order = {
     replication_sync_timeout    = 150,
     replication_synchro_quorum  = 150,
     replication_synchro_timeout = 150,
+    replication_synchro_ack_window = 150,
     replication_connect_timeout = 150,
     replication_connect_quorum  = 150,
     replication             = 200,
@@ -364,6 +399,10 @@ local dynamic_cfg_skip_at_load = {
     vinyl_max_tuple_size    = true,
     vinyl_cache             = true,
     vinyl_timeout           = true,
+    vinyl_parallel_lookup   = true,
+    vinyl_compaction_parts  = true,
+    vinyl_page_cache        = true,
+    vinyl_page_cache_compressed = true,
     too_long_threshold      = true,
     election_mode           = true,
     election_timeout        = true,
@@ -375,7 +414,11 @@ local dynamic_cfg_skip_at_load = {
     replication_sync_timeout = true,
     replication_synchro_quorum = true,
     replication_synchro_timeout = true,
+    replication_synchro_ack_window = true,
     replication_skip_conflict = true,
+    replication_apply_fibers = true,
+    replication_compression = true,
+    replication_relay_fanout = true,
     replication_anon        = true,
     wal_dir_rescan_delay    = true,
     custom_proc_title       = true,
@@ -101,10 +101,12 @@ port_msgpack_dump_lua(struct port *base, struct lua_State *L, bool is_flat)
 static int
 lbox_select(lua_State *L)
 {
-	if (lua_gettop(L) != 6 || !lua_isnumber(L, 1) || !lua_isnumber(L, 2) ||
-		!lua_isnumber(L, 3) || !lua_isnumber(L, 4) || !lua_isnumber(L, 5)) {
+	int argc = lua_gettop(L);
+	if ((argc != 6 && argc != 7) || !lua_isnumber(L, 1) ||
+	    !lua_isnumber(L, 2) || !lua_isnumber(L, 3) ||
+	    !lua_isnumber(L, 4) || !lua_isnumber(L, 5)) {
 		return luaL_error(L, "Usage index:select(iterator, offset, "
-				  "limit, key)");
+				  "limit, key[, no_cache])");
 	}
 
 	uint32_t space_id = lua_tonumber(L, 1);
@@ -115,10 +117,11 @@ lbox_select(lua_State *L)
 
 	size_t key_len;
 	const char *key = lbox_encode_tuple_on_gc(L, 6, &key_len);
+	bool no_cache = argc == 7 && lua_toboolean(L, 7);
 
 	struct port port;
-	if (box_select(space_id, index_id, iterator, offset, limit,
-		       key, key + key_len, &port) != 0) {
+	if (box_select_ex(space_id, index_id, iterator, offset, limit,
+			  key, key + key_len, no_cache, &port) != 0) {
 		return luaT_error(L);
 	}
 
@@ -138,6 +141,34 @@ lbox_select(lua_State *L)
 
 /* }}} */
 
+/** {{{ Lua/C implementation of index:get_many() **/
+
+static int
+lbox_get_many(lua_State *L)
+{
+	if (lua_gettop(L) != 3 || !lua_isnumber(L, 1) || !lua_isnumber(L, 2) ||
+	    !lua_istable(L, 3)) {
+		return luaL_error(L, "Usage index:get_many(keys)");
+	}
+
+	uint32_t space_id = lua_tonumber(L, 1);
+	uint32_t index_id = lua_tonumber(L, 2);
+
+	size_t keys_len;
+	const char *keys = lbox_encode_tuple_on_gc(L, 3, &keys_len);
+
+	struct port port;
+	if (box_get_many(space_id, index_id, keys, keys + keys_len,
+			 &port) != 0) {
+		return luaT_error(L);
+	}
+	port_dump_lua(&port, L, false);
+	port_destroy(&port);
+	return 1; /* lua table with tuples */
+}
+
+/* }}} */
+
 /** {{{ Utils to work with tuple_format. **/
 
 struct tuple_format *
@@ -252,6 +283,7 @@ box_lua_misc_init(struct lua_State *L)
 {
 	static const struct luaL_Reg boxlib_internal[] = {
 		{"select", lbox_select},
+		{"get_many", lbox_get_many},
 		{"new_tuple_format", lbox_tuple_format_new},
 		{NULL, NULL}
 	};
@@ -113,6 +113,7 @@ local method_encoder = {
     prepare = internal.encode_prepare,
     unprepare = internal.encode_prepare,
     get     = internal.encode_select,
+    get_many = internal.encode_get_many,
     min     = internal.encode_select,
     max     = internal.encode_select,
     count   = internal.encode_call,
@@ -139,6 +140,7 @@ local method_decoder = {
     prepare = internal.decode_prepare,
     unprepare = decode_nil,
     get     = decode_get,
+    get_many = internal.decode_select,
     min     = decode_get,
     max     = decode_get,
     count   = decode_count,
@@ -1501,6 +1503,11 @@ space_metatable = function(remote)
         return check_primary_index(self):get(key, opts)
     end
 
+    function methods:get_many(keys, opts)
+        check_space_arg(self, 'get_many')
+        return check_primary_index(self):get_many(keys, opts)
+    end
+
     function methods:format(format)
         if format == nil then
             return self._format
@@ -1538,6 +1545,15 @@ index_metatable = function(remote)
                                                box.index.EQ, 0, 2, key))
     end
 
+    function methods:get_many(keys, opts)
+        check_index_arg(self, 'get_many')
+        if type(keys) ~= 'table' then
+            error("Usage: index:get_many(keys)")
+        end
+        return (remote:_request('get_many', opts, self.space._format_cdata,
+                                self.space.id, self.id, keys))
+    end
+
     function methods:min(key, opts)
         check_index_arg(self, 'min')
         if opts and opts.buffer then
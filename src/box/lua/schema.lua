@@ -1050,6 +1050,11 @@ local index_options = {
     range_size = 'number',
     page_size = 'number',
     bloom_fpr = 'number',
+    compaction_policy = 'string',
+    page_filter = 'boolean',
+    page_key_index = 'boolean',
+    compression_dict_size = 'number',
+    quota_class = 'string',
     func = 'number, string',
     hint = 'boolean',
 }
@@ -1197,6 +1202,11 @@ box.schema.index.create = function(space_id, name, options)
             run_count_per_level = options.run_count_per_level,
             run_size_ratio = options.run_size_ratio,
             bloom_fpr = options.bloom_fpr,
+            compaction_policy = options.compaction_policy,
+            page_filter = options.page_filter,
+            page_key_index = options.page_key_index,
+            compression_dict_size = options.compression_dict_size,
+            quota_class = options.quota_class,
             func = options.func,
             hint = options.hint,
     }
@@ -1898,6 +1908,18 @@ base_index_mt.get_luac = function(index, key)
     return internal.get(index.space_id, index.id, key)
 end
 
+base_index_mt.get_many = function(index, keys)
+    check_index_arg(index, 'get_many')
+    if type(keys) ~= 'table' then
+        box.error(box.error.PROC_LUA, "Usage: index:get_many(keys)")
+    end
+    local converted = {}
+    for i, key in ipairs(keys) do
+        converted[i] = keify(key)
+    end
+    return internal.get_many(index.space_id, index.id, converted)
+end
+
 local function check_select_opts(opts, key_is_nil)
     local offset = 0
     local limit = 4294967295
@@ -1939,8 +1961,9 @@ base_index_mt.select_luac = function(index, key, opts)
     check_index_arg(index, 'select')
     local key = keify(key)
     local iterator, offset, limit = check_select_opts(opts, #key == 0)
+    local no_cache = type(opts) == 'table' and opts.cache == false
     return internal.select(index.space_id, index.id, iterator,
-        offset, limit, key)
+        offset, limit, key, no_cache)
 end
 
 base_index_mt.update = function(index, key, ops)
@@ -2017,6 +2040,10 @@ space_mt.get = function(space, key)
     check_space_arg(space, 'get')
     return check_primary_index(space):get(key)
 end
+space_mt.get_many = function(space, keys)
+    check_space_arg(space, 'get_many')
+    return check_primary_index(space):get_many(keys)
+end
 space_mt.select = function(space, key, opts)
     check_space_arg(space, 'select')
     return check_primary_index(space):select(key, opts)
@@ -439,6 +439,36 @@ lbox_fillspace(struct lua_State *L, struct space *space, int i)
 			lua_pushnumber(L, index_opts->bloom_fpr);
 			lua_setfield(L, -2, "bloom_fpr");
 
+			if (index_opts->compaction_policy !=
+			    INDEX_COMPACTION_POLICY_HYBRID) {
+				lua_pushstring(L, index_compaction_policy_strs[
+					index_opts->compaction_policy]);
+				lua_setfield(L, -2, "compaction_policy");
+			}
+
+			if (index_opts->page_filter) {
+				lua_pushboolean(L, true);
+				lua_setfield(L, -2, "page_filter");
+			}
+
+			if (index_opts->page_key_index) {
+				lua_pushboolean(L, true);
+				lua_setfield(L, -2, "page_key_index");
+			}
+
+			if (index_opts->compression_dict_size != 0) {
+				lua_pushnumber(L,
+					index_opts->compression_dict_size);
+				lua_setfield(L, -2, "compression_dict_size");
+			}
+
+			if (index_opts->quota_class !=
+			    INDEX_QUOTA_CLASS_NORMAL) {
+				lua_pushstring(L, index_quota_class_strs[
+					index_opts->quota_class]);
+				lua_setfield(L, -2, "quota_class");
+			}
+
 			lua_settable(L, -3);
 		}
 		lua_setfield(L, -2, index_def->name);
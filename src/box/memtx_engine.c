@@ -36,6 +36,7 @@
 #include <small/mempool.h>
 
 #include "fiber.h"
+#include "cbus.h"
 #include "errinj.h"
 #include "coio_file.h"
 #include "tuple.h"
@@ -128,6 +129,159 @@ memtx_build_secondary_keys(struct space *space, void *param)
 	return 0;
 }
 
+/** Spaces whose secondary keys are built in parallel. */
+struct memtx_build_state {
+	struct memtx_engine *memtx;
+	struct space **spaces;
+	int space_count;
+	/** Total number of secondary keys of the spaces. */
+	int index_count;
+};
+
+static int
+memtx_collect_secondary_keys(struct space *space, void *param)
+{
+	struct memtx_build_state *state = param;
+	struct memtx_space *memtx_space = (struct memtx_space *)space;
+	if (space->engine != (struct engine *)state->memtx ||
+	    space_index(space, 0) == NULL ||
+	    memtx_space->replace == memtx_space_replace_all_keys)
+		return 0;
+	size_t size = (state->space_count + 1) * sizeof(*state->spaces);
+	struct space **spaces = realloc(state->spaces, size);
+	if (spaces == NULL) {
+		diag_set(OutOfMemory, size, "realloc", "spaces");
+		return -1;
+	}
+	spaces[state->space_count++] = space;
+	state->spaces = spaces;
+	if (space->index_id_max > 0)
+		state->index_count += space->index_count - 1;
+	return 0;
+}
+
+static void *
+memtx_sort_build_array_f(void *arg)
+{
+	memtx_tree_index_sort_build_array(arg);
+	return NULL;
+}
+
+/**
+ * Sort keys of the given tree indexes in parallel and finish
+ * building them.
+ */
+static int
+memtx_end_build_secondary_keys(struct index **indexes, int count)
+{
+	struct cord *cords = NULL;
+	int cord_count = 0;
+	if (count > 1) {
+		size_t size = (count - 1) * sizeof(*cords);
+		cords = malloc(size);
+		if (cords == NULL) {
+			diag_set(OutOfMemory, size, "malloc", "cords");
+			return -1;
+		}
+	}
+	int rc = 0;
+	for (int i = 1; i < count; i++) {
+		if (cord_start(&cords[i - 1], "memtx.build",
+			       memtx_sort_build_array_f, indexes[i]) != 0) {
+			rc = -1;
+			break;
+		}
+		cord_count++;
+	}
+	/* Use the tx thread for one of the indexes, too. */
+	if (count > 0)
+		memtx_tree_index_sort_build_array(indexes[0]);
+	for (int i = 0; i < cord_count; i++) {
+		if (cord_join(&cords[i]) != 0)
+			rc = -1;
+	}
+	free(cords);
+	if (rc != 0)
+		return -1;
+	for (int i = 0; i < count; i++)
+		index_end_build(indexes[i]);
+	return 0;
+}
+
+/**
+ * Build secondary keys of all spaces after recovery using
+ * memtx_engine::recovery_threads threads.
+ *
+ * Keys of tree indexes are collected in the tx thread, but
+ * sorted, which takes most of the time, in worker threads,
+ * one index per thread. To limit memory usage, no more indexes
+ * than there are threads are being built at the same time.
+ * Other index types are built in the tx thread.
+ */
+static int
+memtx_build_all_secondary_keys(struct memtx_engine *memtx)
+{
+	if (memtx->recovery_threads <= 1)
+		return space_foreach(memtx_build_secondary_keys, memtx);
+
+	struct memtx_build_state state;
+	state.memtx = memtx;
+	state.spaces = NULL;
+	state.space_count = 0;
+	state.index_count = 0;
+	int batch_size = 0;
+	int rc = -1;
+	size_t size = memtx->recovery_threads * sizeof(struct index *);
+	struct index **batch = malloc(size);
+	if (batch == NULL) {
+		diag_set(OutOfMemory, size, "malloc", "batch");
+		return -1;
+	}
+	if (space_foreach(memtx_collect_secondary_keys, &state) != 0)
+		goto out;
+	if (state.index_count > 0) {
+		say_info("Building secondary indexes using %d threads...",
+			 memtx->recovery_threads);
+	}
+	for (int i = 0; i < state.space_count; i++) {
+		struct space *space = state.spaces[i];
+		if (space->index_id_max == 0)
+			continue;
+		struct index *pk = space->index[0];
+		for (uint32_t j = 1; j < space->index_count; j++) {
+			struct index *index = space->index[j];
+			if (index->def->type != TREE) {
+				if (index_build(index, pk) != 0)
+					goto out;
+				continue;
+			}
+			if (index_build_keys(index, pk) != 0)
+				goto out;
+			batch[batch_size++] = index;
+			if (batch_size < memtx->recovery_threads)
+				continue;
+			if (memtx_end_build_secondary_keys(batch,
+							   batch_size) != 0)
+				goto out;
+			batch_size = 0;
+		}
+	}
+	if (memtx_end_build_secondary_keys(batch, batch_size) != 0)
+		goto out;
+	for (int i = 0; i < state.space_count; i++) {
+		struct memtx_space *memtx_space =
+			(struct memtx_space *)state.spaces[i];
+		memtx_space->replace = memtx_space_replace_all_keys;
+	}
+	if (state.index_count > 0)
+		say_info("Building secondary indexes: done");
+	rc = 0;
+out:
+	free(batch);
+	free(state.spaces);
+	return rc;
+}
+
 static void
 memtx_engine_shutdown(struct engine *engine)
 {
@@ -152,6 +306,349 @@ static int
 memtx_engine_recover_snapshot_row(struct memtx_engine *memtx,
 				  struct xrow_header *row, int *is_space_system);
 
+static int
+memtx_engine_recover_snapshot_request(struct memtx_engine *memtx,
+				      struct request *request);
+
+enum {
+	/** Max number of rows in a snapshot batch. */
+	MEMTX_SNAP_BATCH_ROWS = 1024,
+	/** Size of the row data buffer of a snapshot batch. */
+	MEMTX_SNAP_BATCH_DATA = 256 * 1024,
+	/** Max number of snapshot batches sent to tx at a time. */
+	MEMTX_SNAP_BATCHES_MAX = 16,
+};
+
+/** A snapshot row read and decoded by the snapshot reader. */
+struct memtx_snap_row {
+	struct xrow_header row;
+	/** DML request decoded from the row, if is_decoded is set. */
+	struct request request;
+	/**
+	 * Set if the row is an INSERT that was successfully
+	 * decoded by the reader. Other rows are decoded in tx,
+	 * which also takes care of reporting decode errors.
+	 */
+	bool is_decoded;
+};
+
+/** A batch of snapshot rows sent from the reader to tx. */
+struct memtx_snap_batch {
+	struct cmsg base;
+	struct memtx_snap_reader *reader;
+	/** Set by tx if the reader should stop reading. */
+	bool is_stopped;
+	int row_count;
+	struct memtx_snap_row rows[MEMTX_SNAP_BATCH_ROWS];
+	/** Row bodies, referenced by rows. */
+	size_t data_size;
+	size_t data_used;
+	char data[0];
+};
+
+/**
+ * Snapshot reader. Reads snapshot rows in a separate thread,
+ * which takes care of reading the file, decompression, checksum
+ * verification and decoding, and sends them in batches to tx,
+ * which only has to apply them.
+ */
+struct memtx_snap_reader {
+	struct memtx_engine *memtx;
+	char filename[PATH_MAX];
+	int64_t signature;
+	/** Reader thread. */
+	struct cord cord;
+	/** Endpoint of the reader thread. */
+	struct cbus_endpoint endpoint;
+	/** Endpoint of tx. */
+	struct cbus_endpoint tx_endpoint;
+	/** Pipe from the reader thread to tx. */
+	struct cpipe tx_pipe;
+	/** Pipe from tx to the reader thread. */
+	struct cpipe reader_pipe;
+	/** Route of batches: apply in tx, free in the reader. */
+	struct cmsg_hop batch_route[2];
+	/** Message sent to tx when the reader is done. */
+	struct cmsg end_msg;
+	/* Reader thread state. */
+	/** Number of batches sent to tx and not freed yet. */
+	int in_flight;
+	/** Set if tx failed to apply a row. */
+	bool is_stopped;
+	/** Set if the EOF marker was read. */
+	bool is_eof;
+	/* Tx state. */
+	/** Set if all batches have been received by tx. */
+	bool is_done;
+	/** Return code of applying rows, -1 on error. */
+	int rc;
+	/** Error of applying rows. */
+	struct diag diag;
+	int is_space_system;
+	uint64_t row_count;
+};
+
+static struct memtx_snap_batch *
+memtx_snap_batch_new(struct memtx_snap_reader *reader, size_t data_size)
+{
+	data_size = MAX(data_size, (size_t)MEMTX_SNAP_BATCH_DATA);
+	size_t size = sizeof(struct memtx_snap_batch) + data_size;
+	struct memtx_snap_batch *batch = malloc(size);
+	if (batch == NULL) {
+		diag_set(OutOfMemory, size, "malloc", "batch");
+		return NULL;
+	}
+	batch->reader = reader;
+	batch->is_stopped = false;
+	batch->row_count = 0;
+	batch->data_size = data_size;
+	batch->data_used = 0;
+	return batch;
+}
+
+static inline bool
+memtx_snap_batch_has_room(struct memtx_snap_batch *batch, size_t size)
+{
+	return batch->row_count < MEMTX_SNAP_BATCH_ROWS &&
+	       batch->data_used + size <= batch->data_size;
+}
+
+/**
+ * Copy a row to a batch. INSERT rows are decoded right away
+ * so that tx doesn't have to.
+ */
+static void
+memtx_snap_batch_add_row(struct memtx_snap_batch *batch,
+			 struct xrow_header *row, int *is_space_system)
+{
+	assert(row->bodycnt == 1); /* always 1 for read */
+	assert(memtx_snap_batch_has_room(batch, row->body[0].iov_len));
+	struct memtx_snap_row *r = &batch->rows[batch->row_count++];
+	r->row = *row;
+	char *data = batch->data + batch->data_used;
+	memcpy(data, row->body[0].iov_base, row->body[0].iov_len);
+	r->row.body[0].iov_base = data;
+	batch->data_used += row->body[0].iov_len;
+	r->is_decoded = false;
+	if (row->type != IPROTO_INSERT)
+		return;
+	if (xrow_decode_dml(&r->row, &r->request,
+			    dml_request_key_map(row->type)) != 0) {
+		diag_clear(diag_get());
+		return;
+	}
+	r->is_decoded = true;
+	*is_space_system = (r->request.space_id < BOX_SYSTEM_ID_MAX);
+}
+
+/** Apply rows of a batch. Called in tx. */
+static void
+memtx_snap_tx_apply(struct cmsg *msg)
+{
+	struct memtx_snap_batch *batch = (struct memtx_snap_batch *)msg;
+	struct memtx_snap_reader *reader = batch->reader;
+	struct memtx_engine *memtx = reader->memtx;
+	for (int i = 0; i < batch->row_count && reader->rc == 0; i++) {
+		struct memtx_snap_row *r = &batch->rows[i];
+		int rc;
+		if (r->is_decoded) {
+			reader->is_space_system =
+				(r->request.space_id < BOX_SYSTEM_ID_MAX);
+			rc = memtx_engine_recover_snapshot_request(memtx,
+								   &r->request);
+		} else {
+			rc = memtx_engine_recover_snapshot_row(memtx, &r->row,
+						&reader->is_space_system);
+		}
+		bool force_recovery = reader->is_space_system == 0 ?
+				      memtx->force_recovery : false;
+		if (rc < 0) {
+			if (!force_recovery) {
+				reader->rc = -1;
+				diag_move(diag_get(), &reader->diag);
+				break;
+			}
+			say_error("can't apply row: ");
+			diag_log();
+		}
+		++reader->row_count;
+		if (reader->row_count % 100000 == 0) {
+			say_info("%.1fM rows processed",
+				 reader->row_count / 1000000.);
+			fiber_yield_timeout(0);
+		}
+	}
+	if (reader->rc != 0)
+		batch->is_stopped = true;
+}
+
+/** Free a batch applied by tx. Called in the reader thread. */
+static void
+memtx_snap_batch_free(struct cmsg *msg)
+{
+	struct memtx_snap_batch *batch = (struct memtx_snap_batch *)msg;
+	struct memtx_snap_reader *reader = batch->reader;
+	assert(reader->in_flight > 0);
+	reader->in_flight--;
+	if (batch->is_stopped)
+		reader->is_stopped = true;
+	free(batch);
+}
+
+/** Notify tx that the reader is done. Called in tx. */
+static void
+memtx_snap_tx_end(struct cmsg *msg)
+{
+	struct memtx_snap_reader *reader =
+		container_of(msg, struct memtx_snap_reader, end_msg);
+	reader->is_done = true;
+}
+
+/**
+ * Wait until the number of batches sent to tx drops to
+ * the given value.
+ */
+static void
+memtx_snap_reader_wait(struct memtx_snap_reader *reader, int in_flight)
+{
+	while (true) {
+		cbus_process(&reader->endpoint);
+		if (reader->in_flight <= in_flight)
+			break;
+		fiber_yield();
+	}
+}
+
+static void
+memtx_snap_reader_push(struct memtx_snap_reader *reader,
+		       struct memtx_snap_batch *batch)
+{
+	cmsg_init(&batch->base, reader->batch_route);
+	cpipe_push(&reader->tx_pipe, &batch->base);
+	reader->in_flight++;
+	memtx_snap_reader_wait(reader, MEMTX_SNAP_BATCHES_MAX - 1);
+}
+
+static int
+memtx_snap_reader_f(va_list ap)
+{
+	struct memtx_snap_reader *reader =
+		va_arg(ap, struct memtx_snap_reader *);
+	struct memtx_engine *memtx = reader->memtx;
+
+	cbus_endpoint_create(&reader->endpoint, "snap_reader",
+			     fiber_schedule_cb, fiber());
+	cpipe_create(&reader->tx_pipe, "snap_tx");
+	cpipe_set_max_input(&reader->tx_pipe, 1);
+
+	int rc = -1;
+	struct memtx_snap_batch *batch = NULL;
+	struct xrow_header row;
+	int is_space_system = -1;
+	bool force_recovery = false;
+	struct xlog_cursor cursor;
+	if (xlog_cursor_open(&cursor, reader->filename) < 0)
+		goto out;
+	/*
+	 * In case when we read system space, we can't ignore errors.
+	 */
+	while (!reader->is_stopped &&
+	       (rc = xlog_cursor_next(&cursor, &row, force_recovery)) == 0) {
+		row.lsn = reader->signature;
+		size_t size = row.body[0].iov_len;
+		if (batch != NULL && !memtx_snap_batch_has_room(batch, size)) {
+			memtx_snap_reader_push(reader, batch);
+			batch = NULL;
+		}
+		if (batch == NULL) {
+			batch = memtx_snap_batch_new(reader, size);
+			if (batch == NULL) {
+				rc = -1;
+				break;
+			}
+		}
+		memtx_snap_batch_add_row(batch, &row, &is_space_system);
+		force_recovery = is_space_system == 0 ?
+				 memtx->force_recovery : false;
+	}
+	reader->is_eof = xlog_cursor_is_eof(&cursor);
+	xlog_cursor_close(&cursor, false);
+	if (batch != NULL) {
+		if (rc >= 0)
+			memtx_snap_reader_push(reader, batch);
+		else
+			free(batch);
+	}
+out:
+	memtx_snap_reader_wait(reader, 0);
+	static const struct cmsg_hop end_route[] = {
+		{memtx_snap_tx_end, NULL},
+	};
+	cmsg_init(&reader->end_msg, end_route);
+	cpipe_push(&reader->tx_pipe, &reader->end_msg);
+	cpipe_destroy(&reader->tx_pipe);
+	cbus_endpoint_destroy(&reader->endpoint, cbus_process);
+	return rc < 0 ? -1 : 0;
+}
+
+/**
+ * Recover a snapshot reading it in a separate thread.
+ * Sets is_space_system and is_eof like the single-threaded
+ * snapshot recovery loop does.
+ */
+static int
+memtx_engine_recover_snapshot_threaded(struct memtx_engine *memtx,
+				       const char *filename,
+				       int64_t signature,
+				       int *is_space_system, bool *is_eof)
+{
+	struct memtx_snap_reader reader;
+	memset(&reader, 0, sizeof(reader));
+	reader.memtx = memtx;
+	snprintf(reader.filename, sizeof(reader.filename), "%s", filename);
+	reader.signature = signature;
+	reader.batch_route[0].f = memtx_snap_tx_apply;
+	reader.batch_route[0].pipe = &reader.reader_pipe;
+	reader.batch_route[1].f = memtx_snap_batch_free;
+	reader.batch_route[1].pipe = NULL;
+	reader.is_space_system = -1;
+	diag_create(&reader.diag);
+
+	cbus_endpoint_create(&reader.tx_endpoint, "snap_tx",
+			     fiber_schedule_cb, fiber());
+	if (cord_costart(&reader.cord, "snap_reader",
+			 memtx_snap_reader_f, &reader) != 0) {
+		cbus_endpoint_destroy(&reader.tx_endpoint, cbus_process);
+		diag_destroy(&reader.diag);
+		return -1;
+	}
+	cpipe_create(&reader.reader_pipe, "snap_reader");
+	/* Return batches to the reader as soon as they are applied. */
+	cpipe_set_max_input(&reader.reader_pipe, 1);
+
+	while (true) {
+		cbus_process(&reader.tx_endpoint);
+		if (reader.is_done)
+			break;
+		fiber_yield();
+	}
+	cpipe_destroy(&reader.reader_pipe);
+	cbus_endpoint_destroy(&reader.tx_endpoint, cbus_process);
+
+	int rc = 0;
+	if (cord_cojoin(&reader.cord) != 0)
+		rc = -1;
+	if (reader.rc != 0) {
+		/* The error of applying a row takes precedence. */
+		diag_move(&reader.diag, diag_get());
+		rc = -1;
+	}
+	diag_destroy(&reader.diag);
+	*is_space_system = reader.is_space_system;
+	*is_eof = reader.is_eof;
+	return rc;
+}
+
 int
 memtx_engine_recover_snapshot(struct memtx_engine *memtx,
 			      const struct vclock *vclock)
@@ -163,15 +660,22 @@ memtx_engine_recover_snapshot(struct memtx_engine *memtx,
 						    signature, NONE);
 
 	say_info("recovering from `%s'", filename);
-	struct xlog_cursor cursor;
-	if (xlog_cursor_open(&cursor, filename) < 0)
-		return -1;
-
 	int rc;
+	struct xlog_cursor cursor;
 	struct xrow_header row;
 	uint64_t row_count = 0;
 	int is_space_system = -1;
 	bool force_recovery = false;
+	bool is_eof;
+	if (memtx->recovery_threads > 1) {
+		rc = memtx_engine_recover_snapshot_threaded(memtx, filename,
+							    signature,
+							    &is_space_system,
+							    &is_eof);
+		goto done;
+	}
+	if (xlog_cursor_open(&cursor, filename) < 0)
+		return -1;
 	/*
 	 * In case when we read system space, we can't ignore errors.
 	 */
@@ -194,7 +698,9 @@ memtx_engine_recover_snapshot(struct memtx_engine *memtx,
 			fiber_yield_timeout(0);
 		}
 	}
+	is_eof = xlog_cursor_is_eof(&cursor);
 	xlog_cursor_close(&cursor, false);
+done:
 	if (rc < 0 || is_space_system < 0)
 		return -1;
 
@@ -203,7 +709,7 @@ memtx_engine_recover_snapshot(struct memtx_engine *memtx,
 	 * marker - such snapshots are very likely corrupted and
 	 * should not be trusted.
 	 */
-	if (!xlog_cursor_is_eof(&cursor)) {
+	if (!is_eof) {
 		if (!memtx->force_recovery)
 			panic("snapshot `%s' has no EOF marker", filename);
 		else
@@ -237,12 +743,19 @@ memtx_engine_recover_snapshot_row(struct memtx_engine *memtx,
 			 (uint32_t) row->type);
 		return -1;
 	}
-	int rc;
 	struct request request;
 	if (xrow_decode_dml(row, &request, dml_request_key_map(row->type)) != 0)
 		return -1;
 	*is_space_system = (request.space_id < BOX_SYSTEM_ID_MAX);
-	struct space *space = space_cache_find(request.space_id);
+	return memtx_engine_recover_snapshot_request(memtx, &request);
+}
+
+static int
+memtx_engine_recover_snapshot_request(struct memtx_engine *memtx,
+				      struct request *request)
+{
+	int rc;
+	struct space *space = space_cache_find(request->space_id);
 	if (space == NULL)
 		return -1;
 	/* memtx snapshot must contain only memtx spaces */
@@ -257,9 +770,9 @@ memtx_engine_recover_snapshot_row(struct memtx_engine *memtx,
 		goto rollback;
 	/* no access checks here - applier always works with admin privs */
 	struct tuple *unused;
-	if (space_execute_dml(space, txn, &request, &unused) != 0)
+	if (space_execute_dml(space, txn, request, &unused) != 0)
 		goto rollback_stmt;
-	if (txn_commit_stmt(txn, &request) != 0)
+	if (txn_commit_stmt(txn, request) != 0)
 		goto rollback;
 	/*
 	 * Snapshot rows are confirmed by definition. They don't need to go to
@@ -331,7 +844,7 @@ memtx_engine_begin_final_recovery(struct engine *engine)
 		 * unique keys.
 		 */
 		memtx->state = MEMTX_OK;
-		if (space_foreach(memtx_build_secondary_keys, memtx) != 0)
+		if (memtx_build_all_secondary_keys(memtx) != 0)
 			return -1;
 	}
 	return 0;
@@ -350,7 +863,7 @@ memtx_engine_end_recovery(struct engine *engine)
 	if (memtx->state != MEMTX_OK) {
 		assert(memtx->state == MEMTX_FINAL_RECOVERY);
 		memtx->state = MEMTX_OK;
-		if (space_foreach(memtx_build_secondary_keys, memtx) != 0)
+		if (memtx_build_all_secondary_keys(memtx) != 0)
 			return -1;
 	}
 	return 0;
@@ -1149,6 +1662,7 @@ memtx_engine_new(const char *snap_dirname, bool force_recovery,
 
 	memtx->state = MEMTX_INITIALIZED;
 	memtx->max_tuple_size = MAX_TUPLE_SIZE;
+	memtx->recovery_threads = 1;
 	memtx->force_recovery = force_recovery;
 
 	memtx->replica_join_cord = NULL;
@@ -1196,6 +1710,12 @@ memtx_engine_set_max_tuple_size(struct memtx_engine *memtx, size_t max_size)
 	memtx->max_tuple_size = max_size;
 }
 
+void
+memtx_engine_set_recovery_threads(struct memtx_engine *memtx, int count)
+{
+	memtx->recovery_threads = count;
+}
+
 void
 memtx_enter_delayed_free_mode(struct memtx_engine *memtx)
 {
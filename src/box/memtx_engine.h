@@ -152,6 +152,13 @@ struct memtx_engine {
 	void *reserved_extents;
 	/** Maximal allowed tuple size, box.cfg.memtx_max_tuple_size. */
 	size_t max_tuple_size;
+	/**
+	 * Number of threads used for building secondary keys
+	 * after recovery, box.cfg.memtx_recovery_threads.
+	 * If greater than 1, the snapshot is also read and
+	 * decoded in a separate thread.
+	 */
+	int recovery_threads;
 	/** Incremented with each next snapshot. */
 	uint32_t snapshot_version;
 	/**
@@ -228,6 +235,9 @@ memtx_engine_set_memory(struct memtx_engine *memtx, size_t size);
 void
 memtx_engine_set_max_tuple_size(struct memtx_engine *memtx, size_t max_size);
 
+void
+memtx_engine_set_recovery_threads(struct memtx_engine *memtx, int count);
+
 /**
  * Enter tuple delayed free mode: tuple allocated before the call
  * won't be freed until memtx_leave_delayed_free_mode() is called.
@@ -46,6 +46,14 @@ static inline bool
 memtx_hash_equal(struct tuple *tuple_a, struct tuple *tuple_b,
 		 struct key_def *key_def)
 {
+	/*
+	 * Light calls the comparator only for records with
+	 * a matching hash. When a tuple is deleted or replaced,
+	 * such a record almost always stores the very same
+	 * tuple, so don't compare it with itself field by field.
+	 */
+	if (tuple_a == tuple_b)
+		return true;
 	return tuple_compare(tuple_a, HINT_NONE,
 			     tuple_b, HINT_NONE, key_def) == 0;
 }
@@ -315,12 +323,12 @@ memtx_hash_index_get(struct index *base, const char *key,
 	       part_count == base->def->key_def->part_count);
 	(void) part_count;
 
-	struct space *space = space_by_id(base->def->space_id);
 	*result = NULL;
 	uint32_t h = key_hash(key, base->def->key_def);
 	uint32_t k = light_index_find_key(&index->hash_table, h, key);
 	if (k != light_index_end) {
 		struct tuple *tuple = light_index_get(&index->hash_table, k);
+		struct space *space = space_by_id(base->def->space_id);
 		uint32_t iid = base->def->iid;
 		struct txn *txn = in_txn();
 		bool is_rw = txn != NULL;
@@ -544,6 +552,7 @@ static const struct index_vtab memtx_hash_index_vtab = {
 	/* .random = */ memtx_hash_index_random,
 	/* .count = */ memtx_hash_index_count,
 	/* .get = */ memtx_hash_index_get,
+	/* .get_many = */ generic_index_get_many,
 	/* .replace = */ memtx_hash_index_replace,
 	/* .create_iterator = */ memtx_hash_index_create_iterator,
 	/* .create_snapshot_iterator = */
@@ -39,6 +39,7 @@
 #include "tuple.h"
 #include "txn.h"
 #include "memtx_tx.h"
+#include "port.h"
 #include <third_party/qsort_arg.h>
 #include <small/mempool.h>
 
@@ -197,6 +198,8 @@ struct memtx_tree_index {
 	memtx_tree_t<USE_HINT> tree;
 	struct memtx_tree_data<USE_HINT> *build_array;
 	size_t build_array_size, build_array_alloc_size;
+	/** Set if build_array has already been sorted. */
+	bool build_array_is_sorted;
 	struct memtx_gc_task gc_task;
 	memtx_tree_iterator_t<USE_HINT> gc_iterator;
 };
@@ -741,6 +744,85 @@ memtx_tree_index_get(struct index *base, const char *key,
 	return 0;
 }
 
+/**
+ * Look up all keys in the tree in one go with
+ * memtx_tree_find_batch() so that cache misses on
+ * tree blocks are paid for several keys at once.
+ */
+template <bool USE_HINT>
+static int
+memtx_tree_index_get_many(struct index *base, const char *keys,
+			  uint32_t key_count, struct port *port)
+{
+	struct memtx_tree_index<USE_HINT> *index =
+		(struct memtx_tree_index<USE_HINT> *)base;
+	struct key_def *cmp_def = memtx_tree_cmp_def(&index->tree);
+	if (key_count == 0)
+		return 0;
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	size_t size;
+	struct memtx_tree_key_data<USE_HINT> *key_data =
+		region_alloc_array(region, typeof(key_data[0]), key_count,
+				   &size);
+	if (key_data == NULL) {
+		diag_set(OutOfMemory, size, "region_alloc_array", "key_data");
+		return -1;
+	}
+	struct memtx_tree_key_data<USE_HINT> **key_ptrs =
+		region_alloc_array(region, typeof(key_ptrs[0]), key_count,
+				   &size);
+	if (key_ptrs == NULL) {
+		diag_set(OutOfMemory, size, "region_alloc_array", "key_ptrs");
+		region_truncate(region, region_svp);
+		return -1;
+	}
+	struct memtx_tree_data<USE_HINT> **found =
+		region_alloc_array(region, typeof(found[0]), key_count,
+				   &size);
+	if (found == NULL) {
+		diag_set(OutOfMemory, size, "region_alloc_array", "found");
+		region_truncate(region, region_svp);
+		return -1;
+	}
+	for (uint32_t i = 0; i < key_count; i++) {
+		key_data[i].part_count = mp_decode_array(&keys);
+		key_data[i].key = keys;
+		if (USE_HINT) {
+			key_data[i].set_hint(key_hint(keys,
+						      key_data[i].part_count,
+						      cmp_def));
+		}
+		for (uint32_t j = 0; j < key_data[i].part_count; j++)
+			mp_next(&keys);
+		key_ptrs[i] = &key_data[i];
+	}
+	memtx_tree_find_batch(&index->tree, key_ptrs, key_count, found);
+
+	int rc = 0;
+	struct txn *txn = in_txn();
+	struct space *space = space_by_id(base->def->space_id);
+	bool is_rw = txn != NULL;
+	bool is_multikey = base->def->key_def->is_multikey;
+	for (uint32_t i = 0; i < key_count; i++) {
+		struct memtx_tree_data<USE_HINT> *res = found[i];
+		if (res == NULL)
+			continue;
+		uint32_t mk_index = is_multikey ? (uint32_t)res->hint : 0;
+		struct tuple *tuple = memtx_tx_tuple_clarify(txn, space,
+							     res->tuple,
+							     base->def->iid,
+							     mk_index, is_rw);
+		if (tuple == NULL)
+			continue;
+		rc = port_c_add_tuple(port, tuple);
+		if (rc != 0)
+			break;
+	}
+	region_truncate(region, region_svp);
+	return rc;
+}
+
 template <bool USE_HINT>
 static int
 memtx_tree_index_replace(struct index *base, struct tuple *old_tuple,
@@ -1398,14 +1480,24 @@ memtx_tree_index_build_array_deduplicate(struct memtx_tree_index<USE_HINT> *inde
 
 template <bool USE_HINT>
 static void
-memtx_tree_index_end_build(struct index *base)
+memtx_tree_index_sort_build_array_tpl(struct memtx_tree_index<USE_HINT> *index)
 {
-	struct memtx_tree_index<USE_HINT> *index =
-		(struct memtx_tree_index<USE_HINT> *)base;
 	struct key_def *cmp_def = memtx_tree_cmp_def(&index->tree);
 	qsort_arg(index->build_array, index->build_array_size,
 		  sizeof(index->build_array[0]),
 		  memtx_tree_qcompare<USE_HINT>, cmp_def);
+	index->build_array_is_sorted = true;
+}
+
+template <bool USE_HINT>
+static void
+memtx_tree_index_end_build(struct index *base)
+{
+	struct memtx_tree_index<USE_HINT> *index =
+		(struct memtx_tree_index<USE_HINT> *)base;
+	struct key_def *cmp_def = memtx_tree_cmp_def(&index->tree);
+	if (!index->build_array_is_sorted)
+		memtx_tree_index_sort_build_array_tpl<USE_HINT>(index);
 	if (cmp_def->is_multikey) {
 		/*
 		 * Multikey index may have equal(in terms of
@@ -1426,6 +1518,7 @@ memtx_tree_index_end_build(struct index *base)
 	index->build_array = NULL;
 	index->build_array_size = 0;
 	index->build_array_alloc_size = 0;
+	index->build_array_is_sorted = false;
 }
 
 template <bool USE_HINT>
@@ -1539,6 +1632,7 @@ static const struct index_vtab memtx_tree_no_hint_index_vtab = {
 	/* .random = */ memtx_tree_index_random<false>,
 	/* .count = */ memtx_tree_index_count<false>,
 	/* .get = */ memtx_tree_index_get<false>,
+	/* .get_many = */ memtx_tree_index_get_many<false>,
 	/* .replace = */ memtx_tree_index_replace<false>,
 	/* .create_iterator = */ memtx_tree_index_create_iterator<false>,
 	/* .create_snapshot_iterator = */
@@ -1569,6 +1663,7 @@ static const struct index_vtab memtx_tree_use_hint_index_vtab = {
 	/* .random = */ memtx_tree_index_random<true>,
 	/* .count = */ memtx_tree_index_count<true>,
 	/* .get = */ memtx_tree_index_get<true>,
+	/* .get_many = */ memtx_tree_index_get_many<true>,
 	/* .replace = */ memtx_tree_index_replace<true>,
 	/* .create_iterator = */ memtx_tree_index_create_iterator<true>,
 	/* .create_snapshot_iterator = */
@@ -1599,6 +1694,7 @@ static const struct index_vtab memtx_tree_index_multikey_vtab = {
 	/* .random = */ memtx_tree_index_random<true>,
 	/* .count = */ memtx_tree_index_count<true>,
 	/* .get = */ memtx_tree_index_get<true>,
+	/* .get_many = */ memtx_tree_index_get_many<true>,
 	/* .replace = */ memtx_tree_index_replace_multikey,
 	/* .create_iterator = */ memtx_tree_index_create_iterator<true>,
 	/* .create_snapshot_iterator = */
@@ -1629,6 +1725,7 @@ static const struct index_vtab memtx_tree_func_index_vtab = {
 	/* .random = */ memtx_tree_index_random<true>,
 	/* .count = */ memtx_tree_index_count<true>,
 	/* .get = */ memtx_tree_index_get<true>,
+	/* .get_many = */ memtx_tree_index_get_many<true>,
 	/* .replace = */ memtx_tree_func_index_replace,
 	/* .create_iterator = */ memtx_tree_index_create_iterator<true>,
 	/* .create_snapshot_iterator = */
@@ -1665,6 +1762,7 @@ static const struct index_vtab memtx_tree_disabled_index_vtab = {
 	/* .random = */ generic_index_random,
 	/* .count = */ generic_index_count,
 	/* .get = */ generic_index_get,
+	/* .get_many = */ generic_index_get_many,
 	/* .replace = */ disabled_index_replace,
 	/* .create_iterator = */ generic_index_create_iterator,
 	/* .create_snapshot_iterator = */
@@ -1726,3 +1824,16 @@ memtx_tree_index_new(struct memtx_engine *memtx, struct index_def *def)
 	}
 	return memtx_tree_index_new_tpl<true>(memtx, def, vtab);
 }
+
+void
+memtx_tree_index_sort_build_array(struct index *base)
+{
+	assert(base->def->type == TREE);
+	if (base->vtab == &memtx_tree_no_hint_index_vtab) {
+		memtx_tree_index_sort_build_array_tpl<false>(
+			(struct memtx_tree_index<false> *)base);
+	} else {
+		memtx_tree_index_sort_build_array_tpl<true>(
+			(struct memtx_tree_index<true> *)base);
+	}
+}
@@ -42,6 +42,16 @@ struct memtx_engine;
 struct index *
 memtx_tree_index_new(struct memtx_engine *memtx, struct index_def *def);
 
+/**
+ * Sort keys collected by index_build_next() of a memtx tree
+ * index. This is normally done by index_end_build(), but since
+ * the function doesn't touch anything but the build array, it
+ * may be called from a worker thread to sort keys of several
+ * indexes in parallel. index_end_build() won't sort them again.
+ */
+void
+memtx_tree_index_sort_build_array(struct index *index);
+
 #if defined(__cplusplus)
 } /* extern "C" */
 #endif /* defined(__cplusplus) */
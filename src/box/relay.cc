@@ -40,6 +40,7 @@
 
 #include "coio.h"
 #include "coio_task.h"
+#include "fiber_pool.h"
 #include "engine.h"
 #include "gc.h"
 #include "iproto_constants.h"
@@ -55,6 +56,89 @@
 #include "txn_limbo.h"
 #include "raft.h"
 
+#include "small/ibuf.h"
+#include "msgpuck/msgpuck.h"
+
+enum {
+	/**
+	 * Max size of rows copied from the in-memory WAL buffer
+	 * at once. The WAL thread is blocked while they are
+	 * being copied so it shouldn't be too big.
+	 */
+	RELAY_WAL_READ_SIZE = 128 * 1024,
+	/**
+	 * Max total size of decoded rows kept by the fan-out
+	 * thread for relays that are a bit behind the others.
+	 */
+	RELAY_FANOUT_CACHE_SIZE = 8 * RELAY_WAL_READ_SIZE,
+	/**
+	 * Max number of relays running in the fan-out thread.
+	 * Each of them occupies a fiber of the thread pool.
+	 */
+	RELAY_FANOUT_POOL_SIZE = 4096,
+};
+
+/** A row of struct relay_wal_batch. */
+struct relay_wal_row {
+	/** Position of the row in the in-memory WAL buffer. */
+	uint64_t pos;
+	/** Decoded row. The body points to the batch data. */
+	struct xrow_header header;
+};
+
+/**
+ * Rows copied from the in-memory WAL buffer and decoded by
+ * the fan-out thread. Relays running in the thread share
+ * batches so that each row is decoded only once no matter
+ * how many replicas it is sent to.
+ */
+struct relay_wal_batch {
+	/** Link in relay_fanout::batches. */
+	struct rlist in_fanout;
+	/**
+	 * Number of relays sending rows of the batch plus one
+	 * if the batch is cached in relay_fanout::batches.
+	 */
+	int refs;
+	/** Position of the first row in the in-memory WAL buffer. */
+	uint64_t begin;
+	/** Position following the last row. */
+	uint64_t end;
+	/** Encoded rows. */
+	struct ibuf data;
+	/** Decoded rows, sorted by position. */
+	struct relay_wal_row *rows;
+	/** Number of decoded rows. */
+	int row_count;
+};
+
+/**
+ * The thread that runs relays in the fan-out mode, see
+ * replication_relay_fanout. Unlike a relay running in its
+ * own thread, a relay running in the fan-out thread is just
+ * a fiber, and all such relays share rows decoded from the
+ * in-memory WAL buffer.
+ */
+static struct relay_fanout {
+	/** The fan-out thread. */
+	struct cord cord;
+	/** Set if the thread has been started. */
+	bool is_started;
+	/** A pipe from 'tx' to the fan-out thread. */
+	struct cpipe pipe;
+	/** A pipe from the fan-out thread to 'tx'. */
+	struct cpipe tx_pipe;
+	/** Pool of fibers running relays. */
+	struct fiber_pool pool;
+	/**
+	 * Recently decoded batches, oldest first. Accessed
+	 * only from the fan-out thread.
+	 */
+	struct rlist batches;
+	/** Total size of encoded rows of cached batches. */
+	size_t cache_size;
+} relay_fanout;
+
 /**
  * Cbus message to send status updates from relay to tx thread.
  */
@@ -102,6 +186,14 @@ struct relay {
 	struct replica *replica;
 	/** WAL event watcher. */
 	struct wal_watcher wal_watcher;
+	/**
+	 * Position in the in-memory WAL buffer. While the relay
+	 * is in sync with WAL, it reads new rows from there
+	 * rather than from the xlog files.
+	 */
+	struct wal_reader wal_reader;
+	/** Rows copied from the in-memory WAL buffer. */
+	struct ibuf wal_buf;
 	/** Relay reader cond. */
 	struct fiber_cond reader_cond;
 	/** Relay diagnostics. */
@@ -117,6 +209,18 @@ struct relay {
 	 * is passed by the replica on subscribe.
 	 */
 	uint32_t id_filter;
+	/** Set if the replication stream is compressed. */
+	bool compression;
+	/** Compressor of the replication stream. */
+	struct xrow_compressor compressor;
+	/**
+	 * Set if the relay has sent the error that stopped it to
+	 * the replica through the compressor, so it must not be
+	 * sent again.
+	 */
+	bool is_error_sent;
+	/** Set if the relay runs in the fan-out thread. */
+	bool is_fanout;
 	/**
 	 * How many rows has this relay sent to the replica. Used to yield once
 	 * in a while when reading a WAL to unblock the event loop.
@@ -184,6 +288,12 @@ relay_last_row_time(const struct relay *relay)
 	return relay->last_row_time;
 }
 
+const struct xrow_compressor *
+relay_compressor(const struct relay *relay)
+{
+	return relay->compression ? &relay->compressor : NULL;
+}
+
 static void
 relay_send(struct relay *relay, struct xrow_header *packet);
 static void
@@ -232,8 +342,10 @@ relay_start(struct relay *relay, int fd, uint64_t sync,
 	diag_clear(&relay->diag);
 	coio_create(&relay->io, fd);
 	relay->sync = sync;
+	relay->is_error_sent = false;
 	relay->state = RELAY_FOLLOW;
 	relay->row_count = 0;
+	relay->wal_reader.is_attached = false;
 	relay->last_row_time = ev_monotonic_now(loop());
 }
 
@@ -300,19 +412,24 @@ relay_delete(struct relay *relay)
 	free(relay);
 }
 
-static void
-relay_set_cord_name(int fd)
+/** Format the name of a relay thread or fiber. */
+static const char *
+relay_name(int fd)
 {
-	char name[FIBER_NAME_MAX];
 	struct sockaddr_storage peer;
 	socklen_t addrlen = sizeof(peer);
 	if (getpeername(fd, ((struct sockaddr*)&peer), &addrlen) == 0) {
-		snprintf(name, sizeof(name), "relay/%s",
-			 sio_strfaddr((struct sockaddr *)&peer, addrlen));
-	} else {
-		snprintf(name, sizeof(name), "relay/<unknown>");
+		return tt_sprintf("relay/%s",
+				  sio_strfaddr((struct sockaddr *)&peer,
+					       addrlen));
 	}
-	cord_set_name(name);
+	return "relay/<unknown>";
+}
+
+static void
+relay_set_cord_name(int fd)
+{
+	cord_set_name(relay_name(fd));
 }
 
 void
@@ -527,6 +644,261 @@ relay_set_error(struct relay *relay, struct error *e)
 		diag_set_error(&relay->diag, e);
 }
 
+/**
+ * Recreate the recovery context so that it starts reading xlogs
+ * from the given vclock. The current xlog, if any, is closed
+ * without running on_close_log triggers.
+ */
+static void
+relay_reset_recovery(struct relay *relay, const struct vclock *vclock)
+{
+	struct recovery *r = recovery_new(wal_dir(), false, vclock);
+	rlist_swap(&relay->r->on_close_log, &r->on_close_log);
+	recovery_delete(relay->r);
+	relay->r = r;
+}
+
+/**
+ * Switch to the in-memory WAL buffer if the relay has read
+ * all rows written to WAL.
+ */
+static void
+relay_attach_wal_reader(struct relay *relay)
+{
+	if (wal_reader_attach(&relay->wal_reader, &relay->r->vclock) != 0)
+		return;
+	/*
+	 * Close the current xlog. If the relay falls behind,
+	 * the xlog to continue from will be found by vclock.
+	 */
+	struct vclock vclock;
+	vclock_copy(&vclock, &relay->r->vclock);
+	relay_reset_recovery(relay, &vclock);
+}
+
+static void
+relay_wal_batch_unref(struct relay_wal_batch *batch)
+{
+	assert(batch->refs > 0);
+	if (--batch->refs > 0)
+		return;
+	ibuf_destroy(&batch->data);
+	free(batch->rows);
+	free(batch);
+}
+
+/**
+ * Return the index of the row starting at the given position
+ * or -1 if there's no such row in the batch.
+ */
+static int
+relay_wal_batch_find(struct relay_wal_batch *batch, uint64_t pos)
+{
+	int begin = 0, end = batch->row_count;
+	while (begin < end) {
+		int mid = begin + (end - begin) / 2;
+		if (batch->rows[mid].pos < pos)
+			begin = mid + 1;
+		else
+			end = mid;
+	}
+	if (begin < batch->row_count && batch->rows[begin].pos == pos)
+		return begin;
+	return -1;
+}
+
+/**
+ * Copy all whole rows following the reader position from the
+ * in-memory WAL buffer and decode them. Returns NULL if there
+ * are no new rows or the reader has been detached because the
+ * rows have been evicted. Throws on error.
+ */
+static struct relay_wal_batch *
+relay_wal_batch_read(struct wal_reader *reader)
+{
+	struct relay_wal_batch *batch =
+		(struct relay_wal_batch *)calloc(1, sizeof(*batch));
+	if (batch == NULL) {
+		tnt_raise(OutOfMemory, sizeof(*batch), "calloc",
+			  "struct relay_wal_batch");
+	}
+	batch->refs = 1;
+	batch->begin = reader->pos;
+	ibuf_create(&batch->data, &cord()->slabc, RELAY_WAL_READ_SIZE);
+	auto batch_guard = make_scoped_guard([=] {
+		relay_wal_batch_unref(batch);
+	});
+	/*
+	 * Copy rows to a reader of our own, because the tail may
+	 * be cut, while the batch must end at a row boundary.
+	 */
+	struct wal_reader batch_reader = *reader;
+	struct ibuf *buf = &batch->data;
+	size_t size = RELAY_WAL_READ_SIZE;
+	size_t scanned = 0;
+	while (batch->row_count == 0) {
+		ssize_t rc = wal_reader_read(&batch_reader, buf, size);
+		if (rc < 0)
+			diag_raise();
+		if (rc == 0)
+			break;
+		/* Count whole rows. */
+		size = RELAY_WAL_READ_SIZE;
+		const char *pos = buf->rpos + scanned;
+		while (mp_check_uint(pos, buf->wpos) <= 0) {
+			const char *data = pos;
+			uint64_t len = mp_decode_uint(&data);
+			if ((uint64_t)(buf->wpos - data) < len) {
+				/* Make sure a big row is read whole. */
+				size = MAX(size, (size_t)(len -
+						(buf->wpos - data)));
+				break;
+			}
+			pos = data + len;
+			batch->row_count++;
+		}
+		scanned = pos - buf->rpos;
+	}
+	if (batch->row_count == 0) {
+		reader->is_attached = batch_reader.is_attached;
+		return NULL;
+	}
+	batch->end = batch->begin + scanned;
+	batch->rows = (struct relay_wal_row *)
+		malloc(batch->row_count * sizeof(*batch->rows));
+	if (batch->rows == NULL) {
+		tnt_raise(OutOfMemory, batch->row_count * sizeof(*batch->rows),
+			  "malloc", "batch->rows");
+	}
+	const char *pos = buf->rpos;
+	for (int i = 0; i < batch->row_count; i++) {
+		struct relay_wal_row *row = &batch->rows[i];
+		row->pos = batch->begin + (pos - buf->rpos);
+		uint64_t len = mp_decode_uint(&pos);
+		xrow_header_decode_xc(&row->header, &pos, pos + len, true);
+	}
+	batch_guard.is_active = false;
+	return batch;
+}
+
+/**
+ * Find a decoded batch containing the row at the reader position,
+ * decoding new rows if there's none, and take a reference to it.
+ * The index of the row is returned in @a row. Returns NULL if
+ * there are no new rows or the reader has been detached. Throws
+ * on error.
+ */
+static struct relay_wal_batch *
+relay_fanout_get_batch(struct wal_reader *reader, int *row)
+{
+	struct relay_wal_batch *batch;
+	rlist_foreach_entry(batch, &relay_fanout.batches, in_fanout) {
+		if (reader->pos < batch->begin || reader->pos >= batch->end)
+			continue;
+		*row = relay_wal_batch_find(batch, reader->pos);
+		if (*row >= 0) {
+			batch->refs++;
+			return batch;
+		}
+	}
+	batch = relay_wal_batch_read(reader);
+	if (batch == NULL)
+		return NULL;
+	/* Cache the batch for other relays. */
+	rlist_add_tail_entry(&relay_fanout.batches, batch, in_fanout);
+	relay_fanout.cache_size += batch->end - batch->begin;
+	while (relay_fanout.cache_size > RELAY_FANOUT_CACHE_SIZE) {
+		struct relay_wal_batch *oldest = rlist_shift_entry(
+			&relay_fanout.batches, struct relay_wal_batch,
+			in_fanout);
+		relay_fanout.cache_size -= oldest->end - oldest->begin;
+		if (oldest == batch) {
+			/* Too big to cache, keep our reference. */
+			*row = 0;
+			return batch;
+		}
+		relay_wal_batch_unref(oldest);
+	}
+	batch->refs++;
+	*row = 0;
+	return batch;
+}
+
+/**
+ * Send rows decoded by the fan-out thread until the in-memory
+ * WAL buffer is exhausted or the relay falls behind.
+ */
+static void
+relay_fanout_send_wal(struct relay *relay)
+{
+	struct wal_reader *reader = &relay->wal_reader;
+	while (reader->is_attached) {
+		int i;
+		struct relay_wal_batch *batch =
+			relay_fanout_get_batch(reader, &i);
+		if (batch == NULL)
+			break;
+		auto batch_guard = make_scoped_guard([=] {
+			relay_wal_batch_unref(batch);
+		});
+		for (; i < batch->row_count; i++) {
+			/*
+			 * The row is shared with other relays while
+			 * sending may modify it so send a copy.
+			 */
+			struct xrow_header row = batch->rows[i].header;
+			/* Same as in recover_xlog(). */
+			struct vclock *vclock = &relay->r->vclock;
+			if (row.lsn <= vclock_get(vclock, row.replica_id))
+				continue;
+			vclock_follow_xrow(vclock, &row);
+			xstream_write_xc(&relay->stream, &row);
+		}
+		reader->pos = batch->end;
+	}
+}
+
+/**
+ * Send rows from the in-memory WAL buffer until it is
+ * exhausted or the relay falls behind.
+ */
+static void
+relay_send_wal_buf(struct relay *relay)
+{
+	if (relay->is_fanout) {
+		relay_fanout_send_wal(relay);
+		return;
+	}
+	struct ibuf *buf = &relay->wal_buf;
+	while (relay->wal_reader.is_attached) {
+		ssize_t size = wal_reader_read(&relay->wal_reader, buf,
+					       RELAY_WAL_READ_SIZE);
+		if (size < 0)
+			diag_raise();
+		if (size == 0)
+			break;
+		const char *pos = buf->rpos;
+		while (pos < buf->wpos && mp_check_uint(pos, buf->wpos) <= 0) {
+			const char *data = pos;
+			uint64_t len = mp_decode_uint(&data);
+			if ((uint64_t)(buf->wpos - data) < len)
+				break;
+			struct xrow_header row;
+			xrow_header_decode_xc(&row, &data, data + len, true);
+			pos = data;
+			/* Same as in recover_xlog(). */
+			struct vclock *vclock = &relay->r->vclock;
+			if (row.lsn <= vclock_get(vclock, row.replica_id))
+				continue;
+			vclock_follow_xrow(vclock, &row);
+			xstream_write_xc(&relay->stream, &row);
+		}
+		buf->rpos = (char *)pos;
+	}
+	if (!relay->wal_reader.is_attached)
+		ibuf_reset(buf);
+}
+
 static void
 relay_process_wal_event(struct wal_watcher *watcher, unsigned events)
 {
@@ -544,8 +916,31 @@ relay_process_wal_event(struct wal_watcher *watcher, unsigned events)
 		return;
 	}
 	try {
+		if (relay->wal_reader.is_attached) {
+			relay_send_wal_buf(relay);
+			if (relay->wal_reader.is_attached) {
+				/*
+				 * The relay doesn't read xlogs now,
+				 * tell the garbage collector they are
+				 * done with on rotation.
+				 */
+				if ((events & WAL_EVENT_ROTATE) != 0)
+					trigger_run_xc(&relay->r->on_close_log,
+						       NULL);
+				return;
+			}
+			/*
+			 * The relay has fallen behind. New xlogs
+			 * may have been created since it stopped
+			 * reading them.
+			 */
+			say_info("fell behind the in-memory WAL buffer, "
+				 "reading xlog files");
+			events |= WAL_EVENT_ROTATE;
+		}
 		recover_remaining_wals(relay->r, &relay->stream, NULL,
 				       (events & WAL_EVENT_ROTATE) != 0);
+		relay_attach_wal_reader(relay);
 	} catch (Exception *e) {
 		relay_set_error(relay, e);
 		fiber_cancel(fiber());
@@ -668,19 +1063,49 @@ relay_send_is_raft_enabled(struct relay *relay,
 	}
 }
 
+/**
+ * Send the error that stopped a relay to the replica through
+ * the relay's compressor. The replica has been told that the
+ * stream is compressed, so it would fail to decode the error
+ * if iproto wrote it as is.
+ */
+static void
+relay_send_error_compressed(struct relay *relay)
+{
+	struct error *e = diag_last_error(&relay->diag);
+	if (type_cast(SocketError, e) != NULL)
+		return;
+	/*
+	 * Don't let tx write the error after a failed attempt
+	 * either: it would land in the middle of a frame.
+	 */
+	relay->is_error_sent = true;
+	try {
+		struct xrow_header row;
+		xrow_encode_error_xc(&row, e, relay->sync);
+		coio_write_xrow_compressed(&relay->io, &relay->compressor,
+					   &row);
+	} catch (Exception *write_error) {
+		write_error->log();
+	}
+}
+
 /**
  * A libev callback invoked when a relay client socket is ready
  * for read. This currently only happens when the client closes
  * its socket, and we get an EOF.
  */
 static int
-relay_subscribe_f(va_list ap)
+relay_subscribe_loop(struct relay *relay)
 {
-	struct relay *relay = va_arg(ap, struct relay *);
 	struct recovery *r = relay->r;
 
-	coio_enable();
-	relay_set_cord_name(relay->io.fd);
+	if (relay->compression &&
+	    xrow_compressor_create(&relay->compressor) != 0) {
+		relay_set_error(relay, diag_last_error(diag_get()));
+		relay_exit(relay);
+		return -1;
+	}
 
 	/* Create cpipe to tx for propagating vclock. */
 	cbus_endpoint_create(&relay->endpoint, tt_sprintf("relay_%p", relay),
@@ -688,6 +1113,8 @@ relay_subscribe_f(va_list ap)
 	cbus_pair("tx", relay->endpoint.name, &relay->tx_pipe,
 		  &relay->relay_pipe, NULL, NULL, cbus_process);
 
+	ibuf_create(&relay->wal_buf, &cord()->slabc, RELAY_WAL_READ_SIZE);
+
 	struct relay_is_raft_enabled_msg raft_enabler;
 	if (!relay->replica->anon)
 		relay_send_is_raft_enabled(relay, &raft_enabler, true);
@@ -781,6 +1208,12 @@ relay_subscribe_f(va_list ap)
 	 */
 	trigger_clear(&on_close_log);
 	wal_clear_watcher(&relay->wal_watcher, cbus_process);
+	relay->wal_reader.is_attached = false;
+	ibuf_destroy(&relay->wal_buf);
+	if (relay->compression) {
+		relay_send_error_compressed(relay);
+		xrow_compressor_destroy(&relay->compressor);
+	}
 
 	/* Join ack reader fiber. */
 	fiber_cancel(reader);
@@ -805,11 +1238,100 @@ relay_subscribe_f(va_list ap)
 	return -1;
 }
 
+/** Relay thread function. */
+static int
+relay_subscribe_f(va_list ap)
+{
+	struct relay *relay = va_arg(ap, struct relay *);
+	coio_enable();
+	relay_set_cord_name(relay->io.fd);
+	return relay_subscribe_loop(relay);
+}
+
+/** Fan-out thread function. */
+static int
+relay_fanout_f(va_list ap)
+{
+	(void)ap;
+	coio_enable();
+	rlist_create(&relay_fanout.batches);
+	relay_fanout.cache_size = 0;
+	cpipe_create(&relay_fanout.tx_pipe, "tx");
+	fiber_pool_create(&relay_fanout.pool, "relay_fanout",
+			  RELAY_FANOUT_POOL_SIZE, FIBER_POOL_IDLE_TIMEOUT);
+	/*
+	 * Relays are run by the pool fibers. The thread is
+	 * terminated with relay_fanout_cancel() on shutdown.
+	 */
+	while (true)
+		fiber_yield();
+	return 0;
+}
+
+void
+relay_fanout_cancel(void)
+{
+	if (!relay_fanout.is_started)
+		return;
+	if (tt_pthread_cancel(relay_fanout.cord.id) == ESRCH)
+		return;
+	tt_pthread_join(relay_fanout.cord.id, NULL);
+}
+
+/** A request to run a relay in the fan-out thread. */
+struct relay_fanout_msg {
+	struct cbus_call_msg base;
+	struct relay *relay;
+};
+
+/** Run a relay in a fiber of the fan-out thread. */
+static int
+relay_fanout_subscribe_f(struct cbus_call_msg *base)
+{
+	struct relay_fanout_msg *msg = (struct relay_fanout_msg *)base;
+	struct relay *relay = msg->relay;
+	char name[FIBER_NAME_MAX];
+	strlcpy(name, fiber()->name, sizeof(name));
+	fiber_set_name(fiber(), relay_name(relay->io.fd));
+	int rc = relay_subscribe_loop(relay);
+	fiber_set_name(fiber(), name);
+	return rc;
+}
+
+/**
+ * Run a relay in the fan-out thread, starting the thread if
+ * necessary, and wait for it to exit.
+ */
+static int
+relay_fanout_subscribe(struct relay *relay)
+{
+	if (!relay_fanout.is_started) {
+		if (cord_costart(&relay_fanout.cord, "relay_fanout",
+				 relay_fanout_f, NULL) != 0)
+			return -1;
+		cpipe_create(&relay_fanout.pipe, "relay_fanout");
+		relay_fanout.is_started = true;
+	}
+	struct relay_fanout_msg msg;
+	msg.relay = relay;
+	/*
+	 * Like cord_cojoin(), don't let the caller go while
+	 * the relay is running, because it uses the caller's
+	 * socket.
+	 */
+	bool cancellable = fiber_set_cancellable(false);
+	int rc = cbus_call(&relay_fanout.pipe, &relay_fanout.tx_pipe,
+			   &msg.base, relay_fanout_subscribe_f, NULL,
+			   TIMEOUT_INFINITY);
+	fiber_set_cancellable(cancellable);
+	return rc;
+}
+
 /** Replication acceptor fiber handler. */
 void
 relay_subscribe(struct replica *replica, int fd, uint64_t sync,
 		struct vclock *replica_clock, uint32_t replica_version_id,
-		uint32_t replica_id_filter)
+		uint32_t replica_id_filter, bool compression)
 {
 	assert(replica->anon || replica->id != REPLICA_ID_NIL);
 	struct relay *relay = replica->relay;
@@ -838,12 +1360,19 @@ relay_subscribe(struct replica *replica, int fd, uint64_t sync,
 	relay->version_id = replica_version_id;
 
 	relay->id_filter = replica_id_filter;
+	relay->compression = compression;
+	relay->is_fanout = replication_relay_fanout;
 
-	int rc = cord_costart(&relay->cord, "subscribe",
-			      relay_subscribe_f, relay);
-	if (rc == 0)
-		rc = cord_cojoin(&relay->cord);
-	if (rc != 0)
+	int rc;
+	if (relay->is_fanout) {
+		rc = relay_fanout_subscribe(relay);
+	} else {
+		rc = cord_costart(&relay->cord, "subscribe",
+				  relay_subscribe_f, relay);
+		if (rc == 0)
+			rc = cord_cojoin(&relay->cord);
+	}
+	if (rc != 0 && !relay->is_error_sent)
 		diag_raise();
 }
 
@@ -854,7 +1383,11 @@ relay_send(struct relay *relay, struct xrow_header *packet)
 
 	packet->sync = relay->sync;
 	relay->last_row_time = ev_monotonic_now(loop());
-	coio_write_xrow(&relay->io, packet);
+	if (relay->compression)
+		coio_write_xrow_compressed(&relay->io, &relay->compressor,
+					   packet);
+	else
+		coio_write_xrow(&relay->io, packet);
 	fiber_gc();
 
 	/*
@@ -911,10 +1444,9 @@ relay_restart_recovery(struct relay *relay)
 	struct vclock restart_vclock;
 	vclock_copy(&restart_vclock, &relay->recv_vclock);
 	vclock_reset(&restart_vclock, 0, vclock_get(&relay->r->vclock, 0));
-	struct recovery *r = recovery_new(wal_dir(), false, &restart_vclock);
-	rlist_swap(&relay->r->on_close_log, &r->on_close_log);
-	recovery_delete(relay->r);
-	relay->r = r;
+	relay->wal_reader.is_attached = false;
+	ibuf_reset(&relay->wal_buf);
+	relay_reset_recovery(relay, &restart_vclock);
 	recover_remaining_wals(relay->r, &relay->stream, NULL, true);
 }
 
@@ -31,6 +31,7 @@
  * SUCH DAMAGE.
  */
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #if defined(__cplusplus)
@@ -41,6 +42,7 @@ struct relay;
 struct replica;
 struct tt_uuid;
 struct vclock;
+struct xrow_compressor;
 
 enum relay_state {
 	/**
@@ -65,6 +67,13 @@ relay_new(struct replica *replica);
 void
 relay_cancel(struct relay *relay);
 
+/**
+ * Stop the thread running relays in the fan-out mode, see
+ * replication_relay_fanout. Called on shutdown.
+ */
+void
+relay_fanout_cancel(void);
+
 /** Destroy and delete the relay */
 void
 relay_delete(struct relay *relay);
@@ -93,6 +102,14 @@ relay_vclock(const struct relay *relay);
 double
 relay_last_row_time(const struct relay *relay);
 
+/**
+ * Returns the compressor of the relay's replication stream,
+ * which can be used to get compression statistics, or NULL
+ * if the stream isn't compressed.
+ */
+const struct xrow_compressor *
+relay_compressor(const struct relay *relay);
+
 /**
  * Send a Raft update request to the relay channel. It is not
  * guaranteed that it will be delivered. The connection may break.
@@ -127,11 +144,15 @@ relay_final_join(int fd, uint64_t sync, struct vclock *start_vclock,
 /**
  * Subscribe a replica to updates.
  *
+ * If the stream is compressed, the relay sends the error that
+ * stopped it to the replica itself, and the function returns
+ * instead of raising it.
+ *
  * @return none.
  */
 void
 relay_subscribe(struct replica *replica, int fd, uint64_t sync,
 		struct vclock *replica_vclock, uint32_t replica_version_id,
-		uint32_t replica_id_filter);
+		uint32_t replica_id_filter, bool compression);
 
 #endif /* TARANTOOL_REPLICATION_RELAY_H_INCLUDED */
@@ -53,8 +53,12 @@ int replication_connect_quorum = REPLICATION_CONNECT_QUORUM_ALL;
 double replication_sync_lag = 10.0; /* seconds */
 int replication_synchro_quorum = 1;
 double replication_synchro_timeout = 5.0; /* seconds */
+double replication_synchro_ack_window = 0; /* seconds */
 double replication_sync_timeout = 300.0; /* seconds */
 bool replication_skip_conflict = false;
+int replication_apply_fibers = 1;
+bool replication_compression = false;
+bool replication_relay_fanout = false;
 bool replication_anon = false;
 
 struct replicaset replicaset;
@@ -97,6 +101,9 @@ replication_init(void)
 	vclock_copy(&replicaset.applier.vclock, &replicaset.vclock);
 	rlist_create(&replicaset.applier.on_rollback);
 	rlist_create(&replicaset.applier.on_wal_write);
+	for (int i = 0; i < VCLOCK_MAX; i++)
+		rlist_create(&replicaset.applier.apply_queue[i]);
+	fiber_cond_create(&replicaset.applier.apply_cond);
 
 	rlist_create(&replicaset.on_ack);
 
@@ -113,6 +120,7 @@ replication_free(void)
 	 */
 	replicaset_foreach(replica)
 		relay_cancel(replica->relay);
+	relay_fanout_cancel();
 
 	diag_destroy(&replicaset.applier.diag);
 	trigger_destroy(&replicaset.on_ack);
@@ -137,6 +137,13 @@ extern int replication_synchro_quorum;
  */
 extern double replication_synchro_timeout;
 
+/**
+ * Time in seconds which the master node waits for more ACKs
+ * after a synchronous transaction has gathered a quorum, so
+ * that a single CONFIRM covers all of them.
+ */
+extern double replication_synchro_ack_window;
+
 /**
  * Max time to wait for appliers to synchronize before entering
  * the orphan mode.
@@ -149,6 +156,26 @@ extern double replication_sync_timeout;
  */
 extern bool replication_skip_conflict;
 
+/**
+ * Max number of transactions received by an applier that may be
+ * applied concurrently, by separate fibers. If set to 1, an
+ * applier applies transactions one by one in its own fiber.
+ */
+extern int replication_apply_fibers;
+
+/**
+ * Whether appliers should ask masters to compress the replication
+ * stream. Takes effect on reconnect.
+ */
+extern bool replication_compression;
+
+/**
+ * Whether relays should run in a single fan-out thread sharing
+ * decoded rows instead of a thread per replica. Takes effect
+ * on replica resubscribe.
+ */
+extern bool replication_relay_fanout;
+
 /**
  * Whether this replica will be anonymous or not, e.g. be preset
  * in _cluster table and have a non-zero id.
@@ -278,6 +305,18 @@ struct replicaset {
 		struct rlist on_wal_write;
 		/* Shared applier diagnostic area. */
 		struct diag diag;
+		/**
+		 * Transactions dispatched to apply fibers, per
+		 * origin instance id, in LSN order. A transaction
+		 * may be submitted to the journal only when it is
+		 * the first one in its queue.
+		 */
+		struct rlist apply_queue[VCLOCK_MAX];
+		/**
+		 * Signaled whenever a transaction leaves an apply
+		 * queue.
+		 */
+		struct fiber_cond apply_cond;
 	} applier;
 	/** Triggers are invoked on each ACK from each replica. */
 	struct rlist on_ack;
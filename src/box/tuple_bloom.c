@@ -149,6 +149,16 @@ tuple_bloom_builder_add_key(struct tuple_bloom_builder *builder,
 	return 0;
 }
 
+/** Check if a hash of a partial key is stored in a tuple bloom. */
+static inline bool
+tuple_bloom_part_maybe_has(const struct tuple_bloom *bloom,
+			   uint32_t part, uint32_t hash)
+{
+	if (bloom->is_blocked)
+		return bloom_blocked_maybe_has(&bloom->parts[part], hash);
+	return bloom_maybe_has(&bloom->parts[part], hash);
+}
+
 struct tuple_bloom *
 tuple_bloom_new(struct tuple_bloom_builder *builder, double fpr)
 {
@@ -162,6 +172,7 @@ tuple_bloom_new(struct tuple_bloom_builder *builder, double fpr)
 	}
 
 	bloom->is_legacy = false;
+	bloom->is_blocked = true;
 	bloom->part_count = 0;
 
 	for (uint32_t i = 0; i < part_count; i++) {
@@ -177,17 +188,19 @@ tuple_bloom_new(struct tuple_bloom_builder *builder, double fpr)
 		 */
 		double part_fpr = fpr;
 		for (uint32_t j = 0; j < i; j++)
-			part_fpr /= bloom_fpr(&bloom->parts[j], count);
+			part_fpr /= bloom_blocked_fpr(&bloom->parts[j], count);
 		part_fpr = MIN(part_fpr, 0.5);
-		if (bloom_create(&bloom->parts[i], count, part_fpr) != 0) {
-			diag_set(OutOfMemory, 0, "bloom_create",
+		if (bloom_blocked_create(&bloom->parts[i], count,
+					 part_fpr) != 0) {
+			diag_set(OutOfMemory, 0, "bloom_blocked_create",
 				 "tuple bloom part");
 			tuple_bloom_delete(bloom);
 			return NULL;
 		}
 		bloom->part_count++;
 		for (uint32_t k = 0; k < count; k++)
-			bloom_add(&bloom->parts[i], hash_arr->values[k]);
+			bloom_blocked_add(&bloom->parts[i],
+					  hash_arr->values[k]);
 	}
 	return bloom;
 }
@@ -222,7 +235,7 @@ tuple_bloom_maybe_has(const struct tuple_bloom *bloom, struct tuple *tuple,
 						  &key_def->parts[i],
 						  multikey_idx);
 		uint32_t hash = PMurHash32_Result(h, carry, total_size);
-		if (!bloom_maybe_has(&bloom->parts[i], hash))
+		if (!tuple_bloom_part_maybe_has(bloom, i, hash))
 			return false;
 	}
 	return true;
@@ -251,7 +264,7 @@ tuple_bloom_maybe_has_key(const struct tuple_bloom *bloom,
 		total_size += tuple_hash_field(&h, &carry, &key,
 					       key_def->parts[i].coll);
 		uint32_t hash = PMurHash32_Result(h, carry, total_size);
-		if (!bloom_maybe_has(&bloom->parts[i], hash))
+		if (!tuple_bloom_part_maybe_has(bloom, i, hash))
 			return false;
 	}
 	return true;
@@ -317,8 +330,8 @@ tuple_bloom_encode(const struct tuple_bloom *bloom, char *buf)
 	return buf;
 }
 
-struct tuple_bloom *
-tuple_bloom_decode(const char **data)
+static struct tuple_bloom *
+tuple_bloom_do_decode(const char **data, bool is_blocked)
 {
 	uint32_t part_count = mp_decode_array(data);
 	struct tuple_bloom *bloom = malloc(sizeof(*bloom) +
@@ -331,6 +344,7 @@ tuple_bloom_decode(const char **data)
 	}
 
 	bloom->is_legacy = false;
+	bloom->is_blocked = is_blocked;
 	bloom->part_count = 0;
 
 	for (uint32_t i = 0; i < part_count; i++) {
@@ -343,6 +357,18 @@ tuple_bloom_decode(const char **data)
 	return bloom;
 }
 
+struct tuple_bloom *
+tuple_bloom_decode(const char **data)
+{
+	return tuple_bloom_do_decode(data, false);
+}
+
+struct tuple_bloom *
+tuple_bloom_decode_blocked(const char **data)
+{
+	return tuple_bloom_do_decode(data, true);
+}
+
 struct tuple_bloom *
 tuple_bloom_decode_legacy(const char **data)
 {
@@ -355,6 +381,7 @@ tuple_bloom_decode_legacy(const char **data)
 	}
 
 	bloom->is_legacy = true;
+	bloom->is_blocked = false;
 	bloom->part_count = 1;
 
 	if (mp_decode_array(data) != 4)
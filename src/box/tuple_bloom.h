@@ -58,6 +58,13 @@ struct tuple_bloom {
 	 * (see tuple_bloom_decode_legacy).
 	 */
 	bool is_legacy;
+	/**
+	 * If the following flag is set, partial key bloom
+	 * filters are blocked (see bloom_blocked_create), i.e.
+	 * a check of a partial key touches only one cache line
+	 * and doesn't branch on bits.
+	 */
+	bool is_blocked;
 	/** Number of key parts. */
 	uint32_t part_count;
 	/** Array of bloom filters, one per each partial key. */
@@ -151,7 +158,7 @@ tuple_bloom_builder_add_key(struct tuple_bloom_builder *builder,
 			    struct key_def *key_def);
 
 /**
- * Create a new tuple bloom filter.
+ * Create a new tuple bloom filter. The filter is blocked.
  * @param builder - bloom filter builder
  * @param fpr - desired false positive rate
  * @return bloom filter on success or NULL on OOM
@@ -219,6 +226,19 @@ tuple_bloom_encode(const struct tuple_bloom *bloom, char *buf);
 struct tuple_bloom *
 tuple_bloom_decode(const char **data);
 
+/**
+ * Decode a blocked tuple bloom filter from MsgPack.
+ * @param data - pointer to buffer storing encoded bloom filter;
+ *  on success it is advanced by the number of decoded bytes
+ * @return the decoded bloom on success or NULL on OOM
+ *
+ * Blocked bloom filters are encoded in the same way as classic
+ * ones, but they must be stored under a different key, because
+ * they use different hash functions.
+ */
+struct tuple_bloom *
+tuple_bloom_decode_blocked(const char **data);
+
 /**
  * Decode a legacy bloom filter from MsgPack.
  * @param data - pointer to buffer storing encoded bloom filter;
@@ -33,6 +33,8 @@
 #include "replication.h"
 #include "iproto_constants.h"
 #include "journal.h"
+#include "histogram.h"
+#include "info/info.h"
 #include "box.h"
 
 struct txn_limbo txn_limbo;
@@ -41,12 +43,30 @@ static inline void
 txn_limbo_create(struct txn_limbo *limbo)
 {
 	rlist_create(&limbo->queue);
+	limbo->len = 0;
 	limbo->owner_id = REPLICA_ID_NIL;
 	fiber_cond_create(&limbo->wait_cond);
 	vclock_create(&limbo->vclock);
 	limbo->confirmed_lsn = 0;
+	limbo->confirm_cursor = NULL;
+	limbo->is_confirm_pending = false;
+	limbo->is_confirm_in_progress = false;
+	fiber_cond_create(&limbo->confirm_cond);
+	limbo->confirm_fiber = NULL;
 	limbo->rollback_count = 0;
 	limbo->is_in_rollback = false;
+
+	static const int64_t queue_len_buckets[] = {
+		1, 2, 4, 8, 16, 32, 64, 128, 256, 512, 1024, 2048, 4096,
+		8192, 16384, 32768, 65536,
+	};
+	limbo->stat.ack_count = 0;
+	limbo->stat.confirm_count = 0;
+	limbo->stat.queue_len = histogram_new(queue_len_buckets,
+					      lengthof(queue_len_buckets));
+	if (limbo->stat.queue_len == NULL ||
+	    latency_create(&limbo->stat.confirm_latency) != 0)
+		panic("failed to allocate limbo statistics");
 }
 
 bool
@@ -114,10 +134,12 @@ txn_limbo_append(struct txn_limbo *limbo, uint32_t id, struct txn *txn)
 	}
 	e->txn = txn;
 	e->lsn = -1;
-	e->ack_count = 0;
+	e->insertion_time = fiber_clock();
 	e->is_commit = false;
 	e->is_rollback = false;
 	rlist_add_tail_entry(&limbo->queue, e, in_queue);
+	limbo->len++;
+	histogram_collect(limbo->stat.queue_len, limbo->len);
 	/*
 	 * We added new entries from a remote instance to an empty limbo.
 	 * Time to make this instance read-only.
@@ -132,8 +154,10 @@ txn_limbo_remove(struct txn_limbo *limbo, struct txn_limbo_entry *entry)
 {
 	assert(!rlist_empty(&entry->in_queue));
 	assert(txn_limbo_first_entry(limbo) == entry);
-	(void) limbo;
 	rlist_del_entry(entry, in_queue);
+	limbo->len--;
+	if (limbo->confirm_cursor == entry)
+		limbo->confirm_cursor = NULL;
 }
 
 static inline void
@@ -144,6 +168,9 @@ txn_limbo_pop(struct txn_limbo *limbo, struct txn_limbo_entry *entry)
 	assert(entry->is_rollback);
 
 	rlist_del_entry(entry, in_queue);
+	limbo->len--;
+	if (limbo->confirm_cursor == entry)
+		limbo->confirm_cursor = NULL;
 	++limbo->rollback_count;
 }
 
@@ -183,20 +210,14 @@ txn_limbo_assign_local_lsn(struct txn_limbo *limbo,
 	assert(lsn > 0);
 	assert(txn_has_flag(entry->txn, TXN_WAIT_ACK));
 
-	entry->lsn = lsn;
 	/*
 	 * The entry just got its LSN after a WAL write. It could
-	 * happen that this LSN was already ACKed by some
-	 * replicas. Update the ACK counter to take them into
-	 * account.
+	 * happen that this LSN was already ACKed by some replicas.
+	 * There's nothing to update though - ACKs are accounted in
+	 * the limbo vclock, which is checked by txn_limbo_ack().
 	 */
-	struct vclock_iterator iter;
-	vclock_iterator_init(&iter, &limbo->vclock);
-	int ack_count = 0;
-	vclock_foreach(&iter, vc)
-		ack_count += vc.lsn >= lsn;
-	assert(ack_count >= entry->ack_count);
-	entry->ack_count = ack_count;
+	(void) limbo;
+	entry->lsn = lsn;
 }
 
 void
@@ -358,17 +379,112 @@ txn_limbo_write_synchro(struct txn_limbo *limbo, uint32_t type, int64_t lsn)
 	}
 }
 
+static void
+txn_limbo_read_confirm(struct txn_limbo *limbo, int64_t lsn);
+
 /**
- * Write a confirmation entry to WAL. After it's written all the
- * transactions waiting for confirmation may be finished.
+ * Schedule confirmation of all the entries <= @a lsn. The
+ * CONFIRM entry is written by txn_limbo_flush_confirm(), so
+ * that confirmations scheduled one after another are written
+ * as one entry.
  */
 static void
-txn_limbo_write_confirm(struct txn_limbo *limbo, int64_t lsn)
+txn_limbo_schedule_confirm(struct txn_limbo *limbo, int64_t lsn)
 {
 	assert(lsn > limbo->confirmed_lsn);
 	assert(!limbo->is_in_rollback);
 	limbo->confirmed_lsn = lsn;
-	txn_limbo_write_synchro(limbo, IPROTO_CONFIRM, lsn);
+	if (!limbo->is_confirm_pending) {
+		limbo->is_confirm_pending = true;
+		fiber_cond_broadcast(&limbo->confirm_cond);
+	}
+}
+
+/**
+ * Write a confirmation entry for the last scheduled LSN to WAL
+ * and finish the confirmed transactions. If a confirmation is
+ * being written by another fiber, wait for it to complete.
+ */
+static void
+txn_limbo_flush_confirm(struct txn_limbo *limbo)
+{
+	while (limbo->is_confirm_pending || limbo->is_confirm_in_progress) {
+		if (limbo->is_confirm_in_progress) {
+			fiber_cond_wait(&limbo->confirm_cond);
+			continue;
+		}
+		assert(!limbo->is_in_rollback);
+		/*
+		 * ACKs received while the entry is being written
+		 * schedule the next one, which will cover all of
+		 * them.
+		 */
+		int64_t lsn = limbo->confirmed_lsn;
+		limbo->is_confirm_pending = false;
+		limbo->is_confirm_in_progress = true;
+		txn_limbo_write_synchro(limbo, IPROTO_CONFIRM, lsn);
+		limbo->stat.confirm_count++;
+		txn_limbo_read_confirm(limbo, lsn);
+		limbo->is_confirm_in_progress = false;
+		fiber_cond_broadcast(&limbo->confirm_cond);
+	}
+}
+
+/**
+ * Return the LSN of the last synchronous entry that has gathered
+ * a quorum of ACKs and hasn't been confirmed yet or -1 if there's
+ * no such entry.
+ */
+static int64_t
+txn_limbo_quorum_lsn(struct txn_limbo *limbo)
+{
+	/*
+	 * An LSN has a quorum if replication_synchro_quorum
+	 * vclock components are >= it. Find the greatest such
+	 * LSN by sorting the components in descending order.
+	 */
+	int64_t lsns[VCLOCK_MAX];
+	int count = 0;
+	struct vclock_iterator iter;
+	vclock_iterator_init(&iter, &limbo->vclock);
+	vclock_foreach(&iter, vc) {
+		int i = count++;
+		for (; i > 0 && lsns[i - 1] < vc.lsn; i--)
+			lsns[i] = lsns[i - 1];
+		lsns[i] = vc.lsn;
+	}
+	if (count < replication_synchro_quorum)
+		return -1;
+	int64_t quorum_lsn = lsns[replication_synchro_quorum - 1];
+	if (quorum_lsn <= limbo->confirmed_lsn)
+		return -1;
+	/*
+	 * Entries up to the cursor have been confirmed already.
+	 * Find the last synchronous one covered by the quorum.
+	 */
+	int64_t confirm_lsn = -1;
+	struct txn_limbo_entry *e = limbo->confirm_cursor;
+	if (e == NULL)
+		e = txn_limbo_first_entry(limbo);
+	else
+		e = rlist_next_entry(e, in_queue);
+	for (; &e->in_queue != &limbo->queue;
+	     e = rlist_next_entry(e, in_queue)) {
+		/*
+		 * Async transactions are automatically committed
+		 * right after all the previous sync transactions
+		 * are.
+		 */
+		if (!txn_has_flag(e->txn, TXN_WAIT_ACK))
+			continue;
+		/* WAL write is in progress or not enough ACKs. */
+		if (e->lsn == -1 || e->lsn > quorum_lsn)
+			break;
+		limbo->confirm_cursor = e;
+		confirm_lsn = e->lsn;
+	}
+	assert(confirm_lsn == -1 || confirm_lsn > limbo->confirmed_lsn);
+	return confirm_lsn;
 }
 
 /** Confirm all the entries <= @a lsn. */
@@ -396,6 +512,10 @@ txn_limbo_read_confirm(struct txn_limbo *limbo, int64_t lsn)
 			if (e->lsn == -1)
 				break;
 		}
+		if (txn_has_flag(e->txn, TXN_WAIT_ACK)) {
+			latency_collect(&limbo->stat.confirm_latency,
+					fiber_clock() - e->insertion_time);
+		}
 		e->is_commit = true;
 		txn_limbo_remove(limbo, e);
 		txn_clear_flags(e->txn, TXN_WAIT_SYNC | TXN_WAIT_ACK);
@@ -516,33 +636,14 @@ txn_limbo_ack(struct txn_limbo *limbo, uint32_t replica_id, int64_t lsn)
 	if (lsn == prev_lsn)
 		return;
 	vclock_follow(&limbo->vclock, replica_id, lsn);
-	struct txn_limbo_entry *e;
-	int64_t confirm_lsn = -1;
-	rlist_foreach_entry(e, &limbo->queue, in_queue) {
-		assert(e->ack_count <= VCLOCK_MAX);
-		if (e->lsn > lsn)
-			break;
-		/*
-		 * Sync transactions need to collect acks. Async
-		 * transactions are automatically committed right
-		 * after all the previous sync transactions are.
-		 */
-		if (!txn_has_flag(e->txn, TXN_WAIT_ACK)) {
-			assert(e->lsn == -1);
-			if (confirm_lsn == -1)
-				continue;
-		} else if (e->lsn <= prev_lsn) {
-			continue;
-		} else if (++e->ack_count < replication_synchro_quorum) {
-			continue;
-		} else {
-			confirm_lsn = e->lsn;
-		}
-	}
-	if (confirm_lsn == -1 || confirm_lsn <= limbo->confirmed_lsn)
-		return;
-	txn_limbo_write_confirm(limbo, confirm_lsn);
-	txn_limbo_read_confirm(limbo, confirm_lsn);
+	limbo->stat.ack_count++;
+	/*
+	 * Don't write CONFIRM right away. The confirm fiber will
+	 * do it, covering all the ACKs received in the meantime.
+	 */
+	int64_t confirm_lsn = txn_limbo_quorum_lsn(limbo);
+	if (confirm_lsn != -1)
+		txn_limbo_schedule_confirm(limbo, confirm_lsn);
 }
 
 /**
@@ -672,8 +773,13 @@ txn_limbo_force_empty(struct txn_limbo *limbo, int64_t confirm_lsn)
 	}
 
 	if (last_quorum != NULL) {
-		txn_limbo_write_confirm(limbo, last_quorum->lsn);
-		txn_limbo_read_confirm(limbo, last_quorum->lsn);
+		/*
+		 * The confirmation may have been scheduled already.
+		 * Either way, wait for it to be written.
+		 */
+		if (last_quorum->lsn > limbo->confirmed_lsn)
+			txn_limbo_schedule_confirm(limbo, last_quorum->lsn);
+		txn_limbo_flush_confirm(limbo);
 	}
 	if (rollback != NULL) {
 		txn_limbo_write_rollback(limbo, rollback->lsn);
@@ -686,24 +792,10 @@ txn_limbo_on_parameters_change(struct txn_limbo *limbo)
 {
 	if (rlist_empty(&limbo->queue))
 		return;
-	struct txn_limbo_entry *e;
-	int64_t confirm_lsn = -1;
-	rlist_foreach_entry(e, &limbo->queue, in_queue) {
-		assert(e->ack_count <= VCLOCK_MAX);
-		if (!txn_has_flag(e->txn, TXN_WAIT_ACK)) {
-			assert(e->lsn == -1);
-			if (confirm_lsn == -1)
-				continue;
-		} else if (e->ack_count < replication_synchro_quorum) {
-			continue;
-		} else {
-			confirm_lsn = e->lsn;
-			assert(confirm_lsn > 0);
-		}
-	}
-	if (confirm_lsn > limbo->confirmed_lsn && !limbo->is_in_rollback) {
-		txn_limbo_write_confirm(limbo, confirm_lsn);
-		txn_limbo_read_confirm(limbo, confirm_lsn);
+	if (limbo->owner_id == instance_id && !limbo->is_in_rollback) {
+		int64_t confirm_lsn = txn_limbo_quorum_lsn(limbo);
+		if (confirm_lsn != -1)
+			txn_limbo_schedule_confirm(limbo, confirm_lsn);
 	}
 	/*
 	 * Wakeup all the others - timed out will rollback. Also
@@ -715,8 +807,76 @@ txn_limbo_on_parameters_change(struct txn_limbo *limbo)
 	fiber_cond_broadcast(&limbo->wait_cond);
 }
 
+/**
+ * Confirm fiber function. Waits for confirmations scheduled by
+ * ACKs and writes them to WAL.
+ */
+static int
+txn_limbo_confirm_f(va_list ap)
+{
+	struct txn_limbo *limbo = va_arg(ap, struct txn_limbo *);
+	while (!fiber_is_cancelled()) {
+		if (!limbo->is_confirm_pending ||
+		    limbo->is_confirm_in_progress) {
+			fiber_cond_wait(&limbo->confirm_cond);
+			continue;
+		}
+		/* Let more ACKs arrive to cover them all at once. */
+		if (replication_synchro_ack_window > 0)
+			fiber_sleep(replication_synchro_ack_window);
+		txn_limbo_flush_confirm(limbo);
+	}
+	return 0;
+}
+
+static int64_t
+txn_limbo_stat_percentile(struct histogram *hist, int pct)
+{
+	return hist->total > 0 ? histogram_percentile(hist, pct) : 0;
+}
+
+void
+txn_limbo_stat(struct txn_limbo *limbo, struct info_handler *h)
+{
+	struct histogram *queue_len = limbo->stat.queue_len;
+	struct latency *latency = &limbo->stat.confirm_latency;
+	info_begin(h);
+	info_append_int(h, "len", limbo->len);
+	info_append_int(h, "acks", limbo->stat.ack_count);
+	info_append_int(h, "confirms", limbo->stat.confirm_count);
+	info_table_begin(h, "queue_len");
+	info_append_int(h, "p50", txn_limbo_stat_percentile(queue_len, 50));
+	info_append_int(h, "p75", txn_limbo_stat_percentile(queue_len, 75));
+	info_append_int(h, "p90", txn_limbo_stat_percentile(queue_len, 90));
+	info_append_int(h, "p95", txn_limbo_stat_percentile(queue_len, 95));
+	info_append_int(h, "p99", txn_limbo_stat_percentile(queue_len, 99));
+	info_table_end(h); /* queue_len */
+	info_table_begin(h, "confirm_latency");
+	info_append_double(h, "p50", latency_get(latency, 50));
+	info_append_double(h, "p75", latency_get(latency, 75));
+	info_append_double(h, "p90", latency_get(latency, 90));
+	info_append_double(h, "p95", latency_get(latency, 95));
+	info_append_double(h, "p99", latency_get(latency, 99));
+	info_table_end(h); /* confirm_latency */
+	info_end(h);
+}
+
+void
+txn_limbo_reset_stat(struct txn_limbo *limbo)
+{
+	limbo->stat.ack_count = 0;
+	limbo->stat.confirm_count = 0;
+	histogram_reset(limbo->stat.queue_len);
+	latency_reset(&limbo->stat.confirm_latency);
+}
+
 void
 txn_limbo_init(void)
 {
 	txn_limbo_create(&txn_limbo);
+	struct fiber *f = fiber_new("limbo", txn_limbo_confirm_f);
+	if (f == NULL)
+		panic("failed to start limbo confirm fiber");
+	txn_limbo.confirm_fiber = f;
+	fiber_start(f, &txn_limbo);
 }
@@ -31,6 +31,8 @@
  */
 #include "small/rlist.h"
 #include "vclock/vclock.h"
+#include "fiber_cond.h"
+#include "latency.h"
 
 #include <stdint.h>
 
@@ -40,6 +42,8 @@ extern "C" {
 
 struct txn;
 struct synchro_request;
+struct histogram;
+struct info_handler;
 
 /**
  * Transaction and its quorum metadata, to be stored in limbo.
@@ -55,11 +59,8 @@ struct txn_limbo_entry {
 	 * written to WAL yet.
 	 */
 	int64_t lsn;
-	/**
-	 * Number of ACKs. Or in other words - how many replicas
-	 * confirmed receipt of the transaction.
-	 */
-	int ack_count;
+	/** Time when the entry was added to the limbo. */
+	double insertion_time;
 	/**
 	 * Result flags. Only one of them can be true. But both
 	 * can be false if the transaction is still waiting for
@@ -94,6 +95,8 @@ struct txn_limbo {
 	 * them LSNs in the same order.
 	 */
 	struct rlist queue;
+	/** Number of entries in the queue. */
+	int64_t len;
 	/**
 	 * Instance ID of the owner of all the transactions in the
 	 * queue. Strictly speaking, nothing prevents to store not
@@ -127,12 +130,41 @@ struct txn_limbo {
 	struct vclock vclock;
 	/**
 	 * Maximal LSN gathered quorum and either already confirmed in WAL, or
-	 * whose confirmation is in progress right now. Any attempt to confirm
-	 * something smaller than this value can be safely ignored. Moreover,
-	 * any attempt to rollback something starting from <= this LSN is
-	 * illegal.
+	 * whose confirmation is in progress or scheduled right now. Any
+	 * attempt to confirm something smaller than this value can be safely
+	 * ignored. Moreover, any attempt to rollback something starting from
+	 * <= this LSN is illegal.
 	 */
 	int64_t confirmed_lsn;
+	/**
+	 * The last synchronous entry known to have gathered a
+	 * quorum, i.e. the one with LSN equal to confirmed_lsn,
+	 * or NULL if it has left the queue. Entries following it
+	 * are the only ones that may need to be confirmed, so the
+	 * search for them starts here rather than at the queue
+	 * head.
+	 */
+	struct txn_limbo_entry *confirm_cursor;
+	/**
+	 * Set if confirmed_lsn has been advanced, but CONFIRM
+	 * hasn't been written for it yet.
+	 */
+	bool is_confirm_pending;
+	/** Set while CONFIRM is being written to WAL. */
+	bool is_confirm_in_progress;
+	/**
+	 * Condition signaled when a CONFIRM is scheduled or
+	 * written, see is_confirm_pending.
+	 */
+	struct fiber_cond confirm_cond;
+	/**
+	 * Fiber writing CONFIRM entries. ACKs don't write CONFIRM
+	 * themselves. Instead, they advance confirmed_lsn and wake
+	 * up the fiber, so that ACKs received while a CONFIRM is
+	 * being written, or during replication_synchro_ack_window,
+	 * are covered by a single CONFIRM.
+	 */
+	struct fiber *confirm_fiber;
 	/**
 	 * Total number of performed rollbacks. It used as a guard
 	 * to do some actions assuming all limbo transactions will
@@ -157,6 +189,17 @@ struct txn_limbo {
 	 * by the 'reversed rollback order' rule - contradiction.
 	 */
 	bool is_in_rollback;
+	/** Statistics, see box.stat.synchro(). */
+	struct {
+		/** Number of ACKs received. */
+		int64_t ack_count;
+		/** Number of CONFIRM entries written. */
+		int64_t confirm_count;
+		/** Queue length observed by new entries. */
+		struct histogram *queue_len;
+		/** Time from adding an entry to confirming it. */
+		struct latency confirm_latency;
+	} stat;
 };
 
 /**
@@ -283,6 +326,14 @@ txn_limbo_force_empty(struct txn_limbo *limbo, int64_t last_confirm);
 void
 txn_limbo_on_parameters_change(struct txn_limbo *limbo);
 
+/** Output limbo statistics, see box.stat.synchro(). */
+void
+txn_limbo_stat(struct txn_limbo *limbo, struct info_handler *h);
+
+/** Reset limbo statistics. */
+void
+txn_limbo_reset_stat(struct txn_limbo *limbo);
+
 /**
  * Initialize qsync engine.
  */
@@ -71,6 +71,8 @@
 #include "column_mask.h"
 #include "trigger.h"
 #include "wal.h" /* wal_mode() */
+#include "port.h"
+#include "third_party/qsort_arg.h"
 
 /**
  * Yield after iterating over this many objects (e.g. ranges).
@@ -297,9 +299,36 @@ vy_info_append_memory(struct vy_env *env, struct info_handler *h)
 	info_append_int(h, "tuple_cache", env->cache_env.mem_used);
 	info_append_int(h, "page_index", env->lsm_env.page_index_size);
 	info_append_int(h, "bloom_filter", env->lsm_env.bloom_size);
+	info_append_int(h, "page_cache", env->run_env.page_cache.mem_used);
 	info_table_end(h); /* memory */
 }
 
+static void
+vy_info_append_page_cache(struct vy_env *env, struct info_handler *h)
+{
+	struct vy_page_cache *cache = &env->run_env.page_cache;
+	info_table_begin(h, "page_cache");
+	info_append_int(h, "hit", cache->stat.hit);
+	info_append_int(h, "miss", cache->stat.miss);
+	info_append_int(h, "evict", cache->stat.evict);
+	info_table_end(h); /* page_cache */
+}
+
+static void
+vy_info_append_quota(struct vy_env *env, struct info_handler *h)
+{
+	info_table_begin(h, "quota");
+	for (int i = 0; i < vy_quota_consumer_type_MAX; i++) {
+		struct vy_quota_stat *stat = &env->quota.stat[i];
+		info_table_begin(h, vy_quota_consumer_type_strs[i]);
+		info_append_int(h, "throttle_count", stat->throttle_count);
+		info_append_int(h, "throttled_bytes", stat->throttled_bytes);
+		info_append_double(h, "wait_time", stat->wait_time);
+		info_table_end(h);
+	}
+	info_table_end(h); /* quota */
+}
+
 static void
 vy_info_append_disk(struct vy_env *env, struct info_handler *h)
 {
@@ -321,6 +350,8 @@ vinyl_engine_stat(struct engine *engine, struct info_handler *h)
 	vy_info_append_disk(env, h);
 	vy_info_append_scheduler(env, h);
 	vy_info_append_regulator(env, h);
+	vy_info_append_page_cache(env, h);
+	vy_info_append_quota(env, h);
 	info_end(h);
 }
 
@@ -455,6 +486,33 @@ vinyl_index_stat(struct index *index, struct info_handler *h)
 	info_append_int(h, "dumps_per_compaction",
 			vy_lsm_dumps_per_compaction(lsm));
 
+	/*
+	 * Amplification factors resulting from the compaction
+	 * policy: bytes written to disk per byte dumped, runs
+	 * checked per lookup, and disk bytes per byte of data
+	 * stored at the last level.
+	 */
+	info_table_begin(h, "amplification");
+	const struct vy_compaction_policy *policy =
+		vy_compaction_policy_by_type(lsm->opts.compaction_policy);
+	info_append_str(h, "policy", policy->name);
+	double write_amp = 0;
+	if (stat->disk.dump.input.bytes > 0) {
+		write_amp = (double)(stat->disk.dump.output.bytes +
+				     stat->disk.compaction.output.bytes) /
+			    stat->disk.dump.input.bytes;
+	}
+	info_append_double(h, "write", write_amp);
+	info_append_double(h, "read",
+			   (double)lsm->run_count / lsm->range_count);
+	double space_amp = 0;
+	if (stat->disk.last_level_count.bytes > 0) {
+		space_amp = (double)stat->disk.count.bytes /
+			    stat->disk.last_level_count.bytes;
+	}
+	info_append_double(h, "space", space_amp);
+	info_table_end(h); /* amplification */
+
 	info_end(h);
 }
 
@@ -509,6 +567,7 @@ vinyl_engine_memory_stat(struct engine *engine, struct engine_memory_stat *stat)
 	stat->index += env->lsm_env.bloom_size;
 	stat->index += env->lsm_env.page_index_size;
 	stat->cache += env->cache_env.mem_used;
+	stat->cache += env->run_env.page_cache.mem_used;
 	stat->tx += vy_tx_manager_mem_used(env->xm);
 }
 
@@ -519,9 +578,12 @@ vinyl_engine_reset_stat(struct engine *engine)
 
 	struct vy_tx_manager *xm = env->xm;
 	memset(&xm->stat, 0, sizeof(xm->stat));
+	memset(&env->run_env.page_cache.stat, 0,
+	       sizeof(env->run_env.page_cache.stat));
 
 	vy_scheduler_reset_stat(&env->scheduler);
 	vy_regulator_reset_stat(&env->regulator);
+	vy_quota_reset_stat(&env->quota);
 }
 
 /** }}} Introspection */
@@ -1260,6 +1322,8 @@ vy_is_committed(struct vy_env *env, struct vy_lsm *lsm)
  * @param tx          Current transaction.
  * @param rv          Read view.
  * @param entry       Tuple read from a secondary index.
+ * @param no_cache    Don't add the full tuple to the primary
+ *                    index cache.
  * @param[out] result The found tuple is stored here. Must be
  *                    unreferenced after usage.
  *
@@ -1269,7 +1333,8 @@ vy_is_committed(struct vy_env *env, struct vy_lsm *lsm)
 static int
 vy_get_by_secondary_tuple(struct vy_lsm *lsm, struct vy_tx *tx,
 			  const struct vy_read_view **rv,
-			  struct vy_entry entry, struct vy_entry *result)
+			  struct vy_entry entry, bool no_cache,
+			  struct vy_entry *result)
 {
 	int rc = 0;
 	assert(lsm->index_id > 0);
@@ -1355,7 +1420,7 @@ vy_get_by_secondary_tuple(struct vy_lsm *lsm, struct vy_tx *tx,
 		goto out;
 	}
 
-	if ((*rv)->vlsn == INT64_MAX) {
+	if (!no_cache && (*rv)->vlsn == INT64_MAX) {
 		vy_cache_add(&lsm->pk->cache, pk_entry,
 			     vy_entry_none(), key, ITER_EQ);
 	}
@@ -1409,8 +1474,8 @@ vy_get(struct vy_lsm *lsm, struct vy_tx *tx,
 		if (vy_point_lookup(lsm, tx, rv, key, &partial) != 0)
 			return -1;
 		if (lsm->index_id > 0 && partial.stmt != NULL) {
-			rc = vy_get_by_secondary_tuple(lsm, tx, rv,
-						       partial, &entry);
+			rc = vy_get_by_secondary_tuple(lsm, tx, rv, partial,
+						       false, &entry);
 			tuple_unref(partial.stmt);
 			if (rc != 0)
 				return -1;
@@ -1433,7 +1498,8 @@ vy_get(struct vy_lsm *lsm, struct vy_tx *tx,
 				tuple_ref(entry.stmt);
 			break;
 		}
-		rc = vy_get_by_secondary_tuple(lsm, tx, rv, partial, &entry);
+		rc = vy_get_by_secondary_tuple(lsm, tx, rv, partial,
+					       false, &entry);
 		if (rc != 0 || entry.stmt != NULL)
 			break;
 	}
@@ -2425,7 +2491,9 @@ vinyl_engine_prepare(struct engine *engine, struct txn *txn)
 	 * the transaction to be sent to read view or aborted, we call
 	 * it before checking for conflicts.
 	 */
-	if (vy_quota_use(&env->quota, VY_QUOTA_CONSUMER_TX,
+	enum vy_quota_consumer_type quota_type = tx->is_bulk ?
+		VY_QUOTA_CONSUMER_BULK : VY_QUOTA_CONSUMER_TX;
+	if (vy_quota_use(&env->quota, quota_type,
 			 tx->write_size, timeout) != 0)
 		return -1;
 
@@ -2435,7 +2503,7 @@ vinyl_engine_prepare(struct engine *engine, struct txn *txn)
 
 	size_t mem_used_after = lsregion_used(&env->mem_env.allocator);
 	assert(mem_used_after >= mem_used_before);
-	vy_quota_adjust(&env->quota, VY_QUOTA_CONSUMER_TX,
+	vy_quota_adjust(&env->quota, quota_type,
 			tx->write_size, mem_used_after - mem_used_before);
 	vy_regulator_check_dump_watermark(&env->regulator);
 	return rc;
@@ -2461,7 +2529,8 @@ vinyl_engine_commit(struct engine *engine, struct txn *txn)
 	size_t mem_used_after = lsregion_used(&env->mem_env.allocator);
 	assert(mem_used_after >= mem_used_before);
 	/* We can't abort the transaction at this point, use force. */
-	vy_quota_force_use(&env->quota, VY_QUOTA_CONSUMER_TX,
+	vy_quota_force_use(&env->quota, tx->is_bulk ?
+			   VY_QUOTA_CONSUMER_BULK : VY_QUOTA_CONSUMER_TX,
 			   mem_used_after - mem_used_before);
 	vy_regulator_check_dump_watermark(&env->regulator);
 
@@ -2725,6 +2794,30 @@ vinyl_engine_set_timeout(struct engine *engine, double timeout)
 	env->timeout = timeout;
 }
 
+void
+vinyl_engine_set_parallel_lookup(struct engine *engine, bool value)
+{
+	struct vy_env *env = vy_env(engine);
+	env->run_env.parallel_lookup = value;
+}
+
+void
+vinyl_engine_set_compaction_parts(struct engine *engine, int parts)
+{
+	struct vy_env *env = vy_env(engine);
+	env->scheduler.compaction_max_parts = parts;
+}
+
+void
+vinyl_engine_set_page_cache(struct engine *engine, size_t quota,
+			    bool store_compressed)
+{
+	struct vy_env *env = vy_env(engine);
+	struct vy_page_cache *cache = &env->run_env.page_cache;
+	cache->store_compressed = store_compressed;
+	vy_page_cache_set_quota(cache, quota);
+}
+
 void
 vinyl_engine_set_too_long_threshold(struct engine *engine,
 				    double too_long_threshold)
@@ -3563,7 +3656,8 @@ vinyl_iterator_primary_next(struct iterator *base, struct tuple **ret)
 	struct vy_entry entry;
 	if (vy_read_iterator_next(&it->iterator, &entry) != 0)
 		goto fail;
-	vy_read_iterator_cache_add(&it->iterator, entry);
+	if (!base->no_cache)
+		vy_read_iterator_cache_add(&it->iterator, entry);
 	vinyl_iterator_account_read(it, start_time, entry.stmt);
 	if (entry.stmt == NULL) {
 		/* EOF. Close the iterator immediately. */
@@ -3605,7 +3699,9 @@ next:
 
 	if (partial.stmt == NULL) {
 		/* EOF. Close the iterator immediately. */
-		vy_read_iterator_cache_add(&it->iterator, vy_entry_none());
+		if (!base->no_cache)
+			vy_read_iterator_cache_add(&it->iterator,
+						   vy_entry_none());
 		vinyl_iterator_account_read(it, start_time, NULL);
 		vinyl_iterator_close(it);
 		*ret = NULL;
@@ -3614,11 +3710,12 @@ next:
 	ERROR_INJECT_YIELD(ERRINJ_VY_DELAY_PK_LOOKUP);
 	/* Get the full tuple from the primary index. */
 	if (vy_get_by_secondary_tuple(lsm, it->tx, vy_tx_read_view(it->tx),
-				      partial, &entry) != 0)
+				      partial, base->no_cache, &entry) != 0)
 		goto fail;
 	if (entry.stmt == NULL)
 		goto next;
-	vy_read_iterator_cache_add(&it->iterator, entry);
+	if (!base->no_cache)
+		vy_read_iterator_cache_add(&it->iterator, entry);
 	vinyl_iterator_account_read(it, start_time, entry.stmt);
 	*ret = entry.stmt;
 	tuple_bless(*ret);
@@ -3796,6 +3893,215 @@ vinyl_index_get(struct index *index, const char *key,
 	return 0;
 }
 
+/** A key looked up by vinyl_index_get_many(). */
+struct vy_get_many_key {
+	/** Key statement. */
+	struct vy_entry key;
+	/** Position of the key in the request. */
+	uint32_t pos;
+	/**
+	 * Set if the key is equal to the previous one in
+	 * the sorted key array so that its lookup result
+	 * can be reused.
+	 */
+	bool is_dup;
+	/** Found tuple (referenced) or NULL. */
+	struct tuple *result;
+};
+
+/** Lookup state shared by vinyl_index_get_many() workers. */
+struct vy_get_many_ctx {
+	/** LSM tree to look up the keys in. */
+	struct vy_lsm *lsm;
+	/** Transaction or NULL for autocommit. */
+	struct vy_tx *tx;
+	/** Read view to look up the keys in. */
+	const struct vy_read_view **rv;
+	/** Keys sorted in the LSM tree order. */
+	struct vy_get_many_key *keys;
+	/** Number of keys. */
+	uint32_t key_count;
+	/** Index of the next key to look up. */
+	uint32_t next;
+	/** Set if a lookup failed so that workers should stop. */
+	bool is_failed;
+};
+
+static int
+vy_get_many_key_cmp(const void *a, const void *b, void *arg)
+{
+	const struct vy_get_many_key *k1 = a;
+	const struct vy_get_many_key *k2 = b;
+	struct key_def *cmp_def = arg;
+	return vy_entry_compare(k1->key, k2->key, cmp_def);
+}
+
+/**
+ * Look up keys one by one until all keys are processed.
+ * Several workers may run concurrently, each in its own fiber,
+ * so that disk reads issued for different keys are executed by
+ * reader threads in parallel.
+ */
+static int
+vy_get_many_worker(struct vy_get_many_ctx *ctx)
+{
+	while (!ctx->is_failed && ctx->next < ctx->key_count) {
+		struct vy_get_many_key *k = &ctx->keys[ctx->next++];
+		if (k->is_dup)
+			continue;
+		/* The transaction may be aborted while we yield. */
+		if (ctx->tx != NULL && ctx->tx->state == VINYL_TX_ABORT) {
+			diag_set(ClientError, ER_TRANSACTION_CONFLICT);
+			goto fail;
+		}
+		if (vy_get(ctx->lsm, ctx->tx, ctx->rv,
+			   k->key.stmt, &k->result) != 0)
+			goto fail;
+	}
+	return 0;
+fail:
+	ctx->is_failed = true;
+	return -1;
+}
+
+static int
+vy_get_many_worker_f(va_list ap)
+{
+	struct vy_get_many_ctx *ctx = va_arg(ap, struct vy_get_many_ctx *);
+	return vy_get_many_worker(ctx);
+}
+
+/**
+ * Batched point lookup. This is a parallel wrapper around
+ * vy_get(): each distinct key is still looked up on its own,
+ * with its own bloom filter checks and page reads, but lookups
+ * are executed concurrently by up to as many fibers as there
+ * are reader threads. Keys are sorted in the LSM tree order so
+ * that equal keys are looked up only once.
+ */
+static int
+vinyl_index_get_many(struct index *index, const char *keys,
+		     uint32_t key_count, struct port *port)
+{
+	struct vy_lsm *lsm = vy_lsm(index);
+	struct vy_env *env = vy_env(index->engine);
+	struct vy_tx *tx = in_txn() ? in_txn()->engine_tx : NULL;
+	const struct vy_read_view **rv = (tx != NULL ? vy_tx_read_view(tx) :
+					  &env->xm->p_global_read_view);
+
+	if (tx != NULL && tx->state == VINYL_TX_ABORT) {
+		diag_set(ClientError, ER_TRANSACTION_CONFLICT);
+		return -1;
+	}
+	if (key_count == 0)
+		return 0;
+
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	size_t size;
+	struct vy_get_many_key *sorted =
+		region_alloc_array(region, typeof(sorted[0]), key_count, &size);
+	struct tuple **found =
+		region_alloc_array(region, typeof(found[0]), key_count, &size);
+	if (sorted == NULL || found == NULL) {
+		diag_set(OutOfMemory, size, "region_alloc_array", "keys");
+		return -1;
+	}
+	int rc = -1;
+	uint32_t created = 0;
+	for (; created < key_count; created++) {
+		struct vy_get_many_key *k = &sorted[created];
+		const char *key = keys;
+		uint32_t part_count = mp_decode_array(&key);
+		mp_next(&keys);
+		k->key.stmt = vy_key_new(lsm->env->key_format, key, part_count);
+		if (k->key.stmt == NULL)
+			goto out;
+		k->key.hint = vy_stmt_hint(k->key.stmt, lsm->cmp_def);
+		k->pos = created;
+		k->is_dup = false;
+		k->result = NULL;
+	}
+	qsort_arg(sorted, key_count, sizeof(sorted[0]),
+		  vy_get_many_key_cmp, lsm->cmp_def);
+	int distinct_count = 1;
+	for (uint32_t i = 1; i < key_count; i++) {
+		sorted[i].is_dup = vy_entry_compare(sorted[i - 1].key,
+						    sorted[i].key,
+						    lsm->cmp_def) == 0;
+		if (!sorted[i].is_dup)
+			distinct_count++;
+	}
+
+	struct vy_get_many_ctx ctx;
+	ctx.lsm = lsm;
+	ctx.tx = tx;
+	ctx.rv = rv;
+	ctx.keys = sorted;
+	ctx.key_count = key_count;
+	ctx.next = 0;
+	ctx.is_failed = false;
+
+	/*
+	 * Make sure the LSM tree isn't deleted while we are
+	 * reading from it.
+	 */
+	vy_lsm_ref(lsm);
+	/* The calling fiber is a worker, too. */
+	int worker_count = MIN(distinct_count,
+			       env->run_env.reader_pool_size) - 1;
+	struct fiber **workers = NULL;
+	if (worker_count > 0) {
+		workers = region_alloc_array(region, typeof(workers[0]),
+					     worker_count, &size);
+		if (workers == NULL)
+			worker_count = 0;
+	}
+	for (int i = 0; i < worker_count; i++) {
+		workers[i] = fiber_new("vinyl.get_many",
+				       vy_get_many_worker_f);
+		if (workers[i] == NULL) {
+			/* Make do with the workers we have. */
+			diag_clear(diag_get());
+			worker_count = i;
+			break;
+		}
+		fiber_set_joinable(workers[i], true);
+		fiber_start(workers[i], &ctx);
+	}
+	rc = vy_get_many_worker(&ctx);
+	for (int i = 0; i < worker_count; i++) {
+		if (fiber_join(workers[i]) != 0)
+			rc = -1;
+	}
+	vy_lsm_unref(lsm);
+	if (rc != 0)
+		goto out;
+
+	struct tuple *last = NULL;
+	for (uint32_t i = 0; i < key_count; i++) {
+		struct vy_get_many_key *k = &sorted[i];
+		if (!k->is_dup)
+			last = k->result;
+		found[k->pos] = last;
+	}
+	for (uint32_t i = 0; i < key_count; i++) {
+		if (found[i] == NULL)
+			continue;
+		rc = port_c_add_tuple(port, found[i]);
+		if (rc != 0)
+			break;
+	}
+out:
+	for (uint32_t i = 0; i < created; i++) {
+		tuple_unref(sorted[i].key.stmt);
+		if (sorted[i].result != NULL)
+			tuple_unref(sorted[i].result);
+	}
+	region_truncate(region, region_svp);
+	return rc;
+}
+
 /*** }}} Cursor */
 
 /* {{{ Index build */
@@ -4596,6 +4902,7 @@ static const struct index_vtab vinyl_index_vtab = {
 	/* .random = */ generic_index_random,
 	/* .count = */ generic_index_count,
 	/* .get = */ vinyl_index_get,
+	/* .get_many = */ vinyl_index_get_many,
 	/* .replace = */ generic_index_replace,
 	/* .create_iterator = */ vinyl_index_create_iterator,
 	/* .create_snapshot_iterator = */
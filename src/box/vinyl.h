@@ -75,6 +75,25 @@ vinyl_engine_set_max_tuple_size(struct engine *engine, size_t max_size);
 void
 vinyl_engine_set_timeout(struct engine *engine, double timeout);
 
+/**
+ * Enable or disable parallel reading of runs on point lookups.
+ */
+void
+vinyl_engine_set_parallel_lookup(struct engine *engine, bool value);
+
+/**
+ * Update the max number of parts a range compaction can be split into.
+ */
+void
+vinyl_engine_set_compaction_parts(struct engine *engine, int parts);
+
+/**
+ * Update the page cache size and the format of cached pages.
+ */
+void
+vinyl_engine_set_page_cache(struct engine *engine, size_t quota,
+			    bool store_compressed);
+
 /**
  * Update too_long_threshold.
  */
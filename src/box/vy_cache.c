@@ -52,11 +52,16 @@ enum {
 	VY_CACHE_CLEANUP_MAX_STEPS = 10,
 };
 
+/* Max share of the cache quota that may be used by protected nodes */
+static const double VY_CACHE_PROTECTED_SHARE = 0.8;
+
 void
 vy_cache_env_create(struct vy_cache_env *e, struct slab_cache *slab_cache)
 {
 	rlist_create(&e->cache_lru);
+	rlist_create(&e->protected_lru);
 	e->mem_used = 0;
+	e->protected_mem_used = 0;
 	e->mem_quota = 0;
 	mempool_create(&e->cache_node_mempool, slab_cache,
 		       sizeof(struct vy_cache_node));
@@ -93,6 +98,7 @@ vy_cache_node_new(struct vy_cache_env *env, struct vy_cache *cache,
 	node->cache = cache;
 	node->entry = entry;
 	node->flags = 0;
+	node->is_protected = false;
 	node->left_boundary_level = cache->cmp_def->part_count;
 	node->right_boundary_level = cache->cmp_def->part_count;
 	rlist_add(&env->cache_lru, &node->in_lru);
@@ -108,12 +114,39 @@ vy_cache_node_delete(struct vy_cache_env *env, struct vy_cache_node *node)
 				     node->entry.stmt);
 	assert(env->mem_used >= vy_cache_node_size(node));
 	env->mem_used -= vy_cache_node_size(node);
+	if (node->is_protected) {
+		assert(env->protected_mem_used >= vy_cache_node_size(node));
+		env->protected_mem_used -= vy_cache_node_size(node);
+	}
 	tuple_unref(node->entry.stmt);
 	rlist_del(&node->in_lru);
 	TRASH(node);
 	mempool_free(&env->cache_node_mempool, node);
 }
 
+/**
+ * Move a cache node to the head of the protected LRU segment.
+ * If the segment overflows, demote its least recently used
+ * nodes to the probationary segment.
+ */
+static void
+vy_cache_node_promote(struct vy_cache_env *env, struct vy_cache_node *node)
+{
+	rlist_move(&env->protected_lru, &node->in_lru);
+	if (node->is_protected)
+		return;
+	node->is_protected = true;
+	env->protected_mem_used += vy_cache_node_size(node);
+	while (env->protected_mem_used >
+	       env->mem_quota * VY_CACHE_PROTECTED_SHARE) {
+		struct vy_cache_node *victim = rlist_last_entry(
+			&env->protected_lru, struct vy_cache_node, in_lru);
+		victim->is_protected = false;
+		env->protected_mem_used -= vy_cache_node_size(victim);
+		rlist_move(&env->cache_lru, &victim->in_lru);
+	}
+}
+
 static void *
 vy_cache_tree_page_alloc(void *ctx)
 {
@@ -167,6 +200,8 @@ static void
 vy_cache_gc_step(struct vy_cache_env *env)
 {
 	struct rlist *lru = &env->cache_lru;
+	if (rlist_empty(lru))
+		lru = &env->protected_lru;
 	struct vy_cache_node *node =
 		rlist_last_entry(lru, struct vy_cache_node, in_lru);
 	struct vy_cache *cache = node->cache;
@@ -321,6 +356,8 @@ vy_cache_add(struct vy_cache *cache, struct vy_entry curr,
 		node->left_boundary_level = replaced->left_boundary_level;
 		node->right_boundary_level = replaced->right_boundary_level;
 		vy_cache_node_delete(cache->env, replaced);
+		/* The statement is accessed again, protect it. */
+		vy_cache_node_promote(cache->env, node);
 	}
 	if (direction > 0 && boundary_level < node->left_boundary_level)
 		node->left_boundary_level = boundary_level;
@@ -406,7 +443,14 @@ vy_cache_add(struct vy_cache *cache, struct vy_entry curr,
 		prev_node->flags = replaced->flags;
 		prev_node->left_boundary_level = replaced->left_boundary_level;
 		prev_node->right_boundary_level = replaced->right_boundary_level;
+		bool is_protected = replaced->is_protected;
 		vy_cache_node_delete(cache->env, replaced);
+		/*
+		 * The previous statement was added by the same reader
+		 * so it doesn't count as another access.
+		 */
+		if (is_protected)
+			vy_cache_node_promote(cache->env, prev_node);
 	}
 
 	/* Set proper flags */
@@ -61,6 +61,8 @@ struct vy_cache_node {
 	/* VY_CACHE_LEFT_LINKED and/or VY_CACHE_RIGHT_LINKED, see
 	 * description of them for more information */
 	uint32_t flags;
+	/* Set if the node is in the protected LRU segment */
+	bool is_protected;
 	/* Number of parts in key when the value was the first in EQ search */
 	uint8_t left_boundary_level;
 	/* Number of parts in key when the value was the last in EQ search */
@@ -113,14 +115,33 @@ vy_cache_tree_key_cmp(struct vy_cache_node *a, struct vy_entry b,
 
 /**
  * Environment of the cache
+ *
+ * The cache is managed as a segmented LRU so that a big scan
+ * doesn't evict the working set. A statement is first added to
+ * the probationary segment. If it is accessed again while still
+ * in the cache, it is moved to the protected segment. Statements
+ * are evicted from the probationary segment first. The protected
+ * segment size is limited by a share of the cache quota: when it
+ * overflows, the least recently used protected statements are
+ * moved back to the probationary segment.
  */
 struct vy_cache_env {
-	/** Common LRU list of read cache. The first element is the newest */
+	/**
+	 * Common LRU list of the probationary segment of read cache.
+	 * The first element is the newest
+	 */
 	struct rlist cache_lru;
+	/**
+	 * Common LRU list of the protected segment of read cache.
+	 * The first element is the newest
+	 */
+	struct rlist protected_lru;
 	/** Common mempool for vy_cache_node struct */
 	struct mempool cache_node_mempool;
 	/** Size of memory occupied by cached tuples */
 	size_t mem_used;
+	/** Size of memory occupied by protected cached tuples */
+	size_t protected_mem_used;
 	/** Max memory size that can be used for cache */
 	size_t mem_quota;
 };
@@ -203,6 +203,8 @@ vy_lsm_new(struct vy_lsm_env *lsm_env, struct vy_cache_env *cache_env,
 	tuple_format_ref(lsm->mem_format);
 	heap_node_create(&lsm->in_dump);
 	heap_node_create(&lsm->in_compaction);
+	rlist_create(&lsm->split_queue);
+	rlist_create(&lsm->in_split);
 	lsm->space_id = index_def->space_id;
 	lsm->index_id = index_def->iid;
 	lsm->group_id = group_id;
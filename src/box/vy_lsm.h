@@ -305,6 +305,16 @@ struct vy_lsm {
 	struct heap_node in_dump;
 	/** Link in vy_scheduler->compaction_heap. */
 	struct heap_node in_compaction;
+	/**
+	 * Ranges that should be checked for split or coalesce,
+	 * linked by vy_range->in_split.
+	 */
+	struct rlist split_queue;
+	/**
+	 * Link in vy_scheduler->split_queue. Empty if the LSM
+	 * tree has no ranges queued for split/coalesce.
+	 */
+	struct rlist in_split;
 	/**
 	 * Interval tree containing reads from this LSM tree done by
 	 * all active transactions. Linked by vy_tx_interval->in_lsm.
@@ -361,6 +371,17 @@ vy_lsm_is_empty(struct vy_lsm *lsm)
 		lsm->stat.memory.count.rows == 0);
 }
 
+/**
+ * Return true if the LSM tree belongs to a space of the bulk
+ * quota class. The class is set on the primary index.
+ */
+static inline bool
+vy_lsm_is_bulk(struct vy_lsm *lsm)
+{
+	struct vy_lsm *pk = lsm->pk != NULL ? lsm->pk : lsm;
+	return pk->opts.quota_class == INDEX_QUOTA_CLASS_BULK;
+}
+
 /**
  * Return the averange number of dumps it takes to trigger major
  * compaction of a range in this LSM tree.
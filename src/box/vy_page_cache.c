@@ -0,0 +1,240 @@
+/*
+ * Copyright 2010-2021, Tarantool AUTHORS, please see AUTHORS file.
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above
+ *    copyright notice, this list of conditions and the
+ *    following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * AUTHORS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "vy_page_cache.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "fiber.h"
+#include "say.h"
+#include "vy_run.h"
+
+/** Key of a page in the page cache. */
+struct vy_page_cache_key {
+	int64_t run_id;
+	uint32_t page_no;
+};
+
+static inline uint32_t
+vy_page_cache_hash(int64_t run_id, uint32_t page_no)
+{
+	uint64_t h = (uint64_t)run_id * 0x9e3779b97f4a7c15ULL + page_no;
+	return h ^ (h >> 32);
+}
+
+#define mh_name _vy_page_cache
+#define mh_key_t const struct vy_page_cache_key *
+#define mh_node_t struct vy_page_cache_entry *
+#define mh_arg_t int
+#define mh_hash(a, arg) \
+	(vy_page_cache_hash((*(a))->run_id, (*(a))->page_no))
+#define mh_hash_key(a, arg) \
+	(vy_page_cache_hash((a)->run_id, (a)->page_no))
+#define mh_cmp(a, b, arg) \
+	((*(a))->run_id != (*(b))->run_id || \
+	 (*(a))->page_no != (*(b))->page_no)
+#define mh_cmp_key(a, b, arg) \
+	((a)->run_id != (*(b))->run_id || \
+	 (a)->page_no != (*(b))->page_no)
+#define MH_SOURCE
+#include "salad/mhash.h"
+
+void
+vy_page_cache_create(struct vy_page_cache *cache)
+{
+	memset(cache, 0, sizeof(*cache));
+	cache->hash = mh_vy_page_cache_new();
+	if (cache->hash == NULL)
+		panic("failed to allocate vinyl page cache");
+	rlist_create(&cache->lru);
+	mempool_create(&cache->entry_pool, cord_slab_cache(),
+		       sizeof(struct vy_page_cache_entry));
+}
+
+/** Remove an entry from the cache and free it. */
+static void
+vy_page_cache_delete_entry(struct vy_page_cache *cache,
+			   struct vy_page_cache_entry *entry)
+{
+	struct vy_page_cache_key key = {entry->run_id, entry->page_no};
+	mh_int_t pos = mh_vy_page_cache_find(cache->hash, &key, 0);
+	assert(pos != mh_end(cache->hash));
+	mh_vy_page_cache_del(cache->hash, pos, 0);
+	rlist_del_entry(entry, in_lru);
+	assert(cache->mem_used >= entry->mem_used);
+	cache->mem_used -= entry->mem_used;
+	if (entry->page != NULL)
+		vy_page_unref(entry->page);
+	free(entry->data);
+	mempool_free(&cache->entry_pool, entry);
+}
+
+void
+vy_page_cache_destroy(struct vy_page_cache *cache)
+{
+	struct vy_page_cache_entry *entry, *tmp;
+	rlist_foreach_entry_safe(entry, &cache->lru, in_lru, tmp)
+		vy_page_cache_delete_entry(cache, entry);
+	assert(cache->mem_used == 0);
+	mh_vy_page_cache_delete(cache->hash);
+	mempool_destroy(&cache->entry_pool);
+}
+
+/** Evict the least recently used pages until the quota is met. */
+static void
+vy_page_cache_gc(struct vy_page_cache *cache, size_t size)
+{
+	while (cache->mem_used + size > cache->mem_quota &&
+	       !rlist_empty(&cache->lru)) {
+		struct vy_page_cache_entry *entry =
+			rlist_last_entry(&cache->lru,
+					 struct vy_page_cache_entry, in_lru);
+		vy_page_cache_delete_entry(cache, entry);
+		cache->stat.evict++;
+	}
+}
+
+void
+vy_page_cache_set_quota(struct vy_page_cache *cache, size_t quota)
+{
+	cache->mem_quota = quota;
+	vy_page_cache_gc(cache, 0);
+}
+
+struct vy_page_cache_entry *
+vy_page_cache_get(struct vy_page_cache *cache,
+		  int64_t run_id, uint32_t page_no)
+{
+	if (!vy_page_cache_is_enabled(cache))
+		return NULL;
+	struct vy_page_cache_key key = {run_id, page_no};
+	mh_int_t pos = mh_vy_page_cache_find(cache->hash, &key, 0);
+	if (pos == mh_end(cache->hash)) {
+		cache->stat.miss++;
+		return NULL;
+	}
+	struct vy_page_cache_entry *entry =
+		*mh_vy_page_cache_node(cache->hash, pos);
+	rlist_move_entry(&cache->lru, entry, in_lru);
+	cache->stat.hit++;
+	return entry;
+}
+
+/**
+ * Allocate a new cache entry for the given page and insert it
+ * into the cache. Returns NULL if the page can't be cached.
+ */
+static struct vy_page_cache_entry *
+vy_page_cache_new_entry(struct vy_page_cache *cache, int64_t run_id,
+			uint32_t page_no, size_t mem_used)
+{
+	if (mem_used > cache->mem_quota)
+		return NULL;
+	struct vy_page_cache_key key = {run_id, page_no};
+	if (mh_vy_page_cache_find(cache->hash, &key, 0) !=
+	    mh_end(cache->hash)) {
+		/* Loaded by another fiber while we were reading it. */
+		return NULL;
+	}
+	vy_page_cache_gc(cache, mem_used);
+	struct vy_page_cache_entry *entry = mempool_alloc(&cache->entry_pool);
+	if (entry == NULL)
+		return NULL;
+	entry->run_id = run_id;
+	entry->page_no = page_no;
+	entry->page = NULL;
+	entry->data = NULL;
+	entry->data_size = 0;
+	entry->mem_used = mem_used;
+	const struct vy_page_cache_entry *put = entry;
+	if (mh_vy_page_cache_put(cache->hash, &put, NULL, 0) ==
+	    mh_end(cache->hash)) {
+		mempool_free(&cache->entry_pool, entry);
+		return NULL;
+	}
+	rlist_add_entry(&cache->lru, entry, in_lru);
+	cache->mem_used += mem_used;
+	return entry;
+}
+
+void
+vy_page_cache_put_page(struct vy_page_cache *cache, int64_t run_id,
+		       uint32_t page_no, struct vy_page *page)
+{
+	if (!vy_page_cache_is_enabled(cache))
+		return;
+	size_t mem_used = sizeof(struct vy_page_cache_entry) +
+			  sizeof(*page) + page->unpacked_size +
+			  page->row_count * sizeof(*page->row_index);
+	struct vy_page_cache_entry *entry =
+		vy_page_cache_new_entry(cache, run_id, page_no, mem_used);
+	if (entry == NULL)
+		return;
+	vy_page_ref(page);
+	entry->page = page;
+}
+
+void
+vy_page_cache_put_data(struct vy_page_cache *cache, int64_t run_id,
+		       uint32_t page_no, char *data, uint32_t data_size)
+{
+	struct vy_page_cache_entry *entry = NULL;
+	if (vy_page_cache_is_enabled(cache)) {
+		size_t mem_used = sizeof(struct vy_page_cache_entry) +
+				  data_size;
+		entry = vy_page_cache_new_entry(cache, run_id, page_no,
+						mem_used);
+	}
+	if (entry == NULL) {
+		free(data);
+		return;
+	}
+	entry->data = data;
+	entry->data_size = data_size;
+}
+
+void
+vy_page_cache_invalidate(struct vy_page_cache *cache, int64_t run_id,
+			 uint32_t page_count)
+{
+	if (cache->mem_used == 0)
+		return;
+	for (uint32_t page_no = 0; page_no < page_count; page_no++) {
+		struct vy_page_cache_key key = {run_id, page_no};
+		mh_int_t pos = mh_vy_page_cache_find(cache->hash, &key, 0);
+		if (pos == mh_end(cache->hash))
+			continue;
+		vy_page_cache_delete_entry(cache,
+				*mh_vy_page_cache_node(cache->hash, pos));
+	}
+}
@@ -0,0 +1,164 @@
+#ifndef INCLUDES_TARANTOOL_BOX_VY_PAGE_CACHE_H
+#define INCLUDES_TARANTOOL_BOX_VY_PAGE_CACHE_H
+/*
+ * Copyright 2010-2021, Tarantool AUTHORS, please see AUTHORS file.
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above
+ *    copyright notice, this list of conditions and the
+ *    following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * AUTHORS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <small/rlist.h>
+#include <small/mempool.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+struct vy_page;
+struct mh_vy_page_cache_t;
+
+/**
+ * A page stored in the page cache. It holds either a loaded
+ * page or a page in its on-disk (compressed) form.
+ */
+struct vy_page_cache_entry {
+	/** ID of the run the page belongs to. */
+	int64_t run_id;
+	/** Page number in the run. */
+	uint32_t page_no;
+	/** Loaded page, referenced by the cache, or NULL. */
+	struct vy_page *page;
+	/** Page data as it is stored on disk, if page is NULL. */
+	char *data;
+	/** Size of the on-disk page data. */
+	uint32_t data_size;
+	/** Memory accounted to this entry. */
+	size_t mem_used;
+	/** Link in vy_page_cache::lru. */
+	struct rlist in_lru;
+};
+
+/** Page cache statistics. */
+struct vy_page_cache_stat {
+	/** Number of lookups that found a page in the cache. */
+	int64_t hit;
+	/** Number of lookups that didn't find a page in the cache. */
+	int64_t miss;
+	/** Number of pages evicted from the cache. */
+	int64_t evict;
+};
+
+/**
+ * Cache of run pages shared by all vinyl LSM trees. Unlike the
+ * tuple cache (vy_cache), which stores statements returned to
+ * the user, it stores pages read from disk, keyed by run id and
+ * page number, so that a repeated read of a hot page doesn't go
+ * to disk. Run ids are never reused, so an entry is never stale,
+ * but it must be dropped when the run is deleted to free memory.
+ */
+struct vy_page_cache {
+	/** (run id, page no) -> struct vy_page_cache_entry. */
+	struct mh_vy_page_cache_t *hash;
+	/** LRU list of cached pages. The first element is the newest. */
+	struct rlist lru;
+	/** Mempool for struct vy_page_cache_entry. */
+	struct mempool entry_pool;
+	/** Size of memory occupied by cached pages. */
+	size_t mem_used;
+	/** Max memory size that can be used for the cache. */
+	size_t mem_quota;
+	/**
+	 * If set, pages are added to the cache in their on-disk
+	 * form and decompressed on each hit. This allows to cache
+	 * more pages at the cost of CPU time.
+	 */
+	bool store_compressed;
+	/** Cache statistics. */
+	struct vy_page_cache_stat stat;
+};
+
+/** Initialize an empty page cache. The cache is disabled. */
+void
+vy_page_cache_create(struct vy_page_cache *cache);
+
+/** Free all pages stored in a page cache. */
+void
+vy_page_cache_destroy(struct vy_page_cache *cache);
+
+/**
+ * Set memory limit for the cache, evicting pages if needed.
+ * Setting it to 0 disables the cache.
+ */
+void
+vy_page_cache_set_quota(struct vy_page_cache *cache, size_t quota);
+
+/** Return true if the page cache is enabled. */
+static inline bool
+vy_page_cache_is_enabled(struct vy_page_cache *cache)
+{
+	return cache->mem_quota > 0;
+}
+
+/**
+ * Look up a page in the cache and mark it as recently used.
+ * Returns NULL if the page isn't cached.
+ */
+struct vy_page_cache_entry *
+vy_page_cache_get(struct vy_page_cache *cache,
+		  int64_t run_id, uint32_t page_no);
+
+/**
+ * Add a loaded page to the cache. The cache takes a reference
+ * to the page. Evicts old pages if the quota is exceeded.
+ */
+void
+vy_page_cache_put_page(struct vy_page_cache *cache, int64_t run_id,
+		       uint32_t page_no, struct vy_page *page);
+
+/**
+ * Add on-disk page data allocated with malloc() to the cache.
+ * The cache takes ownership of the data, which is freed if it
+ * can't be cached.
+ */
+void
+vy_page_cache_put_data(struct vy_page_cache *cache, int64_t run_id,
+		       uint32_t page_no, char *data, uint32_t data_size);
+
+/** Drop all cached pages of a run. */
+void
+vy_page_cache_invalidate(struct vy_page_cache *cache, int64_t run_id,
+			 uint32_t page_count);
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
+
+#endif /* INCLUDES_TARANTOOL_BOX_VY_PAGE_CACHE_H */
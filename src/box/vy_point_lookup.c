@@ -130,11 +130,13 @@ vy_point_lookup_scan_mems(struct vy_lsm *lsm, const struct vy_read_view **rv,
 /**
  * Scan one particular slice.
  * Add found statements to the history list up to terminal statement.
+ * If @is_bloom_checked is set, the caller has already found out
+ * that the slice may contain the key with the bloom filter.
  */
 static int
 vy_point_lookup_scan_slice(struct vy_lsm *lsm, struct vy_slice *slice,
 			   const struct vy_read_view **rv, struct vy_entry key,
-			   struct vy_history *history)
+			   bool is_bloom_checked, struct vy_history *history)
 {
 	/*
 	 * The format of the statement must be exactly the space
@@ -145,6 +147,7 @@ vy_point_lookup_scan_slice(struct vy_lsm *lsm, struct vy_slice *slice,
 	vy_run_iterator_open(&run_itr, &lsm->stat.disk.iterator, slice,
 			     ITER_EQ, key, rv, lsm->cmp_def, lsm->key_def,
 			     lsm->disk_format);
+	run_itr.is_bloom_checked = is_bloom_checked;
 	struct vy_history slice_history;
 	vy_history_create(&slice_history, &lsm->env->history_node_pool);
 	int rc = vy_run_iterator_next(&run_itr, &slice_history);
@@ -153,11 +156,117 @@ vy_point_lookup_scan_slice(struct vy_lsm *lsm, struct vy_slice *slice,
 	return rc;
 }
 
+static int
+vy_point_lookup_scan_slice_f(va_list ap)
+{
+	struct vy_lsm *lsm = va_arg(ap, struct vy_lsm *);
+	struct vy_slice *slice = va_arg(ap, struct vy_slice *);
+	const struct vy_read_view **rv =
+		va_arg(ap, const struct vy_read_view **);
+	struct vy_entry key = va_arg(ap, struct vy_entry);
+	struct vy_history *history = va_arg(ap, struct vy_history *);
+	return vy_point_lookup_scan_slice(lsm, slice, rv, key, true, history);
+}
+
+/**
+ * Check if a slice may contain the given key according to
+ * the bloom filter of its run, i.e. if a lookup in the slice
+ * is likely to read the disk. The result is accounted the way
+ * vy_run_iterator does it: a negative answer is a bloom hit,
+ * while a positive one is accounted as a bloom miss by the run
+ * iterator in case the key isn't found.
+ */
+static bool
+vy_point_lookup_slice_maybe_has(struct vy_lsm *lsm, struct vy_slice *slice,
+				struct vy_entry key)
+{
+	struct tuple_bloom *bloom = slice->run->info.bloom;
+	if (bloom == NULL || vy_bloom_maybe_has(bloom, key, lsm->key_def))
+		return true;
+	lsm->stat.disk.iterator.bloom_hit++;
+	return false;
+}
+
+/**
+ * Scan the given slices so that disk reads are issued for all
+ * of them at once rather than one by one: each slice that may
+ * contain the key is scanned in its own fiber, so the reads are
+ * executed by different reader threads in parallel. Statements
+ * found in each slice are collected in a separate history list
+ * and then added to the resulting history in the slice order up
+ * to terminal statement. Slices that don't contain the key
+ * according to @maybe_has are skipped.
+ */
+static int
+vy_point_lookup_scan_slices_parallel(struct vy_lsm *lsm,
+				     struct vy_slice **slices,
+				     const bool *maybe_has, int slice_count,
+				     const struct vy_read_view **rv,
+				     struct vy_entry key,
+				     struct vy_history *history)
+{
+	size_t size;
+	struct fiber **fibers =
+		region_alloc_array(&fiber()->gc, typeof(fibers[0]),
+				   slice_count, &size);
+	if (fibers == NULL) {
+		diag_set(OutOfMemory, size, "region_alloc_array", "fibers");
+		return -1;
+	}
+	struct vy_history *histories =
+		region_alloc_array(&fiber()->gc, typeof(histories[0]),
+				   slice_count, &size);
+	if (histories == NULL) {
+		diag_set(OutOfMemory, size, "region_alloc_array", "histories");
+		return -1;
+	}
+	for (int i = 0; i < slice_count; i++) {
+		vy_history_create(&histories[i], &lsm->env->history_node_pool);
+		fibers[i] = NULL;
+		if (!maybe_has[i])
+			continue;
+		/*
+		 * If we fail to start a fiber, the slice will be
+		 * scanned by this fiber, see below.
+		 */
+		fibers[i] = fiber_new("vinyl.lookup",
+				      vy_point_lookup_scan_slice_f);
+		if (fibers[i] == NULL)
+			continue;
+		fiber_set_joinable(fibers[i], true);
+		fiber_start(fibers[i], lsm, slices[i], rv, key, &histories[i]);
+	}
+	int rc = 0;
+	for (int i = 0; i < slice_count; i++) {
+		if (fibers[i] != NULL) {
+			if (fiber_join(fibers[i]) != 0)
+				rc = -1;
+		} else if (rc == 0 && maybe_has[i]) {
+			rc = vy_point_lookup_scan_slice(lsm, slices[i], rv,
+							key, true,
+							&histories[i]);
+		}
+	}
+	for (int i = 0; i < slice_count; i++) {
+		if (rc == 0 && !vy_history_is_terminal(history))
+			vy_history_splice(history, &histories[i]);
+		vy_history_cleanup(&histories[i]);
+	}
+	return rc;
+}
+
 /**
  * Find a range and scan all slices that belongs to the range.
  * Add found statements to the history list up to terminal statement.
  * All slices are pinned before first slice scan, so it's guaranteed
  * that complete history from runs will be extracted.
+ *
+ * If parallel lookups are enabled, more than one slice may
+ * contain the key, and there are several reader threads, the
+ * slices are read in parallel, see
+ * vy_point_lookup_scan_slices_parallel(). This cuts the latency
+ * of a lookup at the cost of reading slices that turn out to be
+ * older than a terminal statement found in a newer slice.
  */
 static int
 vy_point_lookup_scan_slices(struct vy_lsm *lsm, const struct vy_read_view **rv,
@@ -175,6 +284,26 @@ vy_point_lookup_scan_slices(struct vy_lsm *lsm, const struct vy_read_view **rv,
 		diag_set(OutOfMemory, size, "region_alloc_array", "slices");
 		return -1;
 	}
+	/*
+	 * To decide whether to read slices in parallel, we need
+	 * to probe their bloom filters. Remember the results so
+	 * that the filters aren't probed again by run iterators.
+	 */
+	bool *maybe_has = NULL;
+	struct vy_run_env *run_env = slice_count == 0 ? NULL :
+		rlist_first_entry(&range->slices, struct vy_slice,
+				  in_range)->run->env;
+	if (run_env != NULL && run_env->parallel_lookup &&
+	    run_env->reader_pool != NULL && run_env->reader_pool_size > 1) {
+		maybe_has = region_alloc_array(&fiber()->gc,
+					       typeof(maybe_has[0]),
+					       slice_count, &size);
+		if (maybe_has == NULL) {
+			diag_set(OutOfMemory, size, "region_alloc_array",
+				 "maybe_has");
+			return -1;
+		}
+	}
 	int i = 0;
 	struct vy_slice *slice;
 	rlist_foreach_entry(slice, &range->slices, in_range) {
@@ -182,11 +311,32 @@ vy_point_lookup_scan_slices(struct vy_lsm *lsm, const struct vy_read_view **rv,
 		slices[i++] = slice;
 	}
 	assert(i == slice_count);
+	int disk_count = 0;
+	if (maybe_has != NULL) {
+		for (i = 0; i < slice_count; i++) {
+			maybe_has[i] = vy_point_lookup_slice_maybe_has(
+					lsm, slices[i], key);
+			if (maybe_has[i])
+				disk_count++;
+		}
+	}
 	int rc = 0;
+	if (disk_count > 1) {
+		rc = vy_point_lookup_scan_slices_parallel(lsm, slices,
+							  maybe_has,
+							  slice_count, rv,
+							  key, history);
+		for (i = 0; i < slice_count; i++)
+			vy_slice_unpin(slices[i]);
+		return rc;
+	}
 	for (i = 0; i < slice_count; i++) {
-		if (rc == 0 && !vy_history_is_terminal(history))
-			rc = vy_point_lookup_scan_slice(lsm, slices[i],
-							rv, key, history);
+		if (rc == 0 && !vy_history_is_terminal(history) &&
+		    (maybe_has == NULL || maybe_has[i])) {
+			rc = vy_point_lookup_scan_slice(lsm, slices[i], rv,
+							key, maybe_has != NULL,
+							history);
+		}
 		vy_slice_unpin(slices[i]);
 	}
 	return rc;
@@ -33,6 +33,7 @@
 #include <assert.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <string.h>
 #include <tarantool_ev.h>
 
 #include "diag.h"
@@ -51,6 +52,13 @@
  */
 static const double VY_QUOTA_TIMER_PERIOD = 0.1;
 
+const char *vy_quota_consumer_type_strs[] = {
+	[VY_QUOTA_CONSUMER_TX] = "tx",
+	[VY_QUOTA_CONSUMER_BULK] = "bulk",
+	[VY_QUOTA_CONSUMER_COMPACTION] = "compaction",
+	[VY_QUOTA_CONSUMER_DDL] = "ddl",
+};
+
 /**
  * Bit mask of resources used by a particular consumer type.
  */
@@ -67,6 +75,13 @@ vy_quota_consumer_resource_map[] = {
 	 */
 	[VY_QUOTA_CONSUMER_TX] = (1 << VY_QUOTA_RESOURCE_DISK) |
 				 (1 << VY_QUOTA_RESOURCE_MEMORY),
+	/**
+	 * Bulk transactions respect the same limits as normal
+	 * ones, but they get only a share of them, see
+	 * vy_quota_consumer_share.
+	 */
+	[VY_QUOTA_CONSUMER_BULK] = (1 << VY_QUOTA_RESOURCE_DISK) |
+				   (1 << VY_QUOTA_RESOURCE_MEMORY),
 	/**
 	 * Compaction jobs may need some quota too, because they
 	 * may generate deferred DELETEs for secondary indexes.
@@ -91,6 +106,21 @@ vy_quota_consumer_resource_map[] = {
 	[VY_QUOTA_CONSUMER_DDL] = (1 << VY_QUOTA_RESOURCE_MEMORY),
 };
 
+/**
+ * Share of the memory limit and of the rate limits that may be
+ * used by a particular consumer type. A consumer is throttled as
+ * soon as it exceeds its share so that the rest is left for more
+ * important consumers. This way bulk writers get throttled first
+ * when memory is short while normal transactions may proceed.
+ */
+static const double
+vy_quota_consumer_share[] = {
+	[VY_QUOTA_CONSUMER_TX] = 1,
+	[VY_QUOTA_CONSUMER_BULK] = 0.75,
+	[VY_QUOTA_CONSUMER_COMPACTION] = 1,
+	[VY_QUOTA_CONSUMER_DDL] = 1,
+};
+
 /**
  * Check if the rate limit corresponding to resource @resource_type
  * should be applied to a consumer of type @consumer_type.
@@ -117,14 +147,23 @@ vy_quota_may_use(struct vy_quota *q, enum vy_quota_consumer_type type,
 {
 	if (!q->is_enabled)
 		return true;
-	if (q->used + size > q->limit) {
+	double share = vy_quota_consumer_share[type];
+	if (q->used + size > q->limit * share) {
 		q->quota_exceeded_cb(q);
 		return false;
 	}
 	for (int i = 0; i < vy_quota_resource_type_MAX; i++) {
 		struct vy_rate_limit *rl = &q->rate_limit[i];
-		if (vy_rate_limit_is_applicable(type, i) &&
-		    !vy_rate_limit_may_use(rl))
+		if (!vy_rate_limit_is_applicable(type, i))
+			continue;
+		if (!vy_rate_limit_may_use(rl))
+			return false;
+		/*
+		 * Leave the rest of the quota accumulated for
+		 * a timer period to consumers with greater share.
+		 */
+		if (share < 1 && rl->rate != SIZE_MAX &&
+		    rl->value < rl->rate * VY_QUOTA_TIMER_PERIOD * (1 - share))
 			return false;
 	}
 	return true;
@@ -233,6 +272,7 @@ vy_quota_create(struct vy_quota *q, size_t limit,
 		rlist_create(&q->wait_queue[i]);
 	for (int i = 0; i < vy_quota_resource_type_MAX; i++)
 		vy_rate_limit_create(&q->rate_limit[i]);
+	vy_quota_reset_stat(q);
 	ev_timer_init(&q->timer, vy_quota_timer_cb, 0, VY_QUOTA_TIMER_PERIOD);
 	q->timer.data = q;
 }
@@ -279,6 +319,12 @@ vy_quota_get_rate_limit(struct vy_quota *q, enum vy_quota_consumer_type type)
 	return rate;
 }
 
+void
+vy_quota_reset_stat(struct vy_quota *q)
+{
+	memset(q->stat, 0, sizeof(q->stat));
+}
+
 void
 vy_quota_force_use(struct vy_quota *q, enum vy_quota_consumer_type type,
 		   size_t size)
@@ -334,12 +380,17 @@ vy_quota_use(struct vy_quota *q, enum vy_quota_consumer_type type,
 	bool timed_out = fiber_yield_timeout(timeout);
 	rlist_del_entry(&wait_node, in_wait_queue);
 
+	double wait_time = ev_monotonic_now(loop()) - wait_start;
+	struct vy_quota_stat *stat = &q->stat[type];
+	stat->throttle_count++;
+	stat->throttled_bytes += size;
+	stat->wait_time += wait_time;
+
 	if (timed_out) {
 		diag_set(ClientError, ER_VY_QUOTA_TIMEOUT);
 		return -1;
 	}
 
-	double wait_time = ev_monotonic_now(loop()) - wait_start;
 	if (wait_time > q->too_long_threshold) {
 		say_warn_ratelimited("waited for %zu bytes of vinyl memory "
 				     "quota for too long: %.3f sec", size,
@@ -34,6 +34,7 @@
 #include <limits.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <small/rlist.h>
 #include <tarantool_ev.h>
 
@@ -148,14 +149,32 @@ enum vy_quota_resource_type {
 enum vy_quota_consumer_type {
 	/** Transaction processor. */
 	VY_QUOTA_CONSUMER_TX = 0,
+	/**
+	 * Transaction that only writes to spaces of the bulk
+	 * quota class, see index_quota_class.
+	 */
+	VY_QUOTA_CONSUMER_BULK = 1,
 	/** Compaction job. */
-	VY_QUOTA_CONSUMER_COMPACTION = 1,
+	VY_QUOTA_CONSUMER_COMPACTION = 2,
 	/** Request to build a new index. */
-	VY_QUOTA_CONSUMER_DDL = 2,
+	VY_QUOTA_CONSUMER_DDL = 3,
 
 	vy_quota_consumer_type_MAX,
 };
 
+/** Names of quota consumer types, used in statistics. */
+extern const char *vy_quota_consumer_type_strs[];
+
+/** Throttling statistics, one per each consumer type. */
+struct vy_quota_stat {
+	/** Number of times a consumer had to wait for quota. */
+	int64_t throttle_count;
+	/** Amount of quota requested by throttled consumers. */
+	int64_t throttled_bytes;
+	/** Total time spent waiting for quota, in seconds. */
+	double wait_time;
+};
+
 struct vy_quota_wait_node {
 	/** Link in vy_quota::wait_queue. */
 	struct rlist in_wait_queue;
@@ -212,6 +231,8 @@ struct vy_quota {
 	struct rlist wait_queue[vy_quota_consumer_type_MAX];
 	/** Rate limit state, one per each resource type. */
 	struct vy_rate_limit rate_limit[vy_quota_resource_type_MAX];
+	/** Throttling statistics, one per each consumer type. */
+	struct vy_quota_stat stat[vy_quota_consumer_type_MAX];
 	/**
 	 * Periodic timer that is used for refilling the rate
 	 * limit value.
@@ -262,6 +283,12 @@ vy_quota_set_rate_limit(struct vy_quota *q, enum vy_quota_resource_type type,
 size_t
 vy_quota_get_rate_limit(struct vy_quota *q, enum vy_quota_consumer_type type);
 
+/**
+ * Reset throttling statistics.
+ */
+void
+vy_quota_reset_stat(struct vy_quota *q);
+
 /**
  * Consume @size bytes of memory. In contrast to vy_quota_use()
  * this function does not throttle the caller.
@@ -194,6 +194,7 @@ vy_range_new(int64_t id, struct vy_entry begin, struct vy_entry end,
 	range->cmp_def = cmp_def;
 	rlist_create(&range->slices);
 	heap_node_create(&range->heap_node);
+	rlist_create(&range->in_split);
 	return range;
 }
 
@@ -204,6 +205,7 @@ vy_range_delete(struct vy_range *range)
 		tuple_unref(range->begin.stmt);
 	if (range->end.stmt != NULL)
 		tuple_unref(range->end.stmt);
+	rlist_del(&range->in_split);
 
 	struct vy_slice *slice, *next_slice;
 	rlist_foreach_entry_safe(slice, &range->slices, in_range, next_slice)
@@ -261,6 +263,47 @@ vy_range_remove_slice(struct vy_range *range, struct vy_slice *slice)
 	range->version++;
 }
 
+/**
+ * Return the first slice of the oldest run of a range and store
+ * the total size of the run in @p_size. Sibling slices, see
+ * vy_slice_is_sibling(), are accounted as one run.
+ */
+static struct vy_slice *
+vy_range_oldest_run(struct vy_range *range, uint64_t *p_size)
+{
+	assert(!rlist_empty(&range->slices));
+	struct vy_slice *slice, *prev_slice;
+	slice = rlist_last_entry(&range->slices, struct vy_slice, in_range);
+	*p_size = slice->count.bytes;
+	while ((prev_slice = rlist_prev_entry_safe(slice, &range->slices,
+						   in_range)) != NULL &&
+	       vy_slice_is_sibling(prev_slice, slice)) {
+		slice = prev_slice;
+		*p_size += slice->count.bytes;
+	}
+	return slice;
+}
+
+/**
+ * Return the total size of the newest run of a range.
+ * Sibling slices are accounted as one run.
+ */
+static uint64_t
+vy_range_newest_run_size(struct vy_range *range)
+{
+	assert(!rlist_empty(&range->slices));
+	struct vy_slice *slice, *next_slice;
+	slice = rlist_first_entry(&range->slices, struct vy_slice, in_range);
+	uint64_t size = slice->count.bytes;
+	while ((next_slice = rlist_next_entry_safe(slice, &range->slices,
+						   in_range)) != NULL &&
+	       vy_slice_is_sibling(slice, next_slice)) {
+		slice = next_slice;
+		size += slice->count.bytes;
+	}
+	return size;
+}
+
 /**
  * To reduce write amplification caused by compaction, we follow
  * the LSM tree design. Runs in each range are divided into groups
@@ -283,10 +326,19 @@ vy_range_remove_slice(struct vy_range *range, struct vy_slice *slice)
  * Given a range, this function computes the maximal level that needs
  * to be compacted and sets @compaction_priority to the number of runs
  * in this level and all preceding levels.
+ *
+ * Policies differ in how many runs they allow to accumulate at
+ * a level: @max_level_run_count is the limit for all levels but
+ * the newest one, which always may have up to run_count_per_level
+ * runs so as not to trigger compaction on each dump. If
+ * @last_level_is_single is set, the last level is merged into
+ * a single run as soon as a second run appears there.
  */
-void
-vy_range_update_compaction_priority(struct vy_range *range,
-				    const struct index_opts *opts)
+static void
+vy_range_update_compaction_priority_impl(struct vy_range *range,
+					 const struct index_opts *opts,
+					 uint32_t max_level_run_count,
+					 bool last_level_is_single)
 {
 	assert(opts->run_count_per_level > 0);
 	assert(opts->run_size_ratio > 1);
@@ -315,6 +367,8 @@ vy_range_update_compaction_priority(struct vy_range *range,
 	uint64_t est_new_run_size = 0;
 	/* The number of runs at the current level. */
 	uint32_t level_run_count = 0;
+	/* The number of levels checked so far. */
+	uint32_t level_count = 0;
 	/*
 	 * The target (perfect) size of a run at the current level.
 	 * Calculated recurrently: the size of the next level equals
@@ -341,20 +395,32 @@ vy_range_update_compaction_priority(struct vy_range *range,
 	uint64_t target_run_size;
 
 	uint64_t size;
-	struct vy_slice *slice;
-	slice = rlist_last_entry(&range->slices, struct vy_slice, in_range);
-	size = MAX(slice->count.bytes, 1);
-	slice = rlist_first_entry(&range->slices, struct vy_slice, in_range);
+	struct vy_slice *slice, *next_slice;
+	uint64_t newest_run_size = vy_range_newest_run_size(range);
+	vy_range_oldest_run(range, &size);
+	size = MAX(size, 1);
 	do {
 		target_run_size = size;
 		size = DIV_ROUND_UP(target_run_size, opts->run_size_ratio);
-	} while (size > (uint64_t)MAX(slice->count.bytes, 1));
+	} while (size > MAX(newest_run_size, 1));
 
+	size = 0;
 	rlist_foreach_entry(slice, &range->slices, in_range) {
-		size = slice->count.bytes;
-		level_run_count++;
+		size += slice->count.bytes;
 		total_run_count++;
 		vy_disk_stmt_counter_add(&total_stmt_count, &slice->count);
+		/*
+		 * Slices of runs written by the same compaction
+		 * are accounted as one run. Defer the decision
+		 * until we reach the last of them.
+		 */
+		next_slice = rlist_next_entry_safe(slice, &range->slices,
+						   in_range);
+		if (next_slice != NULL &&
+		    vy_slice_is_sibling(slice, next_slice))
+			continue;
+		bool is_new_level = (level_run_count == 0);
+		level_run_count++;
 		while (size > target_run_size) {
 			/*
 			 * The run size exceeds the threshold
@@ -363,6 +429,7 @@ vy_range_update_compaction_priority(struct vy_range *range,
 			 * current level and reset the level run
 			 * count.
 			 */
+			is_new_level = true;
 			level_run_count = 1;
 			/*
 			 * If we have already scheduled
@@ -384,6 +451,8 @@ vy_range_update_compaction_priority(struct vy_range *range,
 			 * we find an appropriate level for it.
 			 */
 		}
+		if (is_new_level)
+			level_count++;
 		/*
 		 * Since all ranges constituting an LSM tree have
 		 * the same configuration, they tend to get compacted
@@ -399,7 +468,9 @@ vy_range_update_compaction_priority(struct vy_range *range,
 		 * scans all LSM tree levels. Instead we use the
 		 * value of rand() from the slice creation time.
 		 */
-		uint32_t max_run_count = opts->run_count_per_level;
+		uint32_t max_run_count = level_count > 1 ?
+					 max_level_run_count :
+					 opts->run_count_per_level;
 		if (slice->seed < RAND_MAX / 10)
 			max_run_count++;
 		if (level_run_count > max_run_count) {
@@ -413,9 +484,10 @@ vy_range_update_compaction_priority(struct vy_range *range,
 			range->compaction_queue = total_stmt_count;
 			est_new_run_size = total_stmt_count.bytes;
 		}
+		size = 0;
 	}
 
-	if (level_run_count > 1) {
+	if (last_level_is_single && level_run_count > 1) {
 		/*
 		 * Do not store more than one run at the last level
 		 * to keep space amplification low.
@@ -425,6 +497,80 @@ vy_range_update_compaction_priority(struct vy_range *range,
 	}
 }
 
+/**
+ * Hybrid policy: tiered compaction at all levels except the
+ * last one, which is kept as a single run. This is a trade-off
+ * between write and space amplification.
+ */
+static void
+vy_hybrid_update_compaction_priority(struct vy_range *range,
+				     const struct index_opts *opts)
+{
+	vy_range_update_compaction_priority_impl(range, opts,
+			opts->run_count_per_level, true);
+}
+
+/**
+ * Tiered policy: up to run_count_per_level runs at each level,
+ * including the last one. Has the lowest write amplification
+ * at the cost of read and space amplification.
+ */
+static void
+vy_tiered_update_compaction_priority(struct vy_range *range,
+				     const struct index_opts *opts)
+{
+	vy_range_update_compaction_priority_impl(range, opts,
+			opts->run_count_per_level, false);
+}
+
+/**
+ * Leveled policy: one run per level, except the newest level,
+ * which accumulates dumps. Since runs are already partitioned
+ * by key ranges, this is what classic leveled LSM trees do.
+ * Has the lowest read and space amplification at the cost of
+ * write amplification.
+ */
+static void
+vy_leveled_update_compaction_priority(struct vy_range *range,
+				      const struct index_opts *opts)
+{
+	vy_range_update_compaction_priority_impl(range, opts, 1, true);
+}
+
+static const struct vy_compaction_policy vy_compaction_policies[] = {
+	[INDEX_COMPACTION_POLICY_HYBRID] = {
+		.name = "hybrid",
+		.update_compaction_priority =
+			vy_hybrid_update_compaction_priority,
+	},
+	[INDEX_COMPACTION_POLICY_TIERED] = {
+		.name = "tiered",
+		.update_compaction_priority =
+			vy_tiered_update_compaction_priority,
+	},
+	[INDEX_COMPACTION_POLICY_LEVELED] = {
+		.name = "leveled",
+		.update_compaction_priority =
+			vy_leveled_update_compaction_priority,
+	},
+};
+
+const struct vy_compaction_policy *
+vy_compaction_policy_by_type(enum index_compaction_policy type)
+{
+	assert(type < index_compaction_policy_MAX);
+	return &vy_compaction_policies[type];
+}
+
+void
+vy_range_update_compaction_priority(struct vy_range *range,
+				    const struct index_opts *opts)
+{
+	const struct vy_compaction_policy *policy =
+		vy_compaction_policy_by_type(opts->compaction_policy);
+	policy->update_compaction_priority(range, opts);
+}
+
 void
 vy_range_update_dumps_per_compaction(struct vy_range *range)
 {
@@ -445,9 +591,13 @@ vy_range_update_dumps_per_compaction(struct vy_range *range)
  *   (actually, it should be a function of run_count_per_level/number
  *   of runs used for the merge: with low run_count_per_level it's more
  *   than once, with high run_count_per_level it's once).
- * - We should use the last run size as the size of the range.
+ * - We should use the last run size as the size of the range unless
+ *   more than range_size bytes have been dumped to the range since
+ *   the last run was written. Such a range receives writes faster
+ *   than it is compacted so we use the total size of its runs so as
+ *   to split it before compaction rather than after.
  * - We should split around the last run middle key.
- * - We should only split if the last run size is greater than
+ * - We should only split if the range size is greater than
  *   4/3 * range_size.
  */
 bool
@@ -461,13 +611,29 @@ vy_range_needs_split(struct vy_range *range, int64_t range_size,
 		return false;
 
 	/* Find the oldest run. */
-	assert(!rlist_empty(&range->slices));
-	slice = rlist_last_entry(&range->slices, struct vy_slice, in_range);
+	uint64_t size;
+	slice = vy_range_oldest_run(range, &size);
+
+	/* Account runs dumped since the oldest run was written. */
+	uint64_t total_size = size;
+	if (range->count.bytes - size >= (uint64_t)range_size)
+		total_size = range->count.bytes;
 
 	/* The range is too small to be split. */
-	if (slice->count.bytes < range_size * 4 / 3)
+	if (total_size < (uint64_t)range_size * 4 / 3)
 		return false;
 
+	/*
+	 * If the oldest run was written by a compaction split
+	 * in parts, it consists of several sibling slices sorted
+	 * by key. Find the one holding the median key.
+	 */
+	uint64_t offset = slice->count.bytes;
+	while (offset < size / 2) {
+		slice = rlist_next_entry(slice, in_range);
+		offset += slice->count.bytes;
+	}
+
 	/* Find the median key in the oldest run (approximately). */
 	struct vy_page_info *mid_page;
 	mid_page = vy_run_page_info(slice->run, slice->first_page_no +
@@ -38,6 +38,7 @@
 #include <small/rb.h>
 #include <small/rlist.h>
 
+#include "index_def.h"
 #include "iterator_type.h"
 #define HEAP_FORWARD_DECLARATION
 #include "salad/heap.h"
@@ -128,6 +129,11 @@ struct vy_range {
 	rb_node(struct vy_range) tree_node;
 	/** Link in vy_lsm->range_heap. */
 	struct heap_node heap_node;
+	/**
+	 * Link in vy_lsm->split_queue. Empty if the range isn't
+	 * queued for split/coalesce.
+	 */
+	struct rlist in_split;
 	/**
 	 * Incremented whenever a run is added to or deleted
 	 * from this range. Used invalidate read iterators.
@@ -238,7 +244,30 @@ void
 vy_range_remove_slice(struct vy_range *range, struct vy_slice *slice);
 
 /**
- * Update compaction priority of a range.
+ * Compaction policy of an LSM tree. Decides which runs of
+ * a range need to be compacted and thus defines the trade-off
+ * between write, read, and space amplification.
+ */
+struct vy_compaction_policy {
+	/** Name of the policy, as reported by index.stat(). */
+	const char *name;
+	/**
+	 * Set range->compaction_priority and compaction_queue
+	 * to the number of runs to compact and their total
+	 * size, respectively.
+	 */
+	void
+	(*update_compaction_priority)(struct vy_range *range,
+				      const struct index_opts *opts);
+};
+
+/** Return the compaction policy implementation of the given type. */
+const struct vy_compaction_policy *
+vy_compaction_policy_by_type(enum index_compaction_policy type);
+
+/**
+ * Update compaction priority of a range according to the
+ * compaction policy set in index options.
  *
  * @param range     The range.
  * @param opts      Index options.
@@ -567,8 +567,12 @@ static void
 vy_read_iterator_add_disk(struct vy_read_iterator *itr)
 {
 	assert(itr->curr_range != NULL);
-	enum iterator_type iterator_type = (itr->iterator_type != ITER_REQ ?
-					    itr->iterator_type : ITER_LE);
+	/*
+	 * Unlike other sources, the run iterator handles REQ
+	 * itself so that it can use bloom filters to skip runs
+	 * that don't store the key prefix.
+	 */
+	enum iterator_type iterator_type = itr->iterator_type;
 	struct vy_lsm *lsm = itr->lsm;
 	struct vy_slice *slice;
 	/*
@@ -656,11 +660,11 @@ vy_read_iterator_open(struct vy_read_iterator *itr, struct vy_lsm *lsm,
 
 	if (iterator_type == ITER_REQ) {
 		/*
-		 * Source iterators cannot handle ITER_REQ and
-		 * use ITER_LE instead, so we need to enable EQ
-		 * check in this case.
+		 * Only the run iterator handles ITER_REQ, other
+		 * source iterators use ITER_LE instead, so we need
+		 * to enable EQ check in this case.
 		 *
-		 * See vy_read_iterator_add_{tx,cache,mem,run}.
+		 * See vy_read_iterator_add_{tx,cache,mem,disk}.
 		 */
 		itr->need_check_eq = true;
 	}
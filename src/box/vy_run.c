@@ -31,6 +31,7 @@
 #include "vy_run.h"
 
 #include <zstd.h>
+#include <zdict.h>
 
 #include "fiber.h"
 #include "fiber_cond.h"
@@ -74,6 +75,21 @@ const char *vy_file_suffix[] = {
 /* sync run and index files very 16 MB */
 #define VY_RUN_SYNC_INTERVAL (1 << 24)
 
+/** Number of keys between two restart points of a page key index. */
+#define VY_PAGE_KEY_RESTART_INTERVAL 16
+
+/**
+ * A zstd dictionary is trained on a sample of statements that is
+ * VY_RUN_DICT_SAMPLE_RATIO times bigger than the dictionary. If
+ * a run is too small to collect a sample that is at least
+ * VY_RUN_DICT_SAMPLE_RATIO_MIN times bigger than the dictionary,
+ * the run is compressed without a dictionary.
+ */
+enum {
+	VY_RUN_DICT_SAMPLE_RATIO = 100,
+	VY_RUN_DICT_SAMPLE_RATIO_MIN = 10,
+};
+
 /**
  * We read runs in background threads so as not to stall tx.
  * This structure represents such a thread.
@@ -109,6 +125,10 @@ struct vy_page_read_task {
 	bool equal_found;
 	/** [out] resulting vinyl page */
 	struct vy_page *page;
+	/** if set, return on-disk page data in @data */
+	bool keep_data;
+	/** [out] on-disk page data allocated with malloc() */
+	char *data;
 };
 
 /** Destructor for env->zdctx_key thread-local variable */
@@ -183,6 +203,7 @@ vy_run_env_create(struct vy_run_env *env, int read_threads)
 	tt_pthread_key_create(&env->zdctx_key, vy_free_zdctx);
 	mempool_create(&env->read_task_pool, cord_slab_cache(),
 		       sizeof(struct vy_page_read_task));
+	vy_page_cache_create(&env->page_cache);
 }
 
 /**
@@ -193,6 +214,7 @@ vy_run_env_destroy(struct vy_run_env *env)
 {
 	if (env->reader_pool != NULL)
 		vy_run_env_stop_readers(env);
+	vy_page_cache_destroy(&env->page_cache);
 	mempool_destroy(&env->read_task_pool);
 	tt_pthread_key_delete(env->zdctx_key);
 }
@@ -268,6 +290,7 @@ vy_page_info_destroy(struct vy_page_info *page_info)
 {
 	if (page_info->min_key != NULL)
 		free(page_info->min_key);
+	xor_filter_destroy(&page_info->filter);
 }
 
 struct vy_run *
@@ -309,6 +332,13 @@ vy_run_clear(struct vy_run *run)
 	run->info.min_key = NULL;
 	free(run->info.max_key);
 	run->info.max_key = NULL;
+	if (run->info.ddict != NULL) {
+		ZSTD_freeDDict(run->info.ddict);
+		run->info.ddict = NULL;
+	}
+	free(run->info.dict);
+	run->info.dict = NULL;
+	run->info.dict_size = 0;
 }
 
 void
@@ -317,6 +347,8 @@ vy_run_delete(struct vy_run *run)
 	assert(run->refs == 0);
 	if (run->fd >= 0 && close(run->fd) < 0)
 		say_syserror("close failed");
+	vy_page_cache_invalidate(&run->env->page_cache, run->id,
+				 run->info.page_count);
 	vy_run_clear(run);
 	TRASH(run);
 	free(run);
@@ -526,6 +558,41 @@ vy_slice_cut(struct vy_slice *slice, int64_t id, struct vy_entry begin,
 	return 0;
 }
 
+/**
+ * Decode a page xor filter stored as [seed, fingerprints].
+ * The fingerprint array is copied to a newly allocated buffer.
+ *
+ * @retval  0 Success.
+ * @retval -1 Error.
+ */
+static int
+vy_page_filter_decode(struct xor_filter *filter, const char **data,
+		      const char *filename)
+{
+	if (mp_typeof(**data) != MP_ARRAY || mp_decode_array(data) != 2 ||
+	    mp_typeof(**data) != MP_UINT)
+		goto invalid;
+	filter->seed = mp_decode_uint(data);
+	if (mp_typeof(**data) != MP_BIN)
+		goto invalid;
+	uint32_t size = mp_decode_binl(data);
+	if (size == 0 || size % 3 != 0)
+		goto invalid;
+	filter->block_length = size / 3;
+	filter->fingerprints = malloc(size);
+	if (filter->fingerprints == NULL) {
+		diag_set(OutOfMemory, size, "malloc", "page filter");
+		return -1;
+	}
+	memcpy(filter->fingerprints, *data, size);
+	*data += size;
+	return 0;
+invalid:
+	diag_set(ClientError, ER_INVALID_INDEX_FILE, filename,
+		 "Can't decode page info: invalid filter");
+	return -1;
+}
+
 /**
  * Decode page information from xrow.
  *
@@ -578,6 +645,16 @@ vy_page_info_decode(struct vy_page_info *page, const struct xrow_header *xrow,
 		case VY_PAGE_INFO_ROW_INDEX_OFFSET:
 			page->row_index_offset = mp_decode_uint(&pos);
 			break;
+		case VY_PAGE_INFO_FILTER:
+			if (vy_page_filter_decode(&page->filter, &pos,
+						  filename) != 0) {
+				vy_page_info_destroy(page);
+				return -1;
+			}
+			break;
+		case VY_PAGE_INFO_KEY_INDEX_OFFSET:
+			page->key_index_offset = mp_decode_uint(&pos);
+			break;
 		default:
 			mp_next(&pos); /* unknown key, ignore */
 			break;
@@ -622,6 +699,37 @@ vy_stmt_stat_decode(struct vy_stmt_stat *stat, const char **data)
 	}
 }
 
+/**
+ * Attach a zstd dictionary to run info. The dictionary data
+ * is copied.
+ *
+ * @retval  0 success
+ * @retval -1 error (check diag)
+ */
+static int
+vy_run_info_set_dict(struct vy_run_info *run_info,
+		     const char *dict, uint32_t dict_size)
+{
+	assert(run_info->dict == NULL);
+	char *copy = malloc(dict_size);
+	if (copy == NULL) {
+		diag_set(OutOfMemory, dict_size, "malloc", "run dictionary");
+		return -1;
+	}
+	memcpy(copy, dict, dict_size);
+	ZSTD_DDict *ddict = ZSTD_createDDict_byReference(copy, dict_size);
+	if (ddict == NULL) {
+		diag_set(OutOfMemory, dict_size, "ZSTD_createDDict",
+			 "run dictionary");
+		free(copy);
+		return -1;
+	}
+	run_info->dict = copy;
+	run_info->dict_size = dict_size;
+	run_info->ddict = ddict;
+	return 0;
+}
+
 /**
  * Decode the run metadata from xrow.
  *
@@ -645,6 +753,7 @@ vy_run_info_decode(struct vy_run_info *run_info,
 	uint32_t map_size = mp_decode_map(&pos);
 	uint32_t map_item;
 	const char *tmp;
+	uint32_t len;
 	/* decode run values */
 	for (map_item = 0; map_item < map_size; ++map_item) {
 		uint32_t key = mp_decode_uint(&pos);
@@ -683,9 +792,22 @@ vy_run_info_decode(struct vy_run_info *run_info,
 			if (run_info->bloom == NULL)
 				return -1;
 			break;
+		case VY_RUN_INFO_BLOOM_BLOCKED:
+			run_info->bloom = tuple_bloom_decode_blocked(&pos);
+			if (run_info->bloom == NULL)
+				return -1;
+			break;
 		case VY_RUN_INFO_STMT_STAT:
 			vy_stmt_stat_decode(&run_info->stmt_stat, &pos);
 			break;
+		case VY_RUN_INFO_DICT:
+			tmp = mp_decode_bin(&pos, &len);
+			if (vy_run_info_set_dict(run_info, tmp, len) != 0)
+				return -1;
+			break;
+		case VY_RUN_INFO_SPLIT_ID:
+			run_info->split_id = mp_decode_uint(&pos);
+			break;
 		default:
 			mp_next(&pos); /* unknown key, ignore */
 			break;
@@ -711,8 +833,10 @@ vy_page_new(const struct vy_page_info *page_info)
 			 "load_page", "page cache");
 		return NULL;
 	}
+	page->refs = 1;
 	page->unpacked_size = page_info->unpacked_size;
 	page->row_count = page_info->row_count;
+	memset(&page->key_index, 0, sizeof(page->key_index));
 	page->row_index = calloc(page_info->row_count, sizeof(uint32_t));
 	if (page->row_index == NULL) {
 		diag_set(OutOfMemory, page_info->row_count * sizeof(uint32_t),
@@ -747,6 +871,14 @@ vy_page_delete(struct vy_page *page)
 	free(page);
 }
 
+void
+vy_page_unref(struct vy_page *page)
+{
+	assert(page->refs > 0);
+	if (--page->refs == 0)
+		vy_page_delete(page);
+}
+
 static int
 vy_page_xrow(struct vy_page *page, uint32_t stmt_no,
 	     struct xrow_header *xrow)
@@ -787,23 +919,15 @@ vy_page_stmt(struct vy_page *page, uint32_t stmt_no,
 }
 
 /**
- * Binary search in page
- * In terms of STL, makes lower_bound for EQ,GE,LT and upper_bound for GT,LE
- * Additionally *equal_key argument is set to true if the found value is
- * equal to given key (set to false otherwise).
- * @retval position in the page
+ * Binary search in statements [beg, end) of a page. Statements
+ * are decoded for comparison. See vy_page_find_key().
  */
 static uint32_t
-vy_page_find_key(struct vy_page *page, struct vy_entry key,
-		 struct key_def *cmp_def, struct tuple_format *format,
-		 enum iterator_type iterator_type, bool *equal_key)
+vy_page_find_key_in_range(struct vy_page *page, uint32_t beg, uint32_t end,
+			  struct vy_entry key, struct key_def *cmp_def,
+			  struct tuple_format *format, int zero_cmp,
+			  bool *equal_key)
 {
-	uint32_t beg = 0;
-	uint32_t end = page->row_count;
-	*equal_key = false;
-	/* for upper bound we change zero comparison result to -1 */
-	int zero_cmp = (iterator_type == ITER_GT ||
-			iterator_type == ITER_LE ? -1 : 0);
 	while (beg != end) {
 		uint32_t mid = beg + (end - beg) / 2;
 		struct vy_entry fnd_key = vy_page_stmt(page, mid, cmp_def,
@@ -822,6 +946,119 @@ vy_page_find_key(struct vy_page *page, struct vy_entry key,
 	return end;
 }
 
+/**
+ * Compare a raw key stored in a page key index with a search key.
+ */
+static inline int
+vy_page_key_compare(const char *page_key, struct vy_entry key,
+		    struct key_def *cmp_def)
+{
+	const char *parts = page_key;
+	uint32_t part_count = mp_decode_array(&parts);
+	hint_t hint = key_hint(parts, part_count, cmp_def);
+	return -vy_entry_compare_with_raw_key(key, page_key, hint, cmp_def);
+}
+
+/**
+ * Decode a key stored in a page key index at @a pos into @a buf.
+ * Since keys are front-coded, @a buf must store the previous key.
+ */
+static inline void
+vy_page_key_index_next(const char **pos, char *buf)
+{
+	uint32_t shared = mp_decode_uint(pos);
+	uint32_t len;
+	const char *suffix = mp_decode_bin(pos, &len);
+	memcpy(buf + shared, suffix, len);
+}
+
+/**
+ * Search a page with the help of its key index, which lets us
+ * avoid decoding statements. See vy_page_find_key().
+ */
+static uint32_t
+vy_page_find_key_in_index(struct vy_page *page, struct vy_entry key,
+			  struct key_def *cmp_def, struct tuple_format *format,
+			  int zero_cmp, bool *equal_key)
+{
+	const struct vy_page_key_index *index = &page->key_index;
+	/* Find the first restart point that isn't less than the key. */
+	uint32_t beg = 0;
+	uint32_t end = index->restart_count;
+	while (beg != end) {
+		uint32_t mid = beg + (end - beg) / 2;
+		const char *pos = index->restarts + mid * sizeof(uint32_t);
+		pos = index->data + mp_load_u32(&pos);
+		uint32_t shared = mp_decode_uint(&pos);
+		assert(shared == 0);
+		(void)shared;
+		uint32_t len;
+		const char *restart_key = mp_decode_bin(&pos, &len);
+		int cmp = vy_page_key_compare(restart_key, key, cmp_def);
+		cmp = cmp ? cmp : zero_cmp;
+		*equal_key = *equal_key || cmp == 0;
+		if (cmp < 0)
+			beg = mid + 1;
+		else
+			end = mid;
+	}
+	if (end == 0)
+		return 0;
+	/*
+	 * The key is greater than the key at the restart point
+	 * end - 1 so scan the keys following it.
+	 */
+	uint32_t first = (end - 1) * index->restart_interval;
+	uint32_t last = MIN(first + index->restart_interval, page->row_count);
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	char *buf = region_alloc(region, index->max_key_size);
+	if (buf == NULL) {
+		/* Fall back on decoding statements. */
+		return vy_page_find_key_in_range(page, first + 1, last, key,
+						 cmp_def, format, zero_cmp,
+						 equal_key);
+	}
+	const char *pos = index->restarts + (end - 1) * sizeof(uint32_t);
+	pos = index->data + mp_load_u32(&pos);
+	vy_page_key_index_next(&pos, buf);
+	uint32_t i;
+	for (i = first + 1; i < last; i++) {
+		vy_page_key_index_next(&pos, buf);
+		int cmp = vy_page_key_compare(buf, key, cmp_def);
+		cmp = cmp ? cmp : zero_cmp;
+		if (cmp >= 0) {
+			*equal_key = *equal_key || cmp == 0;
+			break;
+		}
+	}
+	region_truncate(region, region_svp);
+	return i;
+}
+
+/**
+ * Binary search in page
+ * In terms of STL, makes lower_bound for EQ,GE,LT and upper_bound for GT,LE
+ * Additionally *equal_key argument is set to true if the found value is
+ * equal to given key (set to false otherwise).
+ * @retval position in the page
+ */
+static uint32_t
+vy_page_find_key(struct vy_page *page, struct vy_entry key,
+		 struct key_def *cmp_def, struct tuple_format *format,
+		 enum iterator_type iterator_type, bool *equal_key)
+{
+	*equal_key = false;
+	/* for upper bound we change zero comparison result to -1 */
+	int zero_cmp = (iterator_type == ITER_GT ||
+			iterator_type == ITER_LE ? -1 : 0);
+	if (page->key_index.data != NULL)
+		return vy_page_find_key_in_index(page, key, cmp_def, format,
+						 zero_cmp, equal_key);
+	return vy_page_find_key_in_range(page, 0, page->row_count, key,
+					 cmp_def, format, zero_cmp, equal_key);
+}
+
 /**
  * End iteration and free cached data.
  */
@@ -833,9 +1070,9 @@ vy_run_iterator_stop(struct vy_run_iterator *itr)
 		itr->curr = vy_entry_none();
 	}
 	if (itr->curr_page != NULL) {
-		vy_page_delete(itr->curr_page);
+		vy_page_unref(itr->curr_page);
 		if (itr->prev_page != NULL)
-			vy_page_delete(itr->prev_page);
+			vy_page_unref(itr->prev_page);
 		itr->curr_page = itr->prev_page = NULL;
 	}
 }
@@ -872,6 +1109,105 @@ vy_row_index_decode(uint32_t *row_index, uint32_t row_count,
 	return 0;
 }
 
+/**
+ * Check that keys stored in a page key index are well-formed and
+ * fit in a buffer of max_key_size bytes, which is used to decode
+ * them, see vy_page_find_key_in_index(), and that restart points
+ * point to keys stored in full.
+ */
+static bool
+vy_key_index_is_valid(const struct vy_page_key_index *key_index,
+		      uint32_t data_size, uint32_t row_count)
+{
+	const char *pos = key_index->data;
+	const char *end = key_index->data + data_size;
+	const char *restarts = key_index->restarts;
+	uint32_t key_size = 0;
+	for (uint32_t i = 0; i < row_count; i++) {
+		bool is_restart = (i % key_index->restart_interval == 0);
+		if (is_restart &&
+		    key_index->data + mp_load_u32(&restarts) != pos)
+			return false;
+		const char *p = pos;
+		if (pos >= end || mp_typeof(*pos) != MP_UINT ||
+		    mp_check(&p, end) != 0)
+			return false;
+		uint64_t shared = mp_decode_uint(&pos);
+		p = pos;
+		if (pos >= end || mp_typeof(*pos) != MP_BIN ||
+		    mp_check(&p, end) != 0)
+			return false;
+		uint32_t len;
+		mp_decode_bin(&pos, &len);
+		if (shared > key_size || (is_restart && shared != 0) ||
+		    shared + len > key_index->max_key_size)
+			return false;
+		key_size = shared + len;
+	}
+	return true;
+}
+
+static int
+vy_key_index_decode(struct vy_page_key_index *key_index, uint32_t row_count,
+		    struct xrow_header *xrow)
+{
+	assert(xrow->type == VY_RUN_KEY_INDEX);
+	const char *pos = xrow->body->iov_base;
+	const char *data = NULL;
+	const char *restarts = NULL;
+	uint32_t data_size = 0;
+	uint32_t restarts_size = 0;
+	uint32_t restart_interval = 0;
+	uint32_t max_key_size = 0;
+	uint32_t map_size = mp_decode_map(&pos);
+	uint32_t map_item;
+	for (map_item = 0; map_item < map_size; ++map_item) {
+		uint32_t key = mp_decode_uint(&pos);
+		switch (key) {
+		case VY_KEY_INDEX_RESTART_INTERVAL:
+			restart_interval = mp_decode_uint(&pos);
+			break;
+		case VY_KEY_INDEX_MAX_KEY_SIZE:
+			max_key_size = mp_decode_uint(&pos);
+			break;
+		case VY_KEY_INDEX_RESTARTS:
+			restarts = mp_decode_bin(&pos, &restarts_size);
+			break;
+		case VY_KEY_INDEX_DATA:
+			data = mp_decode_bin(&pos, &data_size);
+			break;
+		default:
+			mp_next(&pos); /* unknown key, ignore */
+			break;
+		}
+	}
+	uint32_t restart_count = restart_interval == 0 ? 0 :
+		DIV_ROUND_UP(row_count, restart_interval);
+	if (data == NULL || restarts == NULL || restart_interval == 0 ||
+	    restarts_size != sizeof(uint32_t) * restart_count) {
+		diag_set(ClientError, ER_INVALID_RUN_FILE,
+			 tt_sprintf("Wrong key index (interval %u, "
+				    "restarts size %u, row count %u)",
+				    (unsigned)restart_interval,
+				    (unsigned)restarts_size,
+				    (unsigned)row_count));
+		return -1;
+	}
+	key_index->data = data;
+	key_index->restarts = restarts;
+	key_index->restart_count = restart_count;
+	key_index->restart_interval = restart_interval;
+	key_index->max_key_size = max_key_size;
+	if (!vy_key_index_is_valid(key_index, data_size, row_count)) {
+		key_index->data = NULL;
+		diag_set(ClientError, ER_INVALID_RUN_FILE,
+			 tt_sprintf("Wrong key index (max key size %u)",
+				    (unsigned)max_key_size));
+		return -1;
+	}
+	return 0;
+}
+
 /** Return the name of a run data file. */
 static inline const char *
 vy_run_filename(struct vy_run *run)
@@ -881,22 +1217,88 @@ vy_run_filename(struct vy_run *run)
 	return buf;
 }
 
+/**
+ * Decode a page from its on-disk form, i.e. decompress the page
+ * rows and load the row index.
+ *
+ * @retval 0 on success
+ * @retval -1 on error, check diag
+ */
+static int
+vy_page_decode(struct vy_page *page, const struct vy_page_info *page_info,
+	       const char *data, struct vy_run *run, ZSTD_DStream *zdctx)
+{
+	/* decode xlog tx */
+	const char *data_pos = data;
+	const char *data_end = data + page_info->size;
+	char *rows = page->data;
+	char *rows_end = rows + page_info->unpacked_size;
+	if (xlog_tx_decode(data, data_end, rows, rows_end,
+			   zdctx, run->info.ddict) != 0)
+		return -1;
+
+	struct xrow_header xrow;
+	data_pos = page->data + page_info->row_index_offset;
+	data_end = page->data + page_info->unpacked_size;
+	if (xrow_header_decode(&xrow, &data_pos, data_end, true) == -1)
+		return -1;
+	if (xrow.type != VY_RUN_ROW_INDEX) {
+		diag_set(ClientError, ER_INVALID_RUN_FILE,
+			 tt_sprintf("Wrong row index type "
+				    "(expected %d, got %u)",
+				    VY_RUN_ROW_INDEX, (unsigned)xrow.type));
+		return -1;
+	}
+	if (vy_row_index_decode(page->row_index, page->row_count, &xrow) != 0)
+		return -1;
+	if (page_info->key_index_offset == 0)
+		return 0;
+
+	data_pos = page->data + page_info->key_index_offset;
+	data_end = page->data + page_info->row_index_offset;
+	if (xrow_header_decode(&xrow, &data_pos, data_end, true) == -1)
+		return -1;
+	if (xrow.type != VY_RUN_KEY_INDEX) {
+		diag_set(ClientError, ER_INVALID_RUN_FILE,
+			 tt_sprintf("Wrong key index type "
+				    "(expected %d, got %u)",
+				    VY_RUN_KEY_INDEX, (unsigned)xrow.type));
+		return -1;
+	}
+	return vy_key_index_decode(&page->key_index, page->row_count, &xrow);
+}
+
 /**
  * Read a page requests from vinyl xlog data file.
  *
+ * If @a data_out is not NULL, the on-disk page data is returned
+ * in a buffer allocated with malloc(), which is to be freed by
+ * the caller.
+ *
  * @retval 0 on success
  * @retval -1 on error, check diag
  */
 static int
 vy_page_read(struct vy_page *page, const struct vy_page_info *page_info,
-	     struct vy_run *run, ZSTD_DStream *zdctx)
+	     struct vy_run *run, ZSTD_DStream *zdctx, char **data_out)
 {
 	/* read xlog tx from xlog file */
 	size_t region_svp = region_used(&fiber()->gc);
-	char *data = (char *)region_alloc(&fiber()->gc, page_info->size);
-	if (data == NULL) {
-		diag_set(OutOfMemory, page_info->size, "region gc", "page");
-		return -1;
+	char *data;
+	if (data_out != NULL) {
+		data = malloc(page_info->size);
+		if (data == NULL) {
+			diag_set(OutOfMemory, page_info->size,
+				 "malloc", "page");
+			return -1;
+		}
+	} else {
+		data = region_alloc(&fiber()->gc, page_info->size);
+		if (data == NULL) {
+			diag_set(OutOfMemory, page_info->size,
+				 "region gc", "page");
+			return -1;
+		}
 	}
 	ssize_t readen = fio_pread(run->fd, data, page_info->size,
 				   page_info->offset);
@@ -919,35 +1321,21 @@ vy_page_read(struct vy_page *page, const struct vy_page_info *page_info,
 
 	ERROR_INJECT_SLEEP(ERRINJ_VY_READ_PAGE_DELAY);
 
-	/* decode xlog tx */
-	const char *data_pos = data;
-	const char *data_end = data + readen;
-	char *rows = page->data;
-	char *rows_end = rows + page_info->unpacked_size;
-	if (xlog_tx_decode(data, data_end, rows, rows_end, zdctx) != 0)
-		goto error;
-
-	struct xrow_header xrow;
-	data_pos = page->data + page_info->row_index_offset;
-	data_end = page->data + page_info->unpacked_size;
-	if (xrow_header_decode(&xrow, &data_pos, data_end, true) == -1)
-		goto error;
-	if (xrow.type != VY_RUN_ROW_INDEX) {
-		diag_set(ClientError, ER_INVALID_RUN_FILE,
-			 tt_sprintf("Wrong row index type "
-				    "(expected %d, got %u)",
-				    VY_RUN_ROW_INDEX, (unsigned)xrow.type));
-		goto error;
-	}
-	if (vy_row_index_decode(page->row_index, page->row_count, &xrow) != 0)
+	if (vy_page_decode(page, page_info, data, run, zdctx) != 0)
 		goto error;
 	region_truncate(&fiber()->gc, region_svp);
 	ERROR_INJECT(ERRINJ_VY_READ_PAGE, {
 		diag_set(ClientError, ER_INJECTION, "vinyl page read");
+		if (data_out != NULL)
+			free(data);
 		return -1;});
+	if (data_out != NULL)
+		*data_out = data;
 	return 0;
 error:
 	region_truncate(&fiber()->gc, region_svp);
+	if (data_out != NULL)
+		free(data);
 	diag_log();
 	say_error("error reading %s@%llu:%u", vy_run_filename(run),
 		  (unsigned long long)page_info->offset,
@@ -984,7 +1372,9 @@ vy_page_read_cb(struct cbus_call_msg *base)
 	ZSTD_DStream *zdctx = vy_env_get_zdctx(task->run->env);
 	if (zdctx == NULL)
 		return -1;
-	if (vy_page_read(task->page, task->page_info, task->run, zdctx) != 0)
+	char **data_out = task->keep_data ? &task->data : NULL;
+	if (vy_page_read(task->page, task->page_info, task->run,
+			 zdctx, data_out) != 0)
 		return -1;
 	if (task->key.stmt != NULL) {
 		task->pos_in_page = vy_page_find_key(task->page, task->key,
@@ -998,6 +1388,8 @@ vy_page_read_cb(struct cbus_call_msg *base)
 /**
  * Read a page from disk given its number.
  * The function caches two most recently read pages.
+ * Pages are also looked up in and added to the page cache
+ * shared by all runs, see vy_run_env::page_cache.
  *
  * @retval 0 success
  * @retval -1 critical error
@@ -1009,7 +1401,9 @@ vy_run_iterator_load_page(struct vy_run_iterator *itr, uint32_t page_no,
 			  bool *equal_found)
 {
 	struct vy_slice *slice = itr->slice;
-	struct vy_run_env *env = slice->run->env;
+	struct vy_run *run = slice->run;
+	struct vy_run_env *env = run->env;
+	struct vy_page_cache *page_cache = &env->page_cache;
 
 	/* Check cache */
 	struct vy_page *page = NULL;
@@ -1030,8 +1424,36 @@ vy_run_iterator_load_page(struct vy_run_iterator *itr, uint32_t page_no,
 		return 0;
 	}
 
+	/* Check the page cache */
+	struct vy_page_info *page_info = vy_run_page_info(run, page_no);
+	struct vy_page_cache_entry *entry = vy_page_cache_get(page_cache,
+							      run->id, page_no);
+	if (entry != NULL && entry->page != NULL) {
+		page = entry->page;
+		vy_page_ref(page);
+	} else if (entry != NULL) {
+		/* The page is cached compressed, decode it. */
+		ZSTD_DStream *zdctx = vy_env_get_zdctx(env);
+		if (zdctx == NULL)
+			return -1;
+		page = vy_page_new(page_info);
+		if (page == NULL)
+			return -1;
+		if (vy_page_decode(page, page_info, entry->data,
+				   run, zdctx) != 0) {
+			vy_page_delete(page);
+			return -1;
+		}
+	}
+	if (page != NULL) {
+		if (key.stmt != NULL)
+			*pos_in_page = vy_page_find_key(page, key, itr->cmp_def,
+							itr->format, iterator_type,
+							equal_found);
+		goto update_cache;
+	}
+
 	/* Allocate buffers */
-	struct vy_page_info *page_info = vy_run_page_info(slice->run, page_no);
 	page = vy_page_new(page_info);
 	if (page == NULL)
 		return -1;
@@ -1053,11 +1475,15 @@ vy_run_iterator_load_page(struct vy_run_iterator *itr, uint32_t page_no,
 	task->format = itr->format;
 	task->pos_in_page = 0;
 	task->equal_found = false;
+	task->keep_data = vy_page_cache_is_enabled(page_cache) &&
+			  page_cache->store_compressed;
+	task->data = NULL;
 
 	int rc = vy_run_env_coio_call(env, &task->base, vy_page_read_cb);
 
 	*pos_in_page = task->pos_in_page;
 	*equal_found = task->equal_found;
+	char *data = task->data;
 
 	mempool_free(&env->read_task_pool, task);
 	if (rc != 0) {
@@ -1065,19 +1491,27 @@ vy_run_iterator_load_page(struct vy_run_iterator *itr, uint32_t page_no,
 		return -1;
 	}
 
-	/* Update cache */
-	if (itr->prev_page != NULL)
-		vy_page_delete(itr->prev_page);
-	itr->prev_page = itr->curr_page;
-	itr->curr_page = page;
-	page->page_no = page_no;
-
 	/* Update read statistics. */
 	itr->stat->read.rows += page_info->row_count;
 	itr->stat->read.bytes += page_info->unpacked_size;
 	itr->stat->read.bytes_compressed += page_info->size;
 	itr->stat->read.pages++;
 
+	/* Add the page to the page cache */
+	if (data != NULL) {
+		vy_page_cache_put_data(page_cache, run->id, page_no,
+				       data, page_info->size);
+	} else {
+		vy_page_cache_put_page(page_cache, run->id, page_no, page);
+	}
+update_cache:
+	/* Update cache */
+	if (itr->prev_page != NULL)
+		vy_page_unref(itr->prev_page);
+	itr->prev_page = itr->curr_page;
+	itr->curr_page = page;
+	page->page_no = page_no;
+
 	*result = page;
 	return 0;
 }
@@ -1125,10 +1559,22 @@ vy_run_iterator_search(struct vy_run_iterator *itr,
 		       enum iterator_type iterator_type, struct vy_entry key,
 		       struct vy_run_iterator_pos *pos, bool *equal_key)
 {
-	pos->page_no = vy_page_index_find_page(itr->slice->run, key,
-					       itr->cmp_def, iterator_type,
-					       equal_key);
-	if (pos->page_no == itr->slice->run->info.page_count)
+	struct vy_run *run = itr->slice->run;
+	pos->page_no = vy_page_index_find_page(run, key, itr->cmp_def,
+					       iterator_type, equal_key);
+	if (pos->page_no == run->info.page_count)
+		return 1;
+	/*
+	 * If the page has a filter and the key isn't the page
+	 * min key, check the filter to avoid reading the page
+	 * in case of a miss.
+	 */
+	struct vy_page_info *page_info = vy_run_page_info(run, pos->page_no);
+	uint32_t hash;
+	if (iterator_type == ITER_EQ && !*equal_key &&
+	    page_info->filter.fingerprints != NULL &&
+	    vy_stmt_key_hash(key, itr->key_def, &hash) &&
+	    !xor_filter_maybe_has(&page_info->filter, hash))
 		return 1;
 	bool equal_in_page;
 	struct vy_page *page;
@@ -1348,10 +1794,16 @@ vy_run_iterator_seek(struct vy_run_iterator *itr, struct vy_entry last,
 	*ret = vy_entry_none();
 	assert(itr->search_started);
 
-	/* Check the bloom filter on the first iteration. */
-	bool check_bloom = (itr->iterator_type == ITER_EQ &&
-			    itr->curr.stmt == NULL && bloom != NULL);
-	if (check_bloom && !vy_bloom_maybe_has(bloom, itr->key, itr->key_def)) {
+	/*
+	 * Check the bloom filter on the first iteration.
+	 * Since there's a bloom filter for each partial key,
+	 * it can be used for any scan with an equality prefix,
+	 * both forward and reverse.
+	 */
+	bool check_bloom = (itr->is_eq_scan && itr->curr.stmt == NULL &&
+			    bloom != NULL);
+	if (check_bloom && !itr->is_bloom_checked &&
+	    !vy_bloom_maybe_has(bloom, itr->key, itr->key_def)) {
 		vy_run_iterator_stop(itr);
 		itr->stat->bloom_hit++;
 		return 0;
@@ -1364,6 +1816,14 @@ vy_run_iterator_seek(struct vy_run_iterator *itr, struct vy_entry last,
 	 */
 	bool check_eq = false;
 
+	/*
+	 * A REQ scan is run as LE, so if the first statement found
+	 * doesn't match the key, the run doesn't store the key
+	 * prefix, i.e. the bloom filter check was a false positive.
+	 */
+	bool check_prefix = (check_bloom && last.stmt == NULL &&
+			     itr->iterator_type == ITER_LE);
+
 	/*
 	 * Modify iterator type and key so as to position it to
 	 * the first statement following the given key.
@@ -1442,8 +1902,8 @@ vy_run_iterator_seek(struct vy_run_iterator *itr, struct vy_entry last,
 		return -1;
 
 	/* Check EQ constraint if necessary. */
-	if (check_eq && vy_entry_compare(itr->curr, itr->key,
-					 itr->cmp_def) != 0)
+	if ((check_eq || check_prefix) &&
+	    vy_entry_compare(itr->curr, itr->key, itr->cmp_def) != 0)
 		goto not_found;
 
 	/* Skip statements invisible from the iterator read view. */
@@ -1474,7 +1934,12 @@ vy_run_iterator_open(struct vy_run_iterator *itr,
 	itr->format = format;
 	itr->slice = slice;
 
+	itr->is_eq_scan = (iterator_type == ITER_EQ ||
+			   iterator_type == ITER_REQ);
+	if (iterator_type == ITER_REQ)
+		iterator_type = ITER_LE;
 	itr->iterator_type = iterator_type;
+	itr->is_bloom_checked = false;
 	itr->key = key;
 	itr->read_view = rv;
 
@@ -1649,6 +2114,8 @@ vy_run_acct_page(struct vy_run *run, struct vy_page_info *page)
 	mp_next(&min_key_end);
 	run->page_index_size += sizeof(struct vy_page_info);
 	run->page_index_size += min_key_end - page->min_key;
+	if (page->filter.fingerprints != NULL)
+		run->page_index_size += xor_filter_size(&page->filter);
 	run->count.rows += page->row_count;
 	run->count.bytes += page->unpacked_size;
 	run->count.bytes_compressed += page->size;
@@ -1883,10 +2350,17 @@ vy_page_info_encode(const struct vy_page_info *page_info,
 	mp_next(&tmp);
 	min_key_size = tmp - page_info->min_key;
 
+	bool has_filter = page_info->filter.fingerprints != NULL;
+	uint32_t filter_size = 0;
+	if (has_filter)
+		filter_size = xor_filter_size(&page_info->filter);
+	bool has_key_index = page_info->key_index_offset != 0;
+	uint32_t key_count = 6 + has_filter + has_key_index;
+
 	/* calc tuple size */
 	uint32_t size;
 	/* 3 items: page offset, size, and map */
-	size = mp_sizeof_map(6) +
+	size = mp_sizeof_map(key_count) +
 	       mp_sizeof_uint(VY_PAGE_INFO_OFFSET) +
 	       mp_sizeof_uint(page_info->offset) +
 	       mp_sizeof_uint(VY_PAGE_INFO_SIZE) +
@@ -1899,6 +2373,16 @@ vy_page_info_encode(const struct vy_page_info *page_info,
 	       mp_sizeof_uint(page_info->unpacked_size) +
 	       mp_sizeof_uint(VY_PAGE_INFO_ROW_INDEX_OFFSET) +
 	       mp_sizeof_uint(page_info->row_index_offset);
+	if (has_filter) {
+		size += mp_sizeof_uint(VY_PAGE_INFO_FILTER) +
+			mp_sizeof_array(2) +
+			mp_sizeof_uint(page_info->filter.seed) +
+			mp_sizeof_bin(filter_size);
+	}
+	if (has_key_index) {
+		size += mp_sizeof_uint(VY_PAGE_INFO_KEY_INDEX_OFFSET) +
+			mp_sizeof_uint(page_info->key_index_offset);
+	}
 
 	char *pos = region_alloc(region, size);
 	if (pos == NULL) {
@@ -1909,7 +2393,7 @@ vy_page_info_encode(const struct vy_page_info *page_info,
 	memset(xrow, 0, sizeof(*xrow));
 	/* encode page */
 	xrow->body->iov_base = pos;
-	pos = mp_encode_map(pos, 6);
+	pos = mp_encode_map(pos, key_count);
 	pos = mp_encode_uint(pos, VY_PAGE_INFO_OFFSET);
 	pos = mp_encode_uint(pos, page_info->offset);
 	pos = mp_encode_uint(pos, VY_PAGE_INFO_SIZE);
@@ -1923,6 +2407,18 @@ vy_page_info_encode(const struct vy_page_info *page_info,
 	pos = mp_encode_uint(pos, page_info->unpacked_size);
 	pos = mp_encode_uint(pos, VY_PAGE_INFO_ROW_INDEX_OFFSET);
 	pos = mp_encode_uint(pos, page_info->row_index_offset);
+	if (has_filter) {
+		pos = mp_encode_uint(pos, VY_PAGE_INFO_FILTER);
+		pos = mp_encode_array(pos, 2);
+		pos = mp_encode_uint(pos, page_info->filter.seed);
+		pos = mp_encode_bin(pos, (const char *)
+				    page_info->filter.fingerprints,
+				    filter_size);
+	}
+	if (has_key_index) {
+		pos = mp_encode_uint(pos, VY_PAGE_INFO_KEY_INDEX_OFFSET);
+		pos = mp_encode_uint(pos, page_info->key_index_offset);
+	}
 	xrow->body->iov_len = (void *)pos - xrow->body->iov_base;
 	xrow->bodycnt = 1;
 
@@ -1990,6 +2486,10 @@ vy_run_info_encode(const struct vy_run_info *run_info,
 	uint32_t key_count = 6;
 	if (run_info->bloom != NULL)
 		key_count++;
+	if (run_info->dict != NULL)
+		key_count++;
+	if (run_info->split_id != 0)
+		key_count++;
 
 	size_t size = mp_sizeof_map(key_count);
 	size += mp_sizeof_uint(VY_RUN_INFO_MIN_KEY) + min_key_size;
@@ -2000,11 +2500,20 @@ vy_run_info_encode(const struct vy_run_info *run_info,
 		mp_sizeof_uint(run_info->max_lsn);
 	size += mp_sizeof_uint(VY_RUN_INFO_PAGE_COUNT) +
 		mp_sizeof_uint(run_info->page_count);
+	enum vy_run_info_key bloom_key = VY_RUN_INFO_BLOOM;
+	if (run_info->bloom != NULL && run_info->bloom->is_blocked)
+		bloom_key = VY_RUN_INFO_BLOOM_BLOCKED;
 	if (run_info->bloom != NULL)
-		size += mp_sizeof_uint(VY_RUN_INFO_BLOOM) +
+		size += mp_sizeof_uint(bloom_key) +
 			tuple_bloom_size(run_info->bloom);
 	size += mp_sizeof_uint(VY_RUN_INFO_STMT_STAT) +
 		vy_stmt_stat_sizeof(&run_info->stmt_stat);
+	if (run_info->dict != NULL)
+		size += mp_sizeof_uint(VY_RUN_INFO_DICT) +
+			mp_sizeof_bin(run_info->dict_size);
+	if (run_info->split_id != 0)
+		size += mp_sizeof_uint(VY_RUN_INFO_SPLIT_ID) +
+			mp_sizeof_uint(run_info->split_id);
 
 	char *pos = region_alloc(&fiber()->gc, size);
 	if (pos == NULL) {
@@ -2028,11 +2537,19 @@ vy_run_info_encode(const struct vy_run_info *run_info,
 	pos = mp_encode_uint(pos, VY_RUN_INFO_PAGE_COUNT);
 	pos = mp_encode_uint(pos, run_info->page_count);
 	if (run_info->bloom != NULL) {
-		pos = mp_encode_uint(pos, VY_RUN_INFO_BLOOM);
+		pos = mp_encode_uint(pos, bloom_key);
 		pos = tuple_bloom_encode(run_info->bloom, pos);
 	}
 	pos = mp_encode_uint(pos, VY_RUN_INFO_STMT_STAT);
 	pos = vy_stmt_stat_encode(&run_info->stmt_stat, pos);
+	if (run_info->dict != NULL) {
+		pos = mp_encode_uint(pos, VY_RUN_INFO_DICT);
+		pos = mp_encode_bin(pos, run_info->dict, run_info->dict_size);
+	}
+	if (run_info->split_id != 0) {
+		pos = mp_encode_uint(pos, VY_RUN_INFO_SPLIT_ID);
+		pos = mp_encode_uint(pos, run_info->split_id);
+	}
 	xrow->body->iov_len = (void *)pos - xrow->body->iov_base;
 	xrow->bodycnt = 1;
 	xrow->type = VY_INDEX_RUN_INFO;
@@ -2112,7 +2629,9 @@ int
 vy_run_writer_create(struct vy_run_writer *writer, struct vy_run *run,
 		     const char *dirpath, uint32_t space_id, uint32_t iid,
 		     struct key_def *cmp_def, struct key_def *key_def,
-		     uint64_t page_size, double bloom_fpr, bool no_compression)
+		     uint64_t page_size, double bloom_fpr, bool page_filter,
+		     bool page_key_index, uint32_t dict_size,
+		     bool no_compression)
 {
 	memset(writer, 0, sizeof(*writer));
 	writer->run = run;
@@ -2123,7 +2642,11 @@ vy_run_writer_create(struct vy_run_writer *writer, struct vy_run *run,
 	writer->key_def = key_def;
 	writer->page_size = page_size;
 	writer->bloom_fpr = bloom_fpr;
+	writer->page_filter = page_filter && !key_def->is_multikey;
+	writer->page_key_index = page_key_index && !cmp_def->is_multikey;
 	writer->no_compression = no_compression;
+	writer->dict_size = no_compression ? 0 : dict_size;
+	writer->is_sampling = writer->dict_size > 0;
 	if (bloom_fpr < 1) {
 		writer->bloom = tuple_bloom_builder_new(key_def->part_count);
 		if (writer->bloom == NULL)
@@ -2132,6 +2655,14 @@ vy_run_writer_create(struct vy_run_writer *writer, struct vy_run *run,
 	xlog_clear(&writer->data_xlog);
 	ibuf_create(&writer->row_index_buf, &cord()->slabc,
 		    4096 * sizeof(uint32_t));
+	ibuf_create(&writer->page_hash_buf, &cord()->slabc,
+		    4096 * sizeof(uint32_t));
+	ibuf_create(&writer->sample_buf, &cord()->slabc,
+		    4096 * sizeof(struct vy_entry));
+	ibuf_create(&writer->key_index_buf, &cord()->slabc, 16 * 1024);
+	ibuf_create(&writer->key_restart_buf, &cord()->slabc,
+		    256 * sizeof(uint32_t));
+	ibuf_create(&writer->last_key_buf, &cord()->slabc, 1024);
 	run->info.min_lsn = INT64_MAX;
 	run->info.max_lsn = -1;
 	assert(run->page_info == NULL);
@@ -2160,6 +2691,7 @@ vy_run_writer_create_xlog(struct vy_run_writer *writer)
 	opts.rate_limit = writer->run->env->snap_io_rate_limit;
 	opts.sync_interval = VY_RUN_SYNC_INTERVAL;
 	opts.no_compression = writer->no_compression;
+	opts.zdict = writer->zdict;
 	if (xlog_create(&writer->data_xlog, path, 0, &meta, &opts) != 0)
 		return -1;
 	return 0;
@@ -2203,6 +2735,116 @@ vy_run_writer_start_page(struct vy_run_writer *writer,
 	return 0;
 }
 
+/**
+ * Add the key of a statement to the key index of a current page.
+ * @param writer Run writer.
+ * @param entry Statement to add.
+ * @param row_no Position of the statement in the page.
+ *
+ * @retval -1 Memory error.
+ * @retval  0 Success.
+ */
+static int
+vy_run_writer_add_key(struct vy_run_writer *writer, struct vy_entry entry,
+		      uint32_t row_no)
+{
+	const char *key;
+	uint32_t key_size;
+	if (vy_stmt_is_key(entry.stmt)) {
+		key = tuple_data_range(entry.stmt, &key_size);
+	} else {
+		key = tuple_extract_key(entry.stmt, writer->cmp_def,
+					MULTIKEY_NONE, &key_size);
+		if (key == NULL)
+			return -1;
+	}
+	uint32_t shared = 0;
+	if (row_no % VY_PAGE_KEY_RESTART_INTERVAL == 0) {
+		/* Store a restart point. */
+		uint32_t *offset = (uint32_t *)ibuf_alloc(
+				&writer->key_restart_buf, sizeof(uint32_t));
+		if (offset == NULL) {
+			diag_set(OutOfMemory, sizeof(uint32_t),
+				 "ibuf", "key index");
+			return -1;
+		}
+		*offset = ibuf_used(&writer->key_index_buf);
+	} else {
+		const char *last_key = writer->last_key_buf.rpos;
+		uint32_t last_key_size = ibuf_used(&writer->last_key_buf);
+		uint32_t max_shared = MIN(key_size, last_key_size);
+		while (shared < max_shared && key[shared] == last_key[shared])
+			shared++;
+	}
+	size_t size = mp_sizeof_uint(shared) + mp_sizeof_bin(key_size - shared);
+	char *pos = (char *)ibuf_alloc(&writer->key_index_buf, size);
+	if (pos == NULL) {
+		diag_set(OutOfMemory, size, "ibuf", "key index");
+		return -1;
+	}
+	pos = mp_encode_uint(pos, shared);
+	pos = mp_encode_bin(pos, key + shared, key_size - shared);
+	ibuf_reset(&writer->last_key_buf);
+	char *last_key = (char *)ibuf_alloc(&writer->last_key_buf, key_size);
+	if (last_key == NULL) {
+		diag_set(OutOfMemory, key_size, "ibuf", "key index");
+		return -1;
+	}
+	memcpy(last_key, key, key_size);
+	writer->max_key_size = MAX(writer->max_key_size, key_size);
+	return 0;
+}
+
+/**
+ * Encode the key index of a current page as xrow.
+ * Allocates using region alloc.
+ *
+ * @retval -1 Memory error.
+ * @retval  0 Success.
+ */
+static int
+vy_run_writer_encode_key_index(struct vy_run_writer *writer,
+			       struct xrow_header *xrow)
+{
+	memset(xrow, 0, sizeof(*xrow));
+	xrow->type = VY_RUN_KEY_INDEX;
+
+	uint32_t restart_count = ibuf_used(&writer->key_restart_buf) /
+				 sizeof(uint32_t);
+	uint32_t data_size = ibuf_used(&writer->key_index_buf);
+	size_t size = mp_sizeof_map(4) +
+		      mp_sizeof_uint(VY_KEY_INDEX_RESTART_INTERVAL) +
+		      mp_sizeof_uint(VY_PAGE_KEY_RESTART_INTERVAL) +
+		      mp_sizeof_uint(VY_KEY_INDEX_MAX_KEY_SIZE) +
+		      mp_sizeof_uint(writer->max_key_size) +
+		      mp_sizeof_uint(VY_KEY_INDEX_RESTARTS) +
+		      mp_sizeof_bin(sizeof(uint32_t) * restart_count) +
+		      mp_sizeof_uint(VY_KEY_INDEX_DATA) +
+		      mp_sizeof_bin(data_size);
+	char *pos = region_alloc(&fiber()->gc, size);
+	if (pos == NULL) {
+		diag_set(OutOfMemory, size, "region", "key index");
+		return -1;
+	}
+	xrow->body->iov_base = pos;
+	pos = mp_encode_map(pos, 4);
+	pos = mp_encode_uint(pos, VY_KEY_INDEX_RESTART_INTERVAL);
+	pos = mp_encode_uint(pos, VY_PAGE_KEY_RESTART_INTERVAL);
+	pos = mp_encode_uint(pos, VY_KEY_INDEX_MAX_KEY_SIZE);
+	pos = mp_encode_uint(pos, writer->max_key_size);
+	pos = mp_encode_uint(pos, VY_KEY_INDEX_RESTARTS);
+	pos = mp_encode_binl(pos, sizeof(uint32_t) * restart_count);
+	uint32_t *restarts = (uint32_t *)writer->key_restart_buf.rpos;
+	for (uint32_t i = 0; i < restart_count; ++i)
+		pos = mp_store_u32(pos, restarts[i]);
+	pos = mp_encode_uint(pos, VY_KEY_INDEX_DATA);
+	pos = mp_encode_bin(pos, writer->key_index_buf.rpos, data_size);
+	xrow->body->iov_len = (void *)pos - xrow->body->iov_base;
+	assert(xrow->body->iov_len == size);
+	xrow->bodycnt = 1;
+	return 0;
+}
+
 /**
  * Write @a stmt into a current page.
  * @param writer Run writer.
@@ -2217,12 +2859,30 @@ vy_run_writer_write_to_page(struct vy_run_writer *writer, struct vy_entry entry)
 	if (writer->bloom != NULL &&
 	    vy_bloom_builder_add(writer->bloom, entry, writer->key_def) != 0)
 		return -1;
+	if (writer->page_filter && !writer->page_filter_failed) {
+		uint32_t hash;
+		if (vy_stmt_key_hash(entry, writer->key_def, &hash)) {
+			uint32_t *p = (uint32_t *)ibuf_alloc(
+				&writer->page_hash_buf, sizeof(uint32_t));
+			if (p == NULL) {
+				diag_set(OutOfMemory, sizeof(uint32_t),
+					 "ibuf", "page hash");
+				return -1;
+			}
+			*p = hash;
+		} else {
+			writer->page_filter_failed = true;
+		}
+	}
 	if (writer->last.stmt != NULL)
 		vy_stmt_unref_if_possible(writer->last.stmt);
 	writer->last = entry;
 	vy_stmt_ref_if_possible(entry.stmt);
 	struct vy_run *run = writer->run;
 	struct vy_page_info *page = run->page_info + run->info.page_count;
+	if (writer->page_key_index &&
+	    vy_run_writer_add_key(writer, entry, page->row_count) != 0)
+		return -1;
 	uint32_t *offset = (uint32_t *)ibuf_alloc(&writer->row_index_buf,
 						  sizeof(uint32_t));
 	if (offset == NULL) {
@@ -2257,10 +2917,21 @@ vy_run_writer_end_page(struct vy_run_writer *writer)
 	       sizeof(uint32_t) * page->row_count);
 
 	struct xrow_header xrow;
+	ssize_t written;
+	if (writer->page_key_index) {
+		if (vy_run_writer_encode_key_index(writer, &xrow) != 0)
+			return -1;
+		written = xlog_write_row(&writer->data_xlog, &xrow);
+		if (written < 0)
+			return -1;
+		page->key_index_offset = page->unpacked_size;
+		page->unpacked_size += written;
+	}
+
 	uint32_t *row_index = (uint32_t *)writer->row_index_buf.rpos;
 	if (vy_row_index_encode(row_index, page->row_count, &xrow) < 0)
 		return -1;
-	ssize_t written = xlog_write_row(&writer->data_xlog, &xrow);
+	written = xlog_write_row(&writer->data_xlog, &xrow);
 	if (written < 0)
 		return -1;
 	page->row_index_offset = page->unpacked_size;
@@ -2272,15 +2943,172 @@ vy_run_writer_end_page(struct vy_run_writer *writer)
 	if (written < 0)
 		return -1;
 	page->size = written;
+	if (writer->page_filter && !writer->page_filter_failed) {
+		uint32_t *hashes = (uint32_t *)writer->page_hash_buf.rpos;
+		uint32_t hash_count = ibuf_used(&writer->page_hash_buf) /
+				      sizeof(uint32_t);
+		if (xor_filter_create(&page->filter, hashes,
+				      hash_count) != 0) {
+			diag_set(OutOfMemory, hash_count, "malloc",
+				 "page filter");
+			return -1;
+		}
+	}
 	run->info.page_count++;
 	vy_run_acct_page(run, page);
 	ibuf_reset(&writer->row_index_buf);
+	ibuf_reset(&writer->page_hash_buf);
+	ibuf_reset(&writer->key_index_buf);
+	ibuf_reset(&writer->key_restart_buf);
+	ibuf_reset(&writer->last_key_buf);
+	writer->max_key_size = 0;
+	writer->page_filter_failed = false;
 	return 0;
 }
 
+/**
+ * Train a zstd dictionary on the statements collected by
+ * the writer and attach it to the run. If there isn't enough
+ * data or zstd fails to train a dictionary, the run pages are
+ * compressed without it.
+ *
+ * @retval -1 Memory error.
+ * @retval  0 Success.
+ */
+static int
+vy_run_writer_train_dict(struct vy_run_writer *writer)
+{
+	assert(writer->zdict == NULL);
+	if (writer->sample_size < (size_t)writer->dict_size *
+				  VY_RUN_DICT_SAMPLE_RATIO_MIN)
+		return 0;
+
+	struct vy_entry *sample = (struct vy_entry *)writer->sample_buf.rpos;
+	size_t sample_count = ibuf_used(&writer->sample_buf) /
+			      sizeof(struct vy_entry);
+	int rc = -1;
+	char *dict = NULL;
+	size_t *sizes = NULL;
+	char *data = malloc(writer->sample_size);
+	if (data == NULL) {
+		diag_set(OutOfMemory, writer->sample_size,
+			 "malloc", "dictionary sample");
+		goto out;
+	}
+	sizes = malloc(sample_count * sizeof(*sizes));
+	if (sizes == NULL) {
+		diag_set(OutOfMemory, sample_count * sizeof(*sizes),
+			 "malloc", "dictionary sample");
+		goto out;
+	}
+	dict = malloc(writer->dict_size);
+	if (dict == NULL) {
+		diag_set(OutOfMemory, writer->dict_size,
+			 "malloc", "dictionary");
+		goto out;
+	}
+	char *pos = data;
+	for (size_t i = 0; i < sample_count; i++) {
+		uint32_t size;
+		const char *stmt_data = tuple_data_range(sample[i].stmt, &size);
+		memcpy(pos, stmt_data, size);
+		pos += size;
+		sizes[i] = size;
+	}
+	assert(pos == data + writer->sample_size);
+
+	size_t dict_size = ZDICT_trainFromBuffer(dict, writer->dict_size,
+						 data, sizes, sample_count);
+	if (ZDICT_isError(dict_size)) {
+		say_verbose("failed to train dictionary for %s: %s",
+			    vy_run_filename(writer->run),
+			    ZDICT_getErrorName(dict_size));
+		rc = 0;
+		goto out;
+	}
+	/* 3 is compression level. */
+	writer->zdict = ZSTD_createCDict(dict, dict_size, 3);
+	if (writer->zdict == NULL) {
+		diag_set(OutOfMemory, dict_size, "ZSTD_createCDict",
+			 "dictionary");
+		goto out;
+	}
+	if (vy_run_info_set_dict(&writer->run->info, dict, dict_size) != 0)
+		goto out;
+	rc = 0;
+out:
+	free(dict);
+	free(sizes);
+	free(data);
+	return rc;
+}
+
+/**
+ * Release statements collected to train a dictionary on.
+ */
+static void
+vy_run_writer_release_sample(struct vy_run_writer *writer)
+{
+	struct vy_entry *entry = (struct vy_entry *)writer->sample_buf.rpos;
+	struct vy_entry *end = (struct vy_entry *)writer->sample_buf.wpos;
+	for (; entry < end; entry++)
+		vy_stmt_unref_if_possible(entry->stmt);
+	ibuf_reset(&writer->sample_buf);
+	writer->sample_size = 0;
+}
+
+/**
+ * Stop collecting statements for the dictionary sample, train
+ * the dictionary, and write the collected statements to the run.
+ *
+ * @retval -1 Memory or IO error.
+ * @retval  0 Success.
+ */
+static int
+vy_run_writer_flush_sample(struct vy_run_writer *writer)
+{
+	assert(writer->is_sampling);
+	writer->is_sampling = false;
+	int rc = vy_run_writer_train_dict(writer);
+	struct vy_entry *entry = (struct vy_entry *)writer->sample_buf.rpos;
+	struct vy_entry *end = (struct vy_entry *)writer->sample_buf.wpos;
+	for (; rc == 0 && entry < end; entry++)
+		rc = vy_run_writer_append_stmt(writer, *entry);
+	vy_run_writer_release_sample(writer);
+	return rc;
+}
+
+/**
+ * Add a statement to the sample the dictionary is trained on.
+ * Once the sample is big enough, flush it.
+ *
+ * @retval -1 Memory or IO error.
+ * @retval  0 Success.
+ */
+static int
+vy_run_writer_sample_stmt(struct vy_run_writer *writer, struct vy_entry entry)
+{
+	struct vy_entry *sample = (struct vy_entry *)ibuf_alloc(
+			&writer->sample_buf, sizeof(*sample));
+	if (sample == NULL) {
+		diag_set(OutOfMemory, sizeof(*sample), "ibuf",
+			 "dictionary sample");
+		return -1;
+	}
+	*sample = entry;
+	vy_stmt_ref_if_possible(entry.stmt);
+	writer->sample_size += entry.stmt->bsize;
+	if (writer->sample_size < (size_t)writer->dict_size *
+				  VY_RUN_DICT_SAMPLE_RATIO)
+		return 0;
+	return vy_run_writer_flush_sample(writer);
+}
+
 int
 vy_run_writer_append_stmt(struct vy_run_writer *writer, struct vy_entry entry)
 {
+	if (writer->is_sampling)
+		return vy_run_writer_sample_stmt(writer, entry);
 	int rc = -1;
 	size_t region_svp = region_used(&fiber()->gc);
 	if (!xlog_is_open(&writer->data_xlog) &&
@@ -2313,9 +3141,17 @@ vy_run_writer_destroy(struct vy_run_writer *writer, bool reuse_fd)
 		vy_stmt_unref_if_possible(writer->last.stmt);
 	if (xlog_is_open(&writer->data_xlog))
 		xlog_close(&writer->data_xlog, reuse_fd);
+	if (writer->zdict != NULL)
+		ZSTD_freeCDict(writer->zdict);
 	if (writer->bloom != NULL)
 		tuple_bloom_builder_delete(writer->bloom);
+	vy_run_writer_release_sample(writer);
 	ibuf_destroy(&writer->row_index_buf);
+	ibuf_destroy(&writer->page_hash_buf);
+	ibuf_destroy(&writer->sample_buf);
+	ibuf_destroy(&writer->key_index_buf);
+	ibuf_destroy(&writer->key_restart_buf);
+	ibuf_destroy(&writer->last_key_buf);
 }
 
 int
@@ -2324,6 +3160,10 @@ vy_run_writer_commit(struct vy_run_writer *writer)
 	int rc = -1;
 	size_t region_svp = region_used(&fiber()->gc);
 
+	if (writer->is_sampling &&
+	    vy_run_writer_flush_sample(writer) != 0)
+		goto out;
+
 	if (ibuf_used(&writer->row_index_buf) != 0 &&
 	    vy_run_writer_end_page(writer) != 0)
 		goto out;
@@ -2431,6 +3271,7 @@ vy_run_rebuild_index(struct vy_run *run, const char *dir,
 			goto close_err;
 		uint32_t page_row_count = 0;
 		uint64_t page_row_index_offset = 0;
+		uint64_t page_key_index_offset = 0;
 		uint64_t row_offset = xlog_cursor_tx_pos(&cursor);
 
 		struct xrow_header xrow;
@@ -2440,6 +3281,11 @@ vy_run_rebuild_index(struct vy_run *run, const char *dir,
 				row_offset = xlog_cursor_tx_pos(&cursor);
 				continue;
 			}
+			if (xrow.type == VY_RUN_KEY_INDEX) {
+				page_key_index_offset = row_offset;
+				row_offset = xlog_cursor_tx_pos(&cursor);
+				continue;
+			}
 			++page_row_count;
 			struct tuple *tuple = vy_stmt_decode(&xrow, format);
 			if (tuple == NULL)
@@ -2485,6 +3331,7 @@ vy_run_rebuild_index(struct vy_run *run, const char *dir,
 		info->size = next_page_offset - page_offset;
 		info->unpacked_size = xlog_cursor_tx_pos(&cursor);
 		info->row_index_offset = page_row_index_offset;
+		info->key_index_offset = page_key_index_offset;
 		++run->info.page_count;
 		vy_run_acct_page(run, info);
 
@@ -2586,7 +3433,7 @@ vy_slice_stream_read_page(struct vy_slice_stream *stream)
 	if (stream->page == NULL)
 		return -1;
 
-	if (vy_page_read(stream->page, page_info, run, zdctx) != 0) {
+	if (vy_page_read(stream->page, page_info, run, zdctx, NULL) != 0) {
 		vy_page_delete(stream->page);
 		stream->page = NULL;
 		return -1;
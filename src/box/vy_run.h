@@ -44,6 +44,8 @@
 #include "xlog.h"
 
 #include "small/mempool.h"
+#include "salad/xor_filter.h"
+#include "vy_page_cache.h"
 
 #if defined(__cplusplus)
 extern "C" {
@@ -69,6 +71,13 @@ struct vy_run_env {
 	 * processing the next read request.
 	 */
 	int next_reader;
+	/**
+	 * If set, a point lookup reads all runs of a range that
+	 * may contain the key in parallel, box.cfg.vinyl_parallel_lookup.
+	 */
+	bool parallel_lookup;
+	/** Cache of pages read from disk, box.cfg.vinyl_page_cache. */
+	struct vy_page_cache page_cache;
 };
 
 /**
@@ -89,6 +98,22 @@ struct vy_run_info {
 	struct tuple_bloom *bloom;
 	/** Statement statistics. */
 	struct vy_stmt_stat stmt_stat;
+	/**
+	 * Zstd dictionary the run pages were compressed with
+	 * or NULL if the pages were compressed without one.
+	 */
+	char *dict;
+	/** Size of the dictionary. */
+	uint32_t dict_size;
+	/** Digested dictionary used for decompression. */
+	ZSTD_DDict *ddict;
+	/**
+	 * If the run was written by a compaction task split in
+	 * key-partitioned parts, ID of the run written by the
+	 * first part, otherwise 0. Runs written by one task
+	 * share it, see vy_slice_is_sibling().
+	 */
+	int64_t split_id;
 };
 
 /**
@@ -109,6 +134,17 @@ struct vy_page_info {
 	hint_t min_key_hint;
 	/** Offset of the row index in the page. */
 	uint32_t row_index_offset;
+	/**
+	 * Xor filter over the keys stored in the page, used to
+	 * skip reading the page on a point lookup miss. If the
+	 * page doesn't have a filter, filter.fingerprints is NULL.
+	 */
+	struct xor_filter filter;
+	/**
+	 * Offset of the key index in the page or 0 if the page
+	 * doesn't have a key index.
+	 */
+	uint32_t key_index_offset;
 };
 
 /**
@@ -260,6 +296,22 @@ struct vy_run_iterator {
 	 * GE, LT to LE for beauty.
 	 */
 	enum iterator_type iterator_type;
+	/**
+	 * Set if all statements returned by the iterator must
+	 * have the search key as a prefix, i.e. the iterator was
+	 * opened for EQ or REQ. Such a scan may be skipped if the
+	 * key isn't found in the run bloom filter. Note, REQ is
+	 * changed to LE, because the run iterator doesn't need to
+	 * check EQ constraint for reverse scans.
+	 */
+	bool is_eq_scan;
+	/**
+	 * Set if the caller has already checked the bloom filter
+	 * and found that the run may contain the key so that the
+	 * iterator doesn't check it again. A bloom miss is still
+	 * accounted by the iterator if the key isn't found.
+	 */
+	bool is_bloom_checked;
 	/** Key to search. */
 	struct vy_entry key;
 	/* LSN visibility, iterator shows values with lsn <= vlsn */
@@ -283,10 +335,39 @@ struct vy_run_iterator {
 	bool search_started;
 };
 
+/**
+ * Keys of the statements stored in a page, used for searching
+ * the page without decoding statements. Keys are front-coded:
+ * each key is stored as the length of the prefix it shares with
+ * the previous key followed by the rest of the key. Every
+ * restart_interval-th key is stored in full, which makes it a
+ * restart point. A key search does a binary search over restart
+ * points and then scans keys between two adjacent ones.
+ *
+ * All pointers point to the page data.
+ */
+struct vy_page_key_index {
+	/** Front-coded keys, NULL if the page has no key index. */
+	const char *data;
+	/** Offsets of restart points in data (mp_store_u32). */
+	const char *restarts;
+	/** Number of restart points. */
+	uint32_t restart_count;
+	/** Number of keys between two restart points. */
+	uint32_t restart_interval;
+	/** Max size of a key stored in the index. */
+	uint32_t max_key_size;
+};
+
 /**
  * Vinyl page stored in memory.
  */
 struct vy_page {
+	/**
+	 * Reference counter. A page may be shared by run iterators
+	 * and the page cache.
+	 */
+	int refs;
 	/** Page position in the run file. */
 	uint32_t page_no;
 	/** Size of page data in memory, i.e. unpacked. */
@@ -295,10 +376,23 @@ struct vy_page {
 	uint32_t row_count;
 	/** Array of row offsets. */
 	uint32_t *row_index;
+	/** Index of the page keys. */
+	struct vy_page_key_index key_index;
 	/** Pointer to the page data. */
 	char *data;
 };
 
+static inline void
+vy_page_ref(struct vy_page *page)
+{
+	assert(page->refs > 0);
+	page->refs++;
+}
+
+/** Drop a page reference, delete the page if it was the last one. */
+void
+vy_page_unref(struct vy_page *page);
+
 /**
  * Initialize vinyl run environment
  *
@@ -510,6 +604,21 @@ vy_slice_cut(struct vy_slice *slice, int64_t id, struct vy_entry begin,
 	     struct vy_entry end, struct key_def *cmp_def,
 	     struct vy_slice **result);
 
+/**
+ * Return true if two adjacent slices of a range belong to the
+ * same run or to runs written by the same compaction task split
+ * in key-partitioned parts, see vy_task_compaction_new(). Such
+ * runs never overlap so the compaction policy treats their
+ * slices as one run.
+ */
+static inline bool
+vy_slice_is_sibling(struct vy_slice *slice, struct vy_slice *other)
+{
+	return slice->run == other->run ||
+	       (slice->run->info.split_id != 0 &&
+		slice->run->info.split_id == other->run->info.split_id);
+}
+
 /**
  * Open an iterator over on-disk run.
  *
@@ -620,8 +729,44 @@ struct vy_run_writer {
 	double bloom_fpr;
 	/** Bloom filter. */
 	struct tuple_bloom_builder *bloom;
+	/** Build a xor filter for each page. */
+	bool page_filter;
+	/**
+	 * Set if a statement of the current page can't be
+	 * hashed so no filter can be built for the page.
+	 */
+	bool page_filter_failed;
 	/** Buffer of a current page row offsets. */
 	struct ibuf row_index_buf;
+	/** Buffer of a current page key hashes. */
+	struct ibuf page_hash_buf;
+	/** Build a key index for each page. */
+	bool page_key_index;
+	/** Front-coded keys of a current page. */
+	struct ibuf key_index_buf;
+	/** Restart point offsets of a current page key index. */
+	struct ibuf key_restart_buf;
+	/** Last key added to the key index. */
+	struct ibuf last_key_buf;
+	/** Max size of a key of a current page. */
+	uint32_t max_key_size;
+	/**
+	 * Max size of a zstd dictionary to train for compressing
+	 * the run pages or 0 if no dictionary should be used.
+	 */
+	uint32_t dict_size;
+	/**
+	 * Set while the writer collects statements to train
+	 * the dictionary on. Nothing is written to the run file
+	 * until the dictionary is trained.
+	 */
+	bool is_sampling;
+	/** Statements collected to train the dictionary on. */
+	struct ibuf sample_buf;
+	/** Total size of statements stored in sample_buf. */
+	size_t sample_size;
+	/** Dictionary used to compress the run pages. */
+	ZSTD_CDict *zdict;
 	/**
 	 * Remember a last written statement to use it as a source
 	 * of max key of a finished run.
@@ -634,7 +779,9 @@ int
 vy_run_writer_create(struct vy_run_writer *writer, struct vy_run *run,
 		     const char *dirpath, uint32_t space_id, uint32_t iid,
 		     struct key_def *cmp_def, struct key_def *key_def,
-		     uint64_t page_size, double bloom_fpr, bool no_compression);
+		     uint64_t page_size, double bloom_fpr, bool page_filter,
+		     bool page_key_index, uint32_t dict_size,
+		     bool no_compression);
 
 /**
  * Write a specified statement into a run.
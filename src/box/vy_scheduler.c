@@ -197,6 +197,32 @@ struct vy_task {
 	 * need to remember the slices we are compacting.
 	 */
 	struct vy_slice *first_slice, *last_slice;
+	/**
+	 * Compaction of a big range may be split into several
+	 * parts, each of which merges statements falling in
+	 * [@begin, @end) and is executed by its own worker thread.
+	 * The task returned by the scheduler, which is called
+	 * the leader, links all parts, including itself, in
+	 * @parts, sorted by key. The other parts point to the
+	 * leader with @leader. Only the leader is completed or
+	 * aborted and only after all parts have been executed.
+	 */
+	struct vy_task *leader;
+	/** List of parts of a compaction task, linked by @in_parts. */
+	struct rlist parts;
+	/** Link in the leader's list of parts. */
+	struct rlist in_parts;
+	/** Number of parts of this task that are still being executed. */
+	int parts_in_progress;
+	/** Key bounds of this compaction part, none if unbounded. */
+	struct vy_entry begin, end;
+	/**
+	 * Slices of the compacted runs cut by [@begin, @end)
+	 * and fed to the write iterator of this part. They
+	 * aren't logged and are deleted once the part has been
+	 * executed. Linked by vy_slice::in_range.
+	 */
+	struct rlist cut_slices;
 	/**
 	 * Index options may be modified while a task is in
 	 * progress so we save them here to safely access them
@@ -204,6 +230,9 @@ struct vy_task {
 	 */
 	double bloom_fpr;
 	int64_t page_size;
+	bool page_filter;
+	bool page_key_index;
+	uint32_t compression_dict_size;
 	/**
 	 * Deferred DELETE handler passed to the write iterator.
 	 * It sends deferred DELETE statements generated during
@@ -224,6 +253,9 @@ struct vy_task {
 static const struct vy_deferred_delete_handler_iface
 vy_task_deferred_delete_iface;
 
+static void
+vy_worker_pool_put(struct vy_worker *worker);
+
 /**
  * Allocate a new task to be executed by a worker thread.
  * When preparing an asynchronous task, this function must
@@ -261,15 +293,37 @@ vy_task_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 	vy_lsm_ref(lsm);
 	diag_create(&task->diag);
 	task->deferred_delete_handler.iface = &vy_task_deferred_delete_iface;
+	rlist_create(&task->parts);
+	rlist_create(&task->in_parts);
+	task->parts_in_progress = 1;
+	task->begin = vy_entry_none();
+	task->end = vy_entry_none();
+	rlist_create(&task->cut_slices);
 	return task;
 }
 
-/** Free a task allocated with vy_task_new(). */
+/**
+ * Free a task allocated with vy_task_new().
+ * Parts of a compaction task are freed along with the leader
+ * and their workers are returned to the pool.
+ */
 static void
 vy_task_delete(struct vy_task *task)
 {
+	struct vy_task *part, *next_part;
+	rlist_foreach_entry_safe(part, &task->parts, in_parts, next_part) {
+		if (part == task)
+			continue;
+		vy_worker_pool_put(part->worker);
+		vy_task_delete(part);
+	}
 	assert(task->deferred_delete_batch == NULL);
 	assert(task->deferred_delete_in_progress == 0);
+	assert(rlist_empty(&task->cut_slices));
+	if (task->begin.stmt != NULL)
+		tuple_unref(task->begin.stmt);
+	if (task->end.stmt != NULL)
+		tuple_unref(task->end.stmt);
 	key_def_delete(task->cmp_def);
 	key_def_delete(task->key_def);
 	vy_lsm_unref(task->lsm);
@@ -460,10 +514,13 @@ vy_scheduler_create(struct vy_scheduler *scheduler, int write_threads,
 	vy_worker_pool_create(&scheduler->compaction_pool,
 			      "compaction", compaction_threads);
 
+	scheduler->compaction_max_parts = 1;
+
 	stailq_create(&scheduler->processed_tasks);
 
 	vy_dump_heap_create(&scheduler->dump_heap);
 	vy_compaction_heap_create(&scheduler->compaction_heap);
+	rlist_create(&scheduler->split_queue);
 
 	diag_create(&scheduler->diag);
 	fiber_cond_create(&scheduler->dump_cond);
@@ -519,11 +576,27 @@ vy_scheduler_on_delete_lsm(struct trigger *trigger, void *event)
 	assert(! heap_node_is_stray(&lsm->in_compaction));
 	vy_dump_heap_delete(&scheduler->dump_heap, lsm);
 	vy_compaction_heap_delete(&scheduler->compaction_heap, lsm);
+	rlist_del(&lsm->in_split);
 	trigger_clear(trigger);
 	free(trigger);
 	return 0;
 }
 
+/**
+ * Queue a range for split/coalesce. The check is performed by
+ * vy_scheduler_split_ranges() before looking for a compaction task.
+ */
+static void
+vy_scheduler_queue_split(struct vy_scheduler *scheduler,
+			 struct vy_lsm *lsm, struct vy_range *range)
+{
+	if (!rlist_empty(&range->in_split))
+		return; /* already queued */
+	rlist_add_tail_entry(&lsm->split_queue, range, in_split);
+	if (rlist_empty(&lsm->in_split))
+		rlist_add_tail_entry(&scheduler->split_queue, lsm, in_split);
+}
+
 int
 vy_scheduler_add_lsm(struct vy_scheduler *scheduler, struct vy_lsm *lsm)
 {
@@ -546,6 +619,16 @@ vy_scheduler_add_lsm(struct vy_scheduler *scheduler, struct vy_lsm *lsm)
 	 */
 	vy_dump_heap_insert(&scheduler->dump_heap, lsm);
 	vy_compaction_heap_insert(&scheduler->compaction_heap, lsm);
+	/*
+	 * Ranges of a recovered LSM tree may need split or
+	 * coalesce, so check them as soon as possible.
+	 */
+	struct vy_range *range;
+	for (range = vy_range_tree_first(&lsm->range_tree); range != NULL;
+	     range = vy_range_tree_next(&lsm->range_tree, range)) {
+		if (range->compaction_priority > 1)
+			vy_scheduler_queue_split(scheduler, lsm, range);
+	}
 	return 0;
 }
 
@@ -633,6 +716,10 @@ vy_scheduler_force_compaction(struct vy_scheduler *scheduler,
 {
 	vy_lsm_force_compaction(lsm);
 	vy_scheduler_update_lsm(scheduler, lsm);
+	struct vy_range *range;
+	for (range = vy_range_tree_first(&lsm->range_tree); range != NULL;
+	     range = vy_range_tree_next(&lsm->range_tree, range))
+		vy_scheduler_queue_split(scheduler, lsm, range);
 	fiber_cond_signal(&scheduler->scheduler_cond);
 }
 
@@ -1067,6 +1154,8 @@ vy_task_write_run(struct vy_task *task, bool no_compression)
 				 lsm->space_id, lsm->index_id,
 				 task->cmp_def, task->key_def,
 				 task->page_size, task->bloom_fpr,
+				 task->page_filter, task->page_key_index,
+				 task->compression_dict_size,
 				 no_compression) != 0)
 		goto fail;
 
@@ -1221,6 +1310,13 @@ vy_task_dump_complete(struct vy_task *task)
 		vy_range_update_compaction_priority(range, &lsm->opts);
 		vy_range_update_dumps_per_compaction(range);
 		vy_lsm_acct_range(lsm, range);
+		/*
+		 * Don't wait for a compaction worker to split
+		 * a range that receives writes faster than it
+		 * is compacted.
+		 */
+		if (range->compaction_priority > 1)
+			vy_scheduler_queue_split(scheduler, lsm, range);
 	}
 	vy_range_heap_update_all(&lsm->range_heap);
 	free(new_slices);
@@ -1397,6 +1493,9 @@ vy_task_dump_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 	task->wi = wi;
 	task->bloom_fpr = lsm->opts.bloom_fpr;
 	task->page_size = lsm->opts.page_size;
+	task->page_filter = lsm->opts.page_filter;
+	task->page_key_index = lsm->opts.page_key_index;
+	task->compression_dict_size = lsm->opts.compression_dict_size;
 
 	lsm->is_dumping = true;
 	vy_scheduler_update_lsm(scheduler, lsm);
@@ -1438,34 +1537,69 @@ vy_task_compaction_execute(struct vy_task *task)
 	return vy_task_write_run(task, false);
 }
 
+/**
+ * Close the write iterators of a compaction task and all its
+ * parts and delete the slices they were reading.
+ */
+static void
+vy_task_compaction_close_input(struct vy_task *task)
+{
+	struct vy_task *part;
+	struct vy_slice *slice, *next_slice;
+	rlist_foreach_entry(part, &task->parts, in_parts) {
+		if (part->wi != NULL) {
+			part->wi->iface->close(part->wi);
+			part->wi = NULL;
+		}
+		rlist_foreach_entry_safe(slice, &part->cut_slices,
+					 in_range, next_slice)
+			vy_slice_delete(slice);
+		rlist_create(&part->cut_slices);
+	}
+}
+
 static int
 vy_task_compaction_complete(struct vy_task *task)
 {
 	struct vy_scheduler *scheduler = task->scheduler;
 	struct vy_lsm *lsm = task->lsm;
 	struct vy_range *range = task->range;
-	struct vy_run *new_run = task->new_run;
 	double compaction_time = ev_monotonic_now(loop()) - task->start_time;
-	struct vy_disk_stmt_counter compaction_output = new_run->count;
+	struct vy_disk_stmt_counter compaction_output;
 	struct vy_disk_stmt_counter compaction_input;
 	struct vy_slice *first_slice = task->first_slice;
 	struct vy_slice *last_slice = task->last_slice;
-	struct vy_slice *slice, *next_slice, *new_slice = NULL;
+	struct vy_slice *slice, *next_slice, *new_slice;
+	struct vy_task *part;
 	struct vy_run *run;
 
 	/*
-	 * Allocate a slice of the new run.
+	 * The iterators have been cleaned up in workers. Close
+	 * them now and delete the slices they were reading so
+	 * that they don't hold references to compacted runs.
+	 */
+	vy_task_compaction_close_input(task);
+
+	/*
+	 * Allocate slices of the new runs, one per task part.
 	 *
-	 * If the run is empty, we don't need to allocate a new slice
+	 * If a run is empty, we don't need to allocate a new slice
 	 * and insert it into the range, but we still need to delete
 	 * compacted runs.
 	 */
-	if (!vy_run_is_empty(new_run)) {
-		new_slice = vy_slice_new(vy_log_next_id(), new_run,
-					 vy_entry_none(), vy_entry_none(),
+	RLIST_HEAD(new_slices);
+	vy_disk_stmt_counter_reset(&compaction_output);
+	rlist_foreach_entry(part, &task->parts, in_parts) {
+		run = part->new_run;
+		vy_disk_stmt_counter_add(&compaction_output, &run->count);
+		if (vy_run_is_empty(run))
+			continue;
+		new_slice = vy_slice_new(vy_log_next_id(), run,
+					 part->begin, part->end,
 					 lsm->cmp_def);
 		if (new_slice == NULL)
-			return -1;
+			goto fail;
+		rlist_add_tail_entry(&new_slices, new_slice, in_range);
 	}
 
 	/*
@@ -1498,18 +1632,16 @@ vy_task_compaction_complete(struct vy_task *task)
 	}
 	rlist_foreach_entry(run, &unused_runs, in_unused)
 		vy_log_drop_run(run->id, VY_LOG_GC_LSN_CURRENT);
-	if (new_slice != NULL) {
-		vy_log_create_run(lsm->id, new_run->id, new_run->dump_lsn,
-				  new_run->dump_count);
-		vy_log_insert_slice(range->id, new_run->id, new_slice->id,
+	rlist_foreach_entry(new_slice, &new_slices, in_range) {
+		run = new_slice->run;
+		vy_log_create_run(lsm->id, run->id, run->dump_lsn,
+				  run->dump_count);
+		vy_log_insert_slice(range->id, run->id, new_slice->id,
 				    tuple_data_or_null(new_slice->begin.stmt),
 				    tuple_data_or_null(new_slice->end.stmt));
 	}
-	if (vy_log_tx_commit() < 0) {
-		if (new_slice != NULL)
-			vy_slice_delete(new_slice);
-		return -1;
-	}
+	if (vy_log_tx_commit() < 0)
+		goto fail;
 
 	/*
 	 * Remove compacted run files that were created after
@@ -1528,29 +1660,34 @@ vy_task_compaction_complete(struct vy_task *task)
 	}
 
 	/*
-	 * Account the new run if it is not empty,
-	 * otherwise discard it.
+	 * Account the new runs that are not empty,
+	 * discard the rest.
 	 */
-	if (new_slice != NULL) {
-		vy_lsm_add_run(lsm, new_run);
-		/* Drop the reference held by the task. */
-		vy_run_unref(new_run);
-	} else
-		vy_run_discard(new_run);
+	rlist_foreach_entry(part, &task->parts, in_parts) {
+		run = part->new_run;
+		if (!vy_run_is_empty(run)) {
+			vy_lsm_add_run(lsm, run);
+			/* Drop the reference held by the task. */
+			vy_run_unref(run);
+		} else
+			vy_run_discard(run);
+	}
 
 	/*
-	 * Replace compacted slices with the resulting slice and
+	 * Replace compacted slices with the resulting slices and
 	 * account compaction in LSM tree statistics.
 	 *
 	 * Note, since a slice might have been added to the range
 	 * by a concurrent dump while compaction was in progress,
-	 * we must insert the new slice at the same position where
+	 * we must insert the new slices at the same position where
 	 * the compacted slices were.
 	 */
 	RLIST_HEAD(compacted_slices);
 	vy_lsm_unacct_range(lsm, range);
-	if (new_slice != NULL)
+	rlist_foreach_entry_safe(new_slice, &new_slices, in_range, next_slice) {
+		rlist_del_entry(new_slice, in_range);
 		vy_range_add_slice_before(range, new_slice, first_slice);
+	}
 	vy_disk_stmt_counter_reset(&compaction_input);
 	for (slice = first_slice; ; slice = next_slice) {
 		next_slice = rlist_next_entry(slice, in_range);
@@ -1581,16 +1718,19 @@ vy_task_compaction_complete(struct vy_task *task)
 		vy_slice_delete(slice);
 	}
 
-	/* The iterator has been cleaned up in worker. */
-	task->wi->iface->close(task->wi);
-
 	assert(heap_node_is_stray(&range->heap_node));
 	vy_range_heap_insert(&lsm->range_heap, range);
 	vy_scheduler_update_lsm(scheduler, lsm);
+	if (range->compaction_priority > 1)
+		vy_scheduler_queue_split(scheduler, lsm, range);
 
 	say_info("%s: completed compacting range %s",
 		 vy_lsm_name(lsm), vy_range_str(range));
 	return 0;
+fail:
+	rlist_foreach_entry_safe(new_slice, &new_slices, in_range, next_slice)
+		vy_slice_delete(new_slice);
+	return -1;
 }
 
 static void
@@ -1600,21 +1740,163 @@ vy_task_compaction_abort(struct vy_task *task)
 	struct vy_lsm *lsm = task->lsm;
 	struct vy_range *range = task->range;
 
-	/* The iterator has been cleaned up in worker. */
-	task->wi->iface->close(task->wi);
+	/* The iterators have been cleaned up in workers. */
+	vy_task_compaction_close_input(task);
 
 	struct error *e = diag_last_error(&task->diag);
 	error_log(e);
 	say_error("%s: failed to compact range %s",
 		  vy_lsm_name(lsm), vy_range_str(range));
 
-	vy_run_discard(task->new_run);
+	struct vy_task *part;
+	rlist_foreach_entry(part, &task->parts, in_parts)
+		vy_run_discard(part->new_run);
 
 	assert(heap_node_is_stray(&range->heap_node));
 	vy_range_heap_insert(&lsm->range_heap, range);
 	vy_scheduler_update_lsm(scheduler, lsm);
 }
 
+/**
+ * Split a range compaction task in key-partitioned parts so that
+ * they can be executed by idle compaction workers in parallel.
+ *
+ * Part boundaries are taken from the page index of the oldest
+ * compacted run, which is usually the biggest one, so that all
+ * parts have roughly the same amount of data to merge. A new
+ * part is only created if there's an idle worker to execute it
+ * and it is going to get at least a quarter of range_size worth
+ * of data. The number of parts is limited by the configured
+ * maximum, see box.cfg.vinyl_compaction_parts.
+ *
+ * Returns 0 on success, -1 on memory allocation error.
+ */
+static int
+vy_task_compaction_split(struct vy_task *task, int64_t input_size)
+{
+	struct vy_scheduler *scheduler = task->scheduler;
+	struct vy_lsm *lsm = task->lsm;
+	struct key_def *cmp_def = lsm->cmp_def;
+	struct vy_slice *slice = task->last_slice;
+
+	int64_t part_size_min = MAX(vy_lsm_range_size(lsm) / 4, 1);
+	int64_t part_count = MIN(scheduler->compaction_max_parts,
+				 input_size / part_size_min);
+	int64_t page_count = slice->last_page_no - slice->first_page_no + 1;
+	part_count = MIN(part_count, page_count);
+	if (part_count <= 1 || slice->run->info.page_count == 0)
+		return 0;
+
+	struct vy_page_info *page;
+	page = vy_run_page_info(slice->run, slice->first_page_no);
+	const char *prev_key = page->min_key;
+	hint_t prev_key_hint = page->min_key_hint;
+	struct vy_task *prev = task;
+	for (int64_t i = 1; i < part_count; i++) {
+		page = vy_run_page_info(slice->run, slice->first_page_no +
+					i * page_count / part_count);
+		/* Don't create a part that is going to be empty. */
+		if (key_compare(prev_key, prev_key_hint, page->min_key,
+				page->min_key_hint, cmp_def) >= 0)
+			continue;
+		if (slice->begin.stmt != NULL &&
+		    vy_entry_compare_with_raw_key(slice->begin, page->min_key,
+						  page->min_key_hint,
+						  cmp_def) >= 0)
+			continue;
+		struct vy_worker *worker;
+		worker = vy_worker_pool_get(&scheduler->compaction_pool);
+		if (worker == NULL)
+			break; /* all workers are busy */
+		struct vy_task *part = vy_task_new(scheduler, worker, lsm,
+						   task->ops);
+		if (part == NULL) {
+			vy_worker_pool_put(worker);
+			return -1;
+		}
+		part->begin = vy_entry_key_from_msgpack(lsm->env->key_format,
+							cmp_def, page->min_key);
+		if (part->begin.stmt == NULL) {
+			vy_worker_pool_put(worker);
+			vy_task_delete(part);
+			return -1;
+		}
+		part->leader = task;
+		rlist_add_tail_entry(&task->parts, part, in_parts);
+		task->parts_in_progress++;
+		prev->end = part->begin;
+		tuple_ref(prev->end.stmt);
+		prev = part;
+		prev_key = page->min_key;
+		prev_key_hint = page->min_key_hint;
+	}
+	return 0;
+}
+
+/**
+ * Prepare a part of a compaction task for execution: allocate
+ * a run for it and create a write iterator over the compacted
+ * slices. If the task is split in parts, the slices are cut
+ * by the part bounds.
+ */
+static int
+vy_task_compaction_prepare_part(struct vy_task *task, struct vy_task *part,
+				bool is_last_level, int64_t dump_lsn,
+				int32_t dump_count)
+{
+	struct vy_scheduler *scheduler = task->scheduler;
+	struct vy_lsm *lsm = task->lsm;
+	bool is_split = task->parts_in_progress > 1;
+
+	part->range = task->range;
+	part->bloom_fpr = lsm->opts.bloom_fpr;
+	part->page_size = lsm->opts.page_size;
+	part->page_filter = lsm->opts.page_filter;
+	part->page_key_index = lsm->opts.page_key_index;
+	part->compression_dict_size = lsm->opts.compression_dict_size;
+
+	part->new_run = vy_run_prepare(scheduler->run_env, lsm);
+	if (part->new_run == NULL)
+		return -1;
+	part->new_run->dump_lsn = dump_lsn;
+	part->new_run->dump_count = dump_count;
+	/*
+	 * The leader is prepared first, see vy_task_compaction_new(),
+	 * so its run ID is shared by all runs of a split task.
+	 */
+	if (is_split)
+		part->new_run->info.split_id = task->new_run->id;
+
+	part->wi = vy_write_iterator_new(part->cmp_def, lsm->index_id == 0,
+					 is_last_level, scheduler->read_views,
+					 lsm->index_id > 0 ? NULL :
+					 &part->deferred_delete_handler);
+	if (part->wi == NULL)
+		return -1;
+
+	struct vy_slice *slice, *cut_slice;
+	for (slice = task->first_slice; ;
+	     slice = rlist_next_entry(slice, in_range)) {
+		cut_slice = slice;
+		if (is_split) {
+			if (vy_slice_cut(slice, vy_log_next_id(), part->begin,
+					 part->end, lsm->cmp_def,
+					 &cut_slice) != 0)
+				return -1;
+			if (cut_slice != NULL)
+				rlist_add_tail_entry(&part->cut_slices,
+						     cut_slice, in_range);
+		}
+		if (cut_slice != NULL &&
+		    vy_write_iterator_new_slice(part->wi, cut_slice,
+						lsm->disk_format) != 0)
+			return -1;
+		if (slice == task->last_slice)
+			break;
+	}
+	return 0;
+}
+
 static int
 vy_task_compaction_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 		       struct vy_lsm *lsm, struct vy_task **p_task)
@@ -1629,6 +1911,11 @@ vy_task_compaction_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 	assert(range != NULL);
 	assert(range->compaction_priority > 1);
 
+	/*
+	 * Normally, ranges are split or coalesced from the split
+	 * queue, but a range may still need it if range_size was
+	 * changed by index:alter() since it was last queued.
+	 */
 	if (vy_lsm_split_range(lsm, range) ||
 	    vy_lsm_coalesce_range(lsm, range)) {
 		vy_scheduler_update_lsm(scheduler, lsm);
@@ -1639,30 +1926,21 @@ vy_task_compaction_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 					   &compaction_ops);
 	if (task == NULL)
 		goto err_task;
+	rlist_add_tail_entry(&task->parts, task, in_parts);
+	task->range = range;
 
-	struct vy_run *new_run = vy_run_prepare(scheduler->run_env, lsm);
-	if (new_run == NULL)
-		goto err_run;
-
-	struct vy_stmt_stream *wi;
-	bool is_last_level = (range->compaction_priority == range->slice_count);
-	wi = vy_write_iterator_new(task->cmp_def, lsm->index_id == 0,
-				   is_last_level, scheduler->read_views,
-				   lsm->index_id > 0 ? NULL :
-				   &task->deferred_delete_handler);
-	if (wi == NULL)
-		goto err_wi;
-
-	struct vy_slice *slice;
+	struct vy_task *part;
+	struct vy_slice *slice, *prev_slice = NULL;
+	int64_t dump_lsn = -1;
 	int32_t dump_count = 0;
 	int n = range->compaction_priority;
 	rlist_foreach_entry(slice, &range->slices, in_range) {
-		if (vy_write_iterator_new_slice(wi, slice,
-						lsm->disk_format) != 0)
-			goto err_wi_sub;
-		new_run->dump_lsn = MAX(new_run->dump_lsn,
-					slice->run->dump_lsn);
-		dump_count += slice->run->dump_count;
+		dump_lsn = MAX(dump_lsn, slice->run->dump_lsn);
+		/* Sibling runs were written by one compaction. */
+		if (prev_slice == NULL ||
+		    !vy_slice_is_sibling(prev_slice, slice))
+			dump_count += slice->run->dump_count;
+		prev_slice = slice;
 		/* Remember the slices we are compacting. */
 		if (task->first_slice == NULL)
 			task->first_slice = slice;
@@ -1672,7 +1950,7 @@ vy_task_compaction_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 			break;
 	}
 	assert(n == 0);
-	assert(new_run->dump_lsn >= 0);
+	assert(dump_lsn >= 0);
 	if (range->compaction_priority == range->slice_count)
 		dump_count -= slice->run->dump_count;
 	/*
@@ -1681,17 +1959,19 @@ vy_task_compaction_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 	 * such as splitting/coalescing ranges for no good reason.
 	 */
 	if (range->needs_compaction)
-		new_run->dump_count = slice->run->dump_count;
-	else
-		new_run->dump_count = dump_count;
+		dump_count = slice->run->dump_count;
 
-	range->needs_compaction = false;
+	if (vy_task_compaction_split(task, range->compaction_queue.bytes) != 0)
+		goto err_parts;
 
-	task->range = range;
-	task->new_run = new_run;
-	task->wi = wi;
-	task->bloom_fpr = lsm->opts.bloom_fpr;
-	task->page_size = lsm->opts.page_size;
+	bool is_last_level = (range->compaction_priority == range->slice_count);
+	rlist_foreach_entry(part, &task->parts, in_parts) {
+		if (vy_task_compaction_prepare_part(task, part, is_last_level,
+						    dump_lsn, dump_count) != 0)
+			goto err_parts;
+	}
+
+	range->needs_compaction = false;
 
 	/*
 	 * Remove the range we are going to compact from the heap
@@ -1703,14 +1983,20 @@ vy_task_compaction_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 	say_info("%s: started compacting range %s, runs %d/%d",
 		 vy_lsm_name(lsm), vy_range_str(range),
                  range->compaction_priority, range->slice_count);
+	if (task->parts_in_progress > 1) {
+		say_info("%s: compaction of range %s is split in %d parts",
+			 vy_lsm_name(lsm), vy_range_str(range),
+			 task->parts_in_progress);
+	}
 	*p_task = task;
 	return 0;
 
-err_wi_sub:
-	task->wi->iface->close(wi);
-err_wi:
-	vy_run_discard(new_run);
-err_run:
+err_parts:
+	vy_task_compaction_close_input(task);
+	rlist_foreach_entry(part, &task->parts, in_parts) {
+		if (part->new_run != NULL)
+			vy_run_discard(part->new_run);
+	}
 	vy_task_delete(task);
 err_task:
 	diag_log();
@@ -1777,12 +2063,18 @@ vy_task_execute_f(struct cmsg *cmsg)
  * Callback invoked by the tx thread upon receiving an executed
  * task from a worker thread. It adds the task to the processed
  * task queue and wakes up the scheduler so that it can complete
- * it.
+ * it. If the task is a part of a split compaction, the leader
+ * task is queued once all its parts have been executed.
  */
 static void
 vy_task_complete_f(struct cmsg *cmsg)
 {
 	struct vy_task *task = container_of(cmsg, struct vy_task, cmsg);
+	if (task->leader != NULL)
+		task = task->leader;
+	assert(task->parts_in_progress > 0);
+	if (--task->parts_in_progress > 0)
+		return;
 	stailq_add_tail_entry(&task->scheduler->processed_tasks,
 			      task, in_processed);
 	fiber_cond_signal(&task->scheduler->scheduler_cond);
@@ -1873,6 +2165,38 @@ no_task:
 	return 0;
 }
 
+/**
+ * Split or coalesce ranges queued by vy_scheduler_queue_split().
+ *
+ * Both operations only rewrite range boundaries in the metadata
+ * log without touching run files so they are done right in the
+ * scheduler fiber. Ranges that are being compacted are skipped:
+ * they will be queued again on compaction completion.
+ */
+static void
+vy_scheduler_split_ranges(struct vy_scheduler *scheduler)
+{
+	while (!rlist_empty(&scheduler->split_queue)) {
+		struct vy_lsm *lsm = rlist_shift_entry(&scheduler->split_queue,
+						       struct vy_lsm, in_split);
+		rlist_create(&lsm->in_split);
+		/* Split and coalesce may yield. */
+		vy_lsm_ref(lsm);
+		while (!rlist_empty(&lsm->split_queue)) {
+			struct vy_range *range;
+			range = rlist_shift_entry(&lsm->split_queue,
+						  struct vy_range, in_split);
+			rlist_create(&range->in_split);
+			if (lsm->is_dropped || vy_range_is_scheduled(range))
+				continue;
+			if (vy_lsm_split_range(lsm, range) ||
+			    vy_lsm_coalesce_range(lsm, range))
+				vy_scheduler_update_lsm(scheduler, lsm);
+		}
+		vy_lsm_unref(lsm);
+	}
+}
+
 /**
  * Create a task for compacting a range. The new task is returned
  * in @ptask. If there's no range that needs to be compacted or all
@@ -1907,7 +2231,7 @@ retry:
 		return -1;
 	}
 	if (*ptask == NULL)
-		goto retry; /* LSM tree dropped or range split/coalesced */
+		goto retry; /* range split/coalesced */
 	return 0; /* new task */
 no_task:
 	if (worker != NULL)
@@ -1925,6 +2249,8 @@ vy_schedule(struct vy_scheduler *scheduler, struct vy_task **ptask)
 	if (*ptask != NULL)
 		goto found;
 
+	vy_scheduler_split_ranges(scheduler);
+
 	if (vy_scheduler_peek_compaction(scheduler, ptask) != 0)
 		goto fail;
 	if (*ptask != NULL)
@@ -1951,6 +2277,14 @@ vy_task_complete(struct vy_task *task)
 	scheduler->stat.tasks_inprogress--;
 
 	struct diag *diag = &task->diag;
+	struct vy_task *part;
+	rlist_foreach_entry(part, &task->parts, in_parts) {
+		if (part != task && part->is_failed && !task->is_failed) {
+			/* Fail the whole task if any of its parts failed. */
+			task->is_failed = true;
+			diag_move(&part->diag, diag);
+		}
+	}
 	if (task->is_failed) {
 		assert(!diag_is_empty(diag));
 		goto fail; /* ->execute fialed */
@@ -2033,6 +2367,15 @@ vy_scheduler_f(va_list va)
 		cmsg_init(&task->cmsg, vy_task_execute_route);
 		cpipe_push(&task->worker->worker_pipe, &task->cmsg);
 
+		/* Queue other parts of a split compaction, if any. */
+		struct vy_task *part;
+		rlist_foreach_entry(part, &task->parts, in_parts) {
+			if (part == task)
+				continue;
+			cmsg_init(&part->cmsg, vy_task_execute_route);
+			cpipe_push(&part->worker->worker_pipe, &part->cmsg);
+		}
+
 		fiber_reschedule();
 		continue;
 error:
@@ -89,6 +89,11 @@ struct vy_scheduler {
 	 * linked by vy_lsm::in_compaction.
 	 */
 	heap_t compaction_heap;
+	/**
+	 * LSM trees that have ranges to be checked for split
+	 * or coalesce, linked by vy_lsm::in_split.
+	 */
+	struct rlist split_queue;
 	/** Last error seen by the scheduler. */
 	struct diag diag;
 	/**
@@ -152,6 +157,12 @@ struct vy_scheduler {
 	struct rlist *read_views;
 	/** Context needed for writing runs. */
 	struct vy_run_env *run_env;
+	/**
+	 * Max number of key-partitioned parts a range compaction
+	 * may be split into so as to be executed by several worker
+	 * threads in parallel. 1 disables the split.
+	 */
+	int compaction_max_parts;
 };
 
 /**
@@ -582,6 +582,25 @@ vy_bloom_maybe_has(const struct tuple_bloom *bloom,
 	}
 }
 
+bool
+vy_stmt_key_hash(struct vy_entry entry, struct key_def *key_def,
+		 uint32_t *hash)
+{
+	if (key_def->is_multikey)
+		return false;
+	struct tuple *stmt = entry.stmt;
+	if (vy_stmt_is_key(stmt)) {
+		const char *data = tuple_data(stmt);
+		uint32_t part_count = mp_decode_array(&data);
+		if (part_count < key_def->part_count)
+			return false;
+		*hash = key_hash(data, key_def);
+	} else {
+		*hash = tuple_hash(stmt, key_def);
+	}
+	return true;
+}
+
 /**
  * Encode the given statement meta data in a request.
  * Returns 0 on success, -1 on memory allocation error.
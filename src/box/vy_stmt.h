@@ -637,6 +637,15 @@ bool
 vy_bloom_maybe_has(const struct tuple_bloom *bloom,
 		   struct vy_entry entry, struct key_def *key_def);
 
+/**
+ * Calculate the hash of a statement key as defined by @key_def.
+ * Returns false if the hash can't be calculated, because the
+ * statement is a partial key or the key definition is multikey.
+ */
+bool
+vy_stmt_key_hash(struct vy_entry entry, struct key_def *key_def,
+		 uint32_t *hash);
+
 /**
  * Encode vy_stmt for a primary key as xrow_header
  *
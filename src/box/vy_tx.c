@@ -327,6 +327,7 @@ vy_tx_create(struct vy_tx_manager *xm, struct vy_tx *tx)
 	tx->xm = xm;
 	tx->state = VINYL_TX_READY;
 	tx->is_applier_session = false;
+	tx->is_bulk = false;
 	tx->read_view = (struct vy_read_view *)xm->p_global_read_view;
 	vy_tx_read_set_new(&tx->read_set);
 	tx->psn = 0;
@@ -1125,6 +1126,8 @@ vy_tx_set_entry(struct vy_tx *tx, struct vy_lsm *lsm, struct vy_entry entry)
 	write_set_insert(&tx->write_set, v);
 	tx->write_set_version++;
 	tx->write_size += tuple_size(entry.stmt);
+	tx->is_bulk = (stailq_empty(&tx->log) || tx->is_bulk) &&
+		      vy_lsm_is_bulk(lsm);
 	stailq_add_tail_entry(&tx->log, v, next_in_log);
 	return 0;
 }
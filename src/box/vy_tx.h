@@ -176,6 +176,12 @@ struct vy_tx {
 	enum tx_state state;
 	/** Set if the transaction was started by an applier. */
 	bool is_applier_session;
+	/**
+	 * Set if all statements of the transaction were written
+	 * to spaces of the bulk quota class, see vy_lsm_is_bulk().
+	 * Such a transaction may be throttled in favor of others.
+	 */
+	bool is_bulk;
 	/**
 	 * The read view of this transaction. When a transaction
 	 * is started, it is set to the "read committed" state,
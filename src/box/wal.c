@@ -39,9 +39,14 @@
 #include "xlog.h"
 #include "xrow.h"
 #include "vy_log.h"
+#include "tt_pthread.h"
+#include "small/ibuf.h"
 #include "cbus.h"
 #include "coio_task.h"
 #include "replication.h"
+#include "histogram.h"
+#include "latency.h"
+#include "info/info.h"
 
 enum {
 	/**
@@ -53,6 +58,13 @@ enum {
 	 * latency. 1 MB seems to be a well balanced choice.
 	 */
 	WAL_FALLOCATE_LEN = 1024 * 1024,
+	/**
+	 * Size of the in-memory buffer of recently written rows,
+	 * see struct wal_ring. It should be big enough to let
+	 * relays ride out a burst of writes without falling
+	 * back to reading xlog files.
+	 */
+	WAL_RING_SIZE = 16 * 1024 * 1024,
 };
 
 const char *wal_mode_STRS[] = { "none", "write", "fsync", NULL };
@@ -103,6 +115,26 @@ struct wal_writer
 	 * rolled back too.
 	 */
 	struct journal_entry *last_entry;
+	/**
+	 * Number of batches sent to the WAL thread and not
+	 * completed yet, including the one being filled.
+	 */
+	int batch_count;
+	/**
+	 * Max time a batch may be held in tx waiting for more
+	 * entries while the WAL thread is busy writing previous
+	 * batches, box.cfg.wal_group_commit_timeout. Zero means
+	 * the batch is sent right away. Only used if wal_mode is
+	 * 'fsync'.
+	 */
+	double group_commit_timeout;
+	/**
+	 * Size a held batch is sent to the WAL thread at,
+	 * regardless of the timeout, box.cfg.wal_group_commit_size.
+	 */
+	int64_t group_commit_size;
+	/** Timer that sends a held batch to the WAL thread. */
+	struct ev_timer group_commit_timer;
 	/* ----------------- wal ------------------- */
 	/** A setting from instance configuration - wal_max_size */
 	int64_t wal_max_size;
@@ -166,6 +198,28 @@ struct wal_writer
 	 * Used for replication relays.
 	 */
 	struct rlist watchers;
+	/** Write statistics, see wal_stat(). */
+	struct wal_writer_stat {
+		/**
+		 * Protects the statistics, which are updated
+		 * by the WAL thread, from concurrent access by tx.
+		 */
+		pthread_mutex_t mutex;
+		/** Number of batches written to disk. */
+		int64_t batch_count;
+		/** Number of journal entries written to disk. */
+		int64_t entry_count;
+		/** Histogram of sizes of written batches, in bytes. */
+		struct histogram *batch_size;
+		/** Histogram of numbers of entries in written batches. */
+		struct histogram *batch_entries;
+		/**
+		 * Time it takes to write a batch to disk. Since
+		 * a WAL file is opened with O_SYNC if wal_mode is
+		 * 'fsync', it includes the time of syncing it.
+		 */
+		struct latency write_latency;
+	} stat;
 };
 
 struct wal_msg {
@@ -194,6 +248,36 @@ struct vy_log_writer {
 static struct vy_log_writer vy_log_writer;
 static struct wal_writer wal_writer_singleton;
 
+/**
+ * In-memory copy of the tail of the WAL.
+ *
+ * Relays used to re-read and decode every xlog file the WAL
+ * thread has just written, once per replica. Instead, the WAL
+ * thread appends all rows it writes to this buffer and relays
+ * that are in sync with the WAL copy rows from it, see
+ * wal_reader_attach() and wal_reader_read(). Only relays that
+ * have fallen behind more than the buffer size read xlogs.
+ *
+ * Rows are stored encoded in the same format as they are sent
+ * over the network, i.e. each row is prefixed with its length.
+ * Positions in the buffer are given as offsets in the logical
+ * stream of bytes ever appended to it.
+ */
+struct wal_ring {
+	/** Protects the buffer from concurrent access by relays. */
+	pthread_mutex_t mutex;
+	/** Circular buffer of WAL_RING_SIZE bytes. */
+	char *data;
+	/** Position of the oldest byte still in the buffer. */
+	uint64_t begin;
+	/** Position past the last appended row. */
+	uint64_t end;
+	/** Vclock of the last appended row. */
+	struct vclock vclock;
+};
+
+static struct wal_ring wal_ring;
+
 enum wal_mode
 wal_mode(void)
 {
@@ -369,6 +453,50 @@ tx_complete_batch(struct cmsg *msg)
 	vclock_copy(&replicaset.vclock, &batch->vclock);
 	tx_schedule_queue(&batch->commit);
 	mempool_free(&writer->msg_pool, container_of(msg, struct wal_msg, base));
+	assert(writer->batch_count > 0);
+	writer->batch_count--;
+	/*
+	 * The WAL thread is done with the batch, send it the
+	 * batch held in tx, if any, without waiting for the
+	 * timeout.
+	 */
+	if (ev_is_active(&writer->group_commit_timer)) {
+		ev_timer_stop(loop(), &writer->group_commit_timer);
+		cpipe_flush_input(&writer->wal_pipe);
+	}
+}
+
+static void
+wal_group_commit_timer_cb(struct ev_loop *loop, struct ev_timer *timer,
+			  int events)
+{
+	(void)loop;
+	(void)events;
+	struct wal_writer *writer = timer->data;
+	cpipe_flush_input(&writer->wal_pipe);
+}
+
+/**
+ * Check if the batch that is being filled should be held in tx
+ * for a while so that more entries can be written with it.
+ *
+ * This only makes sense if wal_mode is 'fsync', because then
+ * each batch costs a disk sync, and only while the WAL thread
+ * is busy writing previous batches, because otherwise we would
+ * delay the batch for no good reason. Therefore under light
+ * load entries are written right away, while under heavy load
+ * the batch grows for as long as it takes to write the
+ * previous one, but no longer than the configured timeout.
+ */
+static inline bool
+wal_group_commit_should_wait(struct wal_writer *writer,
+			     struct wal_msg *batch)
+{
+	return writer->wal_mode == WAL_FSYNC &&
+	       writer->group_commit_timeout > 0 &&
+	       writer->batch_count > 1 &&
+	       (int64_t)batch->approx_len < writer->group_commit_size &&
+	       writer->wal_pipe.n_input < writer->wal_pipe.max_input;
 }
 
 /**
@@ -439,11 +567,43 @@ wal_writer_create(struct wal_writer *writer, enum wal_mode wal_mode,
 	vclock_create(&writer->checkpoint_vclock);
 	rlist_create(&writer->watchers);
 
+	writer->batch_count = 0;
+	writer->group_commit_timeout = 0;
+	writer->group_commit_size = INT64_MAX;
+	ev_timer_init(&writer->group_commit_timer,
+		      wal_group_commit_timer_cb, 0, 0);
+	writer->group_commit_timer.data = writer;
+
+	static const int64_t batch_size_buckets[] = {
+		256, 512, 1024, 2048, 4096, 8192, 16384, 32768,
+		65536, 131072, 262144, 524288, 1048576, 2097152,
+		4194304, 8388608, 16777216,
+	};
+	static const int64_t batch_entries_buckets[] = {
+		1, 2, 4, 8, 16, 32, 64, 128, 256, 512, 1024, 2048, 4096,
+	};
+	struct wal_writer_stat *stat = &writer->stat;
+	tt_pthread_mutex_init(&stat->mutex, NULL);
+	stat->batch_count = 0;
+	stat->entry_count = 0;
+	stat->batch_size = histogram_new(batch_size_buckets,
+					 lengthof(batch_size_buckets));
+	stat->batch_entries = histogram_new(batch_entries_buckets,
+					    lengthof(batch_entries_buckets));
+	if (stat->batch_size == NULL || stat->batch_entries == NULL ||
+	    latency_create(&stat->write_latency) != 0)
+		panic("failed to allocate WAL statistics");
+
 	writer->on_garbage_collection = on_garbage_collection;
 	writer->on_checkpoint_threshold = on_checkpoint_threshold;
 
 	mempool_create(&writer->msg_pool, &cord()->slabc,
 		       sizeof(struct wal_msg));
+
+	tt_pthread_mutex_init(&wal_ring.mutex, NULL);
+	wal_ring.data = NULL;
+	wal_ring.begin = wal_ring.end = 0;
+	vclock_create(&wal_ring.vclock);
 }
 
 /** Destroy a WAL writer structure. */
@@ -451,6 +611,13 @@ static void
 wal_writer_destroy(struct wal_writer *writer)
 {
 	xdir_destroy(&writer->wal_dir);
+	free(wal_ring.data);
+	tt_pthread_mutex_destroy(&wal_ring.mutex);
+	ev_timer_stop(loop(), &writer->group_commit_timer);
+	histogram_delete(writer->stat.batch_size);
+	histogram_delete(writer->stat.batch_entries);
+	latency_destroy(&writer->stat.write_latency);
+	tt_pthread_mutex_destroy(&writer->stat.mutex);
 }
 
 /** WAL writer thread routine. */
@@ -588,6 +755,71 @@ wal_free(void)
 	wal_writer_destroy(writer);
 }
 
+void
+wal_set_group_commit(double timeout, int64_t size)
+{
+	struct wal_writer *writer = &wal_writer_singleton;
+	writer->group_commit_timeout = timeout;
+	writer->group_commit_size = size;
+	if (ev_is_active(&writer->group_commit_timer)) {
+		ev_timer_stop(loop(), &writer->group_commit_timer);
+		cpipe_flush_input(&writer->wal_pipe);
+	}
+}
+
+static int64_t
+wal_stat_percentile(struct histogram *hist, int pct)
+{
+	return hist->total > 0 ? histogram_percentile(hist, pct) : 0;
+}
+
+static void
+wal_stat_append_histogram(struct info_handler *h, const char *name,
+			  struct histogram *hist)
+{
+	info_table_begin(h, name);
+	info_append_int(h, "p50", wal_stat_percentile(hist, 50));
+	info_append_int(h, "p75", wal_stat_percentile(hist, 75));
+	info_append_int(h, "p90", wal_stat_percentile(hist, 90));
+	info_append_int(h, "p95", wal_stat_percentile(hist, 95));
+	info_append_int(h, "p99", wal_stat_percentile(hist, 99));
+	info_table_end(h);
+}
+
+void
+wal_stat(struct info_handler *h)
+{
+	struct wal_writer_stat *stat = &wal_writer_singleton.stat;
+	info_begin(h);
+	tt_pthread_mutex_lock(&stat->mutex);
+	info_append_int(h, "batches", stat->batch_count);
+	info_append_int(h, "entries", stat->entry_count);
+	wal_stat_append_histogram(h, "batch_size", stat->batch_size);
+	wal_stat_append_histogram(h, "batch_entries", stat->batch_entries);
+	info_table_begin(h, "write_latency");
+	info_append_double(h, "p50", latency_get(&stat->write_latency, 50));
+	info_append_double(h, "p75", latency_get(&stat->write_latency, 75));
+	info_append_double(h, "p90", latency_get(&stat->write_latency, 90));
+	info_append_double(h, "p95", latency_get(&stat->write_latency, 95));
+	info_append_double(h, "p99", latency_get(&stat->write_latency, 99));
+	info_table_end(h); /* write_latency */
+	tt_pthread_mutex_unlock(&stat->mutex);
+	info_end(h);
+}
+
+void
+wal_reset_stat(void)
+{
+	struct wal_writer_stat *stat = &wal_writer_singleton.stat;
+	tt_pthread_mutex_lock(&stat->mutex);
+	stat->batch_count = 0;
+	stat->entry_count = 0;
+	histogram_reset(stat->batch_size);
+	histogram_reset(stat->batch_entries);
+	latency_reset(&stat->write_latency);
+	tt_pthread_mutex_unlock(&stat->mutex);
+}
+
 struct wal_vclock_msg {
     struct cbus_call_msg base;
     struct vclock vclock;
@@ -1016,6 +1248,176 @@ wal_assign_lsn(struct vclock *vclock_diff, struct vclock *base,
 		(*row)->tsn = tsn;
 }
 
+/**
+ * Drop all rows from the in-memory WAL buffer and start
+ * over from the given vclock. The buffer isn't maintained
+ * while there are no WAL watchers so this is called when
+ * the first one is attached.
+ */
+static void
+wal_ring_reset(const struct vclock *vclock)
+{
+	struct wal_ring *ring = &wal_ring;
+	tt_pthread_mutex_lock(&ring->mutex);
+	if (ring->data == NULL) {
+		ring->data = malloc(WAL_RING_SIZE);
+		if (ring->data == NULL) {
+			say_warn("failed to allocate in-memory WAL buffer, "
+				 "relays will read xlog files");
+		}
+	}
+	ring->begin = ring->end;
+	vclock_copy(&ring->vclock, vclock);
+	tt_pthread_mutex_unlock(&ring->mutex);
+}
+
+/** Copy data to the in-memory WAL buffer at the given position. */
+static void
+wal_ring_write(struct wal_ring *ring, uint64_t pos,
+	       const void *data, size_t size)
+{
+	assert(size <= WAL_RING_SIZE);
+	size_t offset = pos % WAL_RING_SIZE;
+	size_t n = MIN(size, WAL_RING_SIZE - offset);
+	memcpy(ring->data + offset, data, n);
+	memcpy(ring->data, (const char *)data + n, size - n);
+}
+
+/** Copy data from the in-memory WAL buffer at the given position. */
+static void
+wal_ring_copy(struct wal_ring *ring, uint64_t pos, void *data, size_t size)
+{
+	assert(size <= WAL_RING_SIZE);
+	size_t offset = pos % WAL_RING_SIZE;
+	size_t n = MIN(size, WAL_RING_SIZE - offset);
+	memcpy(data, ring->data + offset, n);
+	memcpy((char *)data + n, ring->data, size - n);
+}
+
+/**
+ * Append rows of written journal entries to the in-memory
+ * WAL buffer, evicting the oldest rows if it's full.
+ */
+static void
+wal_ring_append(struct stailq *entries)
+{
+	struct wal_ring *ring = &wal_ring;
+	struct iovec iov[XROW_IOVMAX];
+	tt_pthread_mutex_lock(&ring->mutex);
+	if (ring->data == NULL)
+		goto out;
+	struct journal_entry *entry;
+	stailq_foreach_entry(entry, entries, fifo) {
+		struct xrow_header **row = entry->rows;
+		for (; row < entry->rows + entry->n_rows; row++) {
+			int iovcnt = xrow_to_iovec(*row, iov);
+			size_t len = 0;
+			for (int i = 0; i < iovcnt; i++)
+				len += iov[i].iov_len;
+			if (iovcnt < 0 || len > WAL_RING_SIZE) {
+				/*
+				 * Out of memory or the row doesn't
+				 * fit. Drop the buffer contents so
+				 * that relays go read the xlog.
+				 */
+				if (iovcnt < 0) {
+					diag_log();
+					diag_clear(diag_get());
+				}
+				ring->end += WAL_RING_SIZE + 1;
+				ring->begin = ring->end;
+			} else {
+				if (ring->end + len - ring->begin >
+				    WAL_RING_SIZE)
+					ring->begin = ring->end + len -
+						      WAL_RING_SIZE;
+				for (int i = 0; i < iovcnt; i++) {
+					wal_ring_write(ring, ring->end,
+						       iov[i].iov_base,
+						       iov[i].iov_len);
+					ring->end += iov[i].iov_len;
+				}
+			}
+			/* Rows with broken LSN are skipped by readers. */
+			if ((*row)->lsn > vclock_get(&ring->vclock,
+						     (*row)->replica_id))
+				vclock_follow_xrow(&ring->vclock, *row);
+		}
+	}
+out:
+	tt_pthread_mutex_unlock(&ring->mutex);
+}
+
+int
+wal_reader_attach(struct wal_reader *reader, const struct vclock *vclock)
+{
+	struct wal_ring *ring = &wal_ring;
+	int rc = -1;
+	tt_pthread_mutex_lock(&ring->mutex);
+	if (ring->data != NULL &&
+	    vclock_compare(vclock, &ring->vclock) == 0) {
+		reader->pos = ring->end;
+		reader->is_attached = true;
+		rc = 0;
+	}
+	tt_pthread_mutex_unlock(&ring->mutex);
+	return rc;
+}
+
+ssize_t
+wal_reader_read(struct wal_reader *reader, struct ibuf *buf, size_t size)
+{
+	assert(reader->is_attached);
+	struct wal_ring *ring = &wal_ring;
+	size = MIN(size, (size_t)WAL_RING_SIZE);
+	if (ibuf_reserve(buf, size) == NULL) {
+		diag_set(OutOfMemory, size, "ibuf_reserve", "buf");
+		return -1;
+	}
+	tt_pthread_mutex_lock(&ring->mutex);
+	bool is_evicted = reader->pos < ring->begin;
+	assert(is_evicted || reader->pos <= ring->end);
+	if (!is_evicted)
+		size = MIN(size, ring->end - reader->pos);
+	tt_pthread_mutex_unlock(&ring->mutex);
+	if (is_evicted)
+		goto evicted;
+	/*
+	 * Copy the data without holding the lock so as not to
+	 * stall the WAL thread. The writer may overwrite the data
+	 * meanwhile, but only after moving the buffer begin past
+	 * it, so check that the rows are still there afterwards.
+	 */
+	wal_ring_copy(ring, reader->pos, buf->wpos, size);
+	tt_pthread_mutex_lock(&ring->mutex);
+	is_evicted = reader->pos < ring->begin;
+	tt_pthread_mutex_unlock(&ring->mutex);
+	if (is_evicted)
+		goto evicted;
+	reader->pos += size;
+	buf->wpos += size;
+	return size;
+evicted:
+	/* The rows have been evicted. */
+	reader->is_attached = false;
+	return 0;
+}
+
+/** Account a batch written to disk in WAL statistics. */
+static void
+wal_collect_stat(struct wal_writer *writer, int64_t size, int entry_count,
+		 double latency)
+{
+	struct wal_writer_stat *stat = &writer->stat;
+	tt_pthread_mutex_lock(&stat->mutex);
+	stat->batch_count++;
+	stat->entry_count += entry_count;
+	histogram_collect(stat->batch_size, size);
+	histogram_collect(stat->batch_entries, entry_count);
+	latency_collect(&stat->write_latency, latency);
+	tt_pthread_mutex_unlock(&stat->mutex);
+}
+
 static void
 wal_write_to_disk(struct cmsg *msg)
 {
@@ -1082,6 +1484,9 @@ wal_write_to_disk(struct cmsg *msg)
 	 */
 
 	struct xlog *l = &writer->current_wal;
+	double start_time = ev_monotonic_time();
+	int64_t written = 0;
+	int entry_count = 0;
 
 	/*
 	 * Iterate over requests (transactions)
@@ -1099,18 +1504,23 @@ wal_write_to_disk(struct cmsg *msg)
 			goto done;
 		if (rc > 0) {
 			writer->checkpoint_wal_size += rc;
+			written += rc;
 			last_committed = &entry->fifo;
 			vclock_merge(&writer->vclock, &vclock_diff);
 		}
 		/* rc == 0: the write is buffered in xlog_tx */
+		entry_count++;
 	}
 	rc = xlog_flush(l);
 	if (rc < 0)
 		goto done;
 
 	writer->checkpoint_wal_size += rc;
+	written += rc;
 	last_committed = stailq_last(&wal_msg->commit);
 	vclock_merge(&writer->vclock, &vclock_diff);
+	wal_collect_stat(writer, written, entry_count,
+			 ev_monotonic_time() - start_time);
 
 	/*
 	 * Notify TX if the checkpoint threshold has been exceeded.
@@ -1165,6 +1575,8 @@ done:
 		stailq_concat(&wal_msg->rollback, &rollback);
 		wal_begin_rollback();
 	}
+	if (!rlist_empty(&writer->watchers))
+		wal_ring_append(&wal_msg->commit);
 	fiber_gc();
 	wal_notify_watchers(writer, WAL_EVENT_WRITE);
 	ERROR_INJECT_SLEEP(ERRINJ_RELAY_FASTER_THAN_TX);
@@ -1261,11 +1673,12 @@ wal_write_async(struct journal *journal, struct journal_entry *entry)
 		wal_msg_create(batch);
 		/*
 		 * Sic: first add a request, then push the batch,
-		 * since cpipe_push() may pass the batch to WAL
-		 * thread right away.
+		 * since cpipe_push_input() may pass the batch to
+		 * WAL thread right away.
 		 */
 		stailq_add_tail_entry(&batch->commit, entry, fifo);
-		cpipe_push(&writer->wal_pipe, &batch->base);
+		cpipe_push_input(&writer->wal_pipe, &batch->base);
+		writer->batch_count++;
 	}
 	/*
 	 * Remember last entry sent to WAL. In case of rollback
@@ -1278,6 +1691,15 @@ wal_write_async(struct journal *journal, struct journal_entry *entry)
 #ifndef NDEBUG
 	++errinj(ERRINJ_WAL_WRITE_COUNT, ERRINJ_INT)->iparam;
 #endif
+	if (wal_group_commit_should_wait(writer, batch)) {
+		if (!ev_is_active(&writer->group_commit_timer)) {
+			ev_timer_set(&writer->group_commit_timer,
+				     writer->group_commit_timeout, 0);
+			ev_timer_start(loop(), &writer->group_commit_timer);
+		}
+		return 0;
+	}
+	ev_timer_stop(loop(), &writer->group_commit_timer);
 	cpipe_flush_input(&writer->wal_pipe);
 	return 0;
 
@@ -1455,6 +1877,12 @@ wal_watcher_attach(void *arg)
 	struct wal_writer *writer = &wal_writer_singleton;
 
 	assert(rlist_empty(&watcher->next));
+	/*
+	 * The in-memory WAL buffer isn't updated while there
+	 * are no watchers, bring it up to date.
+	 */
+	if (rlist_empty(&writer->watchers))
+		wal_ring_reset(&writer->vclock);
 	rlist_add_tail_entry(&writer->watchers, watcher, next);
 
 	/*
@@ -40,6 +40,8 @@
 struct fiber;
 struct wal_writer;
 struct tt_uuid;
+struct ibuf;
+struct info_handler;
 
 enum wal_mode { WAL_NONE = 0, WAL_WRITE, WAL_FSYNC, WAL_MODE_MAX };
 
@@ -180,6 +182,46 @@ void
 wal_clear_watcher(struct wal_watcher *watcher,
 		  void (*process_cb)(struct cbus_endpoint *));
 
+/**
+ * Position of a WAL consumer in the in-memory buffer of rows
+ * recently written to WAL. Consumers that are in sync with WAL
+ * read rows from the buffer instead of xlog files.
+ */
+struct wal_reader {
+	/** Position of the next row to read. */
+	uint64_t pos;
+	/** Set if the consumer reads rows from the buffer. */
+	bool is_attached;
+};
+
+/**
+ * Start reading rows from the in-memory WAL buffer. Succeeds only
+ * if @vclock is the vclock of the last row written to WAL, i.e.
+ * the consumer has already read all xlog files. Rows written
+ * after that can be fetched with wal_reader_read().
+ *
+ * Returns 0 on success, -1 if the consumer must keep reading
+ * xlog files.
+ */
+int
+wal_reader_attach(struct wal_reader *reader, const struct vclock *vclock);
+
+/**
+ * Copy at most @size bytes of rows written to WAL since the
+ * last call to @buf. Rows are encoded in the same way as in
+ * the replication stream, i.e. each row is prefixed with its
+ * length, and may be cut at the end. The rest is copied by
+ * the next call.
+ *
+ * If the consumer has fallen so behind that the rows it needs
+ * have been evicted from the buffer, the reader is detached
+ * and the rows must be read from xlog files.
+ *
+ * Returns the number of copied bytes or -1 on OOM.
+ */
+ssize_t
+wal_reader_read(struct wal_reader *reader, struct ibuf *buf, size_t size);
+
 void
 wal_atfork(void);
 
@@ -237,6 +279,24 @@ wal_commit_checkpoint(struct wal_checkpoint *checkpoint);
 void
 wal_set_checkpoint_threshold(int64_t threshold);
 
+/**
+ * Configure group commit: while the WAL thread is busy, new
+ * journal entries are collected in tx for up to @timeout
+ * seconds or until their total size reaches @size bytes so
+ * as to be written to disk in one go. Only used if wal_mode
+ * is 'fsync'. Zero timeout disables group commit.
+ */
+void
+wal_set_group_commit(double timeout, int64_t size);
+
+/** Output WAL write statistics, see box.stat.wal(). */
+void
+wal_stat(struct info_handler *h);
+
+/** Reset WAL write statistics. */
+void
+wal_reset_stat(void);
+
 /**
  * Remove WAL files that are not needed by consumers reading
  * rows at @vclock or newer.
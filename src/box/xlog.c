@@ -96,6 +96,7 @@ const struct xlog_opts xlog_opts_default = {
 	.free_cache = false,
 	.sync_is_async = false,
 	.no_compression = false,
+	.zdict = NULL,
 };
 
 /* {{{ struct xlog_meta */
@@ -1117,8 +1118,13 @@ xlog_tx_write_zstd(struct xlog *log)
 
 	uint32_t crc32c = 0;
 	struct iovec *iov;
-	/* 3 is compression level. */
-	ZSTD_compressBegin(log->zctx, 3);
+	if (log->opts.zdict != NULL) {
+		/* Compression level is stored in the dictionary. */
+		ZSTD_compressBegin_usingCDict(log->zctx, log->opts.zdict);
+	} else {
+		/* 3 is compression level. */
+		ZSTD_compressBegin(log->zctx, 3);
+	}
 	size_t offset = XLOG_FIXHEADER_SIZE;
 	for (iov = log->obuf.iov; iov->iov_len; ++iov) {
 		/* Estimate max output buffer size. */
@@ -1672,7 +1678,8 @@ xlog_fixheader_decode(struct xlog_fixheader *fixheader,
 
 int
 xlog_tx_decode(const char *data, const char *data_end,
-	       char *rows, char *rows_end, ZSTD_DStream *zdctx)
+	       char *rows, char *rows_end, ZSTD_DStream *zdctx,
+	       const ZSTD_DDict *zddict)
 {
 	/* Decode fixheader */
 	struct xlog_fixheader fixheader;
@@ -1712,6 +1719,8 @@ xlog_tx_decode(const char *data, const char *data_end,
 	/* Decompress zstd rows */
 	assert(fixheader.magic == zrow_marker);
 	ZSTD_initDStream(zdctx);
+	if (zddict != NULL)
+		ZSTD_DCtx_refDDict(zdctx, zddict);
 	int rc = xlog_cursor_decompress(&rows, rows_end, &data, data_end,
 					zdctx);
 	if (rc < 0) {
@@ -82,6 +82,13 @@ struct xlog_opts {
 	 * to be read frequently, e.g. L1 run files in Vinyl.
 	 */
 	bool no_compression;
+	/**
+	 * Zstd dictionary to compress xlog transactions with.
+	 * The dictionary isn't stored in the xlog file so a reader
+	 * has to pass it to xlog_tx_decode() on its own. Must stay
+	 * alive until the xlog is closed. May be NULL.
+	 */
+	const ZSTD_CDict *zdict;
 };
 
 extern const struct xlog_opts xlog_opts_default;
@@ -620,13 +627,16 @@ xlog_tx_cursor_pos(struct xlog_tx_cursor *tx_cursor)
  * @param data_end the end of @a data buffer
  * @param[out] rows a buffer to store decoded rows
  * @param[out] rows_end the end of @a rows buffer
+ * @param zdctx zstd decompression context
+ * @param zddict zstd dictionary the rows were compressed with
+ *               or NULL
  * @retval  0 success
  * @retval -1 error, check diag
  */
 int
 xlog_tx_decode(const char *data, const char *data_end,
 	       char *rows, char *rows_end,
-	       ZSTD_DStream *zdctx);
+	       ZSTD_DStream *zdctx, const ZSTD_DDict *zddict);
 
 /* }}} */
 
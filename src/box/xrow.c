@@ -564,6 +564,34 @@ cleanup:
 	region_truncate(region, region_svp);
 }
 
+int
+xrow_encode_error(struct xrow_header *row, const struct error *e,
+		  uint64_t sync)
+{
+	bool is_error = false;
+	struct mpstream stream;
+	struct region *region = &fiber()->gc;
+	mpstream_init(&stream, region, region_reserve_cb, region_alloc_cb,
+		      mpstream_error_handler, &is_error);
+
+	size_t region_svp = region_used(region);
+	mpstream_iproto_encode_error(&stream, e);
+	mpstream_flush(&stream);
+	size_t size = region_used(region) - region_svp;
+	char *body = is_error ? NULL : (char *)region_join(region, size);
+	if (body == NULL) {
+		diag_set(OutOfMemory, size, "region_join", "body");
+		return -1;
+	}
+	memset(row, 0, sizeof(*row));
+	row->type = iproto_encode_error(box_error_code(e));
+	row->sync = sync;
+	row->body[0].iov_base = body;
+	row->body[0].iov_len = size;
+	row->bodycnt = 1;
+	return 0;
+}
+
 int
 iproto_prepare_header(struct obuf *buf, struct obuf_svp *svp, size_t size)
 {
@@ -586,10 +614,18 @@ iproto_prepare_header(struct obuf *buf, struct obuf_svp *svp, size_t size)
 void
 iproto_reply_select(struct obuf *buf, struct obuf_svp *svp, uint64_t sync,
 		    uint32_t schema_version, uint32_t count)
+{
+	iproto_reply_select_ext(buf, svp, sync, schema_version, count, 0);
+}
+
+void
+iproto_reply_select_ext(struct obuf *buf, struct obuf_svp *svp,
+			uint64_t sync, uint32_t schema_version,
+			uint32_t count, size_t ext_size)
 {
 	char *pos = (char *) obuf_svp_to_ptr(buf, svp);
 	iproto_header_encode(pos, IPROTO_OK, sync, schema_version,
-			        obuf_size(buf) - svp->used -
+			        obuf_size(buf) - svp->used + ext_size -
 				IPROTO_HEADER_LEN);
 
 	struct iproto_body_bin body = iproto_body_bin;
@@ -1455,7 +1491,7 @@ xrow_encode_subscribe(struct xrow_header *row,
 		      const struct tt_uuid *replicaset_uuid,
 		      const struct tt_uuid *instance_uuid,
 		      const struct vclock *vclock, bool anon,
-		      uint32_t id_filter)
+		      uint32_t id_filter, bool compression)
 {
 	memset(row, 0, sizeof(*row));
 	size_t size = XROW_BODY_LEN_MAX +
@@ -1467,7 +1503,7 @@ xrow_encode_subscribe(struct xrow_header *row,
 	}
 	char *data = buf;
 	int filter_size = bit_count_u32(id_filter);
-	data = mp_encode_map(data, filter_size != 0 ? 6 : 5);
+	data = mp_encode_map(data, 5 + (filter_size != 0) + compression);
 	data = mp_encode_uint(data, IPROTO_CLUSTER_UUID);
 	data = xrow_encode_uuid(data, replicaset_uuid);
 	data = mp_encode_uint(data, IPROTO_INSTANCE_UUID);
@@ -1489,6 +1525,10 @@ xrow_encode_subscribe(struct xrow_header *row,
 			data = mp_encode_uint(data, id);
 		}
 	}
+	if (compression) {
+		data = mp_encode_uint(data, IPROTO_REPLICA_COMPRESSION);
+		data = mp_encode_bool(data, true);
+	}
 	assert(data <= buf + size);
 	row->body[0].iov_base = buf;
 	row->body[0].iov_len = (data - buf);
@@ -1501,7 +1541,7 @@ int
 xrow_decode_subscribe(struct xrow_header *row, struct tt_uuid *replicaset_uuid,
 		      struct tt_uuid *instance_uuid, struct vclock *vclock,
 		      uint32_t *version_id, bool *anon,
-		      uint32_t *id_filter)
+		      uint32_t *id_filter, bool *compression)
 {
 	if (row->bodycnt == 0) {
 		diag_set(ClientError, ER_INVALID_MSGPACK, "request body");
@@ -1521,6 +1561,8 @@ xrow_decode_subscribe(struct xrow_header *row, struct tt_uuid *replicaset_uuid,
 		*anon = false;
 	if (id_filter)
 		*id_filter = 0;
+	if (compression)
+		*compression = false;
 	d = data;
 	uint32_t map_size = mp_decode_map(&d);
 	for (uint32_t i = 0; i < map_size; i++) {
@@ -1596,6 +1638,17 @@ id_filter_decode_err:		xrow_on_decode_err(data, end, ER_INVALID_MSGPACK,
 				*id_filter |= 1 << val;
 			}
 			break;
+		case IPROTO_REPLICA_COMPRESSION:
+			if (compression == NULL)
+				goto skip;
+			if (mp_typeof(*d) != MP_BOOL) {
+				xrow_on_decode_err(data, end, ER_INVALID_MSGPACK,
+						   "invalid REPLICA_COMPRESSION "
+						   "flag");
+				return -1;
+			}
+			*compression = mp_decode_bool(&d);
+			break;
 		default: skip:
 			mp_next(&d); /* value */
 		}
@@ -1655,25 +1708,31 @@ xrow_encode_vclock(struct xrow_header *row, const struct vclock *vclock)
 int
 xrow_encode_subscribe_response(struct xrow_header *row,
 			       const struct tt_uuid *replicaset_uuid,
-			       const struct vclock *vclock)
+			       const struct vclock *vclock, bool compression)
 {
 	memset(row, 0, sizeof(*row));
-	size_t size = mp_sizeof_map(2) +
+	size_t size = mp_sizeof_map(3) +
 		      mp_sizeof_uint(IPROTO_VCLOCK) +
 		      mp_sizeof_vclock_ignore0(vclock) +
 		      mp_sizeof_uint(IPROTO_CLUSTER_UUID) +
-		      mp_sizeof_str(UUID_STR_LEN);
+		      mp_sizeof_str(UUID_STR_LEN) +
+		      mp_sizeof_uint(IPROTO_REPLICA_COMPRESSION) +
+		      mp_sizeof_bool(compression);
 	char *buf = (char *) region_alloc(&fiber()->gc, size);
 	if (buf == NULL) {
 		diag_set(OutOfMemory, size, "region_alloc", "buf");
 		return -1;
 	}
 	char *data = buf;
-	data = mp_encode_map(data, 2);
+	data = mp_encode_map(data, compression ? 3 : 2);
 	data = mp_encode_uint(data, IPROTO_VCLOCK);
 	data = mp_encode_vclock_ignore0(data, vclock);
 	data = mp_encode_uint(data, IPROTO_CLUSTER_UUID);
 	data = xrow_encode_uuid(data, replicaset_uuid);
+	if (compression) {
+		data = mp_encode_uint(data, IPROTO_REPLICA_COMPRESSION);
+		data = mp_encode_bool(data, true);
+	}
 	assert(data <= buf + size);
 	row->body[0].iov_base = buf;
 	row->body[0].iov_len = (data - buf);
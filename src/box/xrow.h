@@ -405,6 +405,8 @@ xrow_encode_register(struct xrow_header *row,
  * @param anon Whether it is an anonymous subscribe request or not.
  * @param id_filter A List of replica ids to skip rows from
  *		    when feeding a replica.
+ * @param compression Whether the replication stream should be
+ *		      compressed.
  *
  * @retval  0 Success.
  * @retval -1 Memory error.
@@ -414,7 +416,7 @@ xrow_encode_subscribe(struct xrow_header *row,
 		      const struct tt_uuid *replicaset_uuid,
 		      const struct tt_uuid *instance_uuid,
 		      const struct vclock *vclock, bool anon,
-		      uint32_t id_filter);
+		      uint32_t id_filter, bool compression);
 
 /**
  * Decode SUBSCRIBE command.
@@ -426,6 +428,8 @@ xrow_encode_subscribe(struct xrow_header *row,
  * @param[out] anon Whether it is an anonymous subscribe.
  * @param[out] id_filter A list of ids to skip rows from when
  *			 feeding a replica.
+ * @param[out] compression Whether the replication stream is
+ *			   compressed.
  *
  * @retval  0 Success.
  * @retval -1 Memory or format error.
@@ -434,7 +438,7 @@ int
 xrow_decode_subscribe(struct xrow_header *row, struct tt_uuid *replicaset_uuid,
 		      struct tt_uuid *instance_uuid, struct vclock *vclock,
 		      uint32_t *version_id, bool *anon,
-		      uint32_t *id_filter);
+		      uint32_t *id_filter, bool *compression);
 
 /**
  * Encode JOIN command.
@@ -459,7 +463,7 @@ static inline int
 xrow_decode_join(struct xrow_header *row, struct tt_uuid *instance_uuid)
 {
 	return xrow_decode_subscribe(row, NULL, instance_uuid, NULL, NULL, NULL,
-				     NULL);
+				     NULL, NULL);
 }
 
 /**
@@ -475,7 +479,7 @@ xrow_decode_register(struct xrow_header *row, struct tt_uuid *instance_uuid,
 		     struct vclock *vclock)
 {
 	return xrow_decode_subscribe(row, NULL, instance_uuid, vclock, NULL,
-				     NULL, NULL);
+				     NULL, NULL, NULL);
 }
 
 /**
@@ -500,7 +504,8 @@ xrow_encode_vclock(struct xrow_header *row, const struct vclock *vclock);
 static inline int
 xrow_decode_vclock(struct xrow_header *row, struct vclock *vclock)
 {
-	return xrow_decode_subscribe(row, NULL, NULL, vclock, NULL, NULL, NULL);
+	return xrow_decode_subscribe(row, NULL, NULL, vclock, NULL, NULL, NULL,
+				     NULL);
 }
 
 /**
@@ -508,6 +513,7 @@ xrow_decode_vclock(struct xrow_header *row, struct vclock *vclock)
  * @param row[out] Row to encode into.
  * @param replicaset_uuid.
  * @param vclock.
+ * @param compression Whether the replication stream is compressed.
  *
  * @retval 0 Success.
  * @retval -1 Memory error.
@@ -515,13 +521,15 @@ xrow_decode_vclock(struct xrow_header *row, struct vclock *vclock)
 int
 xrow_encode_subscribe_response(struct xrow_header *row,
 			      const struct tt_uuid *replicaset_uuid,
-			      const struct vclock *vclock);
+			      const struct vclock *vclock, bool compression);
 
 /**
  * Decode a response to subscribe request.
  * @param row Row to decode.
  * @param[out] replicaset_uuid.
  * @param[out] vclock.
+ * @param[out] compression Whether the replication stream is
+ *			   compressed.
  *
  * @retval 0 Success.
  * @retval -1 Memory or format error.
@@ -529,10 +537,10 @@ xrow_encode_subscribe_response(struct xrow_header *row,
 static inline int
 xrow_decode_subscribe_response(struct xrow_header *row,
 			       struct tt_uuid *replicaset_uuid,
-			       struct vclock *vclock)
+			       struct vclock *vclock, bool *compression)
 {
 	return xrow_decode_subscribe(row, replicaset_uuid, NULL, vclock, NULL,
-				     NULL, NULL);
+				     NULL, NULL, compression);
 }
 
 /**
@@ -598,6 +606,16 @@ void
 iproto_reply_select(struct obuf *buf, struct obuf_svp *svp, uint64_t sync,
 		    uint32_t schema_version, uint32_t count);
 
+/**
+ * Same as iproto_reply_select(), but the result set is followed
+ * by @a ext_size more bytes of tuples in the output stream,
+ * which are not stored in the buffer.
+ */
+void
+iproto_reply_select_ext(struct obuf *buf, struct obuf_svp *svp,
+			uint64_t sync, uint32_t schema_version,
+			uint32_t count, size_t ext_size);
+
 /**
  * Encode iproto header with IPROTO_OK response code.
  * @param out Encode to.
@@ -767,6 +785,20 @@ greeting_decode(const char *greetingbuf, struct greeting *greeting);
 int
 xrow_to_iovec(const struct xrow_header *row, struct iovec *out);
 
+/**
+ * Encode an error packet, the same one as iproto_write_error()
+ * writes. The body is allocated on the fiber region.
+ * @param row[out] Row to encode into.
+ * @param e Error to encode.
+ * @param sync Request sync.
+ *
+ * @retval  0 Success.
+ * @retval -1 Memory error.
+ */
+int
+xrow_encode_error(struct xrow_header *row, const struct error *e,
+		  uint64_t sync);
+
 /**
  * Decode ERROR and set it to diagnostics area.
  * @param row Encoded error.
@@ -827,6 +859,15 @@ xrow_to_iovec_xc(const struct xrow_header *row, struct iovec *out)
 	return rc;
 }
 
+/** @copydoc xrow_encode_error. */
+static inline void
+xrow_encode_error_xc(struct xrow_header *row, const struct error *e,
+		     uint64_t sync)
+{
+	if (xrow_encode_error(row, e, sync) != 0)
+		diag_raise();
+}
+
 /** @copydoc xrow_decode_error. */
 static inline void
 xrow_decode_error_xc(struct xrow_header *row)
@@ -908,10 +949,10 @@ xrow_encode_subscribe_xc(struct xrow_header *row,
 			 const struct tt_uuid *replicaset_uuid,
 			 const struct tt_uuid *instance_uuid,
 			 const struct vclock *vclock, bool anon,
-			 uint32_t id_filter)
+			 uint32_t id_filter, bool compression)
 {
 	if (xrow_encode_subscribe(row, replicaset_uuid, instance_uuid,
-				  vclock, anon, id_filter) != 0)
+				  vclock, anon, id_filter, compression) != 0)
 		diag_raise();
 }
 
@@ -921,11 +962,11 @@ xrow_decode_subscribe_xc(struct xrow_header *row,
 			 struct tt_uuid *replicaset_uuid,
 			 struct tt_uuid *instance_uuid, struct vclock *vclock,
 			 uint32_t *replica_version_id, bool *anon,
-			 uint32_t *id_filter)
+			 uint32_t *id_filter, bool *compression)
 {
 	if (xrow_decode_subscribe(row, replicaset_uuid, instance_uuid,
 				  vclock, replica_version_id, anon,
-				  id_filter) != 0)
+				  id_filter, compression) != 0)
 		diag_raise();
 }
 
@@ -975,9 +1016,10 @@ xrow_decode_vclock_xc(struct xrow_header *row, struct vclock *vclock)
 static inline void
 xrow_encode_subscribe_response_xc(struct xrow_header *row,
 				  const struct tt_uuid *replicaset_uuid,
-				  const struct vclock *vclock)
+				  const struct vclock *vclock, bool compression)
 {
-	if (xrow_encode_subscribe_response(row, replicaset_uuid, vclock) != 0)
+	if (xrow_encode_subscribe_response(row, replicaset_uuid, vclock,
+					   compression) != 0)
 		diag_raise();
 }
 
@@ -985,9 +1027,10 @@ xrow_encode_subscribe_response_xc(struct xrow_header *row,
 static inline void
 xrow_decode_subscribe_response_xc(struct xrow_header *row,
 				  struct tt_uuid *replicaset_uuid,
-				  struct vclock *vclock)
+				  struct vclock *vclock, bool *compression)
 {
-	if (xrow_decode_subscribe_response(row, replicaset_uuid, vclock) != 0)
+	if (xrow_decode_subscribe_response(row, replicaset_uuid, vclock,
+					   compression) != 0)
 		diag_raise();
 }
 
@@ -33,8 +33,15 @@
 #include "coio.h"
 #include "coio_buf.h"
 #include "error.h"
+#include "clock.h"
+#include "fiber.h"
 #include "msgpuck/msgpuck.h"
 
+enum {
+	/** Compression level of the replication stream. */
+	XROW_COMPRESSION_LEVEL = 1,
+};
+
 void
 coio_read_xrow(struct ev_io *coio, struct ibuf *in, struct xrow_header *row)
 {
@@ -94,7 +101,6 @@ coio_read_xrow_timeout_xc(struct ev_io *coio, struct ibuf *in,
 			      true);
 }
 
-
 void
 coio_write_xrow(struct ev_io *coio, const struct xrow_header *row)
 {
@@ -103,3 +109,196 @@ coio_write_xrow(struct ev_io *coio, const struct xrow_header *row)
 	coio_writev(coio, iov, iovcnt, 0);
 }
 
+int
+xrow_compressor_create(struct xrow_compressor *c)
+{
+	memset(c, 0, sizeof(*c));
+	c->zctx = ZSTD_createCStream();
+	if (c->zctx == NULL) {
+		diag_set(OutOfMemory, 0, "ZSTD_createCStream", "zstd context");
+		return -1;
+	}
+	size_t rc = ZSTD_initCStream(c->zctx, XROW_COMPRESSION_LEVEL);
+	if (ZSTD_isError(rc)) {
+		diag_set(ClientError, ER_COMPRESSION, ZSTD_getErrorName(rc));
+		ZSTD_freeCStream(c->zctx);
+		return -1;
+	}
+	ibuf_create(&c->buf, &cord()->slabc, ZSTD_CStreamOutSize());
+	return 0;
+}
+
+void
+xrow_compressor_destroy(struct xrow_compressor *c)
+{
+	ZSTD_freeCStream(c->zctx);
+	ibuf_destroy(&c->buf);
+}
+
+int
+xrow_decompressor_create(struct xrow_decompressor *d)
+{
+	memset(d, 0, sizeof(*d));
+	d->zctx = ZSTD_createDStream();
+	if (d->zctx == NULL) {
+		diag_set(OutOfMemory, 0, "ZSTD_createDStream", "zstd context");
+		return -1;
+	}
+	size_t rc = ZSTD_initDStream(d->zctx);
+	if (ZSTD_isError(rc)) {
+		diag_set(ClientError, ER_DECOMPRESSION, ZSTD_getErrorName(rc));
+		ZSTD_freeDStream(d->zctx);
+		return -1;
+	}
+	ibuf_create(&d->buf, &cord()->slabc, ZSTD_DStreamInSize());
+	return 0;
+}
+
+void
+xrow_decompressor_destroy(struct xrow_decompressor *d)
+{
+	ZSTD_freeDStream(d->zctx);
+	ibuf_destroy(&d->buf);
+}
+
+/**
+ * Decompress data read from a socket until there are at least
+ * @a sz bytes in the @a in buffer.
+ */
+static void
+xrow_decompressor_readn_timeout(struct ev_io *coio,
+				struct xrow_decompressor *d,
+				struct ibuf *in, size_t sz, ev_tstamp timeout)
+{
+	ev_tstamp start, delay;
+	coio_timeout_init(&start, &delay, timeout);
+	while (ibuf_used(in) < sz) {
+		if (ibuf_used(&d->buf) == 0 && !d->has_output) {
+			ibuf_reset(&d->buf);
+			coio_breadn_timeout(coio, &d->buf, 1, delay);
+			coio_timeout_update(&start, &delay);
+		}
+		size_t out_size = MAX(sz - ibuf_used(in),
+				      ZSTD_DStreamOutSize());
+		ibuf_reserve_xc(in, out_size);
+		ZSTD_inBuffer input = {d->buf.rpos, ibuf_used(&d->buf), 0};
+		ZSTD_outBuffer output = {in->wpos, ibuf_unused(in), 0};
+		size_t rc = ZSTD_decompressStream(d->zctx, &output, &input);
+		if (ZSTD_isError(rc)) {
+			tnt_raise(ClientError, ER_DECOMPRESSION,
+				  ZSTD_getErrorName(rc));
+		}
+		d->buf.rpos += input.pos;
+		in->wpos += output.pos;
+		d->has_output = output.pos == output.size;
+	}
+}
+
+void
+coio_read_xrow_compressed_timeout_xc(struct ev_io *coio,
+				     struct xrow_decompressor *d,
+				     struct ibuf *in, struct xrow_header *row,
+				     ev_tstamp timeout)
+{
+	ev_tstamp start, delay;
+	coio_timeout_init(&start, &delay, timeout);
+	/* Read fixed header */
+	xrow_decompressor_readn_timeout(coio, d, in, 1, delay);
+	coio_timeout_update(&start, &delay);
+
+	/* Read length */
+	if (mp_typeof(*in->rpos) != MP_UINT) {
+		tnt_raise(ClientError, ER_INVALID_MSGPACK,
+			  "packet length");
+	}
+	ssize_t to_read = mp_check_uint(in->rpos, in->wpos);
+	if (to_read > 0) {
+		xrow_decompressor_readn_timeout(coio, d, in,
+						ibuf_used(in) + to_read,
+						delay);
+	}
+	coio_timeout_update(&start, &delay);
+
+	uint32_t len = mp_decode_uint((const char **) &in->rpos);
+
+	/* Read header and body */
+	xrow_decompressor_readn_timeout(coio, d, in, len, delay);
+
+	xrow_header_decode_xc(row, (const char **) &in->rpos, in->rpos + len,
+			      true);
+}
+
+/**
+ * Feed data to a compressor. If @a end is set, flush the
+ * compressor so that all data fed so far can be decompressed.
+ */
+static void
+xrow_compressor_feed(struct xrow_compressor *c, const void *data,
+		     size_t size, bool end)
+{
+	ZSTD_inBuffer input = {data, size, 0};
+	bool is_flushed = false;
+	while (!is_flushed) {
+		ibuf_reserve_xc(&c->buf, ZSTD_CStreamOutSize());
+		ZSTD_outBuffer output = {c->buf.wpos, ibuf_unused(&c->buf), 0};
+		size_t rc;
+		if (input.pos < input.size) {
+			rc = ZSTD_compressStream(c->zctx, &output, &input);
+		} else if (end) {
+			/* Returns the number of bytes left to flush. */
+			rc = ZSTD_flushStream(c->zctx, &output);
+			is_flushed = rc == 0;
+		} else {
+			break;
+		}
+		if (ZSTD_isError(rc)) {
+			tnt_raise(ClientError, ER_COMPRESSION,
+				  ZSTD_getErrorName(rc));
+		}
+		c->buf.wpos += output.pos;
+	}
+	c->raw_size += size;
+}
+
+void
+coio_write_xrow_compressed(struct ev_io *coio, struct xrow_compressor *c,
+			   const struct xrow_header *row)
+{
+	struct iovec iov[XROW_IOVMAX];
+	int iovcnt = xrow_to_iovec_xc(row, iov);
+	double start = clock_thread();
+	for (int i = 0; i < iovcnt; i++) {
+		xrow_compressor_feed(c, iov[i].iov_base, iov[i].iov_len,
+				     i == iovcnt - 1);
+	}
+	c->time += clock_thread() - start;
+	size_t size = ibuf_used(&c->buf);
+	c->size += size;
+	coio_write(coio, c->buf.rpos, size);
+	ibuf_reset(&c->buf);
+}
+
+void
+coio_write_xrow_zstd_frame(struct ev_io *coio, const struct xrow_header *row)
+{
+	struct iovec iov[XROW_IOVMAX];
+	int iovcnt = xrow_to_iovec_xc(row, iov);
+	size_t size = 0;
+	for (int i = 0; i < iovcnt; i++)
+		size += iov[i].iov_len;
+	size_t bound = ZSTD_compressBound(size);
+	char *buf = (char *)region_alloc(&fiber()->gc, size + bound);
+	if (buf == NULL)
+		tnt_raise(OutOfMemory, size + bound, "region", "xrow");
+	char *pos = buf;
+	for (int i = 0; i < iovcnt; i++) {
+		memcpy(pos, iov[i].iov_base, iov[i].iov_len);
+		pos += iov[i].iov_len;
+	}
+	size_t rc = ZSTD_compress(pos, bound, buf, size,
+				  XROW_COMPRESSION_LEVEL);
+	if (ZSTD_isError(rc))
+		tnt_raise(ClientError, ER_COMPRESSION, ZSTD_getErrorName(rc));
+	coio_write(coio, pos, rc);
+}
+
@@ -30,14 +30,76 @@
  * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
  * SUCH DAMAGE.
  */
+#include <stdbool.h>
+#include <stdint.h>
+#include <zstd.h>
+#include <small/ibuf.h>
+
 #if defined(__cplusplus)
 extern "C" {
 #endif
 
 struct ev_io;
-struct ibuf;
 struct xrow_header;
 
+/**
+ * Compressor of a stream of rows sent over the network.
+ *
+ * All rows are compressed with the same zstd context so that
+ * a row may refer to data sent in the preceding rows, which
+ * gives a decent compression ratio even for small rows. The
+ * stream is flushed after each row so that the peer can decode
+ * it as soon as it's received.
+ */
+struct xrow_compressor {
+	/** zstd compression context. */
+	ZSTD_CStream *zctx;
+	/** Buffer for compressed data. */
+	struct ibuf buf;
+	/** Number of bytes passed to the compressor. */
+	uint64_t raw_size;
+	/** Number of bytes produced by the compressor. */
+	uint64_t size;
+	/** CPU time spent compressing, in seconds. */
+	double time;
+};
+
+/**
+ * Decompressor of a stream of rows compressed by
+ * xrow_compressor.
+ */
+struct xrow_decompressor {
+	/** zstd decompression context. */
+	ZSTD_DStream *zctx;
+	/** Compressed data read from the network. */
+	struct ibuf buf;
+	/**
+	 * Set if the decompressor may have buffered output that
+	 * didn't fit in the output buffer on the last call.
+	 */
+	bool has_output;
+};
+
+/**
+ * Initialize a compressor. Return 0 on success, -1 on memory
+ * allocation error.
+ */
+int
+xrow_compressor_create(struct xrow_compressor *c);
+
+void
+xrow_compressor_destroy(struct xrow_compressor *c);
+
+/**
+ * Initialize a decompressor. Return 0 on success, -1 on memory
+ * allocation error.
+ */
+int
+xrow_decompressor_create(struct xrow_decompressor *d);
+
+void
+xrow_decompressor_destroy(struct xrow_decompressor *d);
+
 void
 coio_read_xrow(struct ev_io *coio, struct ibuf *in, struct xrow_header *row);
 
@@ -48,6 +110,35 @@ coio_read_xrow_timeout_xc(struct ev_io *coio, struct ibuf *in,
 void
 coio_write_xrow(struct ev_io *coio, const struct xrow_header *row);
 
+/**
+ * Read a row from a compressed stream.
+ * @param coio Socket to read from.
+ * @param d Decompressor of the stream.
+ * @param in Buffer for decompressed data.
+ * @param[out] row Decoded row.
+ * @param timeout Read timeout.
+ */
+void
+coio_read_xrow_compressed_timeout_xc(struct ev_io *coio,
+				     struct xrow_decompressor *d,
+				     struct ibuf *in, struct xrow_header *row,
+				     double timeout);
+
+/**
+ * Compress a row and write it to a socket.
+ */
+void
+coio_write_xrow_compressed(struct ev_io *coio, struct xrow_compressor *c,
+			   const struct xrow_header *row);
+
+/**
+ * Compress a row into a standalone zstd frame and write it to
+ * a socket. Used for rows sent before a compressed stream is
+ * started, because xrow_decompressor decodes concatenated frames.
+ */
+void
+coio_write_xrow_zstd_frame(struct ev_io *coio, const struct xrow_header *row);
+
 
 #if defined(__cplusplus)
 } /* extern "C" */
@@ -401,6 +401,27 @@ evio_service_bind(struct evio_service *service, const char *uri)
 	return -1;
 }
 
+int
+evio_service_attach(struct evio_service *service,
+		    const struct evio_service *src)
+{
+	assert(! ev_is_active(&service->ev));
+	assert(src->ev.fd >= 0);
+	int fd = dup(src->ev.fd);
+	if (fd < 0) {
+		diag_set(SocketError, sio_socketname(src->ev.fd), "dup");
+		return -1;
+	}
+	memcpy(service->host, src->host, sizeof(service->host));
+	memcpy(service->serv, src->serv, sizeof(service->serv));
+	service->addrstorage = src->addrstorage;
+	service->addr_len = src->addr_len;
+	service->is_attached = true;
+	ev_io_set(&service->ev, fd, EV_READ);
+	ev_io_start(service->loop, &service->ev);
+	return 0;
+}
+
 /** It's safe to stop a service which is not started yet. */
 void
 evio_service_stop(struct evio_service *service)
@@ -415,8 +436,10 @@ evio_service_stop(struct evio_service *service)
 	if (service->ev.fd >= 0) {
 		close(service->ev.fd);
 		ev_io_set(&service->ev, -1, 0);
-		if (service->addr.sa_family == AF_UNIX) {
+		if (service->addr.sa_family == AF_UNIX &&
+		    !service->is_attached) {
 			unlink(((struct sockaddr_un *) &service->addr)->sun_path);
 		}
+		service->is_attached = false;
 	}
 }
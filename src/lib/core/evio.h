@@ -86,6 +86,13 @@ struct evio_service
 		struct sockaddr_storage addrstorage;
 	};
 	socklen_t addr_len;
+	/**
+	 * Set if the service accepts connections from a socket
+	 * of another service, see evio_service_attach(). Such
+	 * a service doesn't own the socket file of a unix socket
+	 * and so doesn't unlink it when stopped.
+	 */
+	bool is_attached;
 
 	/**
 	 * A callback invoked on every accepted client socket.
@@ -117,6 +124,17 @@ evio_service_bind(struct evio_service *service, const char *uri);
 int
 evio_service_listen(struct evio_service *service);
 
+/**
+ * Make @a service accept connections from the listening socket
+ * of @a src, which may be served by another thread. The socket
+ * is duplicated, so each service can be stopped on its own.
+ *
+ * @retval 0 for success
+ */
+int
+evio_service_attach(struct evio_service *service,
+		    const struct evio_service *src);
+
 /** If started, stop event flow and close the acceptor socket. */
 void
 evio_service_stop(struct evio_service *service);
@@ -64,6 +64,59 @@ bloom_destroy(struct bloom *bloom)
 	free(bloom->table);
 }
 
+int
+bloom_blocked_create(struct bloom *bloom, uint32_t number_of_values,
+		     double false_positive_rate)
+{
+	/*
+	 * Start with the size of the optimal classic bloom filter
+	 * and grow it until the false positive rate is low enough:
+	 * blocked filters need a few more bits per value. Note,
+	 * since each hash function sets a bit in its own word,
+	 * using fewer hash functions wouldn't save space.
+	 */
+	uint64_t bit_count = ceil(number_of_values *
+				  log(false_positive_rate) /
+				  (log(0.5) * log(2)));
+	uint32_t block_bits = CHAR_BIT * sizeof(struct bloom_block);
+	uint64_t block_count = (bit_count + block_bits - 1) / block_bits;
+	if (block_count > UINT32_MAX / 2)
+		block_count = UINT32_MAX / 2;
+	bloom->table_size = block_count > 0 ? block_count : 1;
+	bloom->hash_count = BLOOM_BLOCKED_HASH_COUNT;
+	while (bloom->table_size < UINT32_MAX / 2 &&
+	       bloom_blocked_fpr(bloom, number_of_values) >
+						false_positive_rate)
+		bloom->table_size += bloom->table_size / 16 + 1;
+
+	bloom->table = calloc(bloom->table_size, sizeof(*bloom->table));
+	if (bloom->table == NULL)
+		return -1;
+	return 0;
+}
+
+double
+bloom_blocked_fpr(const struct bloom *bloom, uint32_t number_of_values)
+{
+	/*
+	 * The number of values stored in a block is distributed
+	 * according to Poisson law. The false positive rate of
+	 * a block storing j values equals the probability that
+	 * all bits corresponding to a checked value are set.
+	 */
+	double lambda = (double)number_of_values / bloom->table_size;
+	double word_bits = CHAR_BIT * sizeof(uint64_t);
+	double p = exp(-lambda);
+	double fpr = 0;
+	uint32_t max_j = lambda + 20 * sqrt(lambda) + 20;
+	for (uint32_t j = 1; j <= max_j; j++) {
+		p *= lambda / j;
+		fpr += p * pow(1 - pow(1 - 1 / word_bits, j),
+			       bloom->hash_count);
+	}
+	return fpr;
+}
+
 double
 bloom_fpr(const struct bloom *bloom, uint32_t number_of_values)
 {
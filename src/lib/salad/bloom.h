@@ -41,6 +41,15 @@
  *  "Less Hashing, Same Performance: Building a Better Bloom Filter"
  *   https://www.eecs.harvard.edu/~michaelm/postscripts/tr-02-05.pdf
  * 3) Using only one hash value that is splitted into several independent parts
+ *
+ * There is also a blocked variant of the filter (bloom_blocked_*),
+ * which sets exactly one bit in each 64-bit word of a block, similar
+ * to "Split Block Bloom Filters" used by Apache Impala and Parquet.
+ * Its bit positions are computed with independent multiply-shift
+ * hashes so that a probe doesn't have data dependent branches and
+ * can be vectorized by the compiler. The price is a slightly higher
+ * false positive rate for the same size, which is compensated by
+ * allocating more blocks.
  */
 
 #include <stdint.h>
@@ -56,6 +65,10 @@ extern "C" {
 enum {
 	/* Expected cache line of target processor */
 	BLOOM_CACHE_LINE = 64,
+	/* Number of 64-bit words in a block */
+	BLOOM_BLOCK_WORDS = BLOOM_CACHE_LINE / sizeof(uint64_t),
+	/* Number of hash functions used by a blocked bloom filter */
+	BLOOM_BLOCKED_HASH_COUNT = BLOOM_BLOCK_WORDS,
 };
 
 typedef uint32_t bloom_hash_t;
@@ -64,7 +77,10 @@ typedef uint32_t bloom_hash_t;
  * Cache-line-size block of bloom filter
  */
 struct bloom_block {
-	unsigned char bits[BLOOM_CACHE_LINE];
+	union {
+		unsigned char bits[BLOOM_CACHE_LINE];
+		uint64_t words[BLOOM_BLOCK_WORDS];
+	};
 };
 
 /**
@@ -129,6 +145,45 @@ bloom_maybe_has(const struct bloom *bloom, bloom_hash_t hash);
 double
 bloom_fpr(const struct bloom *bloom, uint32_t number_of_values);
 
+/**
+ * Allocate and initialize an instance of blocked bloom filter
+ *
+ * @param bloom - structure to initialize
+ * @param number_of_values - estimated number of values to be added
+ * @param false_positive_rate - desired false positive rate
+ * @return 0 - OK, -1 - memory error
+ */
+int
+bloom_blocked_create(struct bloom *bloom, uint32_t number_of_values,
+		     double false_positive_rate);
+
+/**
+ * Add a value into the data set of a blocked bloom filter
+ * @param bloom - the bloom filter
+ * @param hash - hash of the value
+ */
+static void
+bloom_blocked_add(struct bloom *bloom, bloom_hash_t hash);
+
+/**
+ * Query for presence of a value in a blocked bloom filter
+ * @param bloom - the bloom filter
+ * @param hash - hash of the value
+ * @return true - the value could be in data set; false - the value is
+ *  definitively not in data set
+ */
+static bool
+bloom_blocked_maybe_has(const struct bloom *bloom, bloom_hash_t hash);
+
+/**
+ * Return the expected false positive rate of a blocked bloom filter.
+ * @param bloom - the bloom filter
+ * @param number_of_values - number of values stored in the filter
+ * @return - expected false positive rate
+ */
+double
+bloom_blocked_fpr(const struct bloom *bloom, uint32_t number_of_values);
+
 /**
  * Calculate size of a buffer that is needed for storing bloom table
  * @param bloom - the bloom filter to store
@@ -204,6 +259,56 @@ bloom_maybe_has(const struct bloom *bloom, bloom_hash_t hash)
 	return true;
 }
 
+/**
+ * Return the block of a blocked bloom filter that stores the
+ * given hash and the mask of bits set for the hash in the block.
+ */
+static inline const struct bloom_block *
+bloom_blocked_lookup(const struct bloom *bloom, bloom_hash_t hash,
+		     uint64_t mask[BLOOM_BLOCK_WORDS])
+{
+	/* Odd constants for multiply-shift hashing */
+	static const uint32_t salt[BLOOM_BLOCK_WORDS] = {
+		0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+		0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U,
+	};
+	/*
+	 * Remix the hash before using its upper bits for finding
+	 * a block so that the block number doesn't correlate with
+	 * bit numbers. Use multiplication instead of division.
+	 */
+	uint32_t block_hash = (hash ^ (hash >> 16)) * 0x85ebca6bU;
+	uint32_t pos = ((uint64_t)block_hash * bloom->table_size) >> 32;
+	for (int i = 0; i < BLOOM_BLOCK_WORDS; i++) {
+		/* Upper 6 bits of the product is the bit number */
+		mask[i] = (uint64_t)1 << ((hash * salt[i]) >> 26);
+	}
+	return &bloom->table[pos];
+}
+
+static inline void
+bloom_blocked_add(struct bloom *bloom, bloom_hash_t hash)
+{
+	uint64_t mask[BLOOM_BLOCK_WORDS];
+	struct bloom_block *block =
+		(struct bloom_block *)bloom_blocked_lookup(bloom, hash, mask);
+	for (int i = 0; i < BLOOM_BLOCK_WORDS; i++)
+		block->words[i] |= mask[i];
+}
+
+static inline bool
+bloom_blocked_maybe_has(const struct bloom *bloom, bloom_hash_t hash)
+{
+	uint64_t mask[BLOOM_BLOCK_WORDS];
+	const struct bloom_block *block =
+		bloom_blocked_lookup(bloom, hash, mask);
+	/* No branches in the loop so that it can be vectorized */
+	uint64_t missing = 0;
+	for (int i = 0; i < BLOOM_BLOCK_WORDS; i++)
+		missing |= mask[i] & ~block->words[i];
+	return missing == 0;
+}
+
 /* }}} API definition */
 
 #if defined(__cplusplus)
@@ -37,6 +37,7 @@
 #include <assert.h>
 #include <stdio.h> /* printf */
 #include "small/matras.h"
+#include "trivia/util.h" /* prefetch */
 
 /* {{{ BPS-tree description */
 /**
@@ -372,6 +373,7 @@ typedef uint32_t bps_tree_block_id_t;
 #define bps_tree_build _api_name(build)
 #define bps_tree_destroy _api_name(destroy)
 #define bps_tree_find _api_name(find)
+#define bps_tree_find_batch _api_name(find_batch)
 #define bps_tree_insert _api_name(insert)
 #define bps_tree_insert_get_iterator _api_name(insert_get_iterator)
 #define bps_tree_delete _api_name(delete)
@@ -403,6 +405,7 @@ typedef uint32_t bps_tree_block_id_t;
 #define BPS_TREE_MAX_COUNT_IN_LEAF _BPS_TREE(MAX_COUNT_IN_LEAF)
 #define BPS_TREE_MAX_COUNT_IN_INNER _BPS_TREE(MAX_COUNT_IN_INNER)
 #define BPS_TREE_MAX_DEPTH _BPS_TREE(MAX_DEPTH)
+#define BPS_TREE_FIND_BATCH_SIZE _BPS_TREE(FIND_BATCH_SIZE)
 #define bps_block_type _bps(block_type)
 #define BPS_TREE_BT_GARBAGE _BPS_TREE(BT_GARBAGE)
 #define BPS_TREE_BT_INNER _BPS_TREE(BT_INNER)
@@ -411,6 +414,7 @@ typedef uint32_t bps_tree_block_id_t;
 #define bps_tree_restore_block _bps_tree(restore_block)
 #define bps_tree_restore_block_ver _bps_tree(restore_block_ver)
 #define bps_tree_root _bps_tree(root)
+#define bps_tree_prefetch_block _bps_tree(prefetch_block)
 #define bps_tree_touch_block _bps_tree(touch_block)
 #define bps_tree_find_ins_point_key _bps_tree(find_ins_point_key)
 #define bps_tree_find_ins_point_elem _bps_tree(find_ins_point_elem)
@@ -623,6 +627,22 @@ bps_tree_destroy(struct bps_tree *tree);
 static inline bps_tree_elem_t *
 bps_tree_find(const struct bps_tree *tree, bps_tree_key_t key);
 
+/**
+ * @brief Find the first elements equal to each of the given keys.
+ * Up to BPS_TREE_FIND_BATCH_SIZE keys are looked up in lockstep:
+ * the tree is descended one level for all of them at a time and
+ * blocks of the next level are prefetched, so that cache misses
+ * for different keys overlap instead of being paid one by one.
+ * @param tree - pointer to a tree
+ * @param keys - array of keys
+ * @param count - number of keys
+ * @param results - array that receives a pointer to the first
+ *  element equal to the key at the same position or NULL if not found
+ */
+static inline void
+bps_tree_find_batch(const struct bps_tree *tree, bps_tree_key_t *keys,
+		    size_t count, bps_tree_elem_t **results);
+
 /**
  * @brief Insert an element to the tree or replace an element in the tree
  * In case of replacing, if 'replaced' argument is not null,
@@ -939,7 +959,9 @@ enum bps_tree_max_sizes {
 	BPS_TREE_MAX_COUNT_IN_INNER =
 		(BPS_TREE_BLOCK_SIZE - sizeof(struct bps_block))
 		/ (sizeof(bps_tree_elem_t) + sizeof(bps_tree_block_id_t)),
-	BPS_TREE_MAX_DEPTH = 16
+	BPS_TREE_MAX_DEPTH = 16,
+	/* Number of keys looked up in lockstep by bps_tree_find_batch */
+	BPS_TREE_FIND_BATCH_SIZE = 16
 };
 
 /**
@@ -2110,6 +2132,64 @@ bps_tree_find(const struct bps_tree *tree, bps_tree_key_t key)
 		return 0;
 }
 
+/**
+ * @brief Prefetch a block that is going to be searched.
+ */
+static inline void
+bps_tree_prefetch_block(struct bps_block *block)
+{
+	for (size_t offset = 0; offset < BPS_TREE_BLOCK_SIZE; offset += 64)
+		prefetch((char *)block + offset, 0);
+}
+
+/**
+ * @sa bps_tree_find_batch description
+ */
+static inline void
+bps_tree_find_batch(const struct bps_tree *tree, bps_tree_key_t *keys,
+		    size_t count, bps_tree_elem_t **results)
+{
+	if (tree->root_id == (bps_tree_block_id_t)(-1)) {
+		for (size_t i = 0; i < count; i++)
+			results[i] = 0;
+		return;
+	}
+	struct bps_block *root = bps_tree_root(tree);
+	struct bps_block *blocks[BPS_TREE_FIND_BATCH_SIZE];
+	while (count > 0) {
+		size_t batch_size = count < BPS_TREE_FIND_BATCH_SIZE ?
+				    count : BPS_TREE_FIND_BATCH_SIZE;
+		for (size_t j = 0; j < batch_size; j++)
+			blocks[j] = root;
+		bool exact;
+		for (bps_tree_block_id_t i = 0; i < tree->depth - 1; i++) {
+			for (size_t j = 0; j < batch_size; j++) {
+				struct bps_inner *inner =
+					(struct bps_inner *)blocks[j];
+				bps_tree_pos_t pos;
+				pos = bps_tree_find_ins_point_key(
+					tree, inner->elems,
+					inner->header.size - 1,
+					keys[j], &exact);
+				blocks[j] = bps_tree_restore_block(
+					tree, inner->child_ids[pos]);
+				bps_tree_prefetch_block(blocks[j]);
+			}
+		}
+		for (size_t j = 0; j < batch_size; j++) {
+			struct bps_leaf *leaf = (struct bps_leaf *)blocks[j];
+			bps_tree_pos_t pos;
+			pos = bps_tree_find_ins_point_key(tree, leaf->elems,
+							  leaf->header.size,
+							  keys[j], &exact);
+			results[j] = exact ? leaf->elems + pos : 0;
+		}
+		keys += batch_size;
+		results += batch_size;
+		count -= batch_size;
+	}
+}
+
 /**
  * @brief Add a block to the garbage for future reuse
  */
@@ -6097,6 +6177,7 @@ bps_tree_debug_check_internal_functions(bool assertme)
 #undef bps_tree_build
 #undef bps_tree_destroy
 #undef bps_tree_find
+#undef bps_tree_find_batch
 #undef bps_tree_insert
 #undef bps_tree_delete
 #undef bps_tree_delete_value
@@ -6126,6 +6207,7 @@ bps_tree_debug_check_internal_functions(bool assertme)
 #undef BPS_TREE_MAX_COUNT_IN_LEAF
 #undef BPS_TREE_MAX_COUNT_IN_INNER
 #undef BPS_TREE_MAX_DEPTH
+#undef BPS_TREE_FIND_BATCH_SIZE
 #undef bps_block_type
 #undef BPS_TREE_BT_GARBAGE
 #undef BPS_TREE_BT_INNER
@@ -6134,6 +6216,7 @@ bps_tree_debug_check_internal_functions(bool assertme)
 #undef bps_tree_restore_block
 #undef bps_tree_restore_block_ver
 #undef bps_tree_root
+#undef bps_tree_prefetch_block
 #undef bps_tree_touch_block
 #undef bps_tree_find_ins_point_key
 #undef bps_tree_find_ins_point_elem
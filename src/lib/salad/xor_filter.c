@@ -0,0 +1,167 @@
+/*
+ * Copyright 2010-2020, Tarantool AUTHORS, please see AUTHORS file.
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above
+ *    copyright notice, this list of conditions and the
+ *    following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY <COPYRIGHT HOLDER> ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * <COPYRIGHT HOLDER> OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "xor_filter.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** An element of the set of hashes mapped to a fingerprint slot. */
+struct xor_filter_slot {
+	/** Xor of all hashes mapped to the slot. */
+	uint64_t mask;
+	/** Number of hashes mapped to the slot. */
+	uint32_t count;
+};
+
+/** A hash peeled from the filter along with its slot. */
+struct xor_filter_peeled {
+	uint64_t hash;
+	uint32_t pos;
+};
+
+static int
+xor_filter_cmp_hash(const void *a, const void *b)
+{
+	uint32_t x = *(const uint32_t *)a;
+	uint32_t y = *(const uint32_t *)b;
+	return x < y ? -1 : x > y;
+}
+
+/**
+ * Try to find a mapping of hashes to fingerprint slots such that
+ * each hash has a slot it is the only one mapped to, see the paper
+ * for details. Return true and fill @a stack on success.
+ */
+static bool
+xor_filter_peel(const struct xor_filter *filter, const uint32_t *hashes,
+		uint32_t count, struct xor_filter_slot *slots,
+		uint32_t *queue, struct xor_filter_peeled *stack)
+{
+	uint32_t capacity = xor_filter_size(filter);
+	memset(slots, 0, capacity * sizeof(*slots));
+	for (uint32_t i = 0; i < count; i++) {
+		uint64_t h = xor_filter_mix(hashes[i], filter->seed);
+		for (int b = 0; b < 3; b++) {
+			struct xor_filter_slot *slot =
+				&slots[xor_filter_pos(filter, h, b)];
+			slot->mask ^= h;
+			slot->count++;
+		}
+	}
+	uint32_t queue_size = 0;
+	for (uint32_t i = 0; i < capacity; i++) {
+		if (slots[i].count == 1)
+			queue[queue_size++] = i;
+	}
+	uint32_t stack_size = 0;
+	while (queue_size > 0) {
+		uint32_t pos = queue[--queue_size];
+		if (slots[pos].count != 1)
+			continue;
+		uint64_t h = slots[pos].mask;
+		stack[stack_size].hash = h;
+		stack[stack_size].pos = pos;
+		stack_size++;
+		for (int b = 0; b < 3; b++) {
+			struct xor_filter_slot *slot =
+				&slots[xor_filter_pos(filter, h, b)];
+			slot->mask ^= h;
+			if (--slot->count == 1)
+				queue[queue_size++] = slot - slots;
+		}
+	}
+	return stack_size == count;
+}
+
+int
+xor_filter_create(struct xor_filter *filter, uint32_t *hashes,
+		  uint32_t count)
+{
+	/* Duplicates can't be peeled, remove them. */
+	qsort(hashes, count, sizeof(*hashes), xor_filter_cmp_hash);
+	uint32_t unique_count = 0;
+	for (uint32_t i = 0; i < count; i++) {
+		if (unique_count == 0 || hashes[unique_count - 1] != hashes[i])
+			hashes[unique_count++] = hashes[i];
+	}
+	count = unique_count;
+
+	memset(filter, 0, sizeof(*filter));
+	filter->block_length = (32 + 1.23 * count) / 3 + 1;
+	uint32_t capacity = xor_filter_size(filter);
+	struct xor_filter_slot *slots = malloc(capacity * sizeof(*slots));
+	uint32_t *queue = malloc(capacity * sizeof(*queue));
+	struct xor_filter_peeled *stack = malloc((count + 1) * sizeof(*stack));
+	filter->fingerprints = calloc(capacity, sizeof(uint8_t));
+	if (slots == NULL || queue == NULL || stack == NULL ||
+	    filter->fingerprints == NULL)
+		goto fail;
+	/*
+	 * Peeling succeeds with high probability for the chosen
+	 * capacity so a new seed is tried on failure.
+	 */
+	while (!xor_filter_peel(filter, hashes, count, slots, queue, stack))
+		filter->seed++;
+	/*
+	 * Assign fingerprints in the reverse peeling order: the slot
+	 * of each hash isn't used by any hash assigned before it.
+	 */
+	uint8_t *f = filter->fingerprints;
+	for (uint32_t i = count; i > 0; i--) {
+		uint64_t h = stack[i - 1].hash;
+		uint32_t pos = stack[i - 1].pos;
+		f[pos] = 0;
+		f[pos] = xor_filter_fingerprint(h) ^
+			 f[xor_filter_pos(filter, h, 0)] ^
+			 f[xor_filter_pos(filter, h, 1)] ^
+			 f[xor_filter_pos(filter, h, 2)];
+	}
+	free(slots);
+	free(queue);
+	free(stack);
+	return 0;
+fail:
+	free(slots);
+	free(queue);
+	free(stack);
+	free(filter->fingerprints);
+	filter->fingerprints = NULL;
+	return -1;
+}
+
+void
+xor_filter_destroy(struct xor_filter *filter)
+{
+	free(filter->fingerprints);
+}
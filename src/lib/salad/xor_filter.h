@@ -0,0 +1,171 @@
+#ifndef TARANTOOL_LIB_SALAD_XOR_FILTER_H_INCLUDED
+#define TARANTOOL_LIB_SALAD_XOR_FILTER_H_INCLUDED
+/*
+ * Copyright 2010-2020, Tarantool AUTHORS, please see AUTHORS file.
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above
+ *    copyright notice, this list of conditions and the
+ *    following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY <COPYRIGHT HOLDER> ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * <COPYRIGHT HOLDER> OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * Xor filter with 8-bit fingerprints:
+ *  Graf, Thomas Mueller; Lemire, Daniel (2020),
+ *  "Xor Filters: Faster and Smaller Than Bloom and Cuckoo Filters"
+ *  https://arxiv.org/abs/1912.08258
+ *
+ * A static set of hashes is mapped to an array of 3 * block_length
+ * fingerprints so that the xor of the three fingerprints a hash is
+ * mapped to equals the fingerprint of the hash. It takes about
+ * 9.84 bits per value, the false positive rate is 1/256, and a
+ * lookup takes three memory reads and no branches.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+struct xor_filter {
+	/** Seed used for mixing hashes. */
+	uint32_t seed;
+	/** Number of fingerprints in each of the three blocks. */
+	uint32_t block_length;
+	/** Array of 3 * block_length fingerprints. */
+	uint8_t *fingerprints;
+};
+
+/* {{{ API declaration */
+
+/**
+ * Build a xor filter for the given set of hashes.
+ *
+ * @param filter - structure to initialize
+ * @param hashes - array of hashes; it is sorted and duplicates
+ *  are removed from it in place
+ * @param count - number of hashes in the array
+ * @return 0 - OK, -1 - memory error
+ */
+int
+xor_filter_create(struct xor_filter *filter, uint32_t *hashes,
+		  uint32_t count);
+
+/**
+ * Free resources of a xor filter
+ *
+ * @param filter - the xor filter
+ */
+void
+xor_filter_destroy(struct xor_filter *filter);
+
+/**
+ * Return the size of the fingerprint array of a xor filter.
+ *
+ * @param filter - the xor filter
+ * @return - size, in bytes
+ */
+static inline size_t
+xor_filter_size(const struct xor_filter *filter)
+{
+	return (size_t)filter->block_length * 3;
+}
+
+/**
+ * Query for presence of a value in a xor filter
+ * @param filter - the xor filter
+ * @param hash - hash of the value
+ * @return true - the value could be in data set; false - the value is
+ *  definitively not in data set
+ */
+static bool
+xor_filter_maybe_has(const struct xor_filter *filter, uint32_t hash);
+
+/* }}} API declaration */
+
+/* {{{ API definition */
+
+/** Mix a hash with a seed to get 64 pseudo-random bits. */
+static inline uint64_t
+xor_filter_mix(uint32_t hash, uint32_t seed)
+{
+	/* MurmurHash3 finalizer, a bijection */
+	uint64_t h = ((uint64_t)seed << 32) | hash;
+	h ^= h >> 33;
+	h *= 0xff51afd7ed558ccdULL;
+	h ^= h >> 33;
+	h *= 0xc4ceb9fe1a85ec53ULL;
+	h ^= h >> 33;
+	return h;
+}
+
+/** Map 32 bits to [0, n) without division. */
+static inline uint32_t
+xor_filter_reduce(uint32_t x, uint32_t n)
+{
+	return ((uint64_t)x * n) >> 32;
+}
+
+/**
+ * Return the position of a mixed hash in the given block
+ * of a xor filter.
+ */
+static inline uint32_t
+xor_filter_pos(const struct xor_filter *filter, uint64_t h, int block)
+{
+	int shift = block * 21;
+	uint64_t r = shift == 0 ? h : (h << shift) | (h >> (64 - shift));
+	return xor_filter_reduce(r, filter->block_length) +
+	       block * filter->block_length;
+}
+
+/** Return the fingerprint of a mixed hash. */
+static inline uint8_t
+xor_filter_fingerprint(uint64_t h)
+{
+	return h ^ (h >> 32);
+}
+
+static inline bool
+xor_filter_maybe_has(const struct xor_filter *filter, uint32_t hash)
+{
+	uint64_t h = xor_filter_mix(hash, filter->seed);
+	const uint8_t *f = filter->fingerprints;
+	return xor_filter_fingerprint(h) ==
+	       (f[xor_filter_pos(filter, h, 0)] ^
+		f[xor_filter_pos(filter, h, 1)] ^
+		f[xor_filter_pos(filter, h, 2)]);
+}
+
+/* }}} API definition */
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
+
+#endif /* TARANTOOL_LIB_SALAD_XOR_FILTER_H_INCLUDED */
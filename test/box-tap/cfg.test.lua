@@ -6,7 +6,7 @@ local socket = require('socket')
 local fio = require('fio')
 local uuid = require('uuid')
 local msgpack = require('msgpack')
-test:plan(108)
+test:plan(114)
 
 --------------------------------------------------------------------------------
 -- Invalid values
@@ -49,6 +49,12 @@ invalid('vinyl_run_count_per_level', 0)
 invalid('vinyl_run_size_ratio', 1)
 invalid('vinyl_bloom_fpr', 0)
 invalid('vinyl_bloom_fpr', 1.1)
+invalid('iproto_threads', 0)
+invalid('iproto_threads', 1001)
+invalid('memtx_recovery_threads', 0)
+invalid('wal_group_commit_timeout', -1)
+invalid('wal_group_commit_size', 0)
+invalid('replication_synchro_ack_window', -1)
 
 local function invalid_combinations(name, val)
     local status, result = pcall(box.cfg, val)
@@ -0,0 +1,100 @@
+#!/usr/bin/env tarantool
+
+--
+-- Client connections are spread across several iproto threads,
+-- network statistics are summed up over all of them.
+--
+local tap = require('tap')
+local fiber = require('fiber')
+local net_box = require('net.box')
+
+local test = tap.test('iproto_threads')
+test:plan(9)
+
+box.cfg{listen = 'localhost:0', iproto_threads = 4}
+box.schema.user.grant('guest', 'super')
+
+test:is(box.cfg.iproto_threads, 4, 'iproto_threads is set')
+
+local ok, err = pcall(box.cfg, {iproto_threads = 2})
+test:ok(not ok and err:match("Can't set option 'iproto_threads' dynamically"),
+        'iproto_threads is not dynamic')
+
+local s = box.schema.space.create('test')
+s:create_index('pk')
+
+local connections = {}
+local CONN_COUNT = 16
+local REQ_COUNT = 10
+local requests_before = box.stat.net().REQUESTS.total
+for i = 1, CONN_COUNT do
+    connections[i] = net_box.connect(box.info.listen)
+end
+local all_ok = true
+for i = 1, CONN_COUNT do
+    for j = 1, REQ_COUNT do
+        local id = i * REQ_COUNT + j
+        connections[i].space.test:insert({id})
+        all_ok = all_ok and connections[i].space.test:get({id}) ~= nil
+    end
+end
+test:ok(all_ok, 'requests are served by all threads')
+test:is(s:count(), CONN_COUNT * REQ_COUNT, 'all rows are inserted')
+
+local stat = box.stat.net()
+test:is(stat.CONNECTIONS.current, CONN_COUNT,
+        'connection count is summed up over threads')
+test:ok(stat.REQUESTS.total - requests_before >= 2 * CONN_COUNT * REQ_COUNT,
+        'request count is summed up over threads')
+
+--
+-- Raising net_msg_max resumes connections stopped on every
+-- network thread.
+--
+local function wait(cond)
+    local deadline = fiber.clock() + 60
+    while not cond() and fiber.clock() < deadline do
+        fiber.sleep(0.01)
+    end
+    return cond()
+end
+
+local active = 0
+local finished = 0
+local release = false
+function block()
+    active = active + 1
+    while not release do
+        fiber.sleep(0.01)
+    end
+    active = active - 1
+end
+
+local net_msg_max = box.cfg.net_msg_max
+local CALL_COUNT = 4
+box.cfg{net_msg_max = 2}
+for i = 1, CONN_COUNT do
+    for _ = 1, CALL_COUNT do
+        fiber.create(function()
+            connections[i]:call('block')
+            finished = finished + 1
+        end)
+    end
+end
+fiber.sleep(0.1)
+test:ok(active < CONN_COUNT * CALL_COUNT,
+        'requests are throttled by net_msg_max')
+box.cfg{net_msg_max = net_msg_max}
+test:ok(wait(function() return active == CONN_COUNT * CALL_COUNT end),
+        'stopped connections are resumed on all threads')
+release = true
+test:ok(wait(function() return finished == CONN_COUNT * CALL_COUNT end),
+        'all requests are finished')
+
+for i = 1, CONN_COUNT do
+    connections[i]:close()
+end
+s:drop()
+box.schema.user.revoke('guest', 'super')
+
+os.exit(test:check() and 0 or 1)
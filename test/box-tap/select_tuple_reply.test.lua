@@ -0,0 +1,66 @@
+#!/usr/bin/env tarantool
+
+--
+-- Big tuples of a SELECT reply are written to the socket right
+-- from the tuple storage instead of being copied to the output
+-- buffer. Check the replies are intact.
+--
+local tap = require('tap')
+local net_box = require('net.box')
+local fiber = require('fiber')
+
+local test = tap.test('select_tuple_reply')
+test:plan(4)
+
+box.cfg{listen = 'localhost:0'}
+box.schema.user.grant('guest', 'super')
+
+local s = box.schema.space.create('test')
+s:create_index('pk')
+for i = 1, 1000 do
+    s:insert({i, string.rep(string.char(65 + i % 26), 100 + i % 2000)})
+end
+
+local c = net_box.connect(box.info.listen)
+
+test:is_deeply(c.space.test:select(), s:select(),
+               'full scan by reference')
+test:is_deeply(c.space.test:select({500}, {iterator = 'GE', limit = 10}),
+               s:select({500}, {iterator = 'GE', limit = 10}),
+               'small result set')
+
+-- Replies by reference interleave with ordinary replies.
+local ok = true
+local fibers = {}
+for i = 1, 10 do
+    local f = fiber.new(function()
+        for _ = 1, 10 do
+            ok = ok and c.space.test:get({i}) ~= nil
+            ok = ok and #c.space.test:select({}, {limit = 100 * i}) ==
+                        100 * i
+        end
+    end)
+    f:set_joinable(true)
+    table.insert(fibers, f)
+end
+for _, f in ipairs(fibers) do
+    f:join()
+end
+test:ok(ok, 'concurrent requests')
+
+s:truncate()
+
+-- A connection closed before a reply is sent.
+for i = 1, 1000 do
+    s:insert({i, string.rep('x', 1000)})
+end
+local c2 = net_box.connect(box.info.listen)
+c2.space.test:select({}, {is_async = true})
+c2:close()
+test:ok(c:ping(), 'connection is closed in the middle of a reply')
+
+c:close()
+s:drop()
+box.schema.user.revoke('guest', 'super')
+
+os.exit(test:check() and 0 or 1)
@@ -0,0 +1,45 @@
+--
+-- A hash index compares a tuple being deleted or replaced with
+-- the tuple stored in the hash table by pointer first. Check
+-- that lookups, replaces, and deletions still find the right
+-- tuples, including equal but different ones.
+--
+s = box.schema.space.create('test')
+_ = s:create_index('pk', {type = 'hash'})
+_ = s:create_index('sk', {type = 'hash', parts = {2, 'string', 3, 'unsigned'}})
+for i = 1, 1000 do s:insert{i, 'k' .. i % 10, i} end
+s:count()
+
+-- Lookups.
+s:get{1}
+s:get{1001}
+s.index.sk:get{'k5', 5}
+s.index.sk:get{'k5', 6}
+
+-- Replace with an equal but different tuple.
+s:replace{5, 'k5', 5, 'new'}
+s:get{5}
+s.index.sk:get{'k5', 5}
+
+-- Replace that changes the secondary key.
+s:replace{6, 'k6', 1006}
+s.index.sk:get{'k6', 6}
+s.index.sk:get{'k6', 1006}
+
+-- Deletions.
+for i = 1, 1000, 2 do s:delete{i} end
+s:count()
+s.index.sk:count()
+s:get{1}
+s:get{2}
+s.index.sk:get{'k3', 3}
+s.index.sk:get{'k4', 4}
+s.index.sk:delete{'k4', 4}
+s:get{4}
+
+-- Lookups in a transaction.
+box.begin() s:delete{2} r = {s:get{2} == nil, s:get{6}} box.commit()
+r
+s:count()
+
+s:drop()
@@ -0,0 +1,13 @@
+#!/usr/bin/env tarantool
+
+local threads = 1
+if arg[1] then
+    threads = tonumber(arg[1])
+end
+
+require('console').listen(os.getenv('ADMIN'))
+
+box.cfg({
+    listen = os.getenv("LISTEN"),
+    memtx_recovery_threads = threads,
+})
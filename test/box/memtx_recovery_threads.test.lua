@@ -0,0 +1,47 @@
+env = require('test_run')
+test_run = env.new()
+
+--
+-- Secondary keys are built in several threads after recovery.
+--
+test_run:cmd('create server test with script=\z
+             "box/memtx_recovery_threads.lua"')
+test_run:cmd('start server test with args="0" with crash_expected=True')
+test_run:cmd('start server test')
+test_run:cmd('switch test')
+
+s1 = box.schema.space.create('s1')
+_ = s1:create_index('pk')
+_ = s1:create_index('sk1', {parts = {2, 'string'}, unique = false})
+_ = s1:create_index('sk2', {parts = {3, 'unsigned', 2, 'string'}})
+_ = s1:create_index('sk3', {type = 'hash', parts = {3, 'unsigned'}})
+s2 = box.schema.space.create('s2')
+_ = s2:create_index('pk')
+_ = s2:create_index('sk', {parts = {{2, 'unsigned', path = '[*]'}}, \
+                           unique = false})
+for i = 1, 1000 do s1:insert{i, tostring(i % 100), 1000 - i} end
+for i = 1, 1000 do s2:insert{i, {i % 10, i % 7}} end
+box.snapshot()
+-- Rows recovered from WAL must get to secondary keys, too.
+for i = 1001, 1100 do s1:insert{i, tostring(i % 100), 3000 - i} end
+
+test_run:cmd('switch default')
+test_run:cmd('stop server test')
+test_run:cmd('start server test with args="4"')
+test_run:cmd('switch test')
+
+box.cfg.memtx_recovery_threads
+s1 = box.space.s1
+s2 = box.space.s2
+s1.index.sk1:count()
+s1.index.sk1:count('5')
+s1.index.sk2:select({}, {limit = 3})
+s1.index.sk2:select({}, {iterator = 'LT', limit = 1})
+s1.index.sk3:get{1900}
+s2.index.sk:count()
+s2.index.sk:count(3)
+
+test_run:cmd('switch default')
+test_run:cmd('stop server test')
+test_run:cmd('cleanup server test')
+test_run:cmd('delete server test')
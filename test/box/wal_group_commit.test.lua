@@ -0,0 +1,48 @@
+env = require('test_run')
+test_run = env.new()
+
+--
+-- WAL group commit and box.stat.wal().
+--
+test_run:cmd('create server test with script="box/wal_group_commit.lua"')
+test_run:cmd('start server test')
+test_run:cmd('switch test')
+
+box.cfg.wal_mode
+box.cfg.wal_group_commit_timeout
+box.cfg.wal_group_commit_size
+
+s = box.schema.space.create('test')
+_ = s:create_index('pk')
+
+box.stat.reset()
+stat = box.stat.wal()
+stat.batches
+stat.entries
+stat.batch_size.p50
+stat.batch_entries.p50
+
+box.cfg{wal_group_commit_timeout = 0.01}
+fiber = require('fiber')
+ch = fiber.channel(100)
+for i = 1, 100 do fiber.create(function() s:insert{i} ch:put(true) end) end
+for i = 1, 100 do ch:get() end
+s:count()
+
+stat = box.stat.wal()
+stat.entries
+stat.batches < stat.entries
+stat.batch_entries.p99 > 1
+stat.batch_size.p99 > 0
+stat.write_latency.p99 > 0
+
+box.stat.reset()
+box.stat.wal().entries
+
+box.cfg{wal_group_commit_timeout = 0}
+s:drop()
+
+test_run:cmd('switch default')
+test_run:cmd('stop server test')
+test_run:cmd('cleanup server test')
+test_run:cmd('delete server test')
@@ -0,0 +1,41 @@
+test_run = require('test_run')
+inspector = test_run.new()
+engine = inspector:get_cfg('engine')
+
+space = box.schema.space.create('test', {engine = engine})
+pk = space:create_index('pk')
+sk = space:create_index('sk', {parts = {2, 'string'}})
+nu = space:create_index('nu', {parts = {3, 'unsigned'}, unique = false})
+for i = 1, 10 do space:replace{i, 'k' .. i, i % 3} end
+box.snapshot()
+for i = 1, 10, 2 do space:replace{i, 'k' .. i, i % 3 + 10} end
+_ = space:delete{4}
+
+-- Tuples are returned in the order of the keys, missing keys are skipped.
+space:get_many({3, 1, 2})
+space:get_many({{10}, {4}, {11}, 5})
+-- Duplicate keys.
+space:get_many({7, 7, 1, 7})
+space:get_many({})
+sk:get_many({'k2', 'k9', 'k4', 'k1'})
+
+-- Errors.
+nu:get_many({1})
+pk:get_many({{1, 2}})
+pk:get_many({'a'})
+pk:get_many(1)
+
+-- A transaction sees its own changes.
+box.begin() space:replace{4, 'k4', 0} space:delete{5} t = space:get_many({4, 5, 6}) box.commit()
+t
+
+-- Remote get_many.
+box.schema.user.grant('guest', 'read', 'space', 'test')
+c = require('net.box').connect(box.cfg.listen)
+c.space.test:get_many({3, 1, 2})
+c.space.test.index.sk:get_many({'k9', 'k100', 'k4'})
+c.space.test.index.nu:get_many({1})
+c:close()
+box.schema.user.revoke('guest', 'read', 'space', 'test')
+
+space:drop()
@@ -0,0 +1,40 @@
+test_run = require('test_run').new()
+engine = test_run:get_cfg('engine')
+
+--
+-- The applier keeps reading transactions from the network
+-- while the previous ones are being written to WAL.
+--
+box.schema.user.grant('guest', 'replication')
+s = box.schema.space.create('test', {engine = engine})
+_ = s:create_index('pk')
+
+test_run:cmd("create server replica with rpl_master=default, script='replication/replica.lua'")
+test_run:cmd("start server replica")
+test_run:cmd("switch replica")
+box.info.replication[1].upstream.queue
+box.error.injection.set('ERRINJ_WAL_DELAY', true)
+test_run:cmd("switch default")
+
+for i = 1, 100 do s:replace{i} end
+
+test_run:cmd("switch replica")
+test_run:wait_cond(function()                                       \
+    return box.info.replication[1].upstream.queue == 100            \
+end)
+box.info.replication[1].upstream.status
+box.error.injection.set('ERRINJ_WAL_DELAY', false)
+test_run:wait_cond(function()                                       \
+    return box.info.replication[1].upstream.queue == 0              \
+end)
+box.space.test:count()
+box.info.replication[1].upstream.apply_lag > 0
+box.info.replication[1].upstream.status
+
+test_run:cmd("switch default")
+test_run:cmd("stop server replica")
+test_run:cmd("cleanup server replica")
+test_run:cmd("delete server replica")
+test_run:cleanup_cluster()
+s:drop()
+box.schema.user.revoke('guest', 'replication')
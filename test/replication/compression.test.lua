@@ -0,0 +1,77 @@
+test_run = require('test_run').new()
+engine = test_run:get_cfg('engine')
+
+--
+-- Compression of the replication stream.
+--
+box.cfg.replication_compression
+
+box.schema.user.grant('guest', 'replication')
+s = box.schema.space.create('test', {engine = engine})
+_ = s:create_index('pk')
+
+-- Make the master send its Raft state on subscribe.
+box.cfg{election_mode = 'voter'}
+
+test_run:cmd("create server replica with rpl_master=default, script='replication/replica.lua'")
+test_run:cmd("start server replica")
+test_run:cmd("switch replica")
+replication = box.cfg.replication
+box.cfg{replication = {}}
+box.cfg{replication_compression = true, replication = replication}
+test_run:wait_upstream(1, {status = 'follow'})
+test_run:cmd("switch default")
+
+replica_id = test_run:eval('replica', 'return box.info.id')[1]
+function downstream_compression(enabled)                            \
+    local d = box.info.replication[replica_id].downstream           \
+    return d ~= nil and d.status == 'follow' and                    \
+           (d.compression ~= nil) == enabled                        \
+end
+test_run:wait_cond(function() return downstream_compression(true) end)
+for i = 1, 1000 do s:replace{i, string.rep('x', 100)} end
+test_run:wait_lsn('replica', 'default')
+box.info.replication[replica_id].downstream.compression.ratio > 2
+box.info.replication[replica_id].downstream.compression.time > 0
+
+test_run:cmd("switch replica")
+box.space.test:count()
+box.space.test:get(1000)[2] == string.rep('x', 100)
+box.info.replication[1].upstream.status
+
+-- Compression is negotiated on reconnect.
+box.cfg{replication = {}}
+box.cfg{replication_compression = false, replication = replication}
+test_run:wait_upstream(1, {status = 'follow'})
+test_run:cmd("switch default")
+test_run:wait_cond(function() return downstream_compression(false) end)
+_ = s:replace{1001}
+test_run:wait_lsn('replica', 'default')
+test_run:eval('replica', 'return box.space.test:get(1001)')
+
+-- An error that stops subscribe after the master has confirmed
+-- compression is sent compressed, so the replica reports it
+-- rather than failing to decompress it.
+test_run:cmd("switch replica")
+box.cfg{replication = {}}
+test_run:cmd("switch default")
+test_run:wait_cond(function() return box.info.replication[replica_id].downstream.status == 'stopped' end)
+fio = require('fio')
+box.snapshot()
+xlog = fio.pathjoin(box.cfg.wal_dir, string.format('%020d.xlog', box.info.signature))
+_ = s:replace{1002}
+box.snapshot()
+_ = s:replace{1003}
+fio.unlink(xlog)
+test_run:cmd("switch replica")
+box.cfg{replication_compression = true, replication = replication}
+test_run:wait_upstream(1, {message_re = 'Missing %.xlog file', status = 'loading'})
+test_run:cmd("switch default")
+
+test_run:cmd("stop server replica")
+test_run:cmd("cleanup server replica")
+test_run:cmd("delete server replica")
+test_run:cleanup_cluster()
+box.cfg{election_mode = 'off'}
+s:drop()
+box.schema.user.revoke('guest', 'replication')
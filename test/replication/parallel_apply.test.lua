@@ -0,0 +1,100 @@
+test_run = require('test_run').new()
+engine = test_run:get_cfg('engine')
+fiber = require('fiber')
+digest = require('digest')
+msgpack = require('msgpack')
+
+--
+-- Parallel apply of replicated transactions.
+--
+box.cfg{replication_apply_fibers = 0}
+box.cfg.replication_apply_fibers
+
+box.schema.user.grant('guest', 'replication')
+s = box.schema.space.create('test', {engine = engine})
+_ = s:create_index('pk')
+_ = s:create_index('sk', {parts = {2, 'unsigned'}, unique = false})
+
+test_run:cmd("create server replica with rpl_master=default, script='replication/replica.lua'")
+test_run:cmd("start server replica")
+test_run:cmd("switch replica")
+box.cfg{replication_apply_fibers = 4}
+test_run:cmd("switch default")
+
+-- Independent transactions interleaved with conflicting ones.
+test_run:cmd("setopt delimiter ';'")
+function load(id)
+    for i = 1, 100 do
+        box.begin()
+        s:replace{id * 1000 + i, i}
+        if i % 10 == 0 then
+            s:upsert({0, 1}, {{'+', 2, 1}})
+        end
+        box.commit()
+    end
+end;
+function run_load()
+    local fibers = {}
+    for id = 1, 4 do
+        fibers[id] = fiber.new(load, id)
+        fibers[id]:set_joinable(true)
+    end
+    for _, f in ipairs(fibers) do
+        f:join()
+    end
+end;
+test_run:cmd("setopt delimiter ''");
+run_load()
+
+-- DDL is applied after all preceding transactions.
+_ = s:create_index('sk2', {parts = {2, 'unsigned', 1, 'unsigned'}})
+_ = s:delete{1001}
+run_load()
+
+checksum = digest.md5_hex(msgpack.encode(s:select()))
+vclock = test_run:get_vclock('default')
+vclock[0] = nil
+_ = test_run:wait_vclock('replica', vclock)
+test_run:eval('replica', "return require('digest').md5_hex(" .. \
+    "require('msgpack').encode(box.space.test:select()))")[1] == checksum
+
+test_run:cmd("switch replica")
+box.space.test:count() -- 401
+box.space.test:get{0} -- {0, 80}
+box.space.test.index.sk2:count() -- 401
+
+-- A replaced tuple frees a unique secondary key taken by
+-- the next transaction.
+test_run:cmd("switch default")
+v = box.schema.space.create('test_vinyl', {engine = 'vinyl'})
+_ = v:create_index('pk')
+_ = v:create_index('sk', {parts = {2, 'unsigned'}})
+_ = v:replace{1, 1}
+_ = v:replace{2, 0}
+for i = 1, 100 do v:replace{1, i + 1} v:replace{2, i} end
+vclock = test_run:get_vclock('default')
+vclock[0] = nil
+_ = test_run:wait_vclock('replica', vclock)
+test_run:cmd("switch replica")
+box.info.replication[1].upstream.status
+box.space.test_vinyl:select()
+
+-- An apply error stops the applier.
+box.space.test:insert{1000000, 1}
+test_run:cmd("switch default")
+s:insert{1000000, 2}
+s:insert{1000001, 1}
+test_run:cmd("switch replica")
+ok = test_run:wait_upstream(1, {status = 'stopped', \
+    message_re = "Duplicate key exists in unique index 'pk' in space 'test'"})
+ok
+box.space.test:get{1000000}
+box.space.test:get{1000001}
+
+test_run:cmd("switch default")
+test_run:cmd("stop server replica")
+test_run:cmd("cleanup server replica")
+test_run:cmd("delete server replica")
+s:drop()
+v:drop()
+box.schema.user.revoke('guest', 'replication')
@@ -0,0 +1,64 @@
+test_run = require('test_run').new()
+engine = test_run:get_cfg('engine')
+fiber = require('fiber')
+
+--
+-- ACKs received within replication_synchro_ack_window are
+-- coalesced into a single CONFIRM entry.
+--
+box.cfg.replication_synchro_ack_window
+box.cfg{replication_synchro_ack_window = -1}
+
+box.schema.user.grant('guest', 'replication')
+old_synchro_quorum = box.cfg.replication_synchro_quorum
+old_synchro_timeout = box.cfg.replication_synchro_timeout
+box.cfg{replication_synchro_quorum = 2, replication_synchro_timeout = 1000}
+
+test_run:cmd('create server replica with rpl_master=default,\
+                                         script="replication/replica.lua"')
+test_run:cmd('start server replica with wait=True, wait_load=True')
+
+_ = box.schema.space.create('sync', {is_sync = true, engine = engine})
+_ = box.space.sync:create_index('pk')
+
+box.stat.reset()
+box.cfg{replication_synchro_ack_window = 0.1}
+lsn = box.info.lsn
+done = 0
+for i = 1, 10 do                                                    \
+    fiber.create(function() box.space.sync:insert{i} done = done + 1 end)\
+end
+test_run:wait_cond(function() return done == 10 end)
+box.space.sync:count()
+-- 10 insertions and less than 10 CONFIRM entries.
+box.info.lsn - lsn < 20
+box.stat.synchro().confirms < 10
+box.stat.synchro().acks > 0
+box.stat.synchro().len
+box.stat.synchro().queue_len.p99 > 0
+box.stat.synchro().confirm_latency.p99 > 0
+
+-- Without a window every transaction is confirmed separately.
+box.cfg{replication_synchro_ack_window = 0}
+lsn = box.info.lsn
+_ = box.space.sync:insert{11}
+box.info.lsn - lsn
+
+box.stat.reset()
+box.stat.synchro().confirms
+box.stat.synchro().confirm_latency.p99
+
+test_run:wait_lsn('replica', 'default')
+test_run:cmd('switch replica')
+box.space.sync:count()
+
+test_run:cmd('switch default')
+test_run:cmd('stop server replica')
+test_run:cmd('cleanup server replica')
+test_run:cmd('delete server replica')
+box.space.sync:drop()
+box.cfg{                                                            \
+    replication_synchro_quorum = old_synchro_quorum,                \
+    replication_synchro_timeout = old_synchro_timeout,              \
+}
+box.schema.user.revoke('guest', 'replication')
@@ -0,0 +1,64 @@
+test_run = require('test_run').new()
+engine = test_run:get_cfg('engine')
+
+--
+-- Relays running in the fan-out thread.
+--
+box.cfg.replication_relay_fanout
+box.cfg{replication_relay_fanout = true}
+
+box.schema.user.grant('guest', 'replication')
+s = box.schema.space.create('test', {engine = engine})
+_ = s:create_index('pk')
+
+test_run:cmd('create server replica1 with rpl_master=default, script="replication/replica1.lua"')
+test_run:cmd('start server replica1')
+test_run:cmd('create server replica2 with rpl_master=default, script="replication/replica2.lua"')
+test_run:cmd('start server replica2')
+
+function count(server)                                              \
+    return test_run:eval(server, 'return box.space.test:count()')[1]\
+end
+
+-- Rows are decoded once and sent to both replicas.
+for i = 1, 1000 do _ = s:replace{i, string.rep('x', 100)} end
+test_run:wait_lsn('replica1', 'default')
+test_run:wait_lsn('replica2', 'default')
+count('replica1')
+count('replica2')
+
+-- A row that is bigger than a single read from the WAL buffer.
+_ = s:replace{1001, string.rep('x', 1024 * 1024)}
+test_run:wait_lsn('replica1', 'default')
+test_run:wait_lsn('replica2', 'default')
+test_run:eval('replica1', 'return box.space.test:get(1001)[2]:len()')
+test_run:eval('replica2', 'return box.space.test:get(1001)[2]:len()')
+
+-- A replica that is too far behind to be served from the WAL
+-- buffer is sent xlogs first, then joins the shared stream.
+test_run:cmd('stop server replica2')
+for i = 1, 2000 do _ = s:replace{i, string.rep('y', 10000)} end
+test_run:wait_lsn('replica1', 'default')
+test_run:cmd('start server replica2')
+test_run:wait_lsn('replica2', 'default')
+count('replica2')
+test_run:eval('replica2', 'return box.space.test:get(2000)[2]:len()')
+
+-- Relays of both kinds can run at the same time.
+box.cfg{replication_relay_fanout = false}
+test_run:cmd('restart server replica1')
+for i = 2001, 3000 do _ = s:replace{i} end
+test_run:wait_lsn('replica1', 'default')
+test_run:wait_lsn('replica2', 'default')
+count('replica1')
+count('replica2')
+
+test_run:cmd('stop server replica1')
+test_run:cmd('cleanup server replica1')
+test_run:cmd('delete server replica1')
+test_run:cmd('stop server replica2')
+test_run:cmd('cleanup server replica2')
+test_run:cmd('delete server replica2')
+test_run:cleanup_cluster()
+s:drop()
+box.schema.user.revoke('guest', 'replication')
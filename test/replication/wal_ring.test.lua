@@ -0,0 +1,74 @@
+test_run = require('test_run').new()
+engine = test_run:get_cfg('engine')
+fio = require('fio')
+
+--
+-- Relays that are in sync with WAL read rows from the in-memory
+-- WAL buffer instead of xlog files.
+--
+box.schema.user.grant('guest', 'replication')
+s = box.schema.space.create('test', {engine = engine})
+_ = s:create_index('pk')
+
+-- Make each snapshot trigger garbage collection.
+checkpoint_count = box.cfg.checkpoint_count
+box.cfg{checkpoint_count = 1}
+box.error.injection.set('ERRINJ_RELAY_REPORT_INTERVAL', 0.05)
+
+test_run:cmd("setopt delimiter ';'")
+function wait_xlog(n)
+    return test_run:wait_cond(function()
+        return #fio.glob(fio.pathjoin(box.cfg.wal_dir, '*.xlog')) == n
+    end)
+end;
+test_run:cmd("setopt delimiter ''");
+
+test_run:cmd("create server replica with rpl_master=default, script='replication/replica.lua'")
+test_run:cmd("start server replica")
+
+for i = 1, 100 do s:replace{i} end
+test_run:wait_lsn('replica', 'default')
+
+-- Xlogs are released on rotation while the relay reads rows
+-- from memory.
+box.snapshot()
+_ = s:replace{101}
+box.snapshot()
+_ = s:replace{102}
+test_run:wait_lsn('replica', 'default')
+wait_xlog(1) or fio.listdir(box.cfg.wal_dir)
+
+-- A relay evicted from the buffer goes back to reading xlogs.
+-- Raise the timeouts so that the replica doesn't reconnect
+-- while the relay is delayed.
+replication_timeout = box.cfg.replication_timeout
+box.cfg{replication_timeout = 1}
+_ = test_run:eval('replica', 'box.cfg{replication_timeout = 1}')
+box.error.injection.set('ERRINJ_RELAY_SEND_DELAY', true)
+_ = s:replace{103}
+pad = string.rep('x', 1024 * 1024)
+for i = 1, 20 do s:replace{i, pad} end
+box.error.injection.set('ERRINJ_RELAY_SEND_DELAY', false)
+test_run:wait_lsn('replica', 'default')
+test_run:grep_log('default', 'fell behind the in%-memory WAL buffer') ~= nil
+test_run:eval('replica', 'return box.space.test:count()')
+test_run:eval('replica', 'return box.space.test:get(20)[2]:len()')
+
+box.cfg{replication_timeout = replication_timeout}
+_ = test_run:eval('replica', 'box.cfg{replication_timeout = 0.1}')
+
+-- The relay switches back to the buffer once it catches up.
+box.snapshot()
+_ = s:replace{104}
+test_run:wait_lsn('replica', 'default')
+wait_xlog(1) or fio.listdir(box.cfg.wal_dir)
+test_run:eval('replica', 'return box.space.test:get(104)')
+
+test_run:cmd("stop server replica")
+test_run:cmd("cleanup server replica")
+test_run:cmd("delete server replica")
+test_run:cleanup_cluster()
+box.error.injection.set('ERRINJ_RELAY_REPORT_INTERVAL', 0)
+box.cfg{checkpoint_count = checkpoint_count}
+s:drop()
+box.schema.user.revoke('guest', 'replication')
@@ -858,6 +858,38 @@ delete_value_check()
 	footer();
 }
 
+static void
+find_batch_check()
+{
+	header();
+	test tree;
+	test_create(&tree, 0, extent_alloc, extent_free, &extents_count);
+	type_t keys[100];
+	type_t *results[100];
+	test_find_batch(&tree, keys, 0, results);
+	for (int i = 0; i < 100; i++)
+		keys[i] = i;
+	test_find_batch(&tree, keys, 100, results);
+	for (int i = 0; i < 100; i++) {
+		if (results[i] != NULL)
+			fail("find in an empty tree", "true");
+	}
+	for (type_t i = 0; i < 20000; i += 2)
+		test_insert(&tree, i, NULL);
+	for (int k = 0; k < 100; k++) {
+		int count = rand() % 100 + 1;
+		for (int i = 0; i < count; i++)
+			keys[i] = rand() % 20010 - 5;
+		test_find_batch(&tree, keys, count, results);
+		for (int i = 0; i < count; i++) {
+			if (results[i] != test_find(&tree, keys[i]))
+				fail("batch find result mismatch", "true");
+		}
+	}
+	test_destroy(&tree);
+	footer();
+}
+
 int
 main(void)
 {
@@ -873,4 +905,5 @@ main(void)
 		fail("memory leak!", "true");
 	insert_get_iterator();
 	delete_value_check();
+	find_batch_check();
 }
@@ -133,12 +133,66 @@ test_basic()
 	footer();
 }
 
+static void
+test_scan_resistance()
+{
+	header();
+	plan(3);
+	struct vy_cache cache;
+	uint32_t fields[] = { 0 };
+	uint32_t types[] = { FIELD_TYPE_UNSIGNED };
+	struct key_def *key_def;
+	struct tuple_format *format;
+	create_test_cache(fields, types, lengthof(fields), &cache, &key_def,
+			  &format);
+
+	/*
+	 * A statement accessed twice is moved to the protected
+	 * LRU segment.
+	 */
+	const struct vy_stmt_template hot = STMT_TEMPLATE(1, REPLACE, 0);
+	size_t mem_used = cache_env.mem_used;
+	vy_cache_insert_templates_chain(&cache, format, &hot, 1,
+					&key_template, ITER_GE);
+	size_t node_size = cache_env.mem_used - mem_used;
+	vy_cache_insert_templates_chain(&cache, format, &hot, 1,
+					&key_template, ITER_GE);
+	is(cache_env.protected_mem_used, node_size,
+	   "statement accessed twice is protected");
+
+	/*
+	 * A scan that doesn't fit in the cache evicts only
+	 * statements from the probationary segment.
+	 */
+	size_t quota = cache_env.mem_quota;
+	vy_cache_env_set_quota(&cache_env, 10 * node_size);
+	for (int i = 1; i <= 100; i++) {
+		const struct vy_stmt_template stmt =
+			STMT_TEMPLATE(1, REPLACE, i);
+		vy_cache_insert_templates_chain(&cache, format, &stmt, 1,
+						&key_template, ITER_GE);
+	}
+	ok(cache_env.mem_used <= 11 * node_size, "scan is evicted");
+
+	const struct vy_stmt_template hot_key = STMT_TEMPLATE(0, SELECT, 0);
+	struct vy_entry key = vy_new_simple_stmt(format, key_def, &hot_key);
+	ok(vy_cache_get(&cache, key).stmt != NULL,
+	   "protected statement survives scan");
+	tuple_unref(key.stmt);
+
+	vy_cache_env_set_quota(&cache_env, quota);
+	destroy_test_cache(&cache, key_def, format);
+	check_plan();
+	footer();
+}
+
 int
 main()
 {
 	vy_iterator_C_test_init(1LLU * 1024LLU * 1024LLU * 1024LLU);
 
 	test_basic();
+	test_scan_resistance();
 
 	vy_iterator_C_test_finish();
 	return 0;
@@ -0,0 +1,84 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "unit.h"
+#include "salad/xor_filter.h"
+
+static uint32_t
+h(uint32_t i)
+{
+	return i * 2654435761U;
+}
+
+static void
+empty_check()
+{
+	header();
+	struct xor_filter filter;
+	fail_if(xor_filter_create(&filter, NULL, 0) != 0);
+	uint32_t false_positive = 0;
+	for (uint32_t i = 0; i < 1000; i++)
+		false_positive += xor_filter_maybe_has(&filter, h(i));
+	fail_if(false_positive > 1000 / 256 * 3);
+	xor_filter_destroy(&filter);
+	footer();
+}
+
+static void
+duplicates_check()
+{
+	header();
+	uint32_t hashes[] = {h(1), h(2), h(2), h(3), h(1), h(1)};
+	uint32_t count = sizeof(hashes) / sizeof(hashes[0]);
+	struct xor_filter filter;
+	fail_if(xor_filter_create(&filter, hashes, count) != 0);
+	fail_unless(xor_filter_maybe_has(&filter, h(1)));
+	fail_unless(xor_filter_maybe_has(&filter, h(2)));
+	fail_unless(xor_filter_maybe_has(&filter, h(3)));
+	xor_filter_destroy(&filter);
+	footer();
+}
+
+static void
+fpr_check()
+{
+	header();
+	srand(time(NULL));
+	uint64_t tests = 0;
+	uint64_t false_positive = 0;
+	for (uint32_t count = 1; count <= 100000; count *= 10) {
+		uint32_t *hashes = malloc(count * sizeof(*hashes));
+		fail_if(hashes == NULL);
+		/* Even values are stored, odd values are checked. */
+		for (uint32_t i = 0; i < count; i++)
+			hashes[i] = h(2 * (rand() % (count * 10)));
+		uint32_t *values = malloc(count * sizeof(*values));
+		fail_if(values == NULL);
+		memcpy(values, hashes, count * sizeof(*values));
+		struct xor_filter filter;
+		fail_if(xor_filter_create(&filter, hashes, count) != 0);
+		fail_if(xor_filter_size(&filter) > 32 + 1.23 * count + 3);
+		for (uint32_t i = 0; i < count; i++)
+			fail_unless(xor_filter_maybe_has(&filter, values[i]));
+		for (uint32_t i = 0; i < count * 10; i++) {
+			tests++;
+			false_positive += xor_filter_maybe_has(&filter,
+							       h(2 * i + 1));
+		}
+		xor_filter_destroy(&filter);
+		free(values);
+		free(hashes);
+	}
+	fail_if((double)false_positive / tests > 1.5 / 256);
+	footer();
+}
+
+int
+main(void)
+{
+	empty_check();
+	duplicates_check();
+	fpr_check();
+}
@@ -0,0 +1,24 @@
+--
+-- A select with cache = false doesn't populate the tuple cache.
+--
+s = box.schema.space.create('test', {engine = 'vinyl'})
+_ = s:create_index('pk')
+_ = s:create_index('sk', {parts = {2, 'unsigned'}})
+for i = 1, 100 do s:replace{i, 1000 - i} end
+box.snapshot()
+
+#s:select({}, {cache = false}) -- 100
+s.index.pk:stat().cache.rows -- 0
+#s.index.sk:select({}, {cache = false}) -- 100
+s.index.pk:stat().cache.rows -- 0
+s.index.sk:stat().cache.rows -- 0
+
+-- The hint doesn't affect cache lookups.
+#s:select() -- 100
+s.index.pk:stat().cache.rows -- 100
+st = s.index.pk:stat().cache.lookup
+#s:select({}, {cache = false}) -- 100
+s.index.pk:stat().cache.lookup > st -- true
+s.index.pk:stat().cache.rows -- 100
+
+s:drop()
@@ -0,0 +1,50 @@
+test_run = require('test_run').new()
+
+--
+-- Compaction policy is configured per index.
+--
+s = box.schema.space.create('test', {engine = 'vinyl'})
+s:create_index('pk', {compaction_policy = 'foo'})
+s:create_index('pk', {compaction_policy = 42})
+_ = s:create_index('pk', {compaction_policy = 'tiered'})
+s.index.pk.options.compaction_policy
+s.index.pk:stat().amplification.policy
+
+test_run:cmd("setopt delimiter ';'")
+function dump(count)
+    for i = 1, count do
+        s:replace{i, string.rep('x', 100)}
+    end
+    box.snapshot()
+end;
+test_run:cmd("setopt delimiter ''");
+
+-- Tiered policy allows several runs at the last level.
+dump(100)
+dump(100)
+s.index.pk:stat().run_count -- 2
+s.index.pk:stat().disk.compaction.queue.rows -- 0
+
+-- Hybrid policy keeps the last level as a single run.
+s.index.pk:alter{compaction_policy = 'hybrid'}
+s.index.pk.options.compaction_policy
+s.index.pk:stat().amplification.policy
+dump(1)
+test_run:wait_cond(function() return s.index.pk:stat().run_count == 1 end)
+
+amp = s.index.pk:stat().amplification
+amp.write > 1
+amp.read -- 1
+amp.space -- 1
+
+-- Leveled policy keeps a single run per level, so two runs
+-- of the same size are merged, unlike with tiered policy.
+s.index.pk:alter{compaction_policy = 'leveled'}
+s.index.pk.options.compaction_policy
+s.index.pk:stat().amplification.policy
+dump(100)
+test_run:wait_cond(function() return s.index.pk:stat().run_count == 1 end)
+s.index.pk:stat().amplification.read -- 1
+s:count()
+
+s:drop()
@@ -0,0 +1,71 @@
+test_run = require('test_run').new()
+
+--
+-- A zstd dictionary trained on a sample of statements improves
+-- the compression ratio of small pages.
+--
+s = box.schema.space.create('test', {engine = 'vinyl'})
+s:create_index('pk', {compression_dict_size = 'big'})
+s:create_index('pk', {compression_dict_size = 100})
+s:create_index('pk', {compression_dict_size = 100000})
+_ = s:create_index('pk', {compression_dict_size = 8192, page_size = 4096})
+s.index.pk.options.compression_dict_size
+
+s2 = box.schema.space.create('test2', {engine = 'vinyl'})
+_ = s2:create_index('pk', {page_size = 4096})
+s2.index.pk.options.compression_dict_size
+
+test_run:cmd("setopt delimiter ';'")
+math.randomseed(42)
+words = {}
+for i = 1, 500 do
+    words[i] = string.format('%08x', math.random(0xffffff)) .. '-word'
+end;
+function word()
+    return words[math.random(#words)]
+end;
+for i = 1, 20000 do
+    local t = {i, word(), word(), word(), word()}
+    s:replace(t)
+    s2:replace(t)
+end;
+test_run:cmd("setopt delimiter ''");
+box.snapshot()
+
+s.index.pk:stat().disk.rows
+s2.index.pk:stat().disk.rows
+s.index.pk:stat().disk.bytes_compressed < s2.index.pk:stat().disk.bytes_compressed
+
+-- Pages are read back with the dictionary.
+msgpack = require('msgpack')
+msgpack.encode(s:select()) == msgpack.encode(s2:select())
+
+-- Compaction trains a new dictionary.
+for i = 1, 20000, 10 do s:delete{i} s2:delete{i} end
+box.snapshot()
+s.index.pk:compact()
+s2.index.pk:compact()
+test_run:wait_cond(function() return s.index.pk:stat().disk.compaction.count > 0 end)
+test_run:wait_cond(function() return s2.index.pk:stat().disk.compaction.count > 0 end)
+s.index.pk:stat().disk.rows
+s2.index.pk:stat().disk.rows
+s.index.pk:stat().disk.bytes_compressed < s2.index.pk:stat().disk.bytes_compressed
+msgpack.encode(s:select()) == msgpack.encode(s2:select())
+
+-- The dictionary is stored in the index file.
+test_run:cmd('restart server default')
+
+msgpack = require('msgpack')
+s = box.space.test
+s2 = box.space.test2
+s:count()
+msgpack.encode(s:select()) == msgpack.encode(s2:select())
+
+-- The option can be changed with alter.
+s.index.pk:alter{compression_dict_size = 0}
+s.index.pk.options.compression_dict_size
+s2.index.pk:alter{compression_dict_size = 4096}
+s2.index.pk.options.compression_dict_size
+
+s:drop()
+s2:drop()
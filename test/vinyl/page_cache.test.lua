@@ -0,0 +1,66 @@
+test_run = require('test_run').new()
+
+--
+-- Page cache keeps pages read from disk.
+--
+vinyl_cache = box.cfg.vinyl_cache
+box.cfg{vinyl_cache = 0}
+box.cfg{vinyl_page_cache = 1024 * 1024}
+
+s = box.schema.space.create('test', {engine = 'vinyl'})
+_ = s:create_index('pk', {page_size = 1024})
+for i = 1, 100 do s:replace{i, string.rep('x', 100)} end
+box.snapshot()
+
+test_run:cmd("setopt delimiter ';'")
+function pages()
+    return s.index.pk:stat().disk.iterator.read.pages
+end;
+function read()
+    local count = 0
+    for i = 1, 100 do
+        if s:get{i} ~= nil then
+            count = count + 1
+        end
+    end
+    return count
+end;
+test_run:cmd("setopt delimiter ''");
+
+-- The first pass reads pages from disk.
+st = box.stat.vinyl().page_cache
+p = pages()
+read() -- 100
+pages() - p >= s.index.pk:stat().disk.pages
+box.stat.vinyl().page_cache.miss - st.miss >= s.index.pk:stat().disk.pages
+box.stat.vinyl().memory.page_cache > 0
+
+-- The second pass hits the cache.
+st = box.stat.vinyl().page_cache
+p = pages()
+read() -- 100
+pages() - p -- 0
+box.stat.vinyl().page_cache.miss - st.miss -- 0
+box.stat.vinyl().page_cache.hit - st.hit >= 100
+
+-- Disabling the cache frees memory.
+box.cfg{vinyl_page_cache = 0}
+box.stat.vinyl().memory.page_cache -- 0
+box.stat.vinyl().page_cache.evict > 0
+
+-- Pages can be cached compressed.
+box.cfg{vinyl_page_cache = 1024 * 1024, vinyl_page_cache_compressed = true}
+p = pages()
+read() -- 100
+pages() - p >= s.index.pk:stat().disk.pages
+p = pages()
+read() -- 100
+pages() - p -- 0
+
+-- Pages of a deleted run are dropped from the cache.
+box.stat.vinyl().memory.page_cache > 0
+s:drop()
+test_run:wait_cond(function() return box.stat.vinyl().memory.page_cache == 0 end)
+
+box.cfg{vinyl_page_cache = 0, vinyl_page_cache_compressed = false}
+box.cfg{vinyl_cache = vinyl_cache}
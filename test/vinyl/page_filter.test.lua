@@ -0,0 +1,83 @@
+test_run = require('test_run').new()
+
+--
+-- Per-page xor filters let a point lookup skip reading a page
+-- that doesn't store the key.
+--
+s = box.schema.space.create('test', {engine = 'vinyl'})
+s:create_index('pk', {page_filter = 'yes'})
+_ = s:create_index('pk', {page_filter = true, page_size = 512, bloom_fpr = 1})
+s.index.pk.options.page_filter
+_ = s:create_index('sk', {parts = {2, 'unsigned'}, page_size = 512, bloom_fpr = 1})
+s.index.sk.options.page_filter
+
+-- Disable tuple cache to count page reads.
+vinyl_cache = box.cfg.vinyl_cache
+box.cfg{vinyl_cache = 0}
+
+for i = 1, 1000 do s:replace{i * 2, i * 2, string.rep('x', 20)} end
+box.snapshot()
+
+test_run:cmd("setopt delimiter ';'")
+function pages(idx)
+    return idx:stat().disk.iterator.read.pages
+end;
+function count(idx, first)
+    local found = 0
+    for i = first, 2000, 2 do
+        if idx:get{i} ~= nil then
+            found = found + 1
+        end
+    end
+    return found
+end;
+test_run:cmd("setopt delimiter ''");
+
+-- A miss in the filter avoids reading the page.
+pk_pages = pages(s.index.pk)
+sk_pages = pages(s.index.sk)
+count(s.index.pk, 1) -- 0
+count(s.index.sk, 1) -- 0
+pages(s.index.pk) - pk_pages < 20
+pages(s.index.sk) - sk_pages -- 1000
+
+-- Existing keys are still found.
+count(s.index.pk, 2) -- 1000
+count(s.index.sk, 2) -- 1000
+
+-- Filters are stored in the index file.
+test_run:cmd('restart server default')
+
+vinyl_cache = box.cfg.vinyl_cache
+box.cfg{vinyl_cache = 0}
+
+test_run:cmd("setopt delimiter ';'")
+function pages(idx)
+    return idx:stat().disk.iterator.read.pages
+end;
+function count(idx, first)
+    local found = 0
+    for i = first, 2000, 2 do
+        if idx:get{i} ~= nil then
+            found = found + 1
+        end
+    end
+    return found
+end;
+test_run:cmd("setopt delimiter ''");
+
+s = box.space.test
+s.index.pk.options.page_filter
+pk_pages = pages(s.index.pk)
+count(s.index.pk, 1) -- 0
+pages(s.index.pk) - pk_pages < 20
+count(s.index.pk, 2) -- 1000
+
+-- The option can be changed with alter.
+s.index.sk:alter{page_filter = true}
+s.index.sk.options.page_filter
+s.index.pk:alter{page_filter = false}
+s.index.pk.options.page_filter
+
+box.cfg{vinyl_cache = vinyl_cache}
+s:drop()
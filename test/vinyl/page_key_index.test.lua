@@ -0,0 +1,116 @@
+test_run = require('test_run').new()
+
+--
+-- A page key index lets a key search within a page skip
+-- decoding statements.
+--
+s = box.schema.space.create('test', {engine = 'vinyl'})
+s:create_index('pk', {page_key_index = 1})
+pk_parts = {{1, 'string'}, {2, 'unsigned'}}
+_ = s:create_index('pk', {parts = pk_parts, page_key_index = true, page_size = 1024})
+s.index.pk.options.page_key_index
+_ = s:create_index('sk', {parts = {{3, 'string'}}, unique = false, page_key_index = true, page_size = 1024})
+s.index.sk.options.page_key_index
+
+-- Use a memtx space as a reference.
+m = box.schema.space.create('test_memtx')
+_ = m:create_index('pk', {parts = pk_parts})
+_ = m:create_index('sk', {parts = {{3, 'string'}}, unique = false})
+
+-- Disable tuple cache to make lookups read pages.
+vinyl_cache = box.cfg.vinyl_cache
+box.cfg{vinyl_cache = 0}
+
+test_run:cmd("setopt delimiter ';'")
+function prefix(i)
+    return string.format('some/long/common/key/prefix/%03d', i)
+end;
+for i = 1, 100 do
+    for j = 1, 20, 2 do
+        local t = {prefix(i), j, string.format('value/%02d', j % 7)}
+        s:replace(t)
+        m:replace(t)
+    end
+end;
+msgpack = require('msgpack')
+iterators = {'EQ', 'REQ', 'GE', 'GT', 'LE', 'LT'};
+function check_key(name, key)
+    local errors = 0
+    for _, it in ipairs(iterators) do
+        local opts = {iterator = it, limit = 3}
+        local a = s.index[name]:select(key, opts)
+        local b = m.index[name]:select(key, opts)
+        if msgpack.encode(a) ~= msgpack.encode(b) then
+            errors = errors + 1
+        end
+    end
+    return errors
+end;
+function check()
+    local errors = 0
+    for i = 0, 101 do
+        errors = errors + check_key('pk', {prefix(i)})
+        for _, j in ipairs({0, 1, 2, 10, 19, 20, 21}) do
+            errors = errors + check_key('pk', {prefix(i), j})
+        end
+    end
+    for i = 0, 7 do
+        errors = errors + check_key('sk', {string.format('value/%02d', i)})
+    end
+    return errors
+end;
+test_run:cmd("setopt delimiter ''");
+
+box.snapshot()
+s.index.pk:stat().disk.pages > 1
+check()
+
+-- The key index is stored in the run file.
+test_run:cmd('restart server default')
+
+test_run:cmd("setopt delimiter ';'")
+function prefix(i)
+    return string.format('some/long/common/key/prefix/%03d', i)
+end;
+msgpack = require('msgpack')
+iterators = {'EQ', 'REQ', 'GE', 'GT', 'LE', 'LT'};
+function check_key(name, key)
+    local errors = 0
+    for _, it in ipairs(iterators) do
+        local opts = {iterator = it, limit = 3}
+        local a = s.index[name]:select(key, opts)
+        local b = m.index[name]:select(key, opts)
+        if msgpack.encode(a) ~= msgpack.encode(b) then
+            errors = errors + 1
+        end
+    end
+    return errors
+end;
+function check()
+    local errors = 0
+    for i = 0, 101 do
+        errors = errors + check_key('pk', {prefix(i)})
+        for _, j in ipairs({0, 1, 2, 10, 19, 20, 21}) do
+            errors = errors + check_key('pk', {prefix(i), j})
+        end
+    end
+    for i = 0, 7 do
+        errors = errors + check_key('sk', {string.format('value/%02d', i)})
+    end
+    return errors
+end;
+test_run:cmd("setopt delimiter ''");
+
+vinyl_cache = box.cfg.vinyl_cache
+box.cfg{vinyl_cache = 0}
+s = box.space.test
+m = box.space.test_memtx
+check()
+
+-- The option can be changed with alter.
+s.index.sk:alter{page_key_index = false}
+s.index.sk.options.page_key_index
+
+box.cfg{vinyl_cache = vinyl_cache}
+s:drop()
+m:drop()
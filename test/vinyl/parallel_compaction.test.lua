@@ -0,0 +1,104 @@
+test_run = require('test_run').new()
+fiber = require('fiber')
+digest = require('digest')
+
+--
+-- Compaction of a big range may be split in key-partitioned
+-- parts executed by several worker threads in parallel.
+--
+box.cfg{vinyl_compaction_parts = 0}
+box.cfg{vinyl_compaction_parts = 4}
+
+s = box.schema.space.create('test', {engine = 'vinyl'})
+_ = s:create_index('pk', {run_count_per_level = 100, page_size = 256, range_size = 16 * 1024})
+
+test_run:cmd("setopt delimiter ';'")
+data = {}
+function dump(first, last)
+    for i = first, last do
+        data[i] = digest.urandom(1000)
+        s:replace{i, data[i]}
+    end
+    box.snapshot()
+end;
+function check()
+    for i, v in ipairs(data) do
+        local t = s:get(i)
+        if t == nil or t[2] ~= v then
+            return false
+        end
+    end
+    return s:count() == #data
+end;
+function info()
+    local info = s.index.pk:stat()
+    return {range_count = info.range_count, run_count = info.run_count}
+end;
+function compact()
+    local count = s.index.pk:stat().disk.compaction.count
+    s.index.pk:compact()
+    test_run:wait_cond(function()
+        return s.index.pk:stat().disk.compaction.count > count
+    end)
+end;
+test_run:cmd("setopt delimiter ''");
+
+-- The first run should be big enough to prevent major compaction
+-- from kicking in on the next dump.
+dump(1, 150)
+dump(1, 20)
+info() -- 1 range, 2 runs
+
+-- There are only two compaction threads so the compaction
+-- is split in two parts.
+compact()
+info() -- 1 range, 2 runs
+test_run:grep_log('default', 'compaction of range .* is split in 2 parts') ~= nil
+check()
+
+-- Runs written by a split compaction are accounted as one run
+-- so a small dump doesn't trigger compaction.
+dump(151, 160)
+info() -- 1 range, 3 runs
+fiber.sleep(0.1)
+info() -- 1 range, 3 runs
+check()
+
+test_run:cmd('restart server default')
+
+fiber = require('fiber')
+s = box.space.test
+
+test_run:cmd("setopt delimiter ';'")
+function check(count)
+    local i = 0
+    for _, t in s:pairs() do
+        i = i + 1
+        if t[1] ~= i then
+            return false
+        end
+    end
+    return i == count
+end;
+function info()
+    local info = s.index.pk:stat()
+    return {range_count = info.range_count, run_count = info.run_count}
+end;
+test_run:cmd("setopt delimiter ''");
+
+box.cfg.vinyl_compaction_parts
+
+info() -- 1 range, 3 runs
+check(160)
+
+-- Runs written by a split compaction are still accounted
+-- as one run after restart.
+fiber.sleep(0.1)
+info() -- 1 range, 3 runs
+
+s.index.pk:compact()
+test_run:wait_cond(function() return info().run_count == 1 end)
+info() -- 1 range, 1 run
+check(160)
+
+s:drop()
@@ -0,0 +1,40 @@
+test_run = require('test_run').new()
+
+--
+-- Check that a point lookup returns correct results when
+-- runs of a range are read in parallel.
+--
+box.cfg.vinyl_parallel_lookup
+box.cfg{vinyl_parallel_lookup = true}
+-- Disable tuple cache so that every lookup reads the disk.
+vinyl_cache = box.cfg.vinyl_cache
+box.cfg{vinyl_cache = 0}
+
+s = box.schema.space.create('test', {engine = 'vinyl'})
+_ = s:create_index('pk', {run_count_per_level = 100})
+
+-- Create several runs that contain different versions of the same keys.
+for i = 1, 10 do s:replace{i, 1} end
+box.snapshot()
+for i = 1, 10, 2 do s:replace{i, 2} end
+box.snapshot()
+for i = 1, 10, 3 do s:delete{i} end
+box.snapshot()
+for i = 1, 10, 4 do s:upsert({i, 3}, {{'+', 2, 10}}) end
+box.snapshot()
+
+s.index.pk:stat().run_count -- 4
+
+res = {}
+for i = 1, 12 do table.insert(res, s:get{i} or 'none') end
+res
+s:select()
+
+-- Results must be the same with parallel lookups disabled.
+box.cfg{vinyl_parallel_lookup = false}
+res = {}
+for i = 1, 12 do table.insert(res, s:get{i} or 'none') end
+res
+
+s:drop()
+box.cfg{vinyl_cache = vinyl_cache}
@@ -0,0 +1,54 @@
+test_run = require('test_run').new()
+
+--
+-- Quota class is configured on the primary index.
+--
+s = box.schema.space.create('test', {engine = 'vinyl'})
+s:create_index('pk', {quota_class = 'foo'})
+_ = s:create_index('pk', {quota_class = 'bulk'})
+s.index.pk.options.quota_class
+s:drop()
+
+test_run:cmd("create server test with script='vinyl/low_quota.lua'")
+test_run:cmd("start server test with args='1048576'")
+test_run:cmd('switch test')
+
+box.cfg{vinyl_timeout = 0.01}
+box.error.injection.set('ERRINJ_VY_RUN_WRITE', true)
+
+normal = box.schema.space.create('normal', {engine = 'vinyl'})
+_ = normal:create_index('pk')
+bulk = box.schema.space.create('bulk', {engine = 'vinyl'})
+_ = bulk:create_index('pk', {quota_class = 'bulk'})
+
+_ = normal:replace{1, string.rep('x', 0.6 * box.cfg.vinyl_memory)}
+box.stat.reset()
+
+--
+-- Bulk transactions are throttled as soon as memory usage
+-- exceeds their share while normal transactions may proceed.
+--
+pad = string.rep('x', 0.2 * box.cfg.vinyl_memory)
+bulk:replace{1, pad}
+_ = normal:replace{2, pad}
+
+st = box.stat.vinyl().quota
+st.bulk.throttle_count -- 1
+st.bulk.throttled_bytes > 0
+st.bulk.wait_time > 0
+st.tx.throttle_count -- 0
+
+--
+-- A transaction writing to both a normal and a bulk space
+-- is accounted as normal.
+--
+box.stat.reset()
+box.begin() bulk:replace{1} normal:replace{3} box.commit()
+box.stat.vinyl().quota.bulk.throttle_count -- 0
+bulk:count() -- 1
+
+box.error.injection.set('ERRINJ_VY_RUN_WRITE', false)
+
+test_run:cmd('switch default')
+test_run:cmd("stop server test")
+test_run:cmd("cleanup server test")
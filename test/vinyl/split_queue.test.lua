@@ -0,0 +1,47 @@
+test_run = require('test_run').new()
+fiber = require('fiber')
+digest = require('digest')
+errinj = box.error.injection
+
+--
+-- Check that a range is split when it needs compaction even if
+-- all compaction workers are busy.
+--
+s = box.schema.space.create('test', {engine = 'vinyl'})
+i = s:create_index('pk', {run_count_per_level = 1, run_size_ratio = 100, page_size = 128, range_size = 1024})
+
+test_run:cmd("setopt delimiter ';'")
+function dump(big)
+    local step = big and 1 or 5
+    for k = 1, 20, step do
+        s:replace{k, digest.urandom(1000)}
+    end
+    box.snapshot()
+end;
+test_run:cmd("setopt delimiter ''");
+
+-- The first compaction doesn't split the range.
+dump(true)
+dump()
+test_run:wait_cond(function() return i:stat().disk.compaction.count == 1 end)
+i:stat().range_count -- 1
+
+-- Occupy all compaction workers (there are two of them).
+b = box.schema.space.create('blocker', {engine = 'vinyl'})
+_ = b:create_index('pk', {run_count_per_level = 1})
+_ = b:create_index('sk', {run_count_per_level = 1, parts = {2, 'unsigned'}})
+errinj.set('ERRINJ_VY_COMPACTION_DELAY', true)
+for k = 1, 2 do b:replace{1, k} box.snapshot() end
+test_run:wait_cond(function() return box.stat.vinyl().scheduler.tasks_inprogress == 2 end)
+
+-- The range is split right after dump.
+dump()
+test_run:wait_cond(function() return i:stat().range_count == 2 end)
+i:stat().disk.compaction.count -- 1
+
+errinj.set('ERRINJ_VY_COMPACTION_DELAY', false)
+test_run:wait_cond(function() return i:stat().run_count == 2 end)
+s:count() -- 20
+
+s:drop()
+b:drop()
@@ -72,9 +72,11 @@ end;
 --
 -- Filter dump/compaction time as we need error injection to
 -- test them properly.
+-- Amplification factors are checked by compaction_policy test.
 function istat()
     local st = box.space.test.index.pk:stat()
     st.latency = nil
+    st.amplification = nil
     st.disk.dump.time = nil
     st.disk.compaction.time = nil
     return st
@@ -90,6 +92,9 @@ end;
 function gstat()
     local st = box.stat.vinyl()
     st.regulator = nil
+    st.page_cache = nil
+    st.quota = nil
+    st.memory.page_cache = nil
     st.scheduler.dump_time = nil
     st.scheduler.compaction_time = nil
     return st